@@ -369,6 +369,8 @@ class ROOTFacade(types.ModuleType):
             try:
                 from libROOTPythonizations import AsRTensor
                 ns.Experimental.AsRTensor = AsRTensor
+                from ._pythonization._tmva import CreateBatchGenerator
+                ns.Experimental.CreateBatchGenerator = CreateBatchGenerator
             except:
                 raise Exception('Failed to pythonize the namespace TMVA')
         del type(self).TMVA
@@ -187,6 +187,8 @@ def RDataFrameAsNumpy(df, columns=None, exclude=None, lazy=False):
 
     Be aware that reading out custom types is much less performant than reading out
     fundamental types, such as int or float, which are supported directly by numpy.
+    The values of fundamental types are collected by all threads in a single buffer,
+    which is then adopted by the numpy array without copying.
 
     The reading is performed in multiple threads if the implicit multi-threading of
     ROOT is enabled.
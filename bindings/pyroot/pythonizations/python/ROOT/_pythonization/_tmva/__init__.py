@@ -25,6 +25,7 @@ from ._rbdt import Compute, pythonize_rbdt
 hasRDF = gSystem.GetFromPipe("root-config --has-dataframe") == "yes"
 if hasRDF:
     from ._rtensor import get_array_interface, add_array_interface_property, RTensorGetitem, pythonize_rtensor
+    from ._batchgenerator import CreateBatchGenerator, pythonize_rbatchgenerator
 
 #this should be available only when xgboost is there ?
 # We probably don't need a protection here since the code is run only when there is xgboost
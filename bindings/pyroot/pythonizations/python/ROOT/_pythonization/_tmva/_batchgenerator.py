@@ -0,0 +1,71 @@
+################################################################################
+# Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.                      #
+# All rights reserved.                                                         #
+#                                                                              #
+# For the licensing terms see $ROOTSYS/LICENSE.                                #
+# For the list of contributors see $ROOTSYS/README/CREDITS.                    #
+################################################################################
+
+from .. import pythonization
+
+
+def CreateBatchGenerator(rdf, batch_size, columns=None, shuffle_buffer_size=100000, max_queued_batches=4,
+                         shuffle=True, seed=0, drop_remainder=True):
+    """Create a TMVA.Experimental.RBatchGenerator that streams the content of an RDataFrame as batches.
+
+    The column types are taken from the dataframe. Iterating over the returned object runs one pass over the
+    dataset (an epoch) and yields one numpy array of shape (batch_size, len(columns)) and dtype float32 per batch.
+    The arrays are views on the buffers of the generator: they are only valid until the next batch is requested,
+    copy them (e.g. with numpy.array or torch.tensor) to keep them longer.
+
+    Parameters:
+        rdf: RDataFrame node to read.
+        batch_size (int): number of rows per batch.
+        columns (list): names of the columns to read, all columns if None.
+        shuffle_buffer_size (int): number of rows kept in memory to shuffle the entries.
+        max_queued_batches (int): maximum number of complete batches waiting for the consumer.
+        shuffle (bool): whether to shuffle the rows.
+        seed (int): seed of the random number generators used for shuffling.
+        drop_remainder (bool): whether to drop the last batch of an epoch if it is incomplete.
+
+    Returns:
+        RBatchGenerator: the generator, which can be iterated over once per epoch.
+    """
+    import ROOT
+
+    if isinstance(columns, str):
+        raise TypeError("The columns argument requires a list of strings")
+    if not columns:
+        columns = [str(c) for c in rdf.GetColumnNames()]
+    column_types = tuple(str(rdf.GetColumnType(c)) for c in columns)
+
+    generator_class = ROOT.TMVA.Experimental.RBatchGenerator[column_types]
+    return generator_class(ROOT.RDF.AsRNode(rdf), columns, batch_size, shuffle_buffer_size, max_queued_batches,
+                           shuffle, seed, drop_remainder)
+
+
+def RBatchGeneratorIter(self):
+    """
+    Run one epoch and yield its batches as numpy arrays, which are views valid until the next batch is requested.
+    Stopping the iteration early interrupts the event loop.
+    """
+    import numpy
+
+    self.StartEpoch()
+    try:
+        while True:
+            batch = self.GetNextBatch()
+            if batch.GetShape()[0] == 0:
+                return
+            yield numpy.asarray(batch)
+    finally:
+        self.StopEpoch()
+
+
+@pythonization("RBatchGenerator<", ns="TMVA::Experimental", is_prefix=True)
+def pythonize_rbatchgenerator(klass, name):
+    # Parameters:
+    # klass: class to be pythonized
+    # name: string containing the name of the class
+
+    klass.__iter__ = RBatchGeneratorIter
@@ -16,6 +16,7 @@ Buffer base class used for serializing objects.
 */
 
 #include "TBuffer.h"
+#include "Byteswap.h"
 #include "TClass.h"
 #include "TProcessID.h"
 
@@ -385,6 +386,27 @@ TVirtualArray *TBuffer::PopDataCache()
    return val;
 }
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Byte-swap in place n elements of N bytes starting at buf, which does not
+/// need to be aligned. Written as a plain loop over independent elements so
+/// that the compiler can vectorize it.
+
+template <unsigned N>
+void ByteSwapInPlace(char *buf, Long64_t n)
+{
+   using Value_t = typename RByteSwap<N>::value_type;
+   for (Long64_t idx = 0; idx < n; ++idx) {
+      Value_t tmp;
+      memcpy(&tmp, buf + idx * N, N);
+      tmp = RByteSwap<N>::bswap(tmp);
+      memcpy(buf + idx * N, &tmp, N);
+   }
+}
+
+} // anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Byte-swap N primitive-elements in the buffer.
 /// Bulk API relies on this function.
@@ -394,30 +416,15 @@ Bool_t TBuffer::ByteSwapBuffer(Long64_t n, EDataType type)
    char *input_buf = GetCurrent();
    if ((type == EDataType::kShort_t) || (type == EDataType::kUShort_t)) {
 #ifdef R__BYTESWAP
-      Short_t *buf __attribute__((aligned(8))) = reinterpret_cast<Short_t*>(input_buf);
-      for (int idx=0; idx<n; idx++) {
-         Short_t tmp = *reinterpret_cast<Short_t*>(buf + idx); // Makes a copy of the values; frombuf can't handle aliasing.
-         char *tmp_ptr = reinterpret_cast<char *>(&tmp);
-         frombuf(tmp_ptr, buf + idx);
-      }
+      ByteSwapInPlace<2>(input_buf, n);
 #endif
    } else if ((type == EDataType::kFloat_t) || (type == EDataType::kInt_t) || (type == EDataType::kUInt_t)) {
 #ifdef R__BYTESWAP
-      Float_t *buf __attribute__((aligned(8))) = reinterpret_cast<Float_t*>(input_buf);
-      for (int idx=0; idx<n; idx++) {
-         Float_t tmp = *reinterpret_cast<Float_t*>(buf + idx); // Makes a copy of the values; frombuf can't handle aliasing.
-         char *tmp_ptr = reinterpret_cast<char *>(&tmp);
-         frombuf(tmp_ptr, buf + idx);
-      }
+      ByteSwapInPlace<4>(input_buf, n);
 #endif
    } else if ((type == EDataType::kDouble_t) || (type == EDataType::kLong64_t) || (type == EDataType::kULong64_t)) {
 #ifdef R__BYTESWAP
-      Double_t *buf __attribute__((aligned(8))) = reinterpret_cast<Double_t*>(input_buf);
-      for (int idx=0; idx<n; idx++) {
-         Double_t tmp = *reinterpret_cast<Double_t*>(buf + idx); // Makes a copy of the values; frombuf can't handle aliasing.
-         char *tmp_ptr = reinterpret_cast<char*>(&tmp);
-         frombuf(tmp_ptr, buf + idx);
-      }
+      ByteSwapInPlace<8>(input_buf, n);
 #endif
    } else {
       return false;
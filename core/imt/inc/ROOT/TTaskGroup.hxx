@@ -42,6 +42,7 @@ public:
    void Cancel();
    void Run(const std::function<void(void)> &closure);
    void Wait();
+   void WaitIsolated();
 };
 } // namespace Experimental
 } // namespace ROOT
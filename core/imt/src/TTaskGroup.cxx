@@ -128,5 +128,25 @@ void TTaskGroup::Wait()
    fCanRun = true;
 #endif
 }
+
+/////////////////////////////////////////////////////////////////////////////
+/// Wait until all submitted items of work are completed, like Wait(), but
+/// without executing items of work of other groups meanwhile: the waiting
+/// thread neither runs them nor the items of this group, which are left to the
+/// other threads of the pool. This guarantees that the task calling it, if any,
+/// is not interleaved with unrelated work.
+void TTaskGroup::WaitIsolated()
+{
+   ExecuteInIsolation([this] { Wait(); });
+}
+
+void TTaskGroup::ExecuteInIsolation(const std::function<void(void)> &operation)
+{
+#ifdef R__USE_IMT
+   tbb::this_task_arena::isolate(operation);
+#else
+   operation();
+#endif
+}
 } // namespace Experimental
 } // namespace ROOT
@@ -0,0 +1,53 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RBufferKernels
+#define ROOT_RBufferKernels
+
+#include "RtypesCore.h"
+
+#include <cstddef>
+
+namespace ROOT {
+namespace Internal {
+
+/**
+ * \ingroup IO
+ *
+ * Array kernels converting between the in-memory representation of the fundamental types and their representation in
+ * a TBufferFile, used by its fast-array methods.
+ *
+ * All functions accept unaligned buffers; the source and the destination must not overlap. The implementation is
+ * chosen at the first call depending on the instruction sets supported by the CPU (SSSE3 or AVX2 on x86-64, NEON on
+ * ARM64), with a portable scalar fallback. It can be changed with SetBufferKernelsISA(), e.g. for benchmarks.
+ */
+namespace RBufferKernels {
+
+enum class EISA { kScalar, kSSSE3, kAVX2, kNEON };
+
+/// Copy `n` values of 2, 4 or 8 bytes from `src` to `dst`, reversing the bytes of every value.
+void ByteSwapCopy16(void *dst, const void *src, std::size_t n);
+void ByteSwapCopy32(void *dst, const void *src, std::size_t n);
+void ByteSwapCopy64(void *dst, const void *src, std::size_t n);
+
+/// Decode `n` floats written with a truncated mantissa of `nbits` bits, i.e. 3 bytes per value: the exponent and
+/// the big-endian mantissa with the sign bit; see TBufferFile::WriteFloat16().
+void UnpackFloat16(Float_t *dst, const char *src, std::size_t n, Int_t nbits);
+void UnpackFloat16(Double_t *dst, const char *src, std::size_t n, Int_t nbits);
+
+/// Decode `n` big-endian floats into doubles, as written for Double32_t without range and number of bits.
+void UnpackFloatToDouble(Double_t *dst, const char *src, std::size_t n);
+
+EISA GetBufferKernelsISA();
+bool SetBufferKernelsISA(EISA isa);
+
+} // namespace RBufferKernels
+} // namespace Internal
+} // namespace ROOT
+
+#endif
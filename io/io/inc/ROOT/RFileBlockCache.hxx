@@ -0,0 +1,95 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RFileBlockCache
+#define ROOT_RFileBlockCache
+
+#include "RtypesCore.h"
+#include "ROOT/RStringView.hxx"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace ROOT {
+namespace Internal {
+
+/**
+ * \class RFileBlockCache
+ * \ingroup IO
+ *
+ * A persistent cache of the blocks of remote files on the local disk, see TFile::SetBlockCacheDir().
+ *
+ * The files are split in blocks of a fixed size. Every block is stored in its own file in the cache directory, named
+ * after a key identifying the content of the remote file (its URL and version) and the index of the block; a read
+ * fetches the missing blocks as a whole, with a single vectored read, and serves the requested ranges from the blocks.
+ *
+ * The directory can be shared by any number of processes without locking: a block is written to a temporary file
+ * and renamed into place, so readers see either the complete block or no block. Recently used blocks have their
+ * modification time refreshed; once the amount of data written by a process since the last check exceeds a fraction
+ * of the quota, the least recently used blocks are removed until the directory is below the quota.
+ */
+class RFileBlockCache {
+public:
+   /// Reads the `nbuf` ranges at `pos` of lengths `len` into `buf`, one after the other; returns true on failure.
+   using FetchFunc_t = std::function<bool(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)>;
+
+   /// Usage statistics of the cache by this process.
+   struct RStats {
+      ULong64_t fBlockHits = 0;    ///< Blocks found in the cache
+      ULong64_t fBlockMisses = 0;  ///< Blocks fetched from the remote files
+      ULong64_t fBytesServed = 0;  ///< Bytes returned by Read()
+      ULong64_t fBytesFetched = 0; ///< Bytes fetched from the remote files
+      ULong64_t fBytesEvicted = 0; ///< Bytes removed from the cache directory by this process
+
+      double GetHitRate() const
+      {
+         return fBlockHits + fBlockMisses ? double(fBlockHits) / (fBlockHits + fBlockMisses) : 0;
+      }
+   };
+
+private:
+   std::string fDir;                           ///< The cache directory
+   Long64_t fMaxBytes;                         ///< Quota of the cache directory
+   Int_t fBlockSize;                           ///< Size of the blocks, but for the last one of a file
+   std::atomic<Long64_t> fBytesSinceShrink{0}; ///< Bytes stored since the last check of the quota
+   std::atomic<UInt_t> fTmpCounter{0};         ///< Makes the names of the temporary files unique
+   std::mutex fShrinkMutex;                    ///< Lets a single thread check the quota
+
+   std::atomic<ULong64_t> fBlockHits{0};
+   std::atomic<ULong64_t> fBlockMisses{0};
+   std::atomic<ULong64_t> fBytesServed{0};
+   std::atomic<ULong64_t> fBytesFetched{0};
+   std::atomic<ULong64_t> fBytesEvicted{0};
+
+   std::string GetBlockPath(const std::string &fileKey, Long64_t block) const;
+   void StoreBlock(const std::string &path, const char *data, Int_t len);
+
+public:
+   RFileBlockCache(std::string_view dir, Long64_t maxBytes, Int_t blockSize);
+   RFileBlockCache(const RFileBlockCache &) = delete;
+   RFileBlockCache &operator=(const RFileBlockCache &) = delete;
+
+   static std::string MakeFileKey(std::string_view url, std::string_view version);
+
+   Int_t Read(const std::string &fileKey, Long64_t fileSize, char *buf, const Long64_t *pos, const Int_t *len,
+              Int_t nbuf, const FetchFunc_t &fetch);
+   void Shrink();
+
+   const std::string &GetDir() const { return fDir; }
+   Long64_t GetMaxBytes() const { return fMaxBytes; }
+   Int_t GetBlockSize() const { return fBlockSize; }
+   RStats GetStats() const;
+   void PrintStats() const;
+};
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -0,0 +1,91 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RKeyIndex
+#define ROOT_RKeyIndex
+
+#include "RtypesCore.h"
+#include "ROOT/RStringView.hxx"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ROOT {
+namespace Internal {
+
+/**
+ * \class RKeyIndex
+ * \ingroup IO
+ *
+ * An index of the keys record of a directory, see TDirectoryFile::SetKeyIndexThreshold().
+ *
+ * The record is kept as read from the file. The index holds, for each key header of the record, its position in the
+ * record and the position and length of its name and class name, the cycle and the position of the object on file;
+ * the entries are sorted by name, keeping the order of the record for the cycles of a same name. A lookup by name is
+ * then a binary search, and the TKey of an entry is created from its header in the record only when it is needed.
+ */
+class RKeyIndex {
+public:
+   /// A key header of the record.
+   struct REntry {
+      Long64_t fSeekKey = 0;   ///< Position of the object on file
+      Int_t fKeyOffset = 0;    ///< Position of the key header in the record
+      Int_t fNameOffset = 0;   ///< Position of the name in the record
+      Int_t fNameLen = 0;      ///< Length of the name
+      Int_t fClassOffset = 0;  ///< Position of the class name in the record
+      Int_t fClassLen = 0;     ///< Length of the class name
+      Short_t fCycle = 0;      ///< Cycle of the key
+      Bool_t fLoaded = kFALSE; ///< True once the TKey of the entry was created
+   };
+   using Iterator_t = std::vector<REntry>::iterator;
+
+private:
+   std::unique_ptr<char[]> fRecord; ///< The key headers, one after the other
+   Int_t fRecordSize;               ///< Size of fRecord
+   std::vector<REntry> fEntries;    ///< One entry per valid key header, sorted by name
+   Int_t fNLoaded = 0;              ///< Number of entries whose TKey was created
+
+public:
+   /// Index the `nkeys` key headers of `record`, of `size` bytes, of a file of `fileSize` bytes. The indexing stops
+   /// at the first header which is truncated or points outside of the file.
+   RKeyIndex(std::unique_ptr<char[]> record, Int_t size, Int_t nkeys, Long64_t fileSize);
+
+   Int_t GetNKeys() const { return fEntries.size(); }
+   Int_t GetNLoaded() const { return fNLoaded; }
+   std::vector<REntry> &GetEntries() { return fEntries; }
+
+   std::string_view GetName(const REntry &entry) const
+   {
+      return std::string_view(fRecord.get() + entry.fNameOffset, entry.fNameLen);
+   }
+   std::string_view GetClassName(const REntry &entry) const
+   {
+      return std::string_view(fRecord.get() + entry.fClassOffset, entry.fClassLen);
+   }
+   /// The key header of the entry, to be read by TKey::ReadKeyBuffer().
+   char *GetKeyBuffer(const REntry &entry) { return fRecord.get() + entry.fKeyOffset; }
+
+   /// The entries of the keys named `name`, in the order of the record.
+   std::pair<Iterator_t, Iterator_t> Find(std::string_view name);
+   /// Number of keys of the class `className`.
+   Int_t GetNKeys(std::string_view className) const;
+
+   void SetLoaded(REntry &entry)
+   {
+      if (!entry.fLoaded) {
+         entry.fLoaded = kTRUE;
+         ++fNLoaded;
+      }
+   }
+};
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -15,10 +15,14 @@
 #include "TFileMerger.h"
 #include "TMemFile.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <thread>
+#include <vector>
 
 namespace ROOT {
 
@@ -35,6 +39,12 @@ class TBufferMergerFile;
  * socket, TBufferMerger uses threads that each write to a
  * TBufferMergerFile, which in turn push data into a queue
  * managed by the TBufferMerger.
+ *
+ * By default, the queue is merged into the output file by the
+ * writing threads themselves. With SetMergeThreads(), dedicated
+ * threads merge it instead, so that writers only serialize their
+ * data, and with SetMaxBuffered() writers wait for the queue to
+ * shrink when it holds too much memory.
  */
 
 class TBufferMerger {
@@ -82,6 +92,18 @@ public:
    /** Returns the current merge options. */
    const char* GetMergeOptions();
 
+   /** Returns the maximum number of bytes buffered before writers wait (0, the default, for no limit). */
+   size_t GetMaxBuffered() const
+   {
+      return fMaxBuffered;
+   }
+
+   /** Returns the number of dedicated merging threads (0, the default, if the writers merge the queue). */
+   unsigned int GetMergeThreads() const
+   {
+      return fMergeThreads.size();
+   }
+
    /** By default, TBufferMerger will call TFileMerger::PartialMerge() for each
     *  buffer pushed onto its merge queue. This function lets the user change
     *  this behaviour by telling TBufferMerger to accumulate at least size
@@ -92,6 +114,29 @@ public:
     */
    void SetAutoSave(size_t size);
 
+   /** Limits the memory held by the buffers waiting to be merged, or being
+    *  merged, to about size bytes. A TBufferMergerFile::Write that would
+    *  exceed the limit waits until enough buffers have been merged (merging
+    *  the queue itself if nobody else does), which applies backpressure to
+    *  the writers when they produce data faster than it can be merged.
+    *  A single buffer larger than the limit is accepted once the queue is
+    *  empty. A size of 0 (the default) means no limit.
+    */
+   void SetMaxBuffered(size_t size);
+
+   /** Merges the queue in nthreads dedicated threads instead of in the
+    *  writing threads. TBufferMergerFile::Write then only serializes the
+    *  data of the writer and returns, rather than possibly merging the whole
+    *  queue into the output file. One thread merges into the output file;
+    *  while it does, the other threads merge the buffers queued in the
+    *  meantime into larger buffers, in parallel, so that fewer inputs are
+    *  left to merge into the output file. The buffers still reach the
+    *  output file in the order they were pushed, so that the entries of each
+    *  writer keep their order. Must be called before any TBufferMergerFile
+    *  is written. 0 (the default) restores merging in the writing threads.
+    */
+   void SetMergeThreads(unsigned int nthreads);
+
    /** Sets the merge options. SetMergeOptions("fast") will disable
     * recompression of input data into the output if they have different
     * compression settings.
@@ -153,17 +198,31 @@ private:
 
    void MergeImpl();
 
-   void Merge();
+   bool Merge();
    void Push(TBufferFile *buffer);
    bool TryMerge(TBufferMergerFile *memfile);
 
+   void MergeThread(bool output);
+   TBufferFile *PreMerge(const std::vector<TBufferFile *> &buffers);
+   bool IsPreMerging(const TBufferFile *buffer) const;
+   size_t GetNPreMergeable() const;
+   void StopMergeThreads();
+
    bool fCompressTemporaryKeys{false};                           //< Enable compression of the TKeys in the TMemFile (save memory at the expense of time, end result is unchanged)
    size_t fAutoSave{0};                                          //< AutoSave only every fAutoSave bytes
    std::atomic<size_t> fBuffered{0};                             //< Number of bytes currently buffered
+   size_t fMaxBuffered{0};                                       //< Writers wait above fMaxBuffered pending bytes
+   size_t fPending{0};                                           //< Number of bytes queued or being merged (fQueueMutex)
+   size_t fNMerges{0};                                           //< Number of completed merges (fQueueMutex)
+   bool fMergingOutput{false};                                   //< Whether the output is being merged (fQueueMutex)
+   bool fStopMerging{false};                                     //< Whether the merging threads must stop (fQueueMutex)
+   std::condition_variable fQueueCondition;                      //< Signals new buffers and released memory
+   std::vector<std::thread> fMergeThreads;                       //< Dedicated merging threads
    TFileMerger fMerger{false, false};                            //< TFileMerger used to merge all buffers
    std::mutex fMergeMutex;                                       //< Mutex used to lock fMerger
    mutable std::mutex fQueueMutex;                               //< Mutex used to lock fQueue
-   std::queue<TBufferFile *> fQueue;                             //< Queue to which data is pushed and merged
+   std::deque<TBufferFile *> fQueue;                             //< Queue to which data is pushed and merged
+   std::vector<TBufferFile *> fPreMerging;                       //< Queued buffers standing for the batches being pre-merged (fQueueMutex)
    std::vector<std::weak_ptr<TBufferMergerFile>> fAttachedFiles; //< Attached files
 };
 
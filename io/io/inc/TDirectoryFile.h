@@ -28,6 +28,11 @@
 
 class TKey;
 class TFile;
+namespace ROOT {
+namespace Internal {
+class RKeyIndex;
+}
+} // namespace ROOT
 
 class TDirectoryFile : public TDirectory {
 
@@ -44,10 +49,15 @@ protected:
    Long64_t    fSeekKeys{0};             ///< Location of Keys record on file
    TFile      *fFile{nullptr};           ///< Pointer to current file in memory
    TList      *fKeys{nullptr};           ///< Pointer to keys list in memory
+   mutable ROOT::Internal::RKeyIndex *fKeyIndex{nullptr}; ///<!Index of the keys not all in fKeys yet (if any)
+
+   static Int_t fgKeyIndexThreshold;     ///<Minimum number of keys of the directories read with a key index, 0 for none
 
    void        CleanTargets();
    void        InitDirectoryFile(TClass *cl = nullptr);
    void        BuildDirectoryFile(TFile* motherFile, TDirectory* motherDir);
+   void        DeleteKeyIndex();
+   void        LoadKeys(const char *name = nullptr) const;
 
 private:
    TDirectoryFile(const TDirectoryFile &directory) = delete;  //Directories cannot be copied
@@ -91,10 +101,12 @@ public:
    const TDatime      &GetCreationDate() const { return fDatimeC; }
            TFile      *GetFile() const override { return fFile; }
            TKey       *GetKey(const char *name, Short_t cycle=9999) const override;
-           TList      *GetListOfKeys() const override { return fKeys; }
+           TList      *GetListOfKeys() const override;
+   /// The keys in memory, without creating the ones still in the key index (see SetKeyIndexThreshold).
+           TList      *GetListOfLoadedKeys() const { return fKeys; }
    const TDatime      &GetModificationDate() const { return fDatimeM; }
            Int_t       GetNbytesKeys() const override { return fNbytesKeys; }
-           Int_t       GetNkeys() const override { return fKeys->GetSize(); }
+           Int_t       GetNkeys() const override;
            Long64_t    GetSeekDir() const override { return fSeekDir; }
            Long64_t    GetSeekParent() const override { return fSeekParent; }
            Long64_t    GetSeekKeys() const override { return fSeekKeys; }
@@ -128,6 +140,9 @@ public:
            void        WriteDirHeader() override;
            void        WriteKeys() override;
 
+   static void         SetKeyIndexThreshold(Int_t nkeys);
+   static Int_t        GetKeyIndexThreshold();
+
    ClassDefOverride(TDirectoryFile,5)  //Describe directory structure in a ROOT file
 };
 
@@ -22,6 +22,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <atomic>
+#include <memory>
 #include <string>
 
 #include "Compression.h"
@@ -50,6 +51,12 @@ class TFileCacheWrite;
 class TProcessID;
 class TStopwatch;
 class TFilePrefetch;
+namespace ROOT {
+namespace Internal {
+class RFileBlockCache;
+class RFileWriteBehind;
+}
+} // namespace ROOT
 
 class TFile : public TDirectoryFile {
   friend class TDirectoryFile;
@@ -99,6 +106,10 @@ protected:
    TFileCacheRead  *fCacheRead{nullptr};      ///<!Pointer to the read cache (if any)
    TMap            *fCacheReadMap{nullptr};   ///<!Pointer to the read cache (if any)
    TFileCacheWrite *fCacheWrite{nullptr};     ///<!Pointer to the write cache (if any)
+   ROOT::Internal::RFileWriteBehind *fWriteBehind{nullptr}; ///<!Background writer of the buffers (if any)
+   std::shared_ptr<ROOT::Internal::RFileBlockCache> fBlockCache; ///<!Local disk cache of the blocks of the remote file (if any)
+   std::string      fBlockCacheKey;          ///<!Identifier of the content of the file in fBlockCache
+   Bool_t           fBlockCacheBusy{kFALSE}; ///<!True while the missing blocks are fetched
    Long64_t         fArchiveOffset{0};        ///<!Offset at which file starts in archive
    Bool_t           fIsArchive{kFALSE};       ///<!True if this is a pure archive file
    Bool_t           fNoAnchorInName{kFALSE};  ///<!True if we don't want to force the anchor to be appended to the file name
@@ -115,10 +126,12 @@ protected:
 
    bool             fGlobalRegistration = true; ///<! if true, bypass use of global lists
 
+   Bool_t           fStreamerInfoPending{kFALSE}; ///<!True if the reading of the StreamerInfo record is deferred (see SetFastOpen)
+
 #ifdef R__USE_IMT
    std::mutex                                 fWriteMutex;  ///<!Lock for writing baskets / keys into the file.
-   static ROOT::Internal::RConcurrentHashColl fgTsSIHashes; ///<!TS Set of hashes built from read streamer infos
 #endif
+   static ROOT::Internal::RConcurrentHashColl fgTsSIHashes; ///<!TS Set of hashes built from read streamer infos
 
    static TList    *fgAsyncOpenRequests; //List of handles for pending open requests
 
@@ -134,12 +147,15 @@ protected:
    static std::atomic<Int_t>     fgReadCalls;             ///<Number of bytes read from all TFile objects
    static Int_t     fgReadaheadSize;         ///<Readahead buffer size
    static Bool_t    fgReadInfo;              ///<if true (default) ReadStreamerInfo is called when opening a file
+   static Bool_t    fgFastOpen;              ///<if true ReadStreamerInfo is deferred to the first object read from a read-only file
 
    virtual EAsyncOpenStatus GetAsyncOpenStatus() { return fAsyncOpenStatus; }
    virtual void        Init(Bool_t create);
            Bool_t      FlushWriteCache();
            Int_t       ReadBufferViaCache(char *buf, Int_t len);
+           Int_t       ReadBuffersViaBlockCache(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf);
            Int_t       WriteBufferViaCache(const char *buf, Int_t len);
+           Bool_t      SyncWriteBehind(const char *where);
 
    ////////////////////////////////////////////////////////////////////////////////
    /// \brief Simple struct of the return value of GetStreamerInfoListImpl
@@ -237,6 +253,7 @@ public:
    virtual Long64_t    GetBytesWritten() const;
    virtual Int_t       GetReadCalls() const { return fReadCalls; }
            Int_t       GetVersion() const { return fVersion; }
+           Long64_t    GetWriteBehind() const;
            Int_t       GetRecordHeader(char *buf, Long64_t first, Int_t maxbytes,
                                        Int_t &nbytes, Int_t &objlen, Int_t &keylen);
    virtual Int_t       GetNbytesInfo() const {return fNbytesInfo;}
@@ -252,6 +269,8 @@ public:
    virtual Bool_t      IsArchive() const { return fIsArchive; }
            Bool_t      IsBinary() const { return TestBit(kBinaryFile); }
            Bool_t      IsRaw() const { return !fIsRootFile; }
+           /// True if the reading of the StreamerInfo record was deferred at opening and did not happen yet (see SetFastOpen).
+           Bool_t      IsStreamerInfoPending() const { return fStreamerInfoPending; }
    virtual Bool_t      IsOpen() const;
            void        ls(Option_t *option="") const override;
    virtual void        MakeFree(Long64_t first, Long64_t last);
@@ -270,6 +289,8 @@ public:
    virtual void        ReadFree();
    virtual TProcessID *ReadProcessID(UShort_t pidf);
    virtual void        ReadStreamerInfo();
+           /// Read the StreamerInfo record if its reading was deferred at opening (see SetFastOpen).
+           void        ReadPendingStreamerInfo() { if (fStreamerInfoPending) ReadStreamerInfo(); }
    virtual Int_t       Recover();
    virtual Int_t       ReOpen(Option_t *mode);
    virtual void        Seek(Long64_t offset, ERelativeTo pos = kBeg);
@@ -282,6 +303,7 @@ public:
    virtual void        SetOffset(Long64_t offset, ERelativeTo pos = kBeg);
    virtual void        SetOption(Option_t *option=">") { fOption = option; }
    virtual void        SetReadCalls(Int_t readcalls = 0) { fReadCalls = readcalls; }
+           void        SetWriteBehind(Long64_t maxQueuedBytes = 64000000);
    virtual void        ShowStreamerInfo();
            Int_t       Sizeof() const override;
            void        SumBuffer(Int_t bufsize);
@@ -319,6 +341,8 @@ public:
    static void         SetReadaheadSize(Int_t bufsize = 256000);
    static void         SetReadStreamerInfo(Bool_t readinfo=kTRUE);
    static Bool_t       GetReadStreamerInfo();
+   static void         SetFastOpen(Bool_t fastopen=kTRUE);
+   static Bool_t       GetFastOpen();
 
    static Long64_t     GetFileCounter();
    static void         IncrementFileCounter();
@@ -330,6 +354,8 @@ public:
                                        Bool_t forceCacheread = kFALSE);
    static const char  *GetCacheFileDir();
    static Bool_t       ShrinkCacheFileDir(Long64_t shrinkSize, Long_t cleanupInteval = 0);
+   static Bool_t       SetBlockCacheDir(const char *cacheDir, Long64_t maxBytes = 10000000000LL, Int_t blockSize = 1048576);
+   static std::shared_ptr<ROOT::Internal::RFileBlockCache> GetBlockCache();
    static Bool_t       Cp(const char *src, const char *dst, Bool_t progressbar = kTRUE,
                           UInt_t buffersize = 1000000);
 
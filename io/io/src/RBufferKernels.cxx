@@ -0,0 +1,491 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/RBufferKernels.hxx"
+
+#include <atomic>
+#include <initializer_list>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define R__BUFFERKERNELS_X86
+#include <immintrin.h>
+#define R__TARGET_SSSE3 __attribute__((target("ssse3")))
+#define R__TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__aarch64__) && defined(__ARM_NEON) && defined(R__BYTESWAP)
+#define R__BUFFERKERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace ROOT::Internal::RBufferKernels;
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+// Portable implementation, also used for the tails of the vectorized loops
+
+template <int W>
+struct RSwapType;
+template <>
+struct RSwapType<2> {
+   using Type = UShort_t;
+   static Type Swap(Type x) { return (x >> 8) | (x << 8); }
+};
+template <>
+struct RSwapType<4> {
+   using Type = UInt_t;
+   static Type Swap(Type x)
+   {
+      return (x >> 24) | ((x >> 8) & 0x0000ff00u) | ((x << 8) & 0x00ff0000u) | (x << 24);
+   }
+};
+template <>
+struct RSwapType<8> {
+   using Type = ULong64_t;
+   static Type Swap(Type x)
+   {
+      return (Type(RSwapType<4>::Swap(UInt_t(x))) << 32) | RSwapType<4>::Swap(UInt_t(x >> 32));
+   }
+};
+
+template <int W>
+void SwapScalar(void *dst, const void *src, std::size_t n)
+{
+   using T = typename RSwapType<W>::Type;
+   auto d = static_cast<char *>(dst);
+   auto s = static_cast<const char *>(src);
+   for (std::size_t i = 0; i < n; ++i) {
+      T x;
+      std::memcpy(&x, s + i * W, W);
+      x = RSwapType<W>::Swap(x);
+      std::memcpy(d + i * W, &x, W);
+   }
+}
+
+/// Same computation as TBufferFile::ReadWithNbits().
+inline Float_t DecodeFloat16(const char *s, Int_t nbits)
+{
+   union {
+      Float_t fFloatValue;
+      Int_t fIntValue;
+   } temp;
+   const UChar_t theExp = s[0];
+   const UShort_t theMan = (UShort_t(UChar_t(s[1])) << 8) | UChar_t(s[2]);
+   temp.fIntValue = theExp;
+   temp.fIntValue <<= 23;
+   temp.fIntValue |= (theMan & ((1 << (nbits + 1)) - 1)) << (23 - nbits);
+   if (1 << (nbits + 1) & theMan)
+      temp.fFloatValue = -temp.fFloatValue;
+   return temp.fFloatValue;
+}
+
+template <typename T>
+void UnpackFloat16Scalar(T *dst, const char *src, std::size_t n, Int_t nbits)
+{
+   for (std::size_t i = 0; i < n; ++i)
+      dst[i] = DecodeFloat16(src + 3 * i, nbits);
+}
+
+void UnpackFloatToDoubleScalar(Double_t *dst, const char *src, std::size_t n)
+{
+   for (std::size_t i = 0; i < n; ++i) {
+      UInt_t x;
+      std::memcpy(&x, src + 4 * i, 4);
+#ifdef R__BYTESWAP
+      x = RSwapType<4>::Swap(x);
+#endif
+      Float_t f;
+      std::memcpy(&f, &x, 4);
+      dst[i] = f;
+   }
+}
+
+/// The vectorized Float16 kernels assume that the sign bit is within the 16 bits of the mantissa.
+inline bool IsVectorizableNbits(Int_t nbits)
+{
+   return nbits > 0 && nbits < 15;
+}
+
+#ifdef R__BUFFERKERNELS_X86
+
+////////////////////////////////////////////////////////////////////////////////
+// x86-64: SSSE3 and AVX2, selected at runtime
+
+/// Shuffle control reversing the bytes of every W-byte value of a 16-byte lane.
+template <int W>
+R__TARGET_SSSE3 __m128i SwapControl()
+{
+   alignas(16) char control[16];
+   for (int j = 0; j < 16; ++j)
+      control[j] = (j / W) * W + W - 1 - j % W;
+   return _mm_load_si128(reinterpret_cast<const __m128i *>(control));
+}
+
+template <int W>
+R__TARGET_SSSE3 void SwapSSSE3(void *dst, const void *src, std::size_t n)
+{
+   auto d = static_cast<char *>(dst);
+   auto s = static_cast<const char *>(src);
+   const __m128i control = SwapControl<W>();
+   const std::size_t nbytes = n * W;
+   std::size_t i = 0;
+   for (; i + 16 <= nbytes; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(d + i), _mm_shuffle_epi8(v, control));
+   }
+   SwapScalar<W>(d + i, s + i, (nbytes - i) / W);
+}
+
+template <int W>
+R__TARGET_AVX2 void SwapAVX2(void *dst, const void *src, std::size_t n)
+{
+   auto d = static_cast<char *>(dst);
+   auto s = static_cast<const char *>(src);
+   const __m128i control128 = SwapControl<W>();
+   const __m256i control = _mm256_broadcastsi128_si256(control128);
+   const std::size_t nbytes = n * W;
+   std::size_t i = 0;
+   for (; i + 32 <= nbytes; i += 32) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + i), _mm256_shuffle_epi8(v, control));
+   }
+   SwapScalar<W>(d + i, s + i, (nbytes - i) / W);
+}
+
+/// Spread 4 packed Float16 values (12 bytes) in 32-bit lanes as `exponent << 16 | mantissa`.
+R__TARGET_SSSE3 inline __m128i SpreadFloat16Control()
+{
+   return _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+}
+
+/// Rebuild the bits of 4 floats from the output of SpreadFloat16Control(), as in DecodeFloat16().
+R__TARGET_SSSE3 inline __m128 BuildFloat16(__m128i v, __m128i manMask, __m128i signMask, __m128i manShift,
+                                           __m128i signShift)
+{
+   __m128i bits = _mm_slli_epi32(_mm_srli_epi32(v, 16), 23);
+   bits = _mm_or_si128(bits, _mm_sll_epi32(_mm_and_si128(v, manMask), manShift));
+   bits = _mm_or_si128(bits, _mm_sll_epi32(_mm_and_si128(v, signMask), signShift));
+   return _mm_castsi128_ps(bits);
+}
+
+R__TARGET_SSSE3 void StoreSSSE3(Float_t *dst, __m128 f)
+{
+   _mm_storeu_ps(dst, f);
+}
+
+R__TARGET_SSSE3 void StoreSSSE3(Double_t *dst, __m128 f)
+{
+   _mm_storeu_pd(dst, _mm_cvtps_pd(f));
+   _mm_storeu_pd(dst + 2, _mm_cvtps_pd(_mm_movehl_ps(f, f)));
+}
+
+template <typename T>
+R__TARGET_SSSE3 void UnpackFloat16SSSE3(T *dst, const char *src, std::size_t n, Int_t nbits)
+{
+   std::size_t i = 0;
+   if (IsVectorizableNbits(nbits)) {
+      const __m128i control = SpreadFloat16Control();
+      const __m128i manMask = _mm_set1_epi32((1 << (nbits + 1)) - 1);
+      const __m128i signMask = _mm_set1_epi32(1 << (nbits + 1));
+      const __m128i manShift = _mm_cvtsi32_si128(23 - nbits);
+      const __m128i signShift = _mm_cvtsi32_si128(30 - nbits);
+      // 16 bytes are loaded for every 4 values (12 bytes)
+      for (; i + 6 <= n; i += 4) {
+         __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3 * i)), control);
+         __m128 f = BuildFloat16(v, manMask, signMask, manShift, signShift);
+         StoreSSSE3(dst + i, f);
+      }
+   }
+   UnpackFloat16Scalar(dst + i, src + 3 * i, n - i, nbits);
+}
+
+R__TARGET_AVX2 void StoreAVX2(Float_t *dst, __m256 f)
+{
+   _mm256_storeu_ps(dst, f);
+}
+
+R__TARGET_AVX2 void StoreAVX2(Double_t *dst, __m256 f)
+{
+   _mm256_storeu_pd(dst, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+   _mm256_storeu_pd(dst + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+}
+
+template <typename T>
+R__TARGET_AVX2 void UnpackFloat16AVX2(T *dst, const char *src, std::size_t n, Int_t nbits)
+{
+   std::size_t i = 0;
+   if (IsVectorizableNbits(nbits)) {
+      const __m256i control = _mm256_broadcastsi128_si256(SpreadFloat16Control());
+      const __m256i manMask = _mm256_set1_epi32((1 << (nbits + 1)) - 1);
+      const __m256i signMask = _mm256_set1_epi32(1 << (nbits + 1));
+      const __m128i manShift = _mm_cvtsi32_si128(23 - nbits);
+      const __m128i signShift = _mm_cvtsi32_si128(30 - nbits);
+      // 28 bytes are loaded for every 8 values (24 bytes)
+      for (; i + 10 <= n; i += 8) {
+         const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3 * i));
+         const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3 * i + 12));
+         __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+         v = _mm256_shuffle_epi8(v, control);
+         __m256i bits = _mm256_slli_epi32(_mm256_srli_epi32(v, 16), 23);
+         bits = _mm256_or_si256(bits, _mm256_sll_epi32(_mm256_and_si256(v, manMask), manShift));
+         bits = _mm256_or_si256(bits, _mm256_sll_epi32(_mm256_and_si256(v, signMask), signShift));
+         __m256 f = _mm256_castsi256_ps(bits);
+         StoreAVX2(dst + i, f);
+      }
+   }
+   UnpackFloat16Scalar(dst + i, src + 3 * i, n - i, nbits);
+}
+
+R__TARGET_SSSE3 void UnpackFloatToDoubleSSSE3(Double_t *dst, const char *src, std::size_t n)
+{
+   const __m128i control = SwapControl<4>();
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4) {
+      __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4 * i)), control);
+      __m128 f = _mm_castsi128_ps(v);
+      _mm_storeu_pd(dst + i, _mm_cvtps_pd(f));
+      _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(f, f)));
+   }
+   UnpackFloatToDoubleScalar(dst + i, src + 4 * i, n - i);
+}
+
+R__TARGET_AVX2 void UnpackFloatToDoubleAVX2(Double_t *dst, const char *src, std::size_t n)
+{
+   const __m256i control = _mm256_broadcastsi128_si256(SwapControl<4>());
+   std::size_t i = 0;
+   for (; i + 8 <= n; i += 8) {
+      __m256i v = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 4 * i)), control);
+      __m256 f = _mm256_castsi256_ps(v);
+      _mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+      _mm256_storeu_pd(dst + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+   }
+   UnpackFloatToDoubleScalar(dst + i, src + 4 * i, n - i);
+}
+
+#endif // R__BUFFERKERNELS_X86
+
+#ifdef R__BUFFERKERNELS_NEON
+
+////////////////////////////////////////////////////////////////////////////////
+// ARM64: NEON is part of the base instruction set
+
+template <int W>
+uint8x16_t SwapLaneNEON(uint8x16_t v);
+template <>
+uint8x16_t SwapLaneNEON<2>(uint8x16_t v)
+{
+   return vrev16q_u8(v);
+}
+template <>
+uint8x16_t SwapLaneNEON<4>(uint8x16_t v)
+{
+   return vrev32q_u8(v);
+}
+template <>
+uint8x16_t SwapLaneNEON<8>(uint8x16_t v)
+{
+   return vrev64q_u8(v);
+}
+
+template <int W>
+void SwapNEON(void *dst, const void *src, std::size_t n)
+{
+   auto d = static_cast<uint8_t *>(dst);
+   auto s = static_cast<const uint8_t *>(src);
+   const std::size_t nbytes = n * W;
+   std::size_t i = 0;
+   for (; i + 16 <= nbytes; i += 16)
+      vst1q_u8(d + i, SwapLaneNEON<W>(vld1q_u8(s + i)));
+   SwapScalar<W>(d + i, s + i, (nbytes - i) / W);
+}
+
+void StoreNEON(Float_t *dst, float32x4_t f)
+{
+   vst1q_f32(dst, f);
+}
+
+void StoreNEON(Double_t *dst, float32x4_t f)
+{
+   vst1q_f64(dst, vcvt_f64_f32(vget_low_f32(f)));
+   vst1q_f64(dst + 2, vcvt_high_f64_f32(f));
+}
+
+template <typename T>
+void UnpackFloat16NEON(T *dst, const char *src, std::size_t n, Int_t nbits)
+{
+   std::size_t i = 0;
+   if (IsVectorizableNbits(nbits)) {
+      // Spread 4 values in 32-bit lanes as `exponent << 16 | mantissa`; out-of-range indices give 0
+      static const uint8_t kControl[16] = {2, 1, 0, 255, 5, 4, 3, 255, 8, 7, 6, 255, 11, 10, 9, 255};
+      const uint8x16_t control = vld1q_u8(kControl);
+      const uint32x4_t manMask = vdupq_n_u32((1u << (nbits + 1)) - 1);
+      const uint32x4_t signMask = vdupq_n_u32(1u << (nbits + 1));
+      const int32x4_t manShift = vdupq_n_s32(23 - nbits);
+      const int32x4_t signShift = vdupq_n_s32(30 - nbits);
+      for (; i + 6 <= n; i += 4) {
+         const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(src + 3 * i));
+         const uint32x4_t v = vreinterpretq_u32_u8(vqtbl1q_u8(bytes, control));
+         uint32x4_t bits = vshlq_n_u32(vshrq_n_u32(v, 16), 23);
+         bits = vorrq_u32(bits, vshlq_u32(vandq_u32(v, manMask), manShift));
+         bits = vorrq_u32(bits, vshlq_u32(vandq_u32(v, signMask), signShift));
+         const float32x4_t f = vreinterpretq_f32_u32(bits);
+         StoreNEON(dst + i, f);
+      }
+   }
+   UnpackFloat16Scalar(dst + i, src + 3 * i, n - i, nbits);
+}
+
+void UnpackFloatToDoubleNEON(Double_t *dst, const char *src, std::size_t n)
+{
+   std::size_t i = 0;
+   for (; i + 4 <= n; i += 4) {
+      const uint8x16_t bytes = vrev32q_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(src + 4 * i)));
+      const float32x4_t f = vreinterpretq_f32_u8(bytes);
+      vst1q_f64(dst + i, vcvt_f64_f32(vget_low_f32(f)));
+      vst1q_f64(dst + i + 2, vcvt_high_f64_f32(f));
+   }
+   UnpackFloatToDoubleScalar(dst + i, src + 4 * i, n - i);
+}
+
+#endif // R__BUFFERKERNELS_NEON
+
+////////////////////////////////////////////////////////////////////////////////
+// Dispatch
+
+struct RKernelSet {
+   EISA fISA;
+   void (*fSwap16)(void *, const void *, std::size_t);
+   void (*fSwap32)(void *, const void *, std::size_t);
+   void (*fSwap64)(void *, const void *, std::size_t);
+   void (*fFloat16)(Float_t *, const char *, std::size_t, Int_t);
+   void (*fFloat16ToDouble)(Double_t *, const char *, std::size_t, Int_t);
+   void (*fFloatToDouble)(Double_t *, const char *, std::size_t);
+};
+
+const RKernelSet gScalarKernels{EISA::kScalar,
+                                SwapScalar<2>,
+                                SwapScalar<4>,
+                                SwapScalar<8>,
+                                UnpackFloat16Scalar<Float_t>,
+                                UnpackFloat16Scalar<Double_t>,
+                                UnpackFloatToDoubleScalar};
+#ifdef R__BUFFERKERNELS_X86
+const RKernelSet gSSSE3Kernels{EISA::kSSSE3,
+                               SwapSSSE3<2>,
+                               SwapSSSE3<4>,
+                               SwapSSSE3<8>,
+                               UnpackFloat16SSSE3<Float_t>,
+                               UnpackFloat16SSSE3<Double_t>,
+                               UnpackFloatToDoubleSSSE3};
+const RKernelSet gAVX2Kernels{EISA::kAVX2,
+                              SwapAVX2<2>,
+                              SwapAVX2<4>,
+                              SwapAVX2<8>,
+                              UnpackFloat16AVX2<Float_t>,
+                              UnpackFloat16AVX2<Double_t>,
+                              UnpackFloatToDoubleAVX2};
+#endif
+#ifdef R__BUFFERKERNELS_NEON
+const RKernelSet gNEONKernels{EISA::kNEON,
+                              SwapNEON<2>,
+                              SwapNEON<4>,
+                              SwapNEON<8>,
+                              UnpackFloat16NEON<Float_t>,
+                              UnpackFloat16NEON<Double_t>,
+                              UnpackFloatToDoubleNEON};
+#endif
+
+/// Return the kernels for `isa`, or nullptr if the CPU does not support it.
+const RKernelSet *FindKernels(EISA isa)
+{
+   switch (isa) {
+   case EISA::kScalar: return &gScalarKernels;
+#ifdef R__BUFFERKERNELS_X86
+   case EISA::kSSSE3:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("ssse3") ? &gSSSE3Kernels : nullptr;
+   case EISA::kAVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") ? &gAVX2Kernels : nullptr;
+#endif
+#ifdef R__BUFFERKERNELS_NEON
+   case EISA::kNEON: return &gNEONKernels;
+#endif
+   default: return nullptr;
+   }
+}
+
+std::atomic<const RKernelSet *> &CurrentKernels()
+{
+   static std::atomic<const RKernelSet *> current([] {
+      for (auto isa : {EISA::kAVX2, EISA::kSSSE3, EISA::kNEON}) {
+         if (auto kernels = FindKernels(isa))
+            return kernels;
+      }
+      return &gScalarKernels;
+   }());
+   return current;
+}
+
+inline const RKernelSet &Kernels()
+{
+   return *CurrentKernels().load(std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
+void ROOT::Internal::RBufferKernels::ByteSwapCopy16(void *dst, const void *src, std::size_t n)
+{
+   Kernels().fSwap16(dst, src, n);
+}
+
+void ROOT::Internal::RBufferKernels::ByteSwapCopy32(void *dst, const void *src, std::size_t n)
+{
+   Kernels().fSwap32(dst, src, n);
+}
+
+void ROOT::Internal::RBufferKernels::ByteSwapCopy64(void *dst, const void *src, std::size_t n)
+{
+   Kernels().fSwap64(dst, src, n);
+}
+
+void ROOT::Internal::RBufferKernels::UnpackFloat16(Float_t *dst, const char *src, std::size_t n, Int_t nbits)
+{
+   Kernels().fFloat16(dst, src, n, nbits);
+}
+
+void ROOT::Internal::RBufferKernels::UnpackFloat16(Double_t *dst, const char *src, std::size_t n, Int_t nbits)
+{
+   Kernels().fFloat16ToDouble(dst, src, n, nbits);
+}
+
+void ROOT::Internal::RBufferKernels::UnpackFloatToDouble(Double_t *dst, const char *src, std::size_t n)
+{
+   Kernels().fFloatToDouble(dst, src, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the instruction set used by the kernels.
+
+EISA ROOT::Internal::RBufferKernels::GetBufferKernelsISA()
+{
+   return Kernels().fISA;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Use the implementation of the kernels for `isa`. Returns false, leaving the kernels unchanged, if this
+/// instruction set is not available on this platform or CPU.
+
+bool ROOT::Internal::RBufferKernels::SetBufferKernelsISA(EISA isa)
+{
+   auto kernels = FindKernels(isa);
+   if (!kernels)
+      return false;
+   CurrentKernels().store(kernels, std::memory_order_relaxed);
+   return true;
+}
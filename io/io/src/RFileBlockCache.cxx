@@ -0,0 +1,266 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/RFileBlockCache.hxx"
+
+#include "TMD5.h"
+#include "TString.h"
+#include "TSystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+/// Maximum number of blocks fetched with one vectored read
+constexpr std::size_t kMaxFetchBlocks = 16;
+/// The modification time of a block is refreshed on use if it is older than this (seconds)
+constexpr Long_t kTouchInterval = 60;
+/// Temporary files older than this (seconds) were left over by a crashed process
+constexpr Long_t kStaleTmpAge = 3600;
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Use the directory `dir`, created on demand, to store at most about `maxBytes` of blocks of `blockSize` bytes.
+
+ROOT::Internal::RFileBlockCache::RFileBlockCache(std::string_view dir, Long64_t maxBytes, Int_t blockSize)
+   : fDir(dir), fMaxBytes(maxBytes), fBlockSize(blockSize)
+{
+   while (fDir.size() > 1 && fDir.back() == '/')
+      fDir.pop_back();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the key identifying the content of a remote file, given its URL and a string which changes whenever the
+/// file is modified (e.g. its modification time).
+
+std::string ROOT::Internal::RFileBlockCache::MakeFileKey(std::string_view url, std::string_view version)
+{
+   std::string id(url);
+   id += '\n';
+   id += version;
+   TMD5 md5;
+   md5.Update(reinterpret_cast<const UChar_t *>(id.data()), id.size());
+   md5.Final();
+   return md5.AsString();
+}
+
+std::string ROOT::Internal::RFileBlockCache::GetBlockPath(const std::string &fileKey, Long64_t block) const
+{
+   // Spread the blocks over 256 subdirectories
+   return fDir + '/' + fileKey.substr(0, 2) + '/' + fileKey + '.' + std::to_string(block);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Atomically create the block file `path`; failures are ignored, the block is fetched again next time.
+
+void ROOT::Internal::RFileBlockCache::StoreBlock(const std::string &path, const char *data, Int_t len)
+{
+   const std::string tmpPath = path + ".tmp." + std::to_string(gSystem->GetPid()) + '.' + std::to_string(fTmpCounter++);
+   std::ofstream out(tmpPath, std::ios::binary);
+   if (!out) {
+      // The subdirectory may not exist yet
+      gSystem->mkdir(path.substr(0, path.rfind('/')).c_str(), kTRUE);
+      out.open(tmpPath, std::ios::binary);
+   }
+   out.write(data, len);
+   out.close();
+   if (!out || gSystem->Rename(tmpPath.c_str(), path.c_str())) {
+      gSystem->Unlink(tmpPath.c_str());
+      return;
+   }
+
+   if ((fBytesSinceShrink += len) > fMaxBytes / 16)
+      Shrink();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the `nbuf` ranges at `pos` of lengths `len` of the file identified by `fileKey` (see MakeFileKey()) into
+/// `buf`, one after the other. The blocks not in the cache are read from the file with `fetch` and stored.
+///
+/// Returns 0 if the ranges are not within the `fileSize` bytes of the file, 1 in case of success and 2 in case of
+/// failure to fetch the missing blocks, like TFile::ReadBufferViaCache().
+
+Int_t ROOT::Internal::RFileBlockCache::Read(const std::string &fileKey, Long64_t fileSize, char *buf,
+                                            const Long64_t *pos, const Int_t *len, Int_t nbuf,
+                                            const FetchFunc_t &fetch)
+{
+   std::vector<Long64_t> offsets(nbuf); // position of the ranges in buf
+   std::vector<Long64_t> blocks;
+   Long64_t nbytes = 0;
+   for (Int_t i = 0; i < nbuf; ++i) {
+      if (pos[i] < 0 || len[i] < 0 || pos[i] + len[i] > fileSize)
+         return 0;
+      offsets[i] = nbytes;
+      nbytes += len[i];
+      if (len[i] > 0) {
+         for (Long64_t b = pos[i] / fBlockSize; b <= (pos[i] + len[i] - 1) / fBlockSize; ++b)
+            blocks.push_back(b);
+      }
+   }
+   std::sort(blocks.begin(), blocks.end());
+   blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+
+   // Copy the parts of the requested ranges within the block of `blockLen` bytes at `start`;
+   // `read(dst, offsetInBlock, n)` returns false in case of failure.
+   auto copyRanges = [&](Long64_t start, Long64_t blockLen, auto &&read) {
+      for (Int_t i = 0; i < nbuf; ++i) {
+         const Long64_t lo = std::max(pos[i], start);
+         const Long64_t hi = std::min(pos[i] + len[i], start + blockLen);
+         if (lo < hi && !read(buf + offsets[i] + (lo - pos[i]), lo - start, hi - lo))
+            return false;
+      }
+      return true;
+   };
+
+   std::vector<Long64_t> missing;
+   const Long_t now = time(nullptr);
+   for (auto b : blocks) {
+      const Long64_t start = b * fBlockSize;
+      const Long64_t blockLen = std::min<Long64_t>(fBlockSize, fileSize - start);
+      const std::string path = GetBlockPath(fileKey, b);
+      // A block being evicted stays readable once opened
+      std::ifstream in(path, std::ios::binary | std::ios::ate);
+      auto readBlock = [&in](char *dst, Long64_t off, Long64_t n) {
+         in.seekg(off);
+         in.read(dst, n);
+         return in.gcount() == n;
+      };
+      const bool hit = in && in.tellg() == blockLen && copyRanges(start, blockLen, readBlock);
+      if (!hit) {
+         missing.push_back(b);
+         continue;
+      }
+      ++fBlockHits;
+      FileStat_t stat;
+      if (gSystem->GetPathInfo(path.c_str(), stat) == 0 && stat.fMtime + kTouchInterval < now)
+         gSystem->Utime(path.c_str(), now, 0);
+   }
+
+   std::vector<char> data;
+   std::vector<Long64_t> fetchPos;
+   std::vector<Int_t> fetchLen;
+   for (std::size_t first = 0; first < missing.size(); first += kMaxFetchBlocks) {
+      const std::size_t n = std::min(missing.size() - first, kMaxFetchBlocks);
+      fetchPos.clear();
+      fetchLen.clear();
+      Long64_t total = 0;
+      for (std::size_t k = 0; k < n; ++k) {
+         const Long64_t start = missing[first + k] * fBlockSize;
+         fetchPos.push_back(start);
+         fetchLen.push_back(std::min<Long64_t>(fBlockSize, fileSize - start));
+         total += fetchLen.back();
+      }
+      data.resize(total);
+      // `fetch` may modify the positions (e.g. to add an archive offset)
+      if (fetch(data.data(), fetchPos.data(), fetchLen.data(), n))
+         return 2;
+      fBlockMisses += n;
+      fBytesFetched += total;
+
+      const char *blockData = data.data();
+      for (std::size_t k = 0; k < n; ++k) {
+         copyRanges(missing[first + k] * fBlockSize, fetchLen[k], [blockData](char *dst, Long64_t off, Long64_t len2) {
+            memcpy(dst, blockData + off, len2);
+            return true;
+         });
+         StoreBlock(GetBlockPath(fileKey, missing[first + k]), blockData, fetchLen[k]);
+         blockData += fetchLen[k];
+      }
+   }
+
+   fBytesServed += nbytes;
+   return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove the least recently used blocks until the cache directory is below 90% of the quota, if it exceeds the
+/// quota. The blocks may be shared with other processes: the directory is scanned, and a block removed concurrently
+/// by another process is simply skipped. Does nothing if another thread is already at it.
+
+void ROOT::Internal::RFileBlockCache::Shrink()
+{
+   std::unique_lock<std::mutex> lock(fShrinkMutex, std::try_to_lock);
+   if (!lock)
+      return;
+   fBytesSinceShrink = 0;
+
+   struct REntry {
+      Long_t fMtime;
+      Long64_t fSize;
+      std::string fPath;
+   };
+   std::vector<REntry> entries;
+   Long64_t total = 0;
+   const Long_t now = time(nullptr);
+
+   void *dir = gSystem->OpenDirectory(fDir.c_str());
+   if (!dir)
+      return;
+   while (const char *subName = gSystem->GetDirEntry(dir)) {
+      if (strlen(subName) != 2 || subName[0] == '.')
+         continue;
+      const std::string subPath = fDir + '/' + subName;
+      void *subdir = gSystem->OpenDirectory(subPath.c_str());
+      if (!subdir)
+         continue;
+      while (const char *name = gSystem->GetDirEntry(subdir)) {
+         if (name[0] == '.')
+            continue;
+         std::string path = subPath + '/' + name;
+         FileStat_t stat;
+         if (gSystem->GetPathInfo(path.c_str(), stat) != 0 || !R_ISREG(stat.fMode))
+            continue;
+         if (strstr(name, ".tmp.")) {
+            if (stat.fMtime + kStaleTmpAge < now)
+               gSystem->Unlink(path.c_str());
+            continue;
+         }
+         total += stat.fSize;
+         entries.push_back({stat.fMtime, stat.fSize, std::move(path)});
+      }
+      gSystem->FreeDirectory(subdir);
+   }
+   gSystem->FreeDirectory(dir);
+
+   if (total <= fMaxBytes)
+      return;
+   std::sort(entries.begin(), entries.end(), [](const REntry &a, const REntry &b) { return a.fMtime < b.fMtime; });
+   const Long64_t target = fMaxBytes - fMaxBytes / 10;
+   for (const auto &entry : entries) {
+      if (total <= target)
+         break;
+      if (gSystem->Unlink(entry.fPath.c_str()) == 0)
+         fBytesEvicted += entry.fSize;
+      total -= entry.fSize;
+   }
+}
+
+ROOT::Internal::RFileBlockCache::RStats ROOT::Internal::RFileBlockCache::GetStats() const
+{
+   RStats stats;
+   stats.fBlockHits = fBlockHits;
+   stats.fBlockMisses = fBlockMisses;
+   stats.fBytesServed = fBytesServed;
+   stats.fBytesFetched = fBytesFetched;
+   stats.fBytesEvicted = fBytesEvicted;
+   return stats;
+}
+
+void ROOT::Internal::RFileBlockCache::PrintStats() const
+{
+   const auto stats = GetStats();
+   Printf("Block cache %s: %llu block hits, %llu misses (hit rate %.1f%%), %llu bytes served, %llu bytes fetched, "
+          "%llu bytes evicted",
+          fDir.c_str(), stats.fBlockHits, stats.fBlockMisses, 100 * stats.GetHitRate(), stats.fBytesServed,
+          stats.fBytesFetched, stats.fBytesEvicted);
+}
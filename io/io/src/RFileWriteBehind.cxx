@@ -0,0 +1,157 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "RFileWriteBehind.hxx"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// Start the I/O thread writing to `fd`, with at most `maxQueuedBytes` of pending data.
+
+ROOT::Internal::RFileWriteBehind::RFileWriteBehind(Int_t fd, std::size_t maxQueuedBytes)
+   : fFd(fd), fMaxQueuedBytes(maxQueuedBytes)
+{
+   fThread = std::thread([this] { Run(); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the pending buffers and stop the I/O thread.
+
+ROOT::Internal::RFileWriteBehind::~RFileWriteBehind()
+{
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+   }
+   fCvRequest.notify_one();
+   fThread.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Body of the I/O thread: write the queued buffers in order until stopped.
+
+void ROOT::Internal::RFileWriteBehind::Run()
+{
+   std::unique_lock<std::mutex> lock(fMutex);
+   while (true) {
+      fCvRequest.wait(lock, [this] { return fStop || !fQueue.empty(); });
+      if (fQueue.empty())
+         return;
+
+      // The request stays in the queue while it is written, such that WaitFor() sees it
+      const RRequest &req = fQueue.front();
+      if (fError.empty()) {
+         const char *buf = req.fData.data();
+         std::size_t left = req.fData.size();
+         Long64_t offset = req.fOffset;
+         lock.unlock();
+         std::string error;
+         while (left > 0) {
+#ifdef _WIN32
+            errno = ENOTSUP;
+            long siz = -1;
+#elif defined(R__SEEK64)
+            ssize_t siz = ::pwrite64(fFd, buf, left, offset);
+#else
+            ssize_t siz = ::pwrite(fFd, buf, left, offset);
+#endif
+            if (siz < 0 && errno == EINTR)
+               continue;
+            if (siz <= 0) {
+               error = siz < 0 ? std::system_category().message(errno) : "no bytes written";
+               break;
+            }
+            buf += siz;
+            left -= siz;
+            offset += siz;
+         }
+         lock.lock();
+         if (!error.empty())
+            fError = "writing " + std::to_string(req.fData.size()) + " bytes at offset " +
+                     std::to_string(req.fOffset) + ": " + error;
+      }
+      fQueuedBytes -= req.fData.size();
+      fQueue.pop_front();
+      fCvDone.notify_all();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Queue a copy of `len` bytes of `buf`, to be written at the absolute position `offset` of the file.
+///
+/// Blocks while the queue holds more than the maximum amount of data.
+/// Returns kTRUE in case of failure, i.e. if a previous write failed.
+
+Bool_t ROOT::Internal::RFileWriteBehind::Write(const char *buf, Int_t len, Long64_t offset)
+{
+   RRequest req{offset, std::vector<char>(buf, buf + len)};
+   {
+      std::unique_lock<std::mutex> lock(fMutex);
+      // A single buffer larger than the limit is accepted once the queue is empty
+      fCvDone.wait(lock, [this, len] {
+         return !fError.empty() || fQueue.empty() || fQueuedBytes + len <= fMaxQueuedBytes;
+      });
+      if (!fError.empty())
+         return kTRUE;
+      fQueuedBytes += len;
+      fQueue.emplace_back(std::move(req));
+   }
+   fCvRequest.notify_one();
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait until none of the pending buffers overlaps the `len` bytes at the absolute position `offset`.
+
+void ROOT::Internal::RFileWriteBehind::WaitFor(Long64_t offset, Int_t len)
+{
+   auto overlaps = [this, offset, len] {
+      for (const auto &req : fQueue) {
+         if (req.fOffset < offset + len && offset < req.fOffset + static_cast<Long64_t>(req.fData.size()))
+            return true;
+      }
+      return false;
+   };
+   std::unique_lock<std::mutex> lock(fMutex);
+   fCvDone.wait(lock, [&overlaps] { return !overlaps(); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait until all the pending buffers are written.
+/// Returns kTRUE in case of failure.
+
+Bool_t ROOT::Internal::RFileWriteBehind::Drain()
+{
+   std::unique_lock<std::mutex> lock(fMutex);
+   fCvDone.wait(lock, [this] { return fQueue.empty(); });
+   return !fError.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Change the maximum amount of queued data; waiting writers are woken up if it grew.
+
+void ROOT::Internal::RFileWriteBehind::SetMaxQueuedBytes(std::size_t maxQueuedBytes)
+{
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fMaxQueuedBytes = maxQueuedBytes;
+   }
+   fCvDone.notify_all();
+}
+
+std::string ROOT::Internal::RFileWriteBehind::GetError()
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   return fError;
+}
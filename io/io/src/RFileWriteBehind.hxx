@@ -0,0 +1,75 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RFileWriteBehind
+#define ROOT_RFileWriteBehind
+
+#include "RtypesCore.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ROOT {
+namespace Internal {
+
+/**
+ * \class RFileWriteBehind
+ * \ingroup IO
+ *
+ * Write buffers to a file descriptor from a dedicated I/O thread, for TFile::SetWriteBehind().
+ *
+ * The caller decides where every buffer goes and hands over a copy of the data; the I/O thread writes the buffers
+ * in order with positional writes, so the file offset of the descriptor is left to the caller. The amount of queued
+ * data is bounded: Write() blocks while the queue is full. The first failed write is remembered, the following
+ * writes are discarded and the error is returned by the next call to Write() or Drain().
+ */
+class RFileWriteBehind {
+private:
+   struct RRequest {
+      Long64_t fOffset;
+      std::vector<char> fData;
+   };
+
+   Int_t fFd;                          ///< The file descriptor, owned by the caller
+   std::size_t fMaxQueuedBytes;        ///< Write() blocks above this amount of queued data
+   std::size_t fQueuedBytes = 0;       ///< Amount of data in fQueue
+   std::deque<RRequest> fQueue;        ///< Pending writes; the front is being written by the I/O thread
+   bool fStop = false;                 ///< Tells the I/O thread to exit once the queue is empty
+   std::string fError;                 ///< Description of the first failed write, empty if none
+   std::mutex fMutex;                  ///< Protects all the members above
+   std::condition_variable fCvRequest; ///< Signals a new request, or fStop, to the I/O thread
+   std::condition_variable fCvDone;    ///< Signals a completed request to the waiting callers
+   std::thread fThread;                ///< The I/O thread
+
+   void Run();
+
+public:
+   RFileWriteBehind(Int_t fd, std::size_t maxQueuedBytes);
+   RFileWriteBehind(const RFileWriteBehind &) = delete;
+   RFileWriteBehind &operator=(const RFileWriteBehind &) = delete;
+   ~RFileWriteBehind();
+
+   Bool_t Write(const char *buf, Int_t len, Long64_t offset);
+   void WaitFor(Long64_t offset, Int_t len);
+   Bool_t Drain();
+
+   std::size_t GetMaxQueuedBytes() const { return fMaxQueuedBytes; }
+   void SetMaxQueuedBytes(std::size_t maxQueuedBytes);
+   /// Description of the first failed write, empty if all writes succeeded so far.
+   std::string GetError();
+};
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -0,0 +1,105 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/RKeyIndex.hxx"
+
+#include "Bytes.h"
+
+#include <algorithm>
+
+namespace {
+
+// The 16 highest bits of the directory position hold the TProcessID offset of the key, see TKey::ReadKeyBuffer
+constexpr Long64_t kPidOffsetMask = 0x0000FFFFFFFFFFFFLL;
+
+// Read the length and the position of a TString written by TString::FillBuffer; returns false if it is truncated
+bool ReadString(const char *record, Int_t size, Int_t &pos, Int_t &offset, Int_t &len)
+{
+   if (pos + 1 > size)
+      return false;
+   UChar_t nwh = record[pos++];
+   if (nwh == 255) {
+      if (pos + 4 > size)
+         return false;
+      char *buffer = const_cast<char *>(record + pos);
+      frombuf(buffer, &len);
+      pos += 4;
+   } else {
+      len = nwh;
+   }
+   if (len < 0 || len > size - pos)
+      return false;
+   offset = pos;
+   pos += len;
+   return true;
+}
+
+} // anonymous namespace
+
+ROOT::Internal::RKeyIndex::RKeyIndex(std::unique_ptr<char[]> record, Int_t size, Int_t nkeys, Long64_t fileSize)
+   : fRecord(std::move(record)), fRecordSize(size)
+{
+   fEntries.reserve(nkeys);
+   Int_t pos = 0;
+   for (Int_t i = 0; i < nkeys; ++i) {
+      // Nbytes, Version, ObjLen, Datime, KeyLen, Cycle, SeekKey, SeekPdir
+      REntry entry;
+      entry.fKeyOffset = pos;
+      if (pos + 18 > fRecordSize)
+         break;
+      char *buffer = fRecord.get() + pos + 4;
+      Version_t version;
+      frombuf(buffer, &version);
+      buffer += 4 + 4 + 2;
+      frombuf(buffer, &entry.fCycle);
+      Long64_t seekPdir;
+      if (version > 1000) {
+         if (pos + 34 > fRecordSize)
+            break;
+         frombuf(buffer, &entry.fSeekKey);
+         frombuf(buffer, &seekPdir);
+         seekPdir &= kPidOffsetMask;
+      } else {
+         if (pos + 26 > fRecordSize)
+            break;
+         UInt_t seekKey, seekDir;
+         frombuf(buffer, &seekKey);
+         frombuf(buffer, &seekDir);
+         entry.fSeekKey = seekKey;
+         seekPdir = seekDir;
+      }
+      if (entry.fSeekKey < 64 || entry.fSeekKey > fileSize || seekPdir < 64 || seekPdir > fileSize)
+         break;
+      pos = buffer - fRecord.get();
+      Int_t titleOffset, titleLen;
+      if (!ReadString(fRecord.get(), fRecordSize, pos, entry.fClassOffset, entry.fClassLen) ||
+          !ReadString(fRecord.get(), fRecordSize, pos, entry.fNameOffset, entry.fNameLen) ||
+          !ReadString(fRecord.get(), fRecordSize, pos, titleOffset, titleLen))
+         break;
+      fEntries.push_back(entry);
+   }
+
+   std::stable_sort(fEntries.begin(), fEntries.end(),
+                    [this](const REntry &a, const REntry &b) { return GetName(a) < GetName(b); });
+}
+
+std::pair<ROOT::Internal::RKeyIndex::Iterator_t, ROOT::Internal::RKeyIndex::Iterator_t>
+ROOT::Internal::RKeyIndex::Find(std::string_view name)
+{
+   auto first = std::lower_bound(fEntries.begin(), fEntries.end(), name,
+                                 [this](const REntry &entry, std::string_view n) { return GetName(entry) < n; });
+   auto last = std::upper_bound(first, fEntries.end(), name,
+                                [this](std::string_view n, const REntry &entry) { return n < GetName(entry); });
+   return {first, last};
+}
+
+Int_t ROOT::Internal::RKeyIndex::GetNKeys(std::string_view className) const
+{
+   return std::count_if(fEntries.begin(), fEntries.end(),
+                        [&](const REntry &entry) { return GetClassName(entry) == className; });
+}
@@ -16,6 +16,8 @@
 #include "TROOT.h"
 #include "TVirtualMutex.h"
 
+#include <algorithm>
+#include <memory>
 #include <utility>
 
 namespace ROOT {
@@ -46,6 +48,8 @@ TBufferMerger::~TBufferMerger()
    for (const auto &f : fAttachedFiles)
       if (!f.expired()) Fatal("TBufferMerger", " TBufferMergerFiles must be destroyed before the server");
 
+   StopMergeThreads();
+
    if (!fQueue.empty())
       Merge();
 
@@ -73,13 +77,29 @@ size_t TBufferMerger::GetQueueSize() const
 
 void TBufferMerger::Push(TBufferFile *buffer)
 {
+   const size_t size = buffer->BufferSize();
    {
-      std::lock_guard<std::mutex> lock(fQueueMutex);
-      fBuffered += buffer->BufferSize();
-      fQueue.push(buffer);
+      std::unique_lock<std::mutex> lock(fQueueMutex);
+      auto fits = [this, size] { return fMaxBuffered == 0 || fPending == 0 || fPending + size <= fMaxBuffered; };
+      while (!fits()) {
+         const auto merges = fNMerges;
+         if (fMergeThreads.empty() && !fMergingOutput) {
+            // Nobody merges the queue: merge it here, unless another writer is about to
+            lock.unlock();
+            if (!Merge())
+               std::this_thread::yield();
+            lock.lock();
+            continue;
+         }
+         fQueueCondition.wait(lock, [&] { return fits() || fNMerges != merges; });
+      }
+      fBuffered += size;
+      fPending += size;
+      fQueue.push_back(buffer);
    }
+   fQueueCondition.notify_all();
 
-   if (fBuffered > fAutoSave)
+   if (fMergeThreads.empty() && fBuffered > fAutoSave)
       Merge();
 }
 
@@ -99,41 +119,197 @@ void TBufferMerger::SetAutoSave(size_t size)
    fAutoSave = size;
 }
 
+void TBufferMerger::SetMaxBuffered(size_t size)
+{
+   {
+      std::lock_guard<std::mutex> lock(fQueueMutex);
+      fMaxBuffered = size;
+   }
+   fQueueCondition.notify_all();
+}
+
+void TBufferMerger::SetMergeThreads(unsigned int nthreads)
+{
+   StopMergeThreads();
+   if (nthreads > 0)
+      ROOT::EnableThreadSafety();
+   for (unsigned int i = 0; i < nthreads; ++i)
+      fMergeThreads.emplace_back(&TBufferMerger::MergeThread, this, /*output=*/i == 0);
+}
+
+void TBufferMerger::StopMergeThreads()
+{
+   {
+      std::lock_guard<std::mutex> lock(fQueueMutex);
+      fStopMerging = true;
+   }
+   fQueueCondition.notify_all();
+   for (auto &t : fMergeThreads)
+      t.join();
+   fMergeThreads.clear();
+   fStopMerging = false;
+}
+
 void TBufferMerger::SetMergeOptions(const TString& options)
 {
    fMerger.SetMergeOptions(options);
 }
 
-void TBufferMerger::Merge()
+bool TBufferMerger::Merge()
 {
    if (fMergeMutex.try_lock()) {
       MergeImpl();
       fMergeMutex.unlock();
+      return true;
    }
+   return false;
 }
 
 void TBufferMerger::MergeImpl()
 {
-   std::queue<TBufferFile *> queue;
+   std::vector<TBufferFile *> buffers;
    {
       std::lock_guard<std::mutex> q(fQueueMutex);
-      std::swap(queue, fQueue);
-      fBuffered = 0;
+      // Stop at the first batch being pre-merged, whose buffers must be merged before the ones queued after it
+      auto end = std::find_if(fQueue.begin(), fQueue.end(), [this](TBufferFile *b) { return IsPreMerging(b); });
+      buffers.assign(fQueue.begin(), end);
+      fQueue.erase(fQueue.begin(), end);
+      for (auto b : buffers)
+         fBuffered -= b->BufferSize();
+      fMergingOutput = true;
    }
 
-   while (!queue.empty()) {
-      std::unique_ptr<TBufferFile> buffer{queue.front()};
+   size_t size = 0;
+   for (auto b : buffers) {
+      std::unique_ptr<TBufferFile> buffer{b};
+      size += buffer->BufferSize();
       fMerger.AddAdoptFile(new TMemFile(fMerger.GetOutputFileName(), std::move(buffer)));
-      queue.pop();
    }
 
    fMerger.PartialMerge(TFileMerger::kAll | TFileMerger::kIncremental | TFileMerger::kDelayWrite |
                         TFileMerger::kKeepCompression);
    fMerger.Reset();
+
+   // The merged buffers are gone: wake up the writers waiting for memory
+   {
+      std::lock_guard<std::mutex> q(fQueueMutex);
+      fMergingOutput = false;
+      fPending -= size;
+      ++fNMerges;
+   }
+   fQueueCondition.notify_all();
+}
+
+TBufferFile *TBufferMerger::PreMerge(const std::vector<TBufferFile *> &buffers)
+{
+   TDirectory::TContext ctxt;
+   TBufferFile *merged = nullptr;
+   {
+      TFileMerger merger{false, false};
+      merger.SetMergeOptions(TString(fMerger.GetMergeOptions()));
+      merger.SetNotrees(fMerger.GetNotrees());
+      const char *name = fMerger.GetOutputFileName();
+      merger.OutputFile(
+         std::make_unique<TMemFile>(name, "RECREATE", "", fMerger.GetOutputFile()->GetCompressionSettings()));
+
+      // The input files only view the buffers, which are deleted once the merge succeeded
+      for (auto buffer : buffers) {
+         merger.AddAdoptFile(new TMemFile(name, TMemFile::ZeroCopyView_t(buffer->Buffer(), buffer->BufferSize())));
+      }
+
+      // Not delaying the write, so that the merged objects end up in the TMemFile
+      if (!merger.PartialMerge(TFileMerger::kAll | TFileMerger::kIncremental | TFileMerger::kKeepCompression)) {
+         Error("TBufferMerger", "cannot merge the queued buffers, leaving them to the output merge");
+         return nullptr;
+      }
+
+      const auto *output = static_cast<TMemFile *>(merger.GetOutputFile());
+      merged = new TBufferFile(TBuffer::kWrite, output->GetSize());
+      output->CopyTo(*merged);
+      merged->SetReadMode();
+   }
+
+   return merged;
+}
+
+bool TBufferMerger::IsPreMerging(const TBufferFile *buffer) const
+{
+   return std::find(fPreMerging.begin(), fPreMerging.end(), buffer) != fPreMerging.end();
+}
+
+size_t TBufferMerger::GetNPreMergeable() const
+{
+   // Only the buffers queued after the last batch being pre-merged can be merged together without reordering
+   size_t n = 0;
+   for (auto it = fQueue.rbegin(); it != fQueue.rend() && !IsPreMerging(*it); ++it)
+      ++n;
+   return n;
+}
+
+void TBufferMerger::MergeThread(bool output)
+{
+   std::unique_lock<std::mutex> lock(fQueueMutex);
+   while (true) {
+      if (output) {
+         // Merge the queue into the output file up to the first batch being pre-merged, and drain it before stopping
+         auto canMerge = [this] { return !fQueue.empty() && !IsPreMerging(fQueue.front()); };
+         fQueueCondition.wait(lock, [&] { return (fStopMerging && fPreMerging.empty()) || canMerge(); });
+         if (!canMerge())
+            return;
+         lock.unlock();
+         {
+            std::lock_guard<std::mutex> merge(fMergeMutex);
+            MergeImpl();
+         }
+         lock.lock();
+         continue;
+      }
+
+      // While the output file is busy, merge the buffers queued in the meantime into a single one. The first
+      // buffer of the batch stays in the queue and is replaced by the merged one, so that the order is kept.
+      fQueueCondition.wait(lock, [this] { return fStopMerging || (fMergingOutput && GetNPreMergeable() > 1); });
+      if (fStopMerging)
+         return;
+      const auto first = fQueue.end() - GetNPreMergeable();
+      std::vector<TBufferFile *> buffers(first, fQueue.end());
+      fQueue.erase(first + 1, fQueue.end());
+      fPreMerging.push_back(buffers.front());
+      size_t size = 0;
+      for (auto b : buffers)
+         size += b->BufferSize();
+      fBuffered -= size;
+      lock.unlock();
+
+      TBufferFile *merged = PreMerge(buffers);
+
+      lock.lock();
+      fPreMerging.erase(std::find(fPreMerging.begin(), fPreMerging.end(), buffers.front()));
+      const auto pos = std::find(fQueue.begin(), fQueue.end(), buffers.front());
+      if (!merged) {
+         // Give the buffers back in place, still pending, and let the next output merge consume them
+         fBuffered += size;
+         fQueue.insert(pos + 1, buffers.begin() + 1, buffers.end());
+         fQueueCondition.notify_all();
+         fQueueCondition.wait(lock, [this] { return fStopMerging || !fMergingOutput; });
+         continue;
+      }
+      *pos = merged;
+      fBuffered += merged->BufferSize();
+      fPending += merged->BufferSize();
+      fPending -= size;
+      ++fNMerges;
+      fQueueCondition.notify_all();
+      for (auto b : buffers)
+         delete b;
+   }
 }
 
 bool TBufferMerger::TryMerge(ROOT::TBufferMergerFile *memfile)
 {
+   // With merging threads, the writers leave the merging to them
+   if (!fMergeThreads.empty())
+      return false;
+
    if (fMergeMutex.try_lock()) {
       memfile->WriteStreamerInfo();
       fMerger.AddFile(memfile);
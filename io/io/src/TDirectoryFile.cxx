@@ -27,6 +27,7 @@ End_Macro
 #include "Strlen.h"
 #include "strlcpy.h"
 #include "TDirectoryFile.h"
+#include "ROOT/RKeyIndex.hxx"
 #include "TFile.h"
 #include "TBufferFile.h"
 #include "TBufferJSON.h"
@@ -49,11 +50,51 @@ End_Macro
 #include "TVirtualMutex.h"
 #include "TEmulatedCollectionProxy.h"
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
 const UInt_t kIsBigFile = BIT(16);
 const Int_t  kMaxLen = 2048;
 
+Int_t TDirectoryFile::fgKeyIndexThreshold = 0;
+
 ClassImp(TDirectoryFile);
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// The names of the subdirectories of a directory, in the order of its keys.
+/// If the directory has a key index (see TDirectoryFile::SetKeyIndexThreshold),
+/// they are taken from the index, without creating the keys.
+
+std::vector<std::string> GetSubdirectoryNames(ROOT::Internal::RKeyIndex *index, TList *keys)
+{
+   std::vector<std::string> names;
+   if (index) {
+      std::vector<const ROOT::Internal::RKeyIndex::REntry *> dirs;
+      for (const auto &entry : index->GetEntries()) {
+         if (index->GetClassName(entry).find("TDirectory") != std::string_view::npos)
+            dirs.push_back(&entry);
+      }
+      std::sort(dirs.begin(), dirs.end(),
+                [](const ROOT::Internal::RKeyIndex::REntry *a, const ROOT::Internal::RKeyIndex::REntry *b) {
+                   return a->fKeyOffset < b->fKeyOffset;
+                });
+      for (auto entry : dirs)
+         names.emplace_back(index->GetName(*entry));
+      return names;
+   }
+   for (auto key : TRangeDynCast<TKey>(*keys)) {
+      if (key && strstr(key->GetClassName(), "TDirectory"))
+         names.emplace_back(key->GetName());
+   }
+   return names;
+}
+
+} // anonymous namespace
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Default TDirectoryFile constructor
@@ -177,6 +218,7 @@ void TDirectoryFile::InitDirectoryFile(TClass *cl)
 
 TDirectoryFile::~TDirectoryFile()
 {
+   DeleteKeyIndex();
    if (fKeys) {
       fKeys->Delete("slow");
       SafeDelete(fKeys);
@@ -232,6 +274,8 @@ Int_t TDirectoryFile::AppendKey(TKey *key)
 
    fModified = kTRUE;
 
+   LoadKeys();
+
    key->SetMotherDir(this);
 
    // This is a fast hash lookup in case the key does not already exist
@@ -266,6 +310,7 @@ void TDirectoryFile::Browse(TBrowser *b)
       TObject *obj = nullptr;
       TIter nextin(fList);
       TKey *key = nullptr, *keyo = nullptr;
+      LoadKeys();
       TIter next(fKeys);
 
       cd();
@@ -588,6 +633,7 @@ void TDirectoryFile::Close(Option_t *option)
    }
 
    // Delete keys from key list (but don't delete the list header)
+   DeleteKeyIndex();
    if (fKeys) {
       fKeys->Delete("slow");
    }
@@ -801,7 +847,8 @@ TKey *TDirectoryFile::FindKeyAny(const char *keyname) const
 
    DecodeNameCycle(keyname, name, cycle, kMaxLen);
 
-   auto listOfKeys = dynamic_cast<THashList *>(GetListOfKeys());
+   LoadKeys(name);
+   auto listOfKeys = dynamic_cast<THashList *>(fKeys);
    if (!listOfKeys) {
       Error("FindKeyAny", "Unexpected type of TDirectoryFile::fKeys!");
       return nullptr;
@@ -817,17 +864,12 @@ TKey *TDirectoryFile::FindKeyAny(const char *keyname) const
       }
    }
 
-   //try with subdirectories
-   TIter next(GetListOfKeys());
-   TKey *key;
-   while ((key = (TKey *) next())) {
-      //if (!strcmp(key->GetClassName(),"TDirectory")) {
-      if (strstr(key->GetClassName(),"TDirectory")) {
-         TDirectory* subdir =
-             const_cast<TDirectoryFile*>(this)->GetDirectory(key->GetName(), kTRUE, "FindKeyAny");
-         TKey *k = subdir ? subdir->FindKeyAny(keyname) : nullptr;
-         if (k) return k;
-      }
+   //try with subdirectories, creating only their keys if there is a key index
+   for (const auto &subdirName : GetSubdirectoryNames(fKeyIndex, fKeys)) {
+      TDirectory* subdir =
+          const_cast<TDirectoryFile*>(this)->GetDirectory(subdirName.c_str(), kTRUE, "FindKeyAny");
+      TKey *k = subdir ? subdir->FindKeyAny(keyname) : nullptr;
+      if (k) return k;
    }
    if (dirsav) dirsav->cd();
    return nullptr;
@@ -853,7 +895,8 @@ TObject *TDirectoryFile::FindObjectAny(const char *aname) const
 
    DecodeNameCycle(aname, name, cycle, kMaxLen);
 
-   auto listOfKeys = dynamic_cast<THashList *>(GetListOfKeys());
+   LoadKeys(name);
+   auto listOfKeys = dynamic_cast<THashList *>(fKeys);
    if (!listOfKeys) {
       Error("FindObjectAny", "Unexpected type of TDirectoryFile::fKeys!");
       return nullptr;
@@ -868,17 +911,12 @@ TObject *TDirectoryFile::FindObjectAny(const char *aname) const
       }
    }
 
-   //try with subdirectories
-   TIter next(GetListOfKeys());
-   TKey *key;
-   while ((key = (TKey *) next())) {
-      //if (!strcmp(key->GetClassName(),"TDirectory")) {
-      if (strstr(key->GetClassName(),"TDirectory")) {
-         TDirectory* subdir =
-           ((TDirectory*)this)->GetDirectory(key->GetName(), kTRUE, "FindKeyAny");
-         TKey *k = subdir ? subdir->FindKeyAny(aname) : nullptr;
-         if (k) { if (dirsav) dirsav->cd(); return k->ReadObj();}
-      }
+   //try with subdirectories, creating only their keys if there is a key index
+   for (const auto &subdirName : GetSubdirectoryNames(fKeyIndex, fKeys)) {
+      TDirectory* subdir =
+        ((TDirectory*)this)->GetDirectory(subdirName.c_str(), kTRUE, "FindKeyAny");
+      TKey *k = subdir ? subdir->FindKeyAny(aname) : nullptr;
+      if (k) { if (dirsav) dirsav->cd(); return k->ReadObj();}
    }
    if (dirsav) dirsav->cd();
    return nullptr;
@@ -974,7 +1012,8 @@ TObject *TDirectoryFile::Get(const char *namecycle)
 
 //*-*---------------------Case of Key---------------------
 //                        ===========
-   auto listOfKeys = dynamic_cast<THashList *>(GetListOfKeys());
+   LoadKeys(namobj);
+   auto listOfKeys = dynamic_cast<THashList *>(fKeys);
    if (!listOfKeys) {
       Error("Get", "Unexpected type of TDirectoryFile::fKeys!");
       return nullptr;
@@ -1097,7 +1136,8 @@ void *TDirectoryFile::GetObjectChecked(const char *namecycle, const TClass* expe
 
 //*-*---------------------Case of Key---------------------
 //                        ===========
-   auto listOfKeys = dynamic_cast<THashList *>(GetListOfKeys());
+   LoadKeys(namobj);
+   auto listOfKeys = dynamic_cast<THashList *>(fKeys);
    if (!listOfKeys) {
       Error("GetObjectChecked", "Unexpected type of TDirectoryFile::fKeys!");
       return nullptr;
@@ -1138,7 +1178,8 @@ TKey *TDirectoryFile::GetKey(const char *name, Short_t cycle) const
 {
    if (!fKeys) return nullptr;
 
-   auto listOfKeys = dynamic_cast<THashList *>(GetListOfKeys());
+   LoadKeys(name);
+   auto listOfKeys = dynamic_cast<THashList *>(fKeys);
    if (!listOfKeys) {
       Error("GetKey", "Unexpected type of TDirectoryFile::fKeys!");
       return nullptr;
@@ -1156,6 +1197,30 @@ TKey *TDirectoryFile::GetKey(const char *name, Short_t cycle) const
    return nullptr;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the list of keys of the directory.
+///
+/// The keys still in the key index, if any (see SetKeyIndexThreshold), are
+/// created first.
+
+TList *TDirectoryFile::GetListOfKeys() const
+{
+   LoadKeys();
+   return fKeys;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of keys of the directory, including the ones still in
+/// the key index (see SetKeyIndexThreshold).
+
+Int_t TDirectoryFile::GetNkeys() const
+{
+   Int_t nkeys = fKeys->GetSize();
+   if (fKeyIndex)
+      nkeys += fKeyIndex->GetNKeys() - fKeyIndex->GetNLoaded();
+   return nkeys;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// List Directory contents
 ///
@@ -1204,6 +1269,7 @@ void TDirectoryFile::ls(Option_t *option) const
    }
 
    if (diskobj && fKeys) {
+      LoadKeys();
       //*-* Loop on all the keys
       TObjLink *lnk = fKeys->FirstLink();
       while (lnk) {
@@ -1385,6 +1451,7 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
 
    char *buffer;
    if (forceRead) {
+      DeleteKeyIndex();
       fKeys->Delete();
       //In case directory was updated by another process, read new
       //position for the keys
@@ -1427,6 +1494,22 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
 
       TKey *key;
       frombuf(buffer, &nkeys);
+
+      if (fgKeyIndexThreshold > 0 && nkeys >= fgKeyIndexThreshold && !fFile->IsWritable() && !fKeyIndex &&
+          fKeys->IsEmpty()) {
+         // Keep the key headers and index them, the TKeys are created when needed
+         Int_t size = headerkey->GetBuffer() + fNbytesKeys - buffer;
+         std::unique_ptr<char[]> record(new char[size]);
+         memcpy(record.get(), buffer, size);
+         delete headerkey;
+         fKeyIndex = new ROOT::Internal::RKeyIndex(std::move(record), size, nkeys, fsize);
+         if (fKeyIndex->GetNKeys() < nkeys) {
+            Error("ReadKeys","reading illegal key, exiting after %d keys", fKeyIndex->GetNKeys());
+            nkeys = fKeyIndex->GetNKeys();
+         }
+         return nkeys;
+      }
+
       for (Int_t i = 0; i < nkeys; i++) {
          key = new TKey(this);
          key->ReadKeyBuffer(buffer);
@@ -1463,7 +1546,8 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
 Int_t TDirectoryFile::ReadTObject(TObject *obj, const char *keyname)
 {
    if (!fFile) { Error("ReadTObject","No file open"); return 0; }
-   auto listOfKeys = dynamic_cast<THashList *>(GetListOfKeys());
+   LoadKeys(keyname);
+   auto listOfKeys = dynamic_cast<THashList *>(fKeys);
    if (!listOfKeys) {
       Error("ReadTObject", "Unexpected type of TDirectoryFile::fKeys!");
       return 0;
@@ -1504,6 +1588,7 @@ void TDirectoryFile::ResetAfterMerge(TFileMergeInfo *info)
    fSeekParent = 0; // updated by Init
    fSeekKeys = 0;   // updated by Init
    // Does not change: fFile
+   LoadKeys();
    TKey *key = fKeys ? (TKey*)fKeys->FindObject(fName) : nullptr;
    TClass *cl = IsA();
    if (key) {
@@ -1637,6 +1722,34 @@ void TDirectoryFile::SaveSelf(Bool_t force)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the minimum number of keys of the directories read with a key index.
+///
+/// The directories read afterwards from files opened in read mode, whose keys
+/// record holds at least nkeys keys, do not create their TKeys when read:
+/// they keep the record and index it by name. The TKeys of a name are created
+/// when that name is looked up (Get, GetKey, FindKey, ...), and all of them
+/// when the whole list is needed (GetListOfKeys, ls, iterations, ...) or when
+/// the directory becomes writable. Opening a file or a directory with many
+/// keys to read a few objects then costs a single allocation for the keys.
+///
+/// A value of 0, the default, disables the key index.
+
+void TDirectoryFile::SetKeyIndexThreshold(Int_t nkeys)
+{
+   fgKeyIndexThreshold = nkeys;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the minimum number of keys of the directories read with a key index.
+///
+/// See TDirectoryFile::SetKeyIndexThreshold for more documentation.
+
+Int_t TDirectoryFile::GetKeyIndexThreshold()
+{
+   return fgKeyIndexThreshold;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the default buffer size when creating new TKeys.
 ///
@@ -1680,6 +1793,10 @@ void TDirectoryFile::SetWritable(Bool_t writable)
 {
    TDirectory::TContext ctxt(this);
 
+   // The new keys are inserted among the existing ones
+   if (writable)
+      LoadKeys();
+
    fWritable = writable;
 
    // recursively set all sub-directories
@@ -1822,6 +1939,76 @@ void TDirectoryFile::Streamer(TBuffer &b)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the key index, if any, without creating the keys left in it.
+
+void TDirectoryFile::DeleteKeyIndex()
+{
+   delete fKeyIndex;
+   fKeyIndex = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the keys of the key index (see SetKeyIndexThreshold) named name, or
+/// all of them if name is null. Once all of them are created, fKeys holds them
+/// in the order of the keys record and the index is deleted.
+
+void TDirectoryFile::LoadKeys(const char *name) const
+{
+   if (!fKeyIndex)
+      return;
+
+   auto self = const_cast<TDirectoryFile *>(this);
+   auto createKey = [&](ROOT::Internal::RKeyIndex::REntry &entry) {
+      TKey *key = new TKey(self);
+      char *buffer = fKeyIndex->GetKeyBuffer(entry);
+      key->ReadKeyBuffer(buffer);
+      fKeyIndex->SetLoaded(entry);
+      return key;
+   };
+
+   if (name) {
+      // The cycles of a name are created together, in the order of the record
+      auto range = fKeyIndex->Find(name);
+      for (auto entry = range.first; entry != range.second; ++entry) {
+         if (!entry->fLoaded)
+            fKeys->Add(createKey(*entry));
+      }
+      return;
+   }
+
+   // While the index exists, fKeys only holds keys created from it: rebuild it in the order of the record
+   auto &entries = fKeyIndex->GetEntries();
+   std::sort(entries.begin(), entries.end(),
+             [](const ROOT::Internal::RKeyIndex::REntry &a, const ROOT::Internal::RKeyIndex::REntry &b) {
+                return a.fKeyOffset < b.fKeyOffset;
+             });
+   auto listOfKeys = dynamic_cast<THashList *>(fKeys);
+   std::vector<TKey *> keys;
+   keys.reserve(entries.size());
+   for (auto &entry : entries) {
+      if (!entry.fLoaded) {
+         keys.push_back(createKey(entry));
+         continue;
+      }
+      // Created before, unless it was deleted since
+      const std::string keyName(fKeyIndex->GetName(entry));
+      if (const TList *keyList = listOfKeys ? listOfKeys->GetListForObject(keyName.c_str()) : nullptr) {
+         for (auto key : TRangeDynCast<TKey>(*keyList)) {
+            if (key && keyName == key->GetName() && key->GetCycle() == entry.fCycle &&
+                key->GetSeekKey() == entry.fSeekKey) {
+               keys.push_back(key);
+               break;
+            }
+         }
+      }
+   }
+   fKeys->Clear("nodelete");
+   for (auto key : keys)
+      fKeys->Add(key);
+   self->DeleteKeyIndex();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Write all objects in memory to disk.
 ///
@@ -139,7 +139,11 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include "TThreadSlots.h"
 #include "TGlobal.h"
 #include "ROOT/RConcurrentHashColl.hxx"
+#include "RFileWriteBehind.hxx"
+#include "ROOT/RFileBlockCache.hxx"
+#include "ROOT/RKeyIndex.hxx"
 #include <memory>
+#include <mutex>
 
 using std::sqrt;
 
@@ -149,15 +153,20 @@ std::atomic<Long64_t> TFile::fgFileCounter{0};
 std::atomic<Int_t>    TFile::fgReadCalls{0};
 Int_t    TFile::fgReadaheadSize = 256000;
 Bool_t   TFile::fgReadInfo = kTRUE;
+Bool_t   TFile::fgFastOpen = kFALSE;
 TList   *TFile::fgAsyncOpenRequests = nullptr;
 TString  TFile::fgCacheFileDir;
 Bool_t   TFile::fgCacheFileForce = kFALSE;
 Bool_t   TFile::fgCacheFileDisconnected = kTRUE;
 UInt_t   TFile::fgOpenTimeout = TFile::kEternalTimeout;
 Bool_t   TFile::fgOnlyStaged = kFALSE;
-#ifdef R__USE_IMT
 ROOT::Internal::RConcurrentHashColl TFile::fgTsSIHashes;
-#endif
+
+namespace {
+std::mutex gBlockCacheMutex;                                  ///< Protects the two variables below
+std::shared_ptr<ROOT::Internal::RFileBlockCache> gBlockCache; ///< See TFile::SetBlockCacheDir
+bool gBlockCacheConfigured = false;                           ///< False until set from the rootrc or explicitly
+} // anonymous namespace
 
 #ifdef R__MACOSX
 /* On macOS getxattr takes two extra arguments that should be set to 0 */
@@ -566,6 +575,7 @@ TFile::~TFile()
    SafeDelete(fCacheRead);
    SafeDelete(fCacheReadMap);
    SafeDelete(fCacheWrite);
+   SafeDelete(fWriteBehind);
    SafeDelete(fProcessIDs);
    SafeDelete(fFree);
    SafeDelete(fArchive);
@@ -806,6 +816,23 @@ void TFile::Init(Bool_t create)
          goto zombie;
       }
 
+      //*-* -------------Use the local block cache for remote files opened read-only
+      if (!fWritable && fEND <= size && strcmp(fUrl.GetProtocol(), "file")) {
+         fBlockCache = GetBlockCache();
+         if (fBlockCache) {
+            // The UUID and the modification date identify the version of the file. The date has a resolution
+            // of one second: the end of the file and the position of the keys tell apart the updates done
+            // within the same second (every update rewrites the list of keys of the top directory).
+            UChar_t uuid[16];
+            fUUID.GetUUID(uuid);
+            TString version;
+            for (auto byte : uuid)
+               version += TString::Format("%02x", byte);
+            version += TString::Format(" %u %lld %lld", fDatimeM.Get(), fEND, fSeekKeys);
+            fBlockCacheKey = ROOT::Internal::RFileBlockCache::MakeFileKey(fUrl.GetUrl(), version.Data());
+         }
+      }
+
       //*-* -------------Check if, in case of inconsistencies, we are requested to
       //*-* -------------attempt recovering the file
       Bool_t tryrecover = (gEnv->GetValue("TFile.Recover", 1) == 1) ? kTRUE : kFALSE;
@@ -869,7 +896,10 @@ void TFile::Init(Bool_t create)
       if (lenIndex < 5000) lenIndex = 5000;
       fClassIndex = new TArrayC(lenIndex);
       if (fgReadInfo) {
-         if (fSeekInfo > fBEGIN) {
+         if (fSeekInfo > fBEGIN && fgFastOpen && !fWritable) {
+            // Read by the first TKey::ReadObj & co, if any
+            fStreamerInfoPending = kTRUE;
+         } else if (fSeekInfo > fBEGIN) {
             ReadStreamerInfo();                // NOLINT: silence clang-tidy warnings
             if (IsZombie()) {
                R__LOCKGUARD(gROOTMutex);
@@ -878,7 +908,7 @@ void TFile::Init(Bool_t create)
             }
          } else if (fVersion != gROOT->GetVersionInt() && fVersion > 30000) {
             // Don't complain about missing streamer info for empty files.
-            if (fKeys->GetSize()) {
+            if (GetNkeys()) {
                Warning("Init","no StreamerInfo found in %s therefore preventing schema evolution when reading this file."
                               " The file was produced with version %d.%02d/%02d of ROOT.",
                               GetName(),  fVersion / 10000, (fVersion / 100) % (100), fVersion  % 100);
@@ -888,7 +918,10 @@ void TFile::Init(Bool_t create)
    }
 
    // Count number of TProcessIDs in this file
-   {
+   if (fKeyIndex) {
+      fNProcessIDs += fKeyIndex->GetNKeys("TProcessID");
+      fProcessIDs = new TObjArray(fNProcessIDs+1);
+   } else {
       TIter next(fKeys);
       TKey *key;
       while ((key = (TKey*)next())) {
@@ -897,6 +930,13 @@ void TFile::Init(Bool_t create)
       fProcessIDs = new TObjArray(fNProcessIDs+1);
    }
 
+   // Write the buffers in the background if requested
+   if (fWritable && IsA() == TFile::Class()) {
+      Long64_t writeBehind = gEnv->GetValue("TFile.WriteBehind", 0);
+      if (writeBehind > 0)
+         SetWriteBehind(writeBehind * 1024 * 1024);
+   }
+
    return;
 
 zombie:
@@ -974,6 +1014,8 @@ void TFile::Close(Option_t *option)
    fMustFlush = kTRUE;
 
    FlushWriteCache();
+   SetWriteBehind(0);
+   fBlockCache.reset();
 
    if (gMonitoringWriter)
       gMonitoringWriter->SendFileCloseEvent(this);
@@ -1117,6 +1159,8 @@ void TFile::Flush()
 {
    if (IsOpen() && fWritable) {
       FlushWriteCache();
+      if (SyncWriteBehind("Flush"))
+         return;
       if (SysSync(fD) < 0) {
          // Write the system error only once for this file
          SetBit(kWriteError); SetWritable(kFALSE);
@@ -1326,6 +1370,9 @@ Long64_t TFile::GetSize() const
    if (fArchive && fArchive->GetMember()) {
       size = fArchive->GetMember()->GetDecompressedSize();
    } else {
+      // the pending writes may extend the file
+      if (fWriteBehind)
+         fWriteBehind->Drain();
       Long_t id, flags, modtime;
       if (const_cast<TFile*>(this)->SysStat(fD, &id, &size, &flags, &modtime)) {  // NOLINT: silence clang-tidy warnings
          Error("GetSize", "cannot stat the file %s", GetName());
@@ -1368,7 +1415,6 @@ TFile::InfoListRet TFile::GetStreamerInfoListImpl(bool lookupSICache)
          return {nullptr, 1, hash};
       }
 
-#ifdef R__USE_IMT
       if (lookupSICache) {
          // key data must be excluded from the hash, otherwise the timestamp will
          // always lead to unique hashes for each file
@@ -1378,9 +1424,6 @@ TFile::InfoListRet TFile::GetStreamerInfoListImpl(bool lookupSICache)
             return {nullptr, 0, hash};
          }
       }
-#else
-      (void) lookupSICache;
-#endif
       key->ReadKeyBuffer(buf);
       list = dynamic_cast<TList*>(key->ReadObjWithBuffer(buffer.data()));
       if (list) list->SetOwner();
@@ -1887,9 +1930,45 @@ Int_t TFile::ReadBufferViaCache(char *buf, Int_t len)
       }
    }
 
+   // if write-behind is active wait until the data has reached the file
+   if (fWriteBehind)
+      fWriteBehind->WaitFor(fOffset, len);
+
+   // read remote files through the local block cache, if any
+   if (fBlockCache) {
+      Int_t st = ReadBuffersViaBlockCache(buf, &off, &len, 1);
+      if (st == 1)
+         SetOffset(off + len);
+      return st;
+   }
+
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read the nbuf blocks described in arrays pos and len through the local
+/// block cache of remote files (see SetBlockCacheDir), if this file uses it.
+///
+/// The blocks not in the cache are read with ReadBuffers(). This is called by
+/// ReadBufferViaCache and by the ReadBuffers implementation of the remote file
+/// classes. Returns 0 if the cache was not used, 1 if the data was read from
+/// the cache and 2 in case of failure.
+
+Int_t TFile::ReadBuffersViaBlockCache(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
+{
+   // fBlockCacheBusy: the blocks are being fetched through our ReadBuffers()
+   if (!fBlockCache || fBlockCacheBusy || !buf || nbuf <= 0)
+      return 0;
+
+   fBlockCacheBusy = kTRUE;
+   auto fetch = [this](char *blocks, Long64_t *blockPos, Int_t *blockLen, Int_t nblocks) {
+      return ReadBuffers(blocks, blockPos, blockLen, nblocks);
+   };
+   Int_t st = fBlockCache->Read(fBlockCacheKey, fEND, buf, pos, len, nbuf, fetch);
+   fBlockCacheBusy = kFALSE;
+   return st;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read the FREE linked list.
 ///
@@ -2166,6 +2245,7 @@ Int_t TFile::ReOpen(Option_t *mode)
          }
 
          FlushWriteCache();
+         SetWriteBehind(0);
 
          // delete free segments from free list
          fFree->Delete();
@@ -2211,6 +2291,12 @@ Int_t TFile::ReOpen(Option_t *mode)
          return -1;
       }
       SetWritable(kTRUE);
+      fBlockCache.reset();
+
+      // The class index may be incomplete if the record was deferred or skipped
+      // (see ReadStreamerInfo); it is needed to rewrite the record.
+      if (fgReadInfo && fSeekInfo > fBEGIN)
+         ReadStreamerInfo();
 
       fFree = new TList;
       if (fSeekFree > fBEGIN)
@@ -2262,6 +2348,9 @@ void TFile::Seek(Long64_t offset, ERelativeTo pos)
          // this option is not used currently in the ROOT code
          if (fArchiveOffset)
             Error("Seek", "seeking from end in archive is not (yet) supported");
+         // the pending writes may extend the file
+         if (fWriteBehind)
+            fWriteBehind->Drain();
          break;
    }
    Long64_t retpos;
@@ -2366,6 +2455,80 @@ void TFile::SetCacheWrite(TFileCacheWrite *cache)
    fCacheWrite = cache;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Write the buffers of this file in the background, from a dedicated I/O thread.
+///
+/// With write-behind enabled, WriteBuffer() queues a copy of the data and returns
+/// immediately, so that e.g. TTree::Fill does not wait for the disk when it writes
+/// a basket. The position of every buffer in the file is still allocated
+/// synchronously: the layout of the file is the same as without write-behind.
+/// At most maxQueuedBytes of data are queued; WriteBuffer() blocks when the
+/// queue is full, until the I/O thread has caught up.
+///
+/// Reading data which is still in the queue waits for it to be written.
+/// Flush(), Write() and Close() wait for all the queued data; an error of
+/// a background write is reported by them (or by the next WriteBuffer()), after
+/// which the file is not writable anymore.
+///
+/// A value of 0 (or less) writes the queued data and stops the I/O thread.
+/// Write-behind is only supported for local files opened by TFile itself (not by
+/// its derived classes) and not on Windows. It can also be enabled for all
+/// the files opened for writing with the rootrc variable TFile.WriteBehind,
+/// which gives maxQueuedBytes in MB.
+
+void TFile::SetWriteBehind(Long64_t maxQueuedBytes)
+{
+   if (maxQueuedBytes <= 0) {
+      if (fWriteBehind) {
+         SyncWriteBehind("SetWriteBehind");
+         delete fWriteBehind;
+         fWriteBehind = nullptr;
+      }
+      return;
+   }
+   if (fWriteBehind) {
+      fWriteBehind->SetMaxQueuedBytes(maxQueuedBytes);
+      return;
+   }
+#ifdef WIN32
+   Warning("SetWriteBehind", "write-behind is not supported on Windows");
+#else
+   if (IsA() != TFile::Class()) {
+      Warning("SetWriteBehind", "write-behind is not supported by %s", IsA()->GetName());
+   } else if (IsOpen() && fWritable) {
+      fWriteBehind = new ROOT::Internal::RFileWriteBehind(fD, maxQueuedBytes);
+   }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the maximum amount of data queued by the write-behind thread, 0 if
+/// write-behind is not enabled. See SetWriteBehind().
+
+Long64_t TFile::GetWriteBehind() const
+{
+   return fWriteBehind ? fWriteBehind->GetMaxQueuedBytes() : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the data queued by the write-behind thread to be written.
+///
+/// In case of error the file is flagged with kWriteError and made read-only;
+/// the error is printed on behalf of the method `where`, once. Returns kTRUE in
+/// case of error.
+
+Bool_t TFile::SyncWriteBehind(const char *where)
+{
+   if (!fWriteBehind || !fWriteBehind->Drain())
+      return kFALSE;
+   if (!TestBit(kWriteError)) {
+      SetBit(kWriteError); SetWritable(kFALSE);
+      Error(where, "error writing to file %s in the background, %s", GetName(),
+            fWriteBehind->GetError().c_str());
+   }
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the size in bytes of the file header.
 
@@ -2459,6 +2622,27 @@ Bool_t TFile::WriteBuffer(const char *buf, Int_t len)
          return kFALSE;
       }
 
+      if (fWriteBehind) {
+         // The position in the file is allocated here, the data is written by the I/O thread
+         Long64_t end = SysSeek(fD, len, SEEK_CUR);
+         if (end < 0 || fWriteBehind->Write(buf, len, end - len)) {
+            if (end < 0) {
+               SetBit(kWriteError); SetWritable(kFALSE);
+               SysError("WriteBuffer", "error seeking in file %s", GetName());
+            } else {
+               SyncWriteBehind("WriteBuffer");
+            }
+            return kTRUE;
+         }
+         fBytesWrite  += len;
+         fgBytesWrite += len;
+
+         if (gMonitoringWriter)
+            gMonitoringWriter->SendFileWriteProgress(this);
+
+         return kFALSE;
+      }
+
       ssize_t siz;
       gSystem->IgnoreInterrupt();
       while ((siz = SysWrite(fD, buf, len)) < 0 && GetErrno() == EINTR)  // NOLINT: silence clang-tidy warnings
@@ -3576,10 +3760,17 @@ Int_t TFile::MakeProjectParProofInf(const char *pack, const char *proofinf)
 /// The corresponding TClass objects are updated.
 /// Note that this function is not called if the static member fgReadInfo is false.
 /// (see TFile::SetReadStreamerInfo)
+///
+/// A record identical to one already read from another file is skipped if the
+/// file is read-only: the TClass objects are already up to date. Writable files
+/// always process the record, as they need the complete index of the classes
+/// stored in the file to rewrite it.
 
 void TFile::ReadStreamerInfo()
 {
-   auto listRetcode = GetStreamerInfoListImpl(/*lookupSICache*/ true);  // NOLINT: silence clang-tidy warnings
+   // Reading the record goes through TKey::ReadObjWithBuffer, which must not recurse here
+   fStreamerInfoPending = kFALSE;
+   auto listRetcode = GetStreamerInfoListImpl(/*lookupSICache*/ !fWritable);  // NOLINT: silence clang-tidy warnings
    TList *list = listRetcode.fList;
    auto retcode = listRetcode.fReturnCode;
    if (!list) {
@@ -3684,11 +3875,9 @@ void TFile::ReadStreamerInfo()
    list->Clear();  //this will delete all TStreamerInfo objects with kCanDelete bit set
    delete list;
 
-#ifdef R__USE_IMT
    // We are done processing the record, let future calls and other threads that it
    // has been done.
    fgTsSIHashes.Insert(listRetcode.fHash);
-#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3717,6 +3906,40 @@ Bool_t TFile::GetReadStreamerInfo()
    return fgReadInfo;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Specify if the reading of the StreamerInfo record is deferred for the files
+/// opened in read mode.
+///
+/// If fastopen is true, the files opened afterwards in read mode do not read
+/// their StreamerInfo record in TFile::Init but when the first object is read
+/// from them by TKey (e.g. via TDirectoryFile::Get), or when they are reopened
+/// in update mode. Opening a file to list its keys, to check its integrity or
+/// to read its TProcessIDs then costs no streamer info processing at all.
+///
+/// The record is still processed as a whole, before the first object: its
+/// objects reference each other and cannot be read selectively per class. In
+/// addition, a record identical to the one of a file read before is skipped,
+/// see TFile::ReadStreamerInfo.
+///
+/// Errors in the StreamerInfo record, which make the file a zombie when
+/// detected in TFile::Init, are only detected at the first object read.
+
+void TFile::SetFastOpen(Bool_t fastopen)
+{
+   fgFastOpen = fastopen;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// If the reading of the StreamerInfo record is deferred for the files opened in
+/// read mode.
+///
+/// See TFile::SetFastOpen for more documentation.
+
+Bool_t TFile::GetFastOpen()
+{
+   return fgFastOpen;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Show the StreamerInfo of all classes written to this file.
 
@@ -4696,6 +4919,72 @@ Bool_t TFile::ShrinkCacheFileDir(Long64_t shrinksize, Long_t cleanupinterval)
    return kTRUE;
 }
 
+namespace {
+
+std::shared_ptr<ROOT::Internal::RFileBlockCache> MakeBlockCache(const char *cachedir, Long64_t maxbytes, Int_t blocksize)
+{
+   if (!cachedir || !*cachedir)
+      return nullptr;
+   if (maxbytes <= 0 || blocksize <= 0) {
+      ::Error("TFile::SetBlockCacheDir", "invalid quota (%lld bytes) or block size (%d bytes)", maxbytes, blocksize);
+      return nullptr;
+   }
+   if (gSystem->AccessPathName(cachedir, kFileExists))
+      gSystem->mkdir(cachedir, kTRUE);
+   if (gSystem->AccessPathName(cachedir, kWritePermission)) {
+      ::Error("TFile::SetBlockCacheDir", "no sufficient permissions on cache directory %s or cannot create it", cachedir);
+      return nullptr;
+   }
+   return std::make_shared<ROOT::Internal::RFileBlockCache>(cachedir, maxbytes, blocksize);
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Sets the directory of the local cache of the blocks of remote files.
+///
+/// The remote files (e.g. root://, http:// or https://) opened afterwards in
+/// read mode read their data in blocks of `blockSize` bytes, which are kept in
+/// `cacheDir` and reused by all the processes sharing the directory, e.g. the
+/// jobs of an analysis running repeatedly on the same node. A block is
+/// identified by the URL, the UUID, the modification date, the size and the
+/// position of the keys of its file, such that the blocks of a file which was
+/// rewritten or updated are not reused. When the
+/// directory grows beyond `maxBytes` the least recently used blocks are removed.
+/// An empty `cacheDir` disables the cache.
+///
+/// By default the cache is configured by the rootrc entries TFile.BlockCacheDir,
+/// TFile.BlockCacheSize (in MB) and TFile.BlockCacheBlockSize (in kB).
+/// The hit rate and the amount of data served are returned by
+/// `TFile::GetBlockCache()->GetStats()`.
+///
+/// Returns kFALSE if the directory cannot be created or used.
+
+Bool_t TFile::SetBlockCacheDir(const char *cacheDir, Long64_t maxBytes, Int_t blockSize)
+{
+   auto cache = MakeBlockCache(cacheDir, maxBytes, blockSize);
+   std::lock_guard<std::mutex> lock(gBlockCacheMutex);
+   gBlockCacheConfigured = true;
+   gBlockCache = cache;
+   return cache || !cacheDir || !*cacheDir;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the local cache of the blocks of remote files, nullptr if none.
+/// See TFile::SetBlockCacheDir.
+
+std::shared_ptr<ROOT::Internal::RFileBlockCache> TFile::GetBlockCache()
+{
+   std::lock_guard<std::mutex> lock(gBlockCacheMutex);
+   if (!gBlockCacheConfigured) {
+      gBlockCacheConfigured = true;
+      gBlockCache = MakeBlockCache(gEnv->GetValue("TFile.BlockCacheDir", ""),
+                                   gEnv->GetValue("TFile.BlockCacheSize", 10000) * 1000000LL,
+                                   gEnv->GetValue("TFile.BlockCacheBlockSize", 1024) * 1024);
+   }
+   return gBlockCache;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Sets open timeout time (in ms). Returns previous timeout value.
 
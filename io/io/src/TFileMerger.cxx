@@ -20,6 +20,11 @@ any of its remote file access plugins. It is therefore useful in
 a Grid environment where the files might be accessible only remotely.
 The merging interface allows files containing histograms and trees
 to be merged, like the standalone hadd program.
+
+When implicit multi-threading is enabled (ROOT::EnableImplicitMT()) and the
+histograms are merged in one go (the default), the instances of a histogram
+in the different input files are read and decompressed concurrently, by
+as many threads as the implicit multi-threading pool has, before being merged.
 */
 
 #include "TFileMerger.h"
@@ -49,7 +54,14 @@ to be merged, like the standalone hadd program.
 #include <sys/resource.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 ClassImp(TFileMerger);
 
@@ -445,6 +457,110 @@ Bool_t WriteCycleInOrder(const TString &name, TIter &nextkey, TIter &peeknextkey
    return WriteOneAndDelete(name, cl, obj, kFALSE, kTRUE, target) && result;
 };
 
+/// Threads reading the objects of the keys of a histogram in the different input files, see TFileMerger::MergeOne().
+/// They are started once per TFileMerger::PartialMerge() rather than once per histogram: RIO does not depend on the
+/// Imt library and cannot submit tasks to the implicit multi-threading pool.
+class RReadWorkers {
+   std::vector<std::thread> fThreads;
+   std::mutex fMutex;
+   std::condition_variable fCvWork;        ///< Signals a new batch of keys or the stop
+   std::condition_variable fCvDone;        ///< Signals that no worker reads the current batch anymore
+   const std::vector<TKey *> *fKeys = nullptr; ///< The current batch, null once it is read
+   std::vector<TObject *> *fObjs = nullptr;    ///< The objects of the current batch
+   std::atomic<std::size_t> fNext{0};      ///< Next key of the current batch to be read
+   std::size_t fNBusy = 0;                 ///< Number of workers reading the current batch
+   unsigned int fBatch = 0;                ///< Number of batches submitted so far
+   bool fStop = false;
+   std::atomic<Long64_t> fNRead{0};        ///< Number of keys read so far
+
+   void ReadKeys(const std::vector<TKey *> &keys, std::vector<TObject *> &objs)
+   {
+      for (std::size_t i = fNext++; i < keys.size(); i = fNext++) {
+         if (keys[i]) {
+            objs[i] = keys[i]->ReadObj();
+            ++fNRead;
+         }
+      }
+   }
+
+   void Work()
+   {
+      unsigned int batch = 0;
+      std::unique_lock<std::mutex> lock(fMutex);
+      while (true) {
+         fCvWork.wait(lock, [&] { return fStop || fBatch != batch; });
+         if (fStop)
+            return;
+         batch = fBatch;
+         if (!fKeys)
+            continue;
+         auto keys = fKeys;
+         auto objs = fObjs;
+         ++fNBusy;
+         lock.unlock();
+         ReadKeys(*keys, *objs);
+         lock.lock();
+         if (--fNBusy == 0)
+            fCvDone.notify_all();
+      }
+   }
+
+public:
+   /// Start `nThreads` threads, in addition to the one calling Read().
+   explicit RReadWorkers(UInt_t nThreads)
+   {
+      for (UInt_t i = 0; i < nThreads; ++i)
+         fThreads.emplace_back(&RReadWorkers::Work, this);
+   }
+
+   ~RReadWorkers()
+   {
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fStop = true;
+      }
+      fCvWork.notify_all();
+      for (auto &t : fThreads)
+         t.join();
+   }
+
+   UInt_t GetNThreads() const { return fThreads.size() + 1; }
+   Long64_t GetNRead() const { return fNRead; }
+
+   /// Read the objects of `keys` concurrently; the keys must belong to different files.
+   /// The objects are returned in the order of the keys, null for the null keys and for the failed reads.
+   std::vector<TObject *> Read(const std::vector<TKey *> &keys)
+   {
+      std::vector<TObject *> objs(keys.size(), nullptr);
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fKeys = &keys;
+         fObjs = &objs;
+         fNext = 0;
+         ++fBatch;
+      }
+      fCvWork.notify_all();
+      ReadKeys(keys, objs);
+      std::unique_lock<std::mutex> lock(fMutex);
+      fCvDone.wait(lock, [this] { return fNBusy == 0; });
+      fKeys = nullptr;
+      fObjs = nullptr;
+      return objs;
+   }
+};
+
+/// The read workers of the PartialMerge() running in this thread, if any.
+thread_local RReadWorkers *gReadWorkers = nullptr;
+
+/// Make the read workers available to MergeOne() for the lifetime of the instance.
+class RReadWorkersContext {
+   RReadWorkers *fPrevious;
+
+public:
+   explicit RReadWorkersContext(RReadWorkers *workers) : fPrevious(gReadWorkers) { gReadWorkers = workers; }
+   ~RReadWorkersContext() { gReadWorkers = fPrevious; }
+};
+
 } // anonymous namespace
 
 Bool_t TFileMerger::MergeOne(TDirectory *target, TList *sourcelist, Int_t type, TFileMergeInfo &info,
@@ -625,6 +741,50 @@ Bool_t TFileMerger::MergeOne(TDirectory *target, TList *sourcelist, Int_t type,
          ROOT::MergeFunc_t func = cl->GetMerge();
          func(obj, &inputs, &info);
          info.fIsFirst = kFALSE;
+      } else if (oneGo && gReadWorkers) {
+         // All the inputs are kept in memory anyway: read (and decompress) them from the
+         // different files concurrently, then merge them in one go as below.
+         std::vector<TFile *> files;
+         std::vector<TObject *> liveobjs;
+         std::vector<TKey *> keys;
+         for (; nextsource; nextsource = (TFile*)sourcelist->After(nextsource)) {
+            TDirectory *ndir = getDirectory(nextsource, target->GetName(), path);
+            if (!ndir)
+               continue;
+            ndir->cd();
+            TObject *hobj = ndir->GetList()->FindObject(keyname);
+            files.push_back(nextsource);
+            liveobjs.push_back(hobj);
+            keys.push_back(hobj ? nullptr : (TKey*)ndir->GetListOfKeys()->FindObject(keyname));
+         }
+         std::vector<TObject *> readobjs = gReadWorkers->Read(keys);
+         for (std::size_t i = 0; i < files.size(); ++i) {
+            if (keys[i] && !readobjs[i]) {
+               Info("MergeRecursive", "could not read object for key {%s, %s}; skipping file %s",
+                    keyname, keytitle, files[i]->GetName());
+               for (auto hobj : readobjs)
+                  delete hobj;
+               return kTRUE;
+            }
+         }
+         for (std::size_t i = 0; i < files.size(); ++i) {
+            TObject *hobj = keys[i] ? readobjs[i] : liveobjs[i];
+            if (!hobj)
+               continue;
+            if (keys[i])
+               todelete.Add(hobj);
+            // Set ownership for collections
+            if (hobj->InheritsFrom(TCollection::Class())) {
+               ((TCollection*)hobj)->SetOwner();
+            }
+            hobj->ResetBit(kMustCleanup);
+            inputs.Add(hobj);
+         }
+         ROOT::MergeFunc_t func = cl->GetMerge();
+         func(obj, &inputs, &info);
+         info.fIsFirst = kFALSE;
+         inputs.Clear();
+         todelete.Delete();
       } else {
          do {
             // make sure we are at the correct directory level by cd'ing to path
@@ -962,6 +1122,11 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
 
    TDirectory::TContext ctxt;
 
+   std::unique_ptr<RReadWorkers> readWorkers;
+   if (fHistoOneGo && ROOT::IsImplicitMTEnabled() && ROOT::GetThreadPoolSize() > 1)
+      readWorkers = std::make_unique<RReadWorkers>(ROOT::GetThreadPoolSize() - 1);
+   RReadWorkersContext readWorkersCtxt(readWorkers.get());
+
    Bool_t result = kTRUE;
    Int_t type = in_type;
    while (result && fFileList.GetEntries()>0) {
@@ -1014,6 +1179,8 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
          fOutputFile->Close();
       }
    }
+   if (readWorkers && fPrintLevel > 0)
+      Info("PartialMerge", "read %lld objects with %u threads", readWorkers->GetNRead(), readWorkers->GetNThreads());
 
    // Cleanup
    if (in_type & kIncremental) {
@@ -524,8 +524,11 @@ void TKey::Create(Int_t nbytes, TFile* externFile)
 
 TKey::~TKey()
 {
-   if (fMotherDir && fMotherDir->GetListOfKeys())
-      fMotherDir->GetListOfKeys()->Remove(this);
+   // Do not create the keys still in the key index of the directory just to remove this one
+   auto dirFile = dynamic_cast<TDirectoryFile *>(fMotherDir);
+   TList *keys = dirFile ? dirFile->GetListOfLoadedKeys() : (fMotherDir ? fMotherDir->GetListOfKeys() : nullptr);
+   if (keys)
+      keys->Remove(this);
    TKey::DeleteBuffer();
 }
 
@@ -749,6 +752,9 @@ void TKey::Print(Option_t *) const
 
 TObject *TKey::ReadObj()
 {
+   // The classes of the file may only be known from its StreamerInfo record
+   if (TFile *file = GetFile())
+      file->ReadPendingStreamerInfo();
    TClass *cl = TClass::GetClass(fClassName.Data());
    if (!cl) {
       Error("ReadObj", "Unknown class %s", fClassName.Data());
@@ -883,6 +889,8 @@ TObject *TKey::ReadObj()
 
 TObject *TKey::ReadObjWithBuffer(char *bufferRead)
 {
+   if (TFile *file = GetFile())
+      file->ReadPendingStreamerInfo();
 
    TClass *cl = TClass::GetClass(fClassName.Data());
    if (!cl) {
@@ -1014,6 +1022,8 @@ TObject *TKey::ReadObjWithBuffer(char *bufferRead)
 
 void *TKey::ReadObjectAny(const TClass* expectedClass)
 {
+   if (TFile *file = GetFile())
+      file->ReadPendingStreamerInfo();
    TBufferFile bufferRef(TBuffer::kRead, fObjlen+fKeylen);
    if (!bufferRef.Buffer()) {
       Error("ReadObj", "Cannot allocate buffer: fObjlen = %d", fObjlen);
@@ -1148,6 +1158,8 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
 
 Int_t TKey::Read(TObject *obj)
 {
+   if (TFile *file = GetFile())
+      file->ReadPendingStreamerInfo();
    if (!obj || (GetFile()==0)) return 0;
 
    TBufferFile bufferRef(TBuffer::kRead, fObjlen+fKeylen);
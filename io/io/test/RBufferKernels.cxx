@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+
+#include "ROOT/RBufferKernels.hxx"
+#include "TBufferFile.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace ROOT::Internal::RBufferKernels;
+
+namespace {
+
+const EISA kAllISAs[] = {EISA::kScalar, EISA::kSSSE3, EISA::kAVX2, EISA::kNEON};
+const char *const kISANames[] = {"scalar", "SSSE3", "AVX2", "NEON"};
+
+std::vector<char> RandomBytes(std::size_t n)
+{
+   std::mt19937 gen(42);
+   std::vector<char> bytes(n);
+   for (auto &b : bytes)
+      b = static_cast<char>(gen());
+   return bytes;
+}
+
+/// Restore the automatically selected kernels at the end of a test.
+class RBufferKernelsTest : public ::testing::Test {
+   EISA fDefault = GetBufferKernelsISA();
+
+protected:
+   void TearDown() override { SetBufferKernelsISA(fDefault); }
+};
+
+} // anonymous namespace
+
+TEST_F(RBufferKernelsTest, ByteSwap)
+{
+   // odd sizes and an unaligned source exercise the tails of the vectorized loops
+   const auto src = RandomBytes(8 * 77 + 1);
+   for (auto isa : kAllISAs) {
+      if (!SetBufferKernelsISA(isa))
+         continue;
+      for (std::size_t n : {0, 1, 3, 8, 17, 77}) {
+         std::vector<char> dst16(2 * n), dst32(4 * n), dst64(8 * n);
+         ByteSwapCopy16(dst16.data(), src.data() + 1, n);
+         ByteSwapCopy32(dst32.data(), src.data() + 1, n);
+         ByteSwapCopy64(dst64.data(), src.data() + 1, n);
+         for (std::size_t i = 0; i < 2 * n; ++i)
+            EXPECT_EQ(dst16[i], src[1 + (i / 2) * 2 + 1 - i % 2]) << kISANames[static_cast<int>(isa)];
+         for (std::size_t i = 0; i < 4 * n; ++i)
+            EXPECT_EQ(dst32[i], src[1 + (i / 4) * 4 + 3 - i % 4]) << kISANames[static_cast<int>(isa)];
+         for (std::size_t i = 0; i < 8 * n; ++i)
+            EXPECT_EQ(dst64[i], src[1 + (i / 8) * 8 + 7 - i % 8]) << kISANames[static_cast<int>(isa)];
+      }
+   }
+}
+
+TEST_F(RBufferKernelsTest, UnpackFloat16)
+{
+   const std::size_t n = 77;
+   const auto src = RandomBytes(3 * n + 1);
+   SetBufferKernelsISA(EISA::kScalar);
+   std::vector<std::vector<Float_t>> expectedF;
+   std::vector<std::vector<Double_t>> expectedD;
+   for (Int_t nbits = 1; nbits <= 16; ++nbits) {
+      expectedF.emplace_back(n);
+      expectedD.emplace_back(n);
+      UnpackFloat16(expectedF.back().data(), src.data() + 1, n, nbits);
+      UnpackFloat16(expectedD.back().data(), src.data() + 1, n, nbits);
+   }
+   std::vector<Double_t> expectedFloatToDouble(n / 4);
+   UnpackFloatToDouble(expectedFloatToDouble.data(), src.data() + 1, n / 4);
+
+   for (auto isa : kAllISAs) {
+      if (!SetBufferKernelsISA(isa))
+         continue;
+      for (Int_t nbits = 1; nbits <= 16; ++nbits) {
+         std::vector<Float_t> f(n);
+         std::vector<Double_t> d(n);
+         UnpackFloat16(f.data(), src.data() + 1, n, nbits);
+         UnpackFloat16(d.data(), src.data() + 1, n, nbits);
+         // compare the bits, the random input contains NaNs
+         EXPECT_EQ(0, std::memcmp(f.data(), expectedF[nbits - 1].data(), n * sizeof(Float_t)))
+            << kISANames[static_cast<int>(isa)] << " nbits " << nbits;
+         EXPECT_EQ(0, std::memcmp(d.data(), expectedD[nbits - 1].data(), n * sizeof(Double_t)))
+            << kISANames[static_cast<int>(isa)] << " nbits " << nbits;
+      }
+      std::vector<Double_t> d(n / 4);
+      UnpackFloatToDouble(d.data(), src.data() + 1, n / 4);
+      EXPECT_EQ(0, std::memcmp(d.data(), expectedFloatToDouble.data(), d.size() * sizeof(Double_t)))
+         << kISANames[static_cast<int>(isa)];
+   }
+}
+
+TEST_F(RBufferKernelsTest, TBufferFileRoundTrip)
+{
+   const Int_t n = 1001;
+   std::vector<Float_t> f(n);
+   std::vector<Double_t> d(n);
+   std::vector<Long64_t> l(n);
+   for (Int_t i = 0; i < n; ++i) {
+      f[i] = (i - 500) * 0.37f;
+      d[i] = (i - 500) * 1.3e-3;
+      l[i] = (i - 500) * 123456789012ll;
+   }
+
+   for (auto isa : kAllISAs) {
+      if (!SetBufferKernelsISA(isa))
+         continue;
+      TBufferFile buf(TBuffer::kWrite);
+      buf.WriteFastArray(f.data(), n);
+      buf.WriteFastArray(d.data(), n);
+      buf.WriteFastArray(l.data(), n);
+      buf.WriteFastArrayFloat16(f.data(), n);
+      buf.WriteFastArrayDouble32(d.data(), n);
+
+      buf.SetReadMode();
+      buf.SetBufferOffset(0);
+      std::vector<Float_t> f2(n), f16(n);
+      std::vector<Double_t> d2(n), d32(n);
+      std::vector<Long64_t> l2(n);
+      buf.ReadFastArray(f2.data(), n);
+      buf.ReadFastArray(d2.data(), n);
+      buf.ReadFastArray(l2.data(), n);
+      buf.ReadFastArrayFloat16(f16.data(), n);
+      buf.ReadFastArrayDouble32(d32.data(), n);
+      EXPECT_EQ(f, f2);
+      EXPECT_EQ(d, d2);
+      EXPECT_EQ(l, l2);
+      for (Int_t i = 0; i < n; ++i) {
+         // 12 bits of mantissa by default for Float16_t, float precision for Double32_t
+         EXPECT_NEAR(f16[i], f[i], std::abs(f[i]) / 4096) << kISANames[static_cast<int>(isa)];
+         EXPECT_FLOAT_EQ(d32[i], d[i]) << kISANames[static_cast<int>(isa)];
+      }
+   }
+}
@@ -0,0 +1,146 @@
+#include "gtest/gtest.h"
+
+#include "ROOT/RFileBlockCache.hxx"
+#include "TSystem.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using ROOT::Internal::RFileBlockCache;
+
+namespace {
+
+/// A remote file in memory, counting the vectored reads.
+struct RRemoteFile {
+   std::vector<char> fData;
+   int fNFetches = 0;
+
+   explicit RRemoteFile(std::size_t size) : fData(size)
+   {
+      for (std::size_t i = 0; i < size; ++i)
+         fData[i] = static_cast<char>(i * 7 + i / 251);
+   }
+
+   RFileBlockCache::FetchFunc_t GetFetch()
+   {
+      return [this](char *buf, Long64_t *pos, Int_t *len, Int_t nbuf) {
+         ++fNFetches;
+         for (Int_t i = 0; i < nbuf; ++i) {
+            memcpy(buf, fData.data() + pos[i], len[i]);
+            buf += len[i];
+         }
+         return false;
+      };
+   }
+};
+
+/// Sum the sizes of the blocks in the cache directory, optionally removing them.
+Long64_t ScanCacheDir(const std::string &dir, bool remove)
+{
+   Long64_t total = 0;
+   void *dirp = gSystem->OpenDirectory(dir.c_str());
+   if (!dirp)
+      return 0;
+   while (const char *sub = gSystem->GetDirEntry(dirp)) {
+      if (sub[0] == '.')
+         continue;
+      const std::string subPath = dir + "/" + sub;
+      void *subp = gSystem->OpenDirectory(subPath.c_str());
+      while (const char *name = gSystem->GetDirEntry(subp)) {
+         if (name[0] == '.')
+            continue;
+         const std::string path = subPath + "/" + name;
+         FileStat_t stat;
+         if (gSystem->GetPathInfo(path.c_str(), stat) == 0)
+            total += stat.fSize;
+         if (remove)
+            gSystem->Unlink(path.c_str());
+      }
+      gSystem->FreeDirectory(subp);
+      if (remove)
+         gSystem->Unlink(subPath.c_str());
+   }
+   gSystem->FreeDirectory(dirp);
+   if (remove)
+      gSystem->Unlink(dir.c_str());
+   return total;
+}
+
+} // anonymous namespace
+
+TEST(RFileBlockCache, Read)
+{
+   const std::string dir = "RFileBlockCacheRead";
+   RRemoteFile remote(10000);
+   RFileBlockCache cache(dir, 1000000, 1000);
+   const auto key = RFileBlockCache::MakeFileKey("root://host//file.root", "v1");
+
+   // blocks 0, 2, 3 and 9, the last one being shorter
+   Long64_t pos[] = {10, 2990, 9500};
+   Int_t len[] = {100, 20, 500};
+   auto check = [&](const std::vector<char> &buf) {
+      EXPECT_EQ(0, memcmp(buf.data(), remote.fData.data() + 10, 100));
+      EXPECT_EQ(0, memcmp(buf.data() + 100, remote.fData.data() + 2990, 20));
+      EXPECT_EQ(0, memcmp(buf.data() + 120, remote.fData.data() + 9500, 500));
+   };
+
+   std::vector<char> buf(620);
+   EXPECT_EQ(1, cache.Read(key, remote.fData.size(), buf.data(), pos, len, 3, remote.GetFetch()));
+   check(buf);
+   EXPECT_EQ(1, remote.fNFetches);
+   EXPECT_EQ(4u, cache.GetStats().fBlockMisses);
+   EXPECT_EQ(0u, cache.GetStats().fBlockHits);
+
+   std::vector<char> buf2(620);
+   EXPECT_EQ(1, cache.Read(key, remote.fData.size(), buf2.data(), pos, len, 3, remote.GetFetch()));
+   check(buf2);
+   EXPECT_EQ(1, remote.fNFetches);
+   EXPECT_EQ(4u, cache.GetStats().fBlockHits);
+   EXPECT_DOUBLE_EQ(0.5, cache.GetStats().GetHitRate());
+   EXPECT_EQ(1240u, cache.GetStats().fBytesServed);
+
+   // another version of the file does not share the blocks
+   const auto key2 = RFileBlockCache::MakeFileKey("root://host//file.root", "v2");
+   EXPECT_EQ(1, cache.Read(key2, remote.fData.size(), buf2.data(), pos, len, 3, remote.GetFetch()));
+   EXPECT_EQ(2, remote.fNFetches);
+
+   // ranges beyond the end of the file are not handled
+   Long64_t posEnd = 9990;
+   Int_t lenEnd = 20;
+   EXPECT_EQ(0, cache.Read(key, remote.fData.size(), buf.data(), &posEnd, &lenEnd, 1, remote.GetFetch()));
+
+   // failed fetches are reported
+   RFileBlockCache::FetchFunc_t failure = [](char *, Long64_t *, Int_t *, Int_t) { return true; };
+   const auto key3 = RFileBlockCache::MakeFileKey("root://host//other.root", "v1");
+   EXPECT_EQ(2, cache.Read(key3, remote.fData.size(), buf.data(), pos, len, 3, failure));
+
+   ScanCacheDir(dir, true);
+}
+
+TEST(RFileBlockCache, Quota)
+{
+   const std::string dir = "RFileBlockCacheQuota";
+   RRemoteFile remote(10000);
+   RFileBlockCache cache(dir, 5000, 1000);
+   const auto key = RFileBlockCache::MakeFileKey("root://host//file.root", "v1");
+
+   for (Long64_t pos = 0; pos < 10000; pos += 1000) {
+      std::vector<char> buf(1000);
+      Int_t len = 1000;
+      EXPECT_EQ(1, cache.Read(key, remote.fData.size(), buf.data(), &pos, &len, 1, remote.GetFetch()));
+      EXPECT_EQ(0, memcmp(buf.data(), remote.fData.data() + pos, len));
+   }
+   cache.Shrink();
+   EXPECT_LE(ScanCacheDir(dir, false), 5000);
+   EXPECT_GE(cache.GetStats().fBytesEvicted, 5000u);
+
+   // evicted blocks are fetched again
+   std::vector<char> buf(10000);
+   Long64_t pos = 0;
+   Int_t len = 10000;
+   EXPECT_EQ(1, cache.Read(key, remote.fData.size(), buf.data(), &pos, &len, 1, remote.GetFetch()));
+   EXPECT_EQ(remote.fData, buf);
+
+   ScanCacheDir(dir, true);
+}
@@ -12,6 +12,7 @@
 #include <future>
 #include <memory>
 #include <thread>
+#include <vector>
 #include <sys/stat.h>
 
 #include "gtest/gtest.h"
@@ -266,3 +267,127 @@ TEST(TBufferMerger, SetMaxTreeSize)
 
    RemoveFile("tbuffermerger_setmaxtreesize.root");
 }
+
+static void CheckTreeSum(const char *name, int nevents)
+{
+   TFile f{name};
+   std::unique_ptr<TTree> t{f.Get<TTree>("mytree")};
+   ASSERT_TRUE(t != nullptr);
+   EXPECT_EQ(t->GetEntries(), nevents);
+
+   long long sum{0};
+   int n{0};
+   t->SetBranchAddress("n", &n);
+   for (auto i = 0; i < t->GetEntries(); i++) {
+      t->GetEntry(i);
+      sum += n;
+   }
+
+   EXPECT_EQ(sum, (long long)nevents * (nevents - 1) / 2);
+}
+
+// Each writer fills increasing values of n, in ranges of nperwriter values
+static void CheckWriterOrder(const char *name, int nwriters, int nperwriter)
+{
+   TFile f{name};
+   std::unique_ptr<TTree> t{f.Get<TTree>("mytree")};
+   ASSERT_TRUE(t != nullptr);
+
+   std::vector<int> last(nwriters, -1);
+   int n{0};
+   t->SetBranchAddress("n", &n);
+   for (auto i = 0; i < t->GetEntries(); i++) {
+      t->GetEntry(i);
+      auto &l = last[n / nperwriter];
+      EXPECT_GT(n, l);
+      l = n;
+   }
+}
+
+TEST(TBufferMerger, MergeThreads)
+{
+   int nthreads = 8;
+   int nwrites = 8;
+   int events_per_write = 1024;
+
+   ROOT::EnableThreadSafety();
+
+   {
+      TBufferMerger merger("tbuffermerger_mergethreads.root");
+      merger.SetMergeThreads(4);
+      EXPECT_EQ(merger.GetMergeThreads(), 4u);
+
+      std::vector<std::thread> threads;
+      for (int i = 0; i < nthreads; ++i) {
+         threads.emplace_back([=, &merger]() {
+            auto myfile = merger.GetFile();
+            auto mytree = new TTree("mytree", "mytree");
+            int n = 0;
+            mytree->Branch("n", &n, "n/I");
+            for (int w = 0; w < nwrites; ++w) {
+               for (int e = 0; e < events_per_write; ++e) {
+                  n = (i * nwrites + w) * events_per_write + e;
+                  mytree->Fill();
+               }
+               myfile->Write();
+            }
+            mytree->ResetBranchAddresses();
+         });
+      }
+
+      for (auto &&t : threads)
+         t.join();
+   }
+
+   CheckTreeSum("tbuffermerger_mergethreads.root", nthreads * nwrites * events_per_write);
+   // The pre-merged buffers must not overtake the ones queued before them
+   CheckWriterOrder("tbuffermerger_mergethreads.root", nthreads, nwrites * events_per_write);
+
+   RemoveFile("tbuffermerger_mergethreads.root");
+}
+
+TEST(TBufferMerger, MaxBuffered)
+{
+   int nthreads = 8;
+   int nwrites = 8;
+   int events_per_write = 1024;
+
+   ROOT::EnableThreadSafety();
+
+   for (unsigned int mergeThreads : {0u, 2u}) {
+      {
+         TBufferMerger merger("tbuffermerger_maxbuffered.root");
+         // Smaller than a single buffer: the writers take turns, with at most one buffer queued
+         merger.SetMaxBuffered(1024);
+         merger.SetAutoSave(1024 * 1024);
+         merger.SetMergeThreads(mergeThreads);
+         EXPECT_EQ(merger.GetMaxBuffered(), 1024u);
+
+         std::vector<std::thread> threads;
+         for (int i = 0; i < nthreads; ++i) {
+            threads.emplace_back([=, &merger]() {
+               auto myfile = merger.GetFile();
+               auto mytree = new TTree("mytree", "mytree");
+               int n = 0;
+               mytree->Branch("n", &n, "n/I");
+               for (int w = 0; w < nwrites; ++w) {
+                  for (int e = 0; e < events_per_write; ++e) {
+                     n = (i * nwrites + w) * events_per_write + e;
+                     mytree->Fill();
+                  }
+                  myfile->Write();
+                  EXPECT_LE(merger.GetQueueSize(), 1u);
+               }
+               mytree->ResetBranchAddresses();
+            });
+         }
+
+         for (auto &&t : threads)
+            t.join();
+      }
+
+      CheckTreeSum("tbuffermerger_maxbuffered.root", nthreads * nwrites * events_per_write);
+
+      RemoveFile("tbuffermerger_maxbuffered.root");
+   }
+}
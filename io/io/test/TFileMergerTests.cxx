@@ -2,9 +2,17 @@
 
 #include "TFileMerger.h"
 
+#include "TFile.h"
+#include "TH1D.h"
 #include "TMemFile.h"
+#include "TROOT.h"
+#include "TSystem.h"
 #include "TTree.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 static void CreateATuple(TMemFile &file, const char *name, double value)
 {
    auto mytree = new TTree(name, "A tree");
@@ -68,3 +76,48 @@ TEST(TFileMerger, CreateWithUnwritableTFilePointer)
    ROOT_EXPECT_ERROR(merger.OutputFile(std::move(output)), "TFileMerger::OutputFile",
                      "output file output.root is not writable");
 }
+
+TEST(TFileMerger, MergeHistogramsImplicitMT)
+{
+   const int nFiles = 6;
+   const int nHistos = 20;
+   std::vector<std::string> names;
+   for (int i = 0; i < nFiles; ++i) {
+      names.push_back("TFileMergerImplicitMT" + std::to_string(i) + ".root");
+      TFile f(names.back().c_str(), "RECREATE");
+      TDirectory *dir = f.mkdir("dir");
+      for (int h = 0; h < nHistos; ++h) {
+         TH1D hist(("h" + std::to_string(h)).c_str(), "", 10, 0, 10);
+         hist.SetDirectory(nullptr);
+         hist.Fill(h % 10, i + 1);
+         dir->WriteObject(&hist, hist.GetName());
+      }
+   }
+
+   ROOT::EnableImplicitMT(4);
+   {
+      TFileMerger merger(kFALSE);
+      ASSERT_TRUE(merger.OutputFile("TFileMergerImplicitMT.root", "RECREATE"));
+      for (const auto &name : names)
+         merger.AddFile(name.c_str(), kFALSE);
+      // the histograms of all but the first file are read by the read workers
+      merger.SetPrintLevel(1);
+      ROOT::TestSupport::CheckDiagsRAII diags;
+      diags.requiredDiag(kInfo, "TFileMerger::PartialMerge",
+                         "read " + std::to_string((nFiles - 1) * nHistos) + " objects with 4 threads");
+      EXPECT_TRUE(merger.Merge());
+   }
+   ROOT::DisableImplicitMT();
+
+   TFile output("TFileMergerImplicitMT.root");
+   for (int h = 0; h < nHistos; ++h) {
+      std::unique_ptr<TH1D> hist{output.Get<TH1D>(("dir/h" + std::to_string(h)).c_str())};
+      ASSERT_TRUE(hist != nullptr);
+      EXPECT_DOUBLE_EQ(hist->GetBinContent(hist->FindBin(h % 10)), nFiles * (nFiles + 1) / 2);
+      EXPECT_EQ(hist->GetEntries(), nFiles);
+   }
+   output.Close();
+   for (const auto &name : names)
+      gSystem->Unlink(name.c_str());
+   gSystem->Unlink("TFileMergerImplicitMT.root");
+}
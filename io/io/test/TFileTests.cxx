@@ -1,10 +1,16 @@
 #include <memory>
+#include <string>
 #include <vector>
 
+#include <fcntl.h>
+
 #include "gtest/gtest.h"
 
+#include "ROOT/RFileBlockCache.hxx"
+#include "TDirectoryFile.h"
 #include "TFile.h"
 #include "TKey.h"
+#include "TList.h"
 #include "TNamed.h"
 #include "TPluginManager.h"
 #include "TROOT.h" // gROOT
@@ -109,6 +115,269 @@ TEST(TFile, ReadWithoutGlobalRegistrationLocal)
    gSystem->Unlink(localFile);
 }
 
+#ifndef R__WIN32
+TEST(TFile, WriteBehind)
+{
+   const auto filename = "TFileTestWriteBehind.root";
+   const auto nObjects = 500;
+   auto title = [](int i) { return std::string(100 + (i * 37) % 5000, 'a' + i % 26); };
+   {
+      TFile f(filename, "RECREATE");
+      // a small queue, such that writing blocks regularly
+      f.SetWriteBehind(10000);
+      EXPECT_EQ(f.GetWriteBehind(), 10000);
+      for (int i = 0; i < nObjects; ++i) {
+         TNamed named(("named" + std::to_string(i)).c_str(), title(i).c_str());
+         EXPECT_GT(f.WriteObject(&named, named.GetName()), 0);
+         if (i % 50 == 0) {
+            // reading back data possibly still in the queue
+            std::unique_ptr<TNamed> readBack{f.Get<TNamed>(named.GetName())};
+            ASSERT_TRUE(readBack != nullptr);
+            EXPECT_EQ(title(i), readBack->GetTitle());
+         }
+      }
+      f.Close();
+      EXPECT_FALSE(f.TestBit(TFile::kWriteError));
+      EXPECT_EQ(f.GetWriteBehind(), 0);
+   }
+
+   TFile input(filename);
+   ASSERT_FALSE(input.IsZombie());
+   EXPECT_FALSE(input.TestBit(TFile::kRecovered));
+   for (int i = 0; i < nObjects; ++i) {
+      std::unique_ptr<TNamed> named{input.Get<TNamed>(("named" + std::to_string(i)).c_str())};
+      ASSERT_TRUE(named != nullptr);
+      EXPECT_EQ(title(i), named->GetTitle());
+   }
+   input.Close();
+   gSystem->Unlink(filename);
+}
+#endif
+
+TEST(TFile, FastOpen)
+{
+   const auto filename = "TFileTestFastOpen.root";
+   {
+      TFile f(filename, "RECREATE");
+      TNamed named("named", "title");
+      std::vector<int> vec{1, 2, 3};
+      f.WriteObject(&named, "named");
+      f.WriteObject(&vec, "vec");
+      f.Close();
+   }
+
+   struct FastOpenGuard {
+      const Bool_t fOld = TFile::GetFastOpen();
+      ~FastOpenGuard() { TFile::SetFastOpen(fOld); }
+   } guard;
+   TFile::SetFastOpen();
+   EXPECT_TRUE(TFile::GetFastOpen());
+   {
+      TFile f(filename);
+      ASSERT_FALSE(f.IsZombie());
+      // the StreamerInfo record is not needed to list the keys, it is read with the first object
+      EXPECT_TRUE(f.IsStreamerInfoPending());
+      EXPECT_EQ(f.GetListOfKeys()->GetSize(), 2);
+      EXPECT_TRUE(f.IsStreamerInfoPending());
+      std::unique_ptr<std::vector<int>> vec{f.Get<std::vector<int>>("vec")};
+      EXPECT_FALSE(f.IsStreamerInfoPending());
+      ASSERT_TRUE(vec != nullptr);
+      EXPECT_EQ(*vec, std::vector<int>({1, 2, 3}));
+
+      // the StreamerInfo record must survive the update of a file opened in read mode
+      ASSERT_EQ(f.ReOpen("UPDATE"), 0);
+      TNamed other("other", "title");
+      f.WriteObject(&other, "other");
+      f.Close();
+   }
+   TFile::SetFastOpen(kFALSE);
+
+   TFile f(filename);
+   ASSERT_FALSE(f.IsZombie());
+   EXPECT_FALSE(f.IsStreamerInfoPending());
+   std::unique_ptr<TList> infos{f.GetStreamerInfoList()};
+   ASSERT_TRUE(infos != nullptr);
+   EXPECT_NE(infos->FindObject("TNamed"), nullptr);
+   std::unique_ptr<TNamed> named{f.Get<TNamed>("named")};
+   ASSERT_TRUE(named != nullptr);
+   EXPECT_STREQ(named->GetTitle(), "title");
+   f.Close();
+   gSystem->Unlink(filename);
+}
+
+TEST(TFile, KeyIndex)
+{
+   const auto filename = "TFileTestKeyIndex.root";
+   {
+      TFile f(filename, "RECREATE");
+      for (int i = 0; i < 100; ++i) {
+         TNamed named(("named" + std::to_string(i)).c_str(), "title");
+         f.WriteObject(&named, named.GetName());
+      }
+      // a second cycle
+      TNamed named("named7", "second");
+      f.WriteObject(&named, "named7");
+      auto dir = f.mkdir("dir");
+      dir->WriteObject(&named, "indir");
+      f.Close();
+   }
+
+   struct KeyIndexThresholdGuard {
+      ~KeyIndexThresholdGuard() { TDirectoryFile::SetKeyIndexThreshold(0); }
+   } guard;
+   TDirectoryFile::SetKeyIndexThreshold(10);
+   EXPECT_EQ(TDirectoryFile::GetKeyIndexThreshold(), 10);
+   {
+      TFile f(filename);
+      ASSERT_FALSE(f.IsZombie());
+      EXPECT_EQ(f.GetNkeys(), 102);
+      EXPECT_EQ(f.GetListOfLoadedKeys()->GetSize(), 0);
+
+      // only the keys of the looked up names are created
+      std::unique_ptr<TNamed> named{f.Get<TNamed>("named7")};
+      ASSERT_TRUE(named != nullptr);
+      EXPECT_STREQ(named->GetTitle(), "second");
+      named.reset(f.Get<TNamed>("named7;1"));
+      ASSERT_TRUE(named != nullptr);
+      EXPECT_STREQ(named->GetTitle(), "title");
+      EXPECT_EQ(f.GetListOfLoadedKeys()->GetSize(), 2);
+      EXPECT_EQ(f.GetKey("named42")->GetCycle(), 1);
+      EXPECT_EQ(f.GetKey("missing"), nullptr);
+      EXPECT_EQ(f.GetListOfLoadedKeys()->GetSize(), 3);
+      EXPECT_EQ(f.GetNkeys(), 102);
+
+      // the lookups in the subdirectories only create the keys of the subdirectories
+      TKey *inDir = f.FindKeyAny("indir");
+      ASSERT_TRUE(inDir != nullptr);
+      EXPECT_STREQ(inDir->GetMotherDir()->GetName(), "dir");
+      EXPECT_EQ(f.GetListOfLoadedKeys()->GetSize(), 4);
+      named.reset(static_cast<TNamed *>(f.FindObjectAny("indir")));
+      ASSERT_TRUE(named != nullptr);
+      EXPECT_STREQ(named->GetTitle(), "second");
+      EXPECT_EQ(f.FindKeyAny("missing"), nullptr);
+      EXPECT_EQ(f.GetListOfLoadedKeys()->GetSize(), 4);
+
+      named.reset(f.Get<TNamed>("dir/indir"));
+      ASSERT_TRUE(named != nullptr);
+
+      // the whole list keeps the order of the file
+      TList *keys = f.GetListOfKeys();
+      ASSERT_EQ(keys->GetSize(), 102);
+      EXPECT_STREQ(keys->At(0)->GetName(), "named0");
+      EXPECT_EQ(static_cast<TKey *>(keys->At(7))->GetCycle(), 2);
+      EXPECT_EQ(static_cast<TKey *>(keys->At(8))->GetCycle(), 1);
+      EXPECT_STREQ(keys->At(101)->GetName(), "dir");
+   }
+   {
+      // the keys are all created when the file becomes writable
+      TFile f(filename);
+      ASSERT_EQ(f.ReOpen("UPDATE"), 0);
+      EXPECT_EQ(f.GetListOfLoadedKeys()->GetSize(), 102);
+      TNamed named("named7", "third");
+      f.WriteObject(&named, "named7");
+      f.Close();
+   }
+   TDirectoryFile::SetKeyIndexThreshold(0);
+
+   TFile f(filename);
+   ASSERT_FALSE(f.IsZombie());
+   EXPECT_EQ(f.GetListOfKeys()->GetSize(), 103);
+   EXPECT_EQ(f.GetKey("named7")->GetCycle(), 3);
+   f.Close();
+   gSystem->Unlink(filename);
+}
+
+namespace {
+
+/// A local file that TFile takes for a remote one, such that it is read through the block cache.
+class TFakeRemoteFile : public TFile {
+public:
+   explicit TFakeRemoteFile(const char *path) : TFile(path, "WEB")
+   {
+      fUrl.SetProtocol("fakeremote");
+      fD = SysOpen(path, O_RDONLY, 0644);
+      Init(kFALSE);
+   }
+};
+
+/// Remove a directory, its subdirectories and their files.
+void RemoveDirectory(const std::string &dir)
+{
+   void *dirp = gSystem->OpenDirectory(dir.c_str());
+   if (!dirp)
+      return;
+   while (const char *name = gSystem->GetDirEntry(dirp)) {
+      const std::string entry = name;
+      if (entry == "." || entry == "..")
+         continue;
+      const std::string path = dir + "/" + entry;
+      FileStat_t stat;
+      if (gSystem->GetPathInfo(path.c_str(), stat) == 0 && R_ISDIR(stat.fMode))
+         RemoveDirectory(path);
+      else
+         gSystem->Unlink(path.c_str());
+   }
+   gSystem->FreeDirectory(dirp);
+   gSystem->Unlink(dir.c_str());
+}
+
+} // anonymous namespace
+
+TEST(TFile, BlockCacheUpdatedFile)
+{
+   const auto filename = "TFileTestBlockCache.root";
+   const std::string cacheDir = "TFileTestBlockCacheDir";
+   {
+      TFile f(filename, "RECREATE");
+      TNamed named("first", "title");
+      f.WriteObject(&named, "first");
+      f.Close();
+   }
+
+   struct BlockCacheGuard {
+      ~BlockCacheGuard() { TFile::SetBlockCacheDir(""); }
+   } guard;
+   ASSERT_TRUE(TFile::SetBlockCacheDir(cacheDir.c_str(), 100000000, 1024));
+   auto cache = TFile::GetBlockCache();
+   ASSERT_TRUE(cache != nullptr);
+
+   for (int i = 0; i < 2; ++i) {
+      TFakeRemoteFile f(filename);
+      ASSERT_FALSE(f.IsZombie());
+      std::unique_ptr<TNamed> named{f.Get<TNamed>("first")};
+      ASSERT_TRUE(named != nullptr);
+      EXPECT_STREQ(named->GetTitle(), "title");
+   }
+   // the second time the file is read from the cache
+   EXPECT_GT(cache->GetStats().fBlockHits, 0u);
+   const auto missesBefore = cache->GetStats().fBlockMisses;
+
+   // an update, likely within the same second as the creation: same UUID and modification date
+   {
+      TFile f(filename, "UPDATE");
+      TNamed named("second", "other title");
+      f.WriteObject(&named, "second");
+      f.Close();
+   }
+
+   {
+      TFakeRemoteFile f(filename);
+      ASSERT_FALSE(f.IsZombie());
+      EXPECT_EQ(f.GetNkeys(), 2);
+      std::unique_ptr<TNamed> named{f.Get<TNamed>("second")};
+      ASSERT_TRUE(named != nullptr);
+      EXPECT_STREQ(named->GetTitle(), "other title");
+      named.reset(f.Get<TNamed>("first"));
+      ASSERT_TRUE(named != nullptr);
+      EXPECT_STREQ(named->GetTitle(), "title");
+   }
+   // the blocks of the previous version were not reused
+   EXPECT_GT(cache->GetStats().fBlockMisses, missesBefore);
+
+   gSystem->Unlink(filename);
+   RemoveDirectory(cacheDir);
+}
+
 void TestReadWithoutGlobalRegistrationIfPossible(const char *fname)
 {
    TPluginHandler *h;
@@ -0,0 +1,59 @@
+/// \file RBufferKernelsBench.cxx
+///
+/// Print the throughput of the implementations of the TBufferFile array kernels available on this machine.
+/// This is not a test and is not run by ctest; run it by hand, e.g. `./rbufferkernels_bench [nElements]`.
+
+#include "ROOT/RBufferKernels.hxx"
+#include "TStopwatch.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace ROOT::Internal::RBufferKernels;
+
+namespace {
+
+const EISA kAllISAs[] = {EISA::kScalar, EISA::kSSSE3, EISA::kAVX2, EISA::kNEON};
+const char *const kISANames[] = {"scalar", "SSSE3", "AVX2", "NEON"};
+
+template <typename F>
+void Measure(const char *isaName, const char *kernel, std::size_t nbytes, int nRepetitions, F &&run)
+{
+   TStopwatch w;
+   for (int i = 0; i < nRepetitions; ++i)
+      run();
+   w.Stop();
+   const double seconds = w.RealTime();
+   std::cout << "   " << kernel << " [" << isaName << "]: "
+             << (seconds > 0 ? nRepetitions * nbytes / seconds / 1e9 : 0) << " GB/s\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+   const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1 << 20;
+   const int nRepetitions = 20;
+
+   std::mt19937 gen(42);
+   std::vector<char> src(8 * n);
+   for (auto &b : src)
+      b = static_cast<char>(gen());
+   std::vector<char> dst(8 * n);
+   std::vector<Float_t> f(n);
+   std::vector<Double_t> d(n);
+
+   std::cout << "Throughput for " << n << " elements, " << nRepetitions << " repetitions:\n";
+   for (auto isa : kAllISAs) {
+      if (!SetBufferKernelsISA(isa))
+         continue;
+      const char *name = kISANames[static_cast<int>(isa)];
+      Measure(name, "ByteSwapCopy32", 4 * n, nRepetitions, [&] { ByteSwapCopy32(dst.data(), src.data(), n); });
+      Measure(name, "ByteSwapCopy64", 8 * n, nRepetitions, [&] { ByteSwapCopy64(dst.data(), src.data(), n); });
+      Measure(name, "UnpackFloat16 ", 3 * n, nRepetitions, [&] { UnpackFloat16(f.data(), src.data(), n, 12); });
+      Measure(name, "UnpackFloat16D", 3 * n, nRepetitions, [&] { UnpackFloat16(d.data(), src.data(), n, 12); });
+   }
+   return 0;
+}
@@ -0,0 +1,32 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "CompressSpeedCLI.hxx"
+#include "CompressSpeed.hxx"
+
+#include <iostream>
+#include <stdexcept>
+
+using namespace CompressSpeed;
+
+int main(int argc, char **argv)
+{
+   auto args = ParseArgs(argc, argv);
+
+   if (!args.fShouldRun)
+      return 1; // ParseArgs has printed the --help or has encountered an issue and logged about it
+
+   try {
+      PrintResults(EvalCompression(args.fData, args.fNThreads), args.fData.fBandwidth);
+   } catch (const std::exception &e) {
+      std::cerr << e.what() << '\n';
+      return 1;
+   }
+
+   return 0;
+}
@@ -20,7 +20,19 @@ int main(int argc, char **argv)
    if (!args.fShouldRun)
       return 1; // ParseArgs has printed the --help, has run the --test or has encountered an issue and logged about it
 
-   PrintThroughput(EvalThroughput(args.fData, args.fNThreads));
+   if (args.fPerBranch) {
+      const auto results = EvalBranchThroughput(args.fData);
+      if (args.fJSON)
+         PrintBranchThroughputJSON(results);
+      else
+         PrintBranchThroughput(results);
+   } else {
+      const auto result = EvalThroughput(args.fData, args.fNThreads);
+      if (args.fJSON)
+         PrintThroughputJSON(result);
+      else
+         PrintThroughput(result);
+   }
 
    return 0;
 }
@@ -63,6 +63,9 @@ namespace ROOT {
 namespace Experimental {
 class RLogChannel;
 }
+namespace Internal {
+class RVectorReadPlan;
+}
 }
 
 ROOT::Experimental::RLogChannel &TDavixLogChannel();
@@ -75,6 +78,7 @@ private:
     Long64_t DavixReadBuffer(Davix_fd *fd, char *buf, Int_t len);
     Long64_t DavixPReadBuffer(Davix_fd *fd, char *buf, Long64_t pos, Int_t len);
     Long64_t DavixReadBuffers(Davix_fd *fd, char *buf, Long64_t *pos, Int_t *len, Int_t nbuf);
+    Long64_t DavixReadBuffersParallel(Davix_fd *fd, char *buf, ROOT::Internal::RVectorReadPlan &plan);
     Long64_t DavixWriteBuffer(Davix_fd *fd, const char *buf, Int_t len);
     Int_t DavixStat(struct stat *st) const;
 
@@ -40,6 +40,7 @@
 #include "TBase64.h"
 #include "TVirtualPerfStats.h"
 #include "TDavixFileInternal.h"
+#include "ROOT/RVectorReadPlan.hxx"
 #include "snprintf.h"
 
 #include <cerrno>
@@ -50,6 +51,8 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <atomic>
+#include <thread>
 
 
 static const std::string VERSION = "0.2.0";
@@ -409,6 +412,31 @@ void TDavixFileInternal::Close()
             davixErr->getErrMsg().c_str(), davixErr->getStatus());
       DavixError::clearError(&davixErr);
    }
+   for (auto fd : readVFds) {
+      if (davixPosix->close(fd, &davixErr))
+         DavixError::clearError(&davixErr);
+   }
+   readVFds.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return n additional descriptors of the file, opened on first use, to issue
+/// concurrent vector reads. Less are returned if they cannot be opened.
+
+std::vector<Davix_fd *> TDavixFileInternal::getReadVFileInstances(size_t n)
+{
+   TLockGuard l(&(openLock));
+   while (readVFds.size() < n) {
+      DavixError *davixErr = NULL;
+      Davix_fd *fd = davixPosix->open(davixParam, fUrl.GetUrl(), oflags, &davixErr);
+      if (fd == NULL) {
+         DavixError::clearError(&davixErr);
+         break;
+      }
+      davixPosix->fadvise(fd, 0, 300, Davix::AdviseRandom);
+      readVFds.push_back(fd);
+   }
+   return std::vector<Davix_fd *>(readVFds.begin(), readVFds.begin() + std::min(n, readVFds.size()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -633,6 +661,8 @@ void TDavixFileInternal::init()
    ConfigureDavixLogLevel();
    parseConfig();
    parseParams(opt);
+   readVGap = gEnv->GetValue(ENVPFX "ReadVGap", 0);
+   readVConnections = gEnv->GetValue(ENVPFX "ReadVConnections", 1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -755,6 +785,13 @@ Bool_t TDavixFile::ReadBuffer(char *buf, Int_t len)
 
 Bool_t TDavixFile::ReadBuffer(char *buf, Long64_t pos, Int_t len)
 {
+   Int_t st;
+   if ((st = ReadBuffersViaBlockCache(buf, &pos, &len, 1))) {
+      if (st == 2)
+         return kTRUE;
+      return kFALSE;
+   }
+
    Davix_fd *fd;
    if ((fd = d_ptr->getDavixFileInstance()) == NULL)
       return kTRUE;
@@ -789,13 +826,36 @@ Bool_t TDavixFile::ReadBufferAsync(Long64_t offs, Int_t len)
 
 Bool_t TDavixFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
 {
+   Int_t st;
+   if ((st = ReadBuffersViaBlockCache(buf, pos, len, nbuf))) {
+      if (st == 2)
+         return kTRUE;
+      return kFALSE;
+   }
+
    Davix_fd *fd;
    if ((fd = d_ptr->getDavixFileInstance()) == NULL)
       return kTRUE;
 
-   Long64_t ret = DavixReadBuffers(fd, buf, pos, len, nbuf);
+   // Ranges close to each other are read as one, the data in between is dropped; without coalescing (the default)
+   // the ranges are read directly into buf
+   ROOT::Internal::RVectorReadPlan plan(pos, len, nbuf, d_ptr->readVGap);
+   std::vector<char> coalescedBuf;
+   char *target = buf;
+   if (plan.IsCoalesced()) {
+      coalescedBuf.resize(plan.GetSize());
+      target = coalescedBuf.data();
+   }
+
+   Long64_t ret;
+   if (d_ptr->readVConnections > 1)
+      ret = DavixReadBuffersParallel(fd, target, plan);
+   else
+      ret = DavixReadBuffers(fd, target, plan.GetPositions(), plan.GetLengths(), plan.GetNRanges());
    if (ret < 0)
       return kTRUE;
+   if (target != buf)
+      plan.Scatter(target, buf, len);
 
    if (gDebug > 1)
       Info("ReadBuffers", "%lld bytes of data read from a list of %d buffers",
@@ -994,3 +1054,59 @@ Long64_t TDavixFile::DavixReadBuffers(Davix_fd *fd, char *buf, Long64_t *pos, In
 
    return ret;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the ranges of plan into buf, one after the other, splitting them over
+/// up to Davix.ReadVConnections concurrent vector reads, each one on its own
+/// descriptor of the file. Returns the number of bytes read, or -1 on failure.
+
+Long64_t TDavixFile::DavixReadBuffersParallel(Davix_fd *fd, char *buf, ROOT::Internal::RVectorReadPlan &plan)
+{
+   const auto groups = plan.Split(d_ptr->readVConnections, 128 * 1024, plan.GetNRanges());
+   std::vector<Davix_fd *> fds{fd};
+   if (groups.size() > 1) {
+      auto extraFds = d_ptr->getReadVFileInstances(std::min<size_t>(d_ptr->readVConnections, groups.size()) - 1);
+      fds.insert(fds.end(), extraFds.begin(), extraFds.end());
+   }
+   if (fds.size() < 2)
+      return DavixReadBuffers(fd, buf, plan.GetPositions(), plan.GetLengths(), plan.GetNRanges());
+
+   Double_t start_time = eventStart();
+   std::vector<std::string> errors(groups.size());
+   std::atomic<size_t> next{0};
+   auto work = [&](Davix_fd *groupFd) {
+      for (size_t i = next++; i < groups.size(); i = next++) {
+         const auto &g = groups[i];
+         std::vector<DavIOVecInput> in(g.fN);
+         std::vector<DavIOVecOuput> out(g.fN);
+         Long64_t offset = g.fOffset;
+         for (Int_t j = 0; j < g.fN; ++j) {
+            in[j].diov_buffer = &buf[offset];
+            in[j].diov_offset = plan.GetPositions()[g.fFirst + j];
+            in[j].diov_size = plan.GetLengths()[g.fFirst + j];
+            offset += in[j].diov_size;
+         }
+         DavixError *davixErr = NULL;
+         if (d_ptr->davixPosix->preadVec(groupFd, in.data(), out.data(), g.fN, &davixErr) < 0) {
+            errors[i] = davixErr->getErrMsg();
+            DavixError::clearError(&davixErr);
+         }
+      }
+   };
+   std::vector<std::thread> threads;
+   for (size_t i = 1; i < fds.size(); ++i)
+      threads.emplace_back(work, fds[i]);
+   work(fd);
+   for (auto &t : threads)
+      t.join();
+
+   for (const auto &error : errors) {
+      if (!error.empty()) {
+         Error("DavixReadBuffersParallel", "can not read data with davix: %s", error.c_str());
+         return -1;
+      }
+   }
+
+   eventStop(start_time, plan.GetSize());
+   return plan.GetSize();
+}
@@ -65,7 +65,9 @@ private:
       fUrl(mUrl),
       opt(mopt),
       oflags(0),
-      dirdVec() { }
+      dirdVec(),
+      readVGap(0),
+      readVConnections(1) { }
 
    TDavixFileInternal(const char* url, Option_t* mopt) :
       positionLock(),
@@ -77,7 +79,9 @@ private:
       fUrl(url),
       opt(mopt),
       oflags(0),
-      dirdVec() { }
+      dirdVec(),
+      readVGap(0),
+      readVConnections(1) { }
 
    ~TDavixFileInternal();
 
@@ -97,6 +101,8 @@ private:
 
    void Close();
 
+   std::vector<Davix_fd *> getReadVFileInstances(size_t n);
+
    void enableGridMode();
 
    void setAwsRegion(const std::string & region);
@@ -137,6 +143,10 @@ private:
    Option_t* opt;
    int oflags;
    std::vector<void*> dirdVec;
+   // Vector reads
+   std::vector<Davix_fd *> readVFds; // additional descriptors, for concurrent vector reads
+   Int_t readVGap;
+   Int_t readVConnections;
 
 public:
    Int_t DavixStat(const char *url, struct stat *st);
@@ -0,0 +1,72 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RVectorReadPlan
+#define ROOT_RVectorReadPlan
+
+#include "RtypesCore.h"
+
+#include <vector>
+
+namespace ROOT {
+namespace Internal {
+
+/**
+ * \class RVectorReadPlan
+ * \ingroup Net
+ *
+ * The requests sent for a vector read (TFile::ReadBuffers()) of a remote file.
+ *
+ * Ranges separated by at most a given gap are coalesced into a single range: the bytes of the gap are read and
+ * dropped, which costs less than a separate range when the latency of the server dominates. Without coalescing (a
+ * gap of 0), the ranges are kept as requested and can be read directly into the buffer of the caller. The ranges
+ * can then be split into contiguous groups of similar size, each one fetched with its own request, so that the
+ * groups can be fetched over concurrent connections.
+ */
+class RVectorReadPlan {
+public:
+   /// A contiguous group of coalesced ranges, fetched with one request.
+   struct RGroup {
+      Int_t fFirst = 0;     ///< Index of the first coalesced range of the group
+      Int_t fN = 0;         ///< Number of coalesced ranges in the group
+      Long64_t fOffset = 0; ///< Offset of the data of the group in the coalesced buffer
+      Long64_t fSize = 0;   ///< Number of bytes of the group
+   };
+
+private:
+   std::vector<Long64_t> fPos;    ///< Positions of the coalesced ranges
+   std::vector<Int_t> fLen;       ///< Lengths of the coalesced ranges
+   std::vector<Long64_t> fOffset; ///< Offset of each requested range in the coalesced buffer
+   Long64_t fSize = 0;            ///< Total length of the coalesced ranges
+
+public:
+   /// Coalesce the `nbuf` ranges at `pos` of lengths `len` which overlap or are at most `gap` bytes apart; a gap
+   /// of 0 or less disables coalescing, even of adjacent ranges. Only ranges following each other in the list, in
+   /// increasing order, are coalesced.
+   RVectorReadPlan(const Long64_t *pos, const Int_t *len, Int_t nbuf, Int_t gap);
+
+   Int_t GetNRanges() const { return fPos.size(); }
+   Long64_t *GetPositions() { return fPos.data(); }
+   Int_t *GetLengths() { return fLen.data(); }
+   /// Number of bytes of the coalesced ranges, including the gaps.
+   Long64_t GetSize() const { return fSize; }
+   /// Whether some requested ranges were coalesced; if not, the ranges are read directly into the caller's buffer.
+   bool IsCoalesced() const { return fPos.size() < fOffset.size(); }
+
+   /// Copy the requested ranges, of lengths `len`, from the coalesced data to `buf`, one after the other.
+   void Scatter(const char *coalesced, char *buf, const Int_t *len) const;
+
+   /// Split the coalesced ranges in about `nGroups` groups of similar size, of at least `minGroupSize` bytes (but for
+   /// the last one) and of at most `maxRanges` ranges each.
+   std::vector<RGroup> Split(Int_t nGroups, Long64_t minGroupSize, Int_t maxRanges) const;
+};
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -29,6 +29,12 @@
 class TSocket;
 class TWebSocket;
 
+namespace ROOT {
+namespace Internal {
+class RVectorReadPlan;
+}
+} // namespace ROOT
+
 
 class TWebFile : public TFile {
 
@@ -53,6 +59,8 @@ protected:
    TString           fBasicUrlOrg;      // save original url in case of temp redirection
    void             *fFullCache;        //! complete content of the file, some http server may return complete content
    Long64_t          fFullCacheSize;    //! size of the cached content
+   Int_t             fReadVGap{0};      //! ranges of a vector read at most this many bytes apart are fetched as one
+   Int_t             fReadVConnections{1}; //! number of concurrent connections fetching a vector read
 
    static TUrl       fgProxy;           // globally set proxy URL
    static Long64_t   fgMaxFullCacheSize; // maximal size of full-cached content, 500 MB by default
@@ -69,6 +77,8 @@ protected:
    virtual Int_t       GetFromCache(char *buf, Int_t len, Int_t nseg, Long64_t *seg_pos, Int_t *seg_len);
    virtual Bool_t      ReadBuffer10(char *buf, Int_t len);
    virtual Bool_t      ReadBuffers10(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf);
+           Bool_t      ReadRangesSerial10(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf);
+           Bool_t      ReadRangesParallel10(char *buf, ROOT::Internal::RVectorReadPlan &plan);
    virtual void        SetMsgReadBuffer10(const char *redirectLocation = nullptr, Bool_t tempRedirect = kFALSE);
    virtual void        ProcessHttpHeader(const TString& headerLine);
 
@@ -85,6 +95,11 @@ public:
    Bool_t      ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf) override;
    void        Seek(Long64_t offset, ERelativeTo pos = kBeg) override;
 
+   Int_t       GetReadVGap() const { return fReadVGap; }
+   void        SetReadVGap(Int_t gap) { fReadVGap = gap; }
+   Int_t       GetReadVConnections() const { return fReadVConnections; }
+   void        SetReadVConnections(Int_t n) { fReadVConnections = n; }
+
    static void        SetProxy(const char *url);
    static const char *GetProxy();
 
@@ -0,0 +1,71 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/RVectorReadPlan.hxx"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Coalesced ranges are read into buffers indexed with Int_t
+constexpr Long64_t kMaxCoalescedLength = 1 << 30;
+} // anonymous namespace
+
+ROOT::Internal::RVectorReadPlan::RVectorReadPlan(const Long64_t *pos, const Int_t *len, Int_t nbuf, Int_t gap)
+{
+   fOffset.reserve(nbuf);
+   for (Int_t i = 0; i < nbuf; ++i) {
+      if (gap > 0 && !fPos.empty()) {
+         const Long64_t start = fPos.back();
+         const Long64_t end = start + fLen.back();
+         if (pos[i] >= start && pos[i] + len[i] <= end) {
+            // Already covered by the current range
+            fOffset.push_back(fSize - (end - pos[i]));
+            continue;
+         }
+         if (pos[i] >= start && pos[i] - end <= gap && pos[i] + len[i] - start <= kMaxCoalescedLength) {
+            const Long64_t extension = pos[i] + len[i] - end;
+            fLen.back() += extension;
+            fSize += extension;
+            fOffset.push_back(fSize - len[i]);
+            continue;
+         }
+      }
+      fPos.push_back(pos[i]);
+      fLen.push_back(len[i]);
+      fOffset.push_back(fSize);
+      fSize += len[i];
+   }
+}
+
+void ROOT::Internal::RVectorReadPlan::Scatter(const char *coalesced, char *buf, const Int_t *len) const
+{
+   for (std::size_t i = 0; i < fOffset.size(); ++i) {
+      memcpy(buf, coalesced + fOffset[i], len[i]);
+      buf += len[i];
+   }
+}
+
+std::vector<ROOT::Internal::RVectorReadPlan::RGroup>
+ROOT::Internal::RVectorReadPlan::Split(Int_t nGroups, Long64_t minGroupSize, Int_t maxRanges) const
+{
+   const Long64_t target = std::max(fSize / std::max(nGroups, 1), minGroupSize);
+   std::vector<RGroup> groups;
+   RGroup group;
+   for (Int_t i = 0; i < GetNRanges(); ++i) {
+      if (group.fN > 0 && (group.fSize >= target || group.fN >= maxRanges)) {
+         groups.push_back(group);
+         group = RGroup{i, 0, group.fOffset + group.fSize, 0};
+      }
+      ++group.fN;
+      group.fSize += fLen[i];
+   }
+   if (group.fN > 0)
+      groups.push_back(group);
+   return groups;
+}
@@ -16,9 +16,18 @@
 // A TWebFile is like a normal TFile except that it reads its data      //
 // via a standard apache web server. A TWebFile is a read-only file.    //
 //                                                                      //
+// The ranges of a vector read (e.g. from the TTreeCache) separated by  //
+// at most TWebFile.ReadVGap bytes are fetched as a single range (0,    //
+// the default, disables it), and large vector reads are split over     //
+// up to TWebFile.ReadVConnections concurrent HTTP connections (1 by    //
+// default). Both can also be set per file, with SetReadVGap() and      //
+// SetReadVConnections().                                               //
+//                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
 #include "TWebFile.h"
+#include "ROOT/RVectorReadPlan.hxx"
+#include "TEnv.h"
 #include "TROOT.h"
 #include "TSocket.h"
 #include "Bytes.h"
@@ -34,6 +43,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #ifdef WIN32
 # ifndef EADDRINUSE
 #  define EADDRINUSE  10048
@@ -49,6 +63,11 @@ TUrl TWebFile::fgProxy;
 
 Long64_t TWebFile::fgMaxFullCacheSize = 500000000;
 
+// A vector read is split over several connections in groups of at least this many bytes
+static const Long64_t kMinReadVGroupSize = 128 * 1024;
+// Maximum number of ranges of a request
+static const Int_t kMaxReadVRanges = 200;
+
 
 // Internal class used to manage the socket that may stay open between
 // calls when HTTP/1.1 protocol is used
@@ -125,6 +144,187 @@ void TWebSocket::ReOpen()
 }
 
 
+namespace {
+
+// Buffered reading of an HTTP response from a socket descriptor, usable from any thread
+class TWebResponseReader {
+private:
+   int               fSock;
+   std::vector<char> fBuf;
+   Int_t             fBegin = 0;
+   Int_t             fEnd = 0;
+
+   Bool_t Fill()
+   {
+      fBegin = 0;
+      fEnd = gSystem->RecvRaw(fSock, fBuf.data(), fBuf.size(), kDontBlock);
+      if (fEnd <= 0) {
+         fEnd = 0;
+         return kFALSE;
+      }
+      return kTRUE;
+   }
+
+public:
+   TWebResponseReader(int sock) : fSock(sock), fBuf(65536) {}
+
+   // Read a line without its terminator; returns kFALSE at the end of the stream.
+   Bool_t ReadLine(TString &line)
+   {
+      line = "";
+      while (1) {
+         if (fBegin == fEnd && !Fill())
+            return kFALSE;
+         const char *start = fBuf.data() + fBegin;
+         const char *nl = (const char *) memchr(start, '\n', fEnd - fBegin);
+         if (nl) {
+            line.Append(start, nl - start);
+            fBegin += nl - start + 1;
+            if (line.EndsWith("\r"))
+               line.Chop();
+            return kTRUE;
+         }
+         line.Append(start, fEnd - fBegin);
+         fBegin = fEnd;
+         if (line.Length() > 8192)
+            return kFALSE;
+      }
+   }
+
+   // Read len bytes into buf, or skip them if buf is null.
+   Bool_t Read(char *buf, Long64_t len)
+   {
+      while (len > 0) {
+         if (fBegin == fEnd) {
+            if (buf && len >= (Long64_t) fBuf.size())
+               // Nothing buffered: receive large reads in place
+               return gSystem->RecvRaw(fSock, buf, len, kDefault) == len;
+            if (!Fill())
+               return kFALSE;
+         }
+         Int_t n = (Int_t) std::min<Long64_t>(len, fEnd - fBegin);
+         if (buf) {
+            memcpy(buf, fBuf.data() + fBegin, n);
+            buf += n;
+         }
+         fBegin += n;
+         len -= n;
+      }
+      return kTRUE;
+   }
+};
+
+// Parse the first and last byte of a "Content-Range: bytes first-last/total" header.
+Bool_t ParseContentRange(const TString &header, Long64_t &first, Long64_t &last)
+{
+   static const char *prefix = "Content-Range: bytes ";
+   if (!header.BeginsWith(prefix, TString::kIgnoreCase))
+      return kFALSE;
+   char *end = nullptr;
+   first = strtoll(header.Data() + strlen(prefix), &end, 10);
+   if (*end != '-')
+      return kFALSE;
+   last = strtoll(end + 1, nullptr, 10);
+   return kTRUE;
+}
+
+// Fetch the n ranges at the absolute positions pos of lengths len into buf, one after the other, with a
+// single request on a new connection to host:port. The request is msg (up to "Range: bytes=") followed by
+// the ranges. Only partial content answers are handled: returns kFALSE for anything else, leaving
+// redirections, complete content answers and errors to GetFromWeb10().
+Bool_t FetchRanges(const TString &host, Int_t port, const TString &msg, char *buf, const Long64_t *pos,
+                   const Int_t *len, Int_t n)
+{
+   TString req = msg;
+   std::vector<Long64_t> offset(n);
+   Long64_t total = 0;
+   for (Int_t i = 0; i < n; i++) {
+      if (i) req += ",";
+      req += pos[i];
+      req += "-";
+      req += pos[i] + len[i] - 1;
+      offset[i] = total;
+      total += len[i];
+   }
+   req += "\r\n\r\n";
+
+   int sock = gSystem->OpenConnection(host, port);
+   if (sock < 0)
+      return kFALSE;
+   struct TCloser {
+      int fSock;
+      ~TCloser() { gSystem->CloseConnection(fSock); }
+   } closer{sock};
+
+   if (gSystem->SendRaw(sock, req.Data(), req.Length(), kDefault) != req.Length())
+      return kFALSE;
+
+   TWebResponseReader reader(sock);
+   TString line;
+   if (!reader.ReadLine(line) || !line.BeginsWith("HTTP/1.") || TString(line(9, 3)).Atoi() != 206)
+      return kFALSE;
+
+   TString boundary;
+   Long64_t first = -1, last = -1;
+   while (reader.ReadLine(line) && line.Length() > 0) {
+      if (line.BeginsWith("Content-Type: multipart", TString::kIgnoreCase)) {
+         boundary = line(line.Index("boundary=") + 9, 1000);
+         if (boundary.Length() > 1 && boundary[0] == '"' && boundary[boundary.Length() - 1] == '"')
+            boundary = boundary(1, boundary.Length() - 2);
+         boundary = "--" + boundary;
+      } else {
+         ParseContentRange(line, first, last);
+      }
+   }
+
+   // The parts normally are the requested ranges, in order, but the server may merge some of them
+   std::vector<char> done(n, 0);
+   Int_t ndone = 0;
+   auto readPart = [&]() {
+      if (first < 0 || last < first || last - first + 1 > total)
+         return kFALSE;
+      const Long64_t partLen = last - first + 1;
+      for (Int_t i = 0; i < n; i++) {
+         if (!done[i] && pos[i] == first && len[i] == partLen) {
+            done[i] = 1;
+            ndone++;
+            return reader.Read(buf + offset[i], partLen);
+         }
+      }
+      std::vector<char> part(partLen);
+      if (!reader.Read(part.data(), partLen))
+         return kFALSE;
+      for (Int_t i = 0; i < n; i++) {
+         if (!done[i] && pos[i] >= first && pos[i] + len[i] <= last + 1) {
+            memcpy(buf + offset[i], part.data() + (pos[i] - first), len[i]);
+            done[i] = 1;
+            ndone++;
+         }
+      }
+      return kTRUE;
+   };
+
+   if (boundary.IsNull())
+      return readPart() && ndone == n;
+
+   const TString boundaryEnd = boundary + "--";
+   while (ndone < n && reader.ReadLine(line)) {
+      if (line == boundaryEnd)
+         break;
+      if (line != boundary)
+         continue;
+      first = last = -1;
+      while (reader.ReadLine(line) && line.Length() > 0)
+         ParseContentRange(line, first, last);
+      if (!readPart())
+         return kFALSE;
+   }
+   return ndone == n;
+}
+
+} // anonymous namespace
+
+
 ClassImp(TWebFile);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -220,6 +420,8 @@ void TWebFile::Init(Bool_t readHeadOnly)
    fHTTP11     = kFALSE;
    fFullCache  = 0;
    fFullCacheSize = 0;
+   fReadVGap   = gEnv->GetValue("TWebFile.ReadVGap", 0);
+   fReadVConnections = gEnv->GetValue("TWebFile.ReadVConnections", 1);
    SetMsgReadBuffer10();
 
    if ((err = GetHead()) < 0) {
@@ -500,6 +702,13 @@ Bool_t TWebFile::ReadBuffer10(char *buf, Int_t len)
 
 Bool_t TWebFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
 {
+   Int_t st;
+   if ((st = ReadBuffersViaBlockCache(buf, pos, len, nbuf))) {
+      if (st == 2)
+         return kTRUE;
+      return kFALSE;
+   }
+
    if (!fHasModRoot)
       return ReadBuffers10(buf, pos, len, nbuf);
 
@@ -551,6 +760,31 @@ Bool_t TWebFile::ReadBuffers10(char *buf,  Long64_t *pos, Int_t *len, Int_t nbuf
 {
    SetMsgReadBuffer10();
 
+   ROOT::Internal::RVectorReadPlan plan(pos, len, nbuf, fReadVGap);
+   const Bool_t coalesced = plan.IsCoalesced();
+   if (!coalesced && fReadVConnections <= 1)
+      return ReadRangesSerial10(buf, pos, len, nbuf);
+
+   // The coalesced ranges include the gaps between the requested ones
+   std::vector<char> coalescedBuf;
+   char *target = buf;
+   if (coalesced) {
+      coalescedBuf.resize(plan.GetSize());
+      target = coalescedBuf.data();
+   }
+   if (ReadRangesParallel10(target, plan))
+      return kTRUE;
+   if (coalesced)
+      plan.Scatter(target, buf, len);
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the nbuf ranges described in arrays pos and len with as few requests
+/// as possible, one after the other. Returns kTRUE in case of failure.
+
+Bool_t TWebFile::ReadRangesSerial10(char *buf,  Long64_t *pos, Int_t *len, Int_t nbuf)
+{
    TString msg = fMsgReadBuffer10;
 
    Int_t k = 0, n = 0, r, cnt = 0;
@@ -576,6 +810,86 @@ Bool_t TWebFile::ReadBuffers10(char *buf,  Long64_t *pos, Int_t *len, Int_t nbuf
    return kFALSE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read the ranges of plan into buf, one after the other, splitting them over
+/// up to fReadVConnections concurrent connections. The groups of ranges which
+/// cannot be fetched that way (HTTPS, redirections, servers not answering
+/// with partial content, ...) are read with ReadRangesSerial10().
+/// Returns kTRUE in case of failure.
+
+Bool_t TWebFile::ReadRangesParallel10(char *buf, ROOT::Internal::RVectorReadPlan &plan)
+{
+   TUrl connurl;
+   if (fProxy.IsValid())
+      connurl = fProxy;
+   else
+      connurl = fUrl;
+
+   std::vector<ROOT::Internal::RVectorReadPlan::RGroup> groups;
+   if (fReadVConnections > 1 && !fFullCache && strcmp(connurl.GetProtocol(), "http") == 0)
+      groups = plan.Split(fReadVConnections, kMinReadVGroupSize, kMaxReadVRanges);
+   if (groups.size() < 2)
+      return ReadRangesSerial10(buf, plan.GetPositions(), plan.GetLengths(), plan.GetNRanges());
+
+   Double_t start = 0;
+   if (gPerfStats) start = TTimeStamp();
+
+   std::vector<Long64_t> abspos(plan.GetPositions(), plan.GetPositions() + plan.GetNRanges());
+   for (auto &p : abspos)
+      p += fArchiveOffset;
+   // Resolve the host once, rather than in every connection
+   const TString host = gSystem->GetHostByName(connurl.GetHost()).GetHostAddress();
+   const Int_t port = connurl.GetPort();
+   const TString msg = fMsgReadBuffer10;
+   std::vector<char> fetched(groups.size(), 0);
+   std::atomic<std::size_t> next{0};
+   auto work = [&] {
+      for (std::size_t i = next++; i < groups.size(); i = next++) {
+         const auto &g = groups[i];
+         fetched[i] = FetchRanges(host, port, msg, buf + g.fOffset, abspos.data() + g.fFirst,
+                                  plan.GetLengths() + g.fFirst, g.fN);
+      }
+   };
+   std::vector<std::thread> threads;
+   for (std::size_t i = 1; i < std::min<std::size_t>(fReadVConnections, groups.size()); ++i)
+      threads.emplace_back(work);
+   work();
+   for (auto &t : threads)
+      t.join();
+
+   Long64_t nbytes = 0;
+   Int_t ncalls = 0;
+   for (std::size_t i = 0; i < groups.size(); ++i) {
+      const auto &g = groups[i];
+      if (fetched[i]) {
+         nbytes += g.fSize;
+         ncalls++;
+         continue;
+      }
+      if (gDebug > 0)
+         Info("ReadRangesParallel10", "fetching %d ranges from host %s with a single connection", g.fN,
+              fUrl.GetHost());
+      if (ReadRangesSerial10(buf + g.fOffset, plan.GetPositions() + g.fFirst, plan.GetLengths() + g.fFirst, g.fN))
+         return kTRUE;
+   }
+
+   // collect statistics
+   fBytesRead += nbytes;
+   fReadCalls += ncalls;
+#ifdef R__WIN32
+   SetFileBytesRead(GetFileBytesRead() + nbytes);
+   SetFileReadCalls(GetFileReadCalls() + ncalls);
+#else
+   fgBytesRead += nbytes;
+   fgReadCalls += ncalls;
+#endif
+
+   if (gPerfStats && nbytes)
+      gPerfStats->FileReadEvent(this, nbytes, start);
+
+   return kFALSE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Extract requested segments from the cached content.
 /// Such cache can be produced when server suddenly returns full data instead of segments
@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+
+#include "ROOT/RVectorReadPlan.hxx"
+
+#include <numeric>
+#include <vector>
+
+using ROOT::Internal::RVectorReadPlan;
+
+TEST(RVectorReadPlan, NoCoalescing)
+{
+   // Adjacent and contained ranges are not coalesced either: the ranges are read as requested
+   std::vector<Long64_t> pos{0, 100, 110, 115, 500};
+   std::vector<Int_t> len{100, 10, 20, 5, 50};
+   for (Int_t gap : {-1, 0}) {
+      RVectorReadPlan plan(pos.data(), len.data(), pos.size(), gap);
+      EXPECT_FALSE(plan.IsCoalesced());
+      ASSERT_EQ(5, plan.GetNRanges());
+      EXPECT_EQ(185, plan.GetSize());
+      for (std::size_t i = 0; i < pos.size(); ++i) {
+         EXPECT_EQ(pos[i], plan.GetPositions()[i]);
+         EXPECT_EQ(len[i], plan.GetLengths()[i]);
+      }
+   }
+
+   // Ranges too far apart to be coalesced
+   RVectorReadPlan plan(pos.data() + 3, len.data() + 3, 2, 100);
+   EXPECT_FALSE(plan.IsCoalesced());
+   EXPECT_EQ(2, plan.GetNRanges());
+}
+
+TEST(RVectorReadPlan, Coalescing)
+{
+   // Adjacent, overlapping, close, contained and far apart ranges
+   std::vector<Long64_t> pos{0, 10, 15, 40, 42, 1000, 980};
+   std::vector<Int_t> len{10, 10, 10, 5, 2, 10, 10};
+   RVectorReadPlan plan(pos.data(), len.data(), pos.size(), 20);
+   EXPECT_TRUE(plan.IsCoalesced());
+   ASSERT_EQ(3, plan.GetNRanges());
+   EXPECT_EQ(0, plan.GetPositions()[0]);
+   EXPECT_EQ(45, plan.GetLengths()[0]);
+   EXPECT_EQ(1000, plan.GetPositions()[1]);
+   EXPECT_EQ(10, plan.GetLengths()[1]);
+   // Ranges are only coalesced with the ones following them
+   EXPECT_EQ(980, plan.GetPositions()[2]);
+   EXPECT_EQ(65, plan.GetSize());
+
+   // The coalesced data holds the bytes of the file at the positions of the coalesced ranges
+   std::vector<char> coalesced;
+   for (Int_t i = 0; i < plan.GetNRanges(); ++i) {
+      for (Int_t j = 0; j < plan.GetLengths()[i]; ++j)
+         coalesced.push_back(static_cast<char>((plan.GetPositions()[i] + j) % 127));
+   }
+   std::vector<char> buf(std::accumulate(len.begin(), len.end(), 0));
+   plan.Scatter(coalesced.data(), buf.data(), len.data());
+   std::size_t k = 0;
+   for (std::size_t i = 0; i < pos.size(); ++i) {
+      for (Int_t j = 0; j < len[i]; ++j, ++k)
+         EXPECT_EQ(static_cast<char>((pos[i] + j) % 127), buf[k]) << "range " << i << " byte " << j;
+   }
+}
+
+TEST(RVectorReadPlan, Split)
+{
+   std::vector<Long64_t> pos;
+   std::vector<Int_t> len;
+   for (Int_t i = 0; i < 100; ++i) {
+      pos.push_back(i * 1000);
+      len.push_back(100);
+   }
+   RVectorReadPlan plan(pos.data(), len.data(), pos.size(), 0);
+   ASSERT_EQ(100, plan.GetNRanges());
+
+   auto groups = plan.Split(4, 0, 200);
+   ASSERT_EQ(4u, groups.size());
+   Long64_t offset = 0;
+   Int_t first = 0;
+   for (const auto &g : groups) {
+      EXPECT_EQ(first, g.fFirst);
+      EXPECT_EQ(offset, g.fOffset);
+      EXPECT_EQ(25, g.fN);
+      EXPECT_EQ(2500, g.fSize);
+      first += g.fN;
+      offset += g.fSize;
+   }
+
+   // Groups are not smaller than the minimum size, and hold at most the maximum number of ranges
+   EXPECT_EQ(2u, plan.Split(4, 5000, 200).size());
+   EXPECT_EQ(10u, plan.Split(1, 0, 10).size());
+}
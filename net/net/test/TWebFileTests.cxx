@@ -0,0 +1,280 @@
+#include "gtest/gtest.h"
+
+#include "TFile.h"
+#include "TRandom3.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TWebFile.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// A minimal HTTP/1.0 server of a single file, supporting HEAD and single or multiple range GET requests,
+/// counting the connections and the requested ranges.
+class RHttpFileServer {
+   std::string fData;
+   int fListen = -1;
+   int fPort = 0;
+   std::atomic<bool> fStop{false};
+   std::thread fAcceptThread;
+   std::mutex fMutex;
+   std::vector<std::thread> fConnectionThreads;
+
+   static void SendAll(int sock, const std::string &s)
+   {
+      std::size_t sent = 0;
+      while (sent < s.size()) {
+         auto n = send(sock, s.data() + sent, s.size() - sent, MSG_NOSIGNAL);
+         if (n <= 0)
+            return;
+         sent += n;
+      }
+   }
+
+   void Serve(int sock)
+   {
+      std::string request;
+      char buf[4096];
+      while (request.find("\r\n\r\n") == std::string::npos) {
+         auto n = recv(sock, buf, sizeof(buf), 0);
+         if (n <= 0) {
+            close(sock);
+            return;
+         }
+         request.append(buf, n);
+      }
+
+      const auto size = std::to_string(fData.size());
+      if (request.compare(0, 5, "HEAD ") == 0) {
+         SendAll(sock, "HTTP/1.0 200 OK\r\nContent-Length: " + size + "\r\n\r\n");
+         close(sock);
+         return;
+      }
+
+      // The ranges of "Range: bytes=a-b,c-d,..."
+      std::vector<std::pair<Long64_t, Long64_t>> ranges;
+      auto rangePos = request.find("Range: bytes=");
+      if (rangePos != std::string::npos) {
+         std::istringstream spec(request.substr(rangePos + 13, request.find("\r\n", rangePos) - rangePos - 13));
+         std::string range;
+         while (std::getline(spec, range, ',')) {
+            auto dash = range.find('-');
+            ranges.emplace_back(std::stoll(range.substr(0, dash)), std::stoll(range.substr(dash + 1)));
+         }
+      }
+      fNRequests++;
+      fNRanges += ranges.size();
+
+      auto contentRange = [&](const std::pair<Long64_t, Long64_t> &r) {
+         return "Content-Range: bytes " + std::to_string(r.first) + "-" + std::to_string(r.second) + "/" + size +
+                "\r\n";
+      };
+      auto content = [&](const std::pair<Long64_t, Long64_t> &r) {
+         return fData.substr(r.first, r.second - r.first + 1);
+      };
+      if (ranges.empty()) {
+         SendAll(sock, "HTTP/1.0 200 OK\r\nContent-Length: " + size + "\r\n\r\n" + fData);
+      } else if (ranges.size() == 1) {
+         SendAll(sock, "HTTP/1.0 206 Partial Content\r\n" + contentRange(ranges[0]) + "\r\n" + content(ranges[0]));
+      } else {
+         const std::string boundary = "THIS_STRING_SEPARATES";
+         std::string response =
+            "HTTP/1.0 206 Partial Content\r\nContent-Type: multipart/byteranges; boundary=" + boundary + "\r\n\r\n";
+         for (const auto &r : ranges) {
+            response += "\r\n--" + boundary + "\r\nContent-Type: application/octet-stream\r\n" + contentRange(r) +
+                        "\r\n" + content(r);
+         }
+         response += "\r\n--" + boundary + "--\r\n";
+         SendAll(sock, response);
+      }
+      close(sock);
+   }
+
+public:
+   std::atomic<int> fNConnections{0};
+   std::atomic<int> fNRequests{0};
+   std::atomic<int> fNRanges{0};
+
+   explicit RHttpFileServer(const std::string &fileName)
+   {
+      std::ifstream in(fileName, std::ios::binary);
+      fData.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+      fListen = socket(AF_INET, SOCK_STREAM, 0);
+      int one = 1;
+      setsockopt(fListen, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      sockaddr_in addr{};
+      addr.sin_family = AF_INET;
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      addr.sin_port = 0;
+      bind(fListen, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+      socklen_t addrLen = sizeof(addr);
+      getsockname(fListen, reinterpret_cast<sockaddr *>(&addr), &addrLen);
+      fPort = ntohs(addr.sin_port);
+      listen(fListen, 64);
+
+      fAcceptThread = std::thread([this] {
+         while (!fStop) {
+            pollfd pfd{fListen, POLLIN, 0};
+            if (poll(&pfd, 1, 50) <= 0)
+               continue;
+            int sock = accept(fListen, nullptr, nullptr);
+            if (sock < 0)
+               continue;
+            fNConnections++;
+            std::lock_guard<std::mutex> lock(fMutex);
+            fConnectionThreads.emplace_back(&RHttpFileServer::Serve, this, sock);
+         }
+      });
+   }
+
+   ~RHttpFileServer()
+   {
+      fStop = true;
+      fAcceptThread.join();
+      for (auto &t : fConnectionThreads)
+         t.join();
+      close(fListen);
+   }
+
+   std::string GetUrl(const std::string &fileName) const
+   {
+      return "http://127.0.0.1:" + std::to_string(fPort) + "/" + fileName;
+   }
+
+   const std::string &GetData() const { return fData; }
+};
+
+/// A file of incompressible content of a few MB, served over HTTP.
+class TWebFileTest : public ::testing::Test {
+protected:
+   static constexpr const char *fFileName = "TWebFileTests.root";
+   static constexpr Long64_t fNEntries = 200000;
+
+   static void SetUpTestSuite()
+   {
+      TFile f(fFileName, "RECREATE", "", 0);
+      TTree t("t", "t");
+      Double_t x;
+      Long64_t i;
+      t.Branch("x", &x, 8000);
+      t.Branch("i", &i, 8000);
+      TRandom3 rnd(1);
+      for (i = 0; i < fNEntries; ++i) {
+         x = rnd.Rndm();
+         t.Fill();
+      }
+      t.Write();
+   }
+
+   static void TearDownTestSuite() { gSystem->Unlink(fFileName); }
+};
+
+/// The ranges of the file at pos, of lengths len
+std::string GetRanges(const std::string &data, const std::vector<Long64_t> &pos, const std::vector<Int_t> &len)
+{
+   std::string ranges;
+   for (std::size_t i = 0; i < pos.size(); ++i)
+      ranges += data.substr(pos[i], len[i]);
+   return ranges;
+}
+
+} // anonymous namespace
+
+TEST_F(TWebFileTest, ReadBuffers)
+{
+   RHttpFileServer server(fFileName);
+   TWebFile f(server.GetUrl(fFileName).c_str());
+   ASSERT_FALSE(f.IsZombie());
+   ASSERT_EQ(static_cast<Long64_t>(server.GetData().size()), f.GetSize());
+
+   std::vector<Long64_t> pos;
+   std::vector<Int_t> len;
+   for (Long64_t p = 1000; p + 20000 < f.GetSize(); p += 50000) {
+      pos.push_back(p);
+      len.push_back(16000 + p % 1000);
+   }
+   const auto expected = GetRanges(server.GetData(), pos, len);
+
+   // One connection, no coalescing
+   std::string buf(expected.size(), '\0');
+   const auto nRanges = server.fNRanges.load();
+   ASSERT_FALSE(f.ReadBuffers(&buf[0], pos.data(), len.data(), pos.size()));
+   EXPECT_EQ(expected, buf);
+   EXPECT_EQ(pos.size(), static_cast<std::size_t>(server.fNRanges - nRanges));
+
+   // Split over concurrent connections
+   f.SetReadVConnections(4);
+   buf.assign(expected.size(), '\0');
+   const auto nConnections = server.fNConnections.load();
+   const auto nRequests = server.fNRequests.load();
+   ASSERT_FALSE(f.ReadBuffers(&buf[0], pos.data(), len.data(), pos.size()));
+   EXPECT_EQ(expected, buf);
+   EXPECT_GE(server.fNConnections - nConnections, 2);
+   EXPECT_GE(server.fNRequests - nRequests, 2);
+}
+
+TEST_F(TWebFileTest, ReadVGap)
+{
+   RHttpFileServer server(fFileName);
+   TWebFile f(server.GetUrl(fFileName).c_str());
+   ASSERT_FALSE(f.IsZombie());
+
+   std::vector<Long64_t> pos;
+   std::vector<Int_t> len;
+   for (Int_t i = 0; i < 20; ++i) {
+      pos.push_back(10000 + i * 150);
+      len.push_back(100);
+   }
+   // A range contained in the previous one
+   pos.push_back(pos.back() + 10);
+   len.push_back(50);
+   const auto expected = GetRanges(server.GetData(), pos, len);
+
+   f.SetReadVGap(64);
+   std::string buf(expected.size(), '\0');
+   const auto nRanges = server.fNRanges.load();
+   ASSERT_FALSE(f.ReadBuffers(&buf[0], pos.data(), len.data(), pos.size()));
+   EXPECT_EQ(expected, buf);
+   EXPECT_EQ(1, server.fNRanges - nRanges);
+}
+
+TEST_F(TWebFileTest, TreeCache)
+{
+   RHttpFileServer server(fFileName);
+   for (Int_t connections : {1, 4}) {
+      TWebFile f(server.GetUrl(fFileName).c_str());
+      ASSERT_FALSE(f.IsZombie());
+      f.SetReadVGap(4096);
+      f.SetReadVConnections(connections);
+      auto t = f.Get<TTree>("t");
+      ASSERT_NE(nullptr, t);
+      t->SetCacheSize(4 * 1024 * 1024);
+      Double_t x;
+      Long64_t i;
+      t->SetBranchAddress("x", &x);
+      t->SetBranchAddress("i", &i);
+      TRandom3 rnd(1);
+      ASSERT_EQ(fNEntries, t->GetEntries());
+      for (Long64_t e = 0; e < fNEntries; ++e) {
+         t->GetEntry(e);
+         ASSERT_EQ(e, i);
+         ASSERT_EQ(rnd.Rndm(), x);
+      }
+      delete t;
+   }
+}
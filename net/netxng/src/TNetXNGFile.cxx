@@ -473,6 +473,14 @@ Bool_t TNetXNGFile::ReadBuffers(char *buffer, Long64_t *position, Int_t *length,
    if (!IsUseable())
       return kTRUE;
 
+   // Try to read from the local block cache
+   Int_t status;
+   if ((status = ReadBuffersViaBlockCache(buffer, position, length, nbuffs))) {
+      if (status == 2)
+         return kTRUE;
+      return kFALSE;
+   }
+
    std::vector<ChunkList>      chunkLists;
    ChunkList                   chunks;
    std::vector<XRootDStatus*> *statuses;
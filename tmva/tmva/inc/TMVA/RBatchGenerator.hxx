@@ -0,0 +1,363 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef TMVA_RBATCHGENERATOR
+#define TMVA_RBATCHGENERATOR
+
+#include "TMVA/RTensor.hxx"
+#include "ROOT/RDataFrame.hxx"
+#include "ROOT/RDF/RInterface.hxx"
+#include "RtypesCore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TMVA {
+namespace Experimental {
+
+/**
+\class TMVA::Experimental::RBatchGenerator
+\brief Stream the content of an RDataFrame as batches of fixed size, e.g. to feed a training loop.
+
+The event loop runs on a background thread (and on the ROOT thread pool, if implicit multi-threading is enabled)
+while the consumer retrieves the batches with GetNextBatch(), so that datasets much larger than the available memory
+can be used without materializing them, e.g. with AsTensor or AsNumpy. A batch is a RTensor of shape
+`{batchSize, nColumns}` in row-major layout, with the values of the columns converted to float.
+
+The batches are filled into a fixed set of buffers that are allocated once: when the consumer lags behind, about
+`maxQueuedBatches` complete batches are kept and the event loop waits for the consumer. The tensor returned by
+GetNextBatch() is a view on one of these buffers, and it is only valid until the next call of GetNextBatch() or
+StopEpoch(): copy it to keep its content.
+
+If shuffling is enabled, every processing slot keeps a shuffle buffer with its share of `shuffleBufferSize` rows:
+every new row replaces a randomly chosen row of the buffer, which is moved to the batch being filled. Rows are
+therefore mixed over a window of entries that spans several clusters of the dataset, at the cost of
+`shuffleBufferSize` rows of memory. The order in which clusters are processed is not changed. The remaining rows are shuffled at the end of the
+epoch.
+
+The event loop of an epoch runs on the computation graph of the input node, so the generator needs exclusive use of
+that graph: StartEpoch() throws if other results are booked on it, since they would be computed by the background
+thread, and no other result must be booked or computed on the graph while an epoch is running. Stopping an epoch
+early with StopEpoch() or StartEpoch() ends the event loop without reading the remaining entries.
+
+~~~{.cpp}
+ROOT::RDataFrame df("tree", "file.root");
+TMVA::Experimental::RBatchGenerator<float, float, int> gen(df, {"x", "y", "label"}, 1024);
+for (unsigned int epoch = 0; epoch < nEpochs; ++epoch) {
+   gen.StartEpoch();
+   for (auto batch = gen.GetNextBatch(); batch.GetShape()[0] > 0; batch = gen.GetNextBatch())
+      Train(batch);
+}
+~~~
+\tparam ColTypes Types of the columns, which must be convertible to float.
+*/
+template <typename... ColTypes>
+class RBatchGenerator {
+   static_assert(sizeof...(ColTypes) > 0, "RBatchGenerator needs at least one column.");
+
+   static constexpr std::size_t kNoBuffer = std::numeric_limits<std::size_t>::max();
+   static constexpr std::size_t kNColumns = sizeof...(ColTypes);
+
+   /// State of a processing slot of the event loop.
+   struct RSlotState {
+      std::vector<float> fShuffleBuffer; ///< Rows that have not been moved to a batch yet
+      std::size_t fNShuffleRows{0};
+      std::mt19937_64 fRng;
+      std::size_t fBuffer{kNoBuffer}; ///< Index of the buffer of the batch being filled
+      std::size_t fBatchRows{0};      ///< Number of rows already in the batch being filled
+   };
+
+   ROOT::RDF::RNode fDataFrame; ///< The input node
+   std::vector<std::string> fColumns;
+   std::size_t fBatchSize;
+   std::size_t fShuffleBufferSize; ///< Number of rows in the shuffle buffer of each slot
+   std::size_t fMaxQueuedBatches;
+   bool fShuffle;
+   bool fDropRemainder;
+   ULong64_t fSeed;
+   unsigned int fEpoch{0};
+
+   std::vector<RTensor<float>> fBuffers; ///< Storage of the batches, allocated once
+   std::vector<RSlotState> fSlots;
+   RSlotState fRemainder; ///< Collects the rows left in the slots at the end of the epoch
+
+   std::mutex fMutex; ///< Protects all data members below
+   std::condition_variable fBufferFreed;
+   std::condition_variable fBatchReady;
+   std::deque<std::size_t> fFreeBuffers;
+   std::deque<std::pair<std::size_t, std::size_t>> fReadyBatches; ///< Buffer index and number of rows
+   std::size_t fConsumerBuffer{kNoBuffer};                        ///< Buffer seen by the consumer
+   bool fLoopDone{true};
+   std::atomic<bool> fStop{false}; ///< Also read without lock by the event loop
+   std::exception_ptr fError;
+   std::thread fLoopThread;
+
+   std::size_t AcquireBuffer()
+   {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fBufferFreed.wait(lock, [this] { return fStop || !fFreeBuffers.empty(); });
+      if (fStop)
+         return kNoBuffer;
+      const auto buffer = fFreeBuffers.front();
+      fFreeBuffers.pop_front();
+      return buffer;
+   }
+
+   void ReleaseBuffer(std::size_t buffer)
+   {
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fFreeBuffers.push_back(buffer);
+      }
+      fBufferFreed.notify_one();
+   }
+
+   void PushBatch(std::size_t buffer, std::size_t nRows)
+   {
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fReadyBatches.emplace_back(buffer, nRows);
+      }
+      fBatchReady.notify_one();
+   }
+
+   /// Queue the batch being filled by the slot if it has rows, otherwise give back its buffer.
+   void FlushBatch(RSlotState &s)
+   {
+      if (s.fBuffer == kNoBuffer)
+         return;
+      if (s.fBatchRows > 0)
+         PushBatch(s.fBuffer, s.fBatchRows);
+      else
+         ReleaseBuffer(s.fBuffer);
+      s.fBuffer = kNoBuffer;
+      s.fBatchRows = 0;
+   }
+
+   void AppendRow(RSlotState &s, const float *row)
+   {
+      if (s.fBuffer == kNoBuffer) {
+         s.fBuffer = AcquireBuffer();
+         if (s.fBuffer == kNoBuffer) // the epoch is being stopped, the row is dropped
+            return;
+      }
+      std::copy(row, row + kNColumns, fBuffers[s.fBuffer].GetData() + s.fBatchRows * kNColumns);
+      if (++s.fBatchRows == fBatchSize)
+         FlushBatch(s);
+   }
+
+   void ProcessRow(unsigned int slot, const float *row)
+   {
+      auto &s = fSlots[slot];
+      if (!fShuffle) {
+         AppendRow(s, row);
+         return;
+      }
+      auto &shuffleBuffer = s.fShuffleBuffer;
+      if (s.fNShuffleRows < fShuffleBufferSize) {
+         std::copy(row, row + kNColumns, shuffleBuffer.begin() + s.fNShuffleRows * kNColumns);
+         ++s.fNShuffleRows;
+         return;
+      }
+      // the shuffle buffer is full: a random row leaves it and the new row takes its place
+      std::uniform_int_distribution<std::size_t> dist(0, fShuffleBufferSize - 1);
+      const auto slotRow = shuffleBuffer.begin() + dist(s.fRng) * kNColumns;
+      AppendRow(s, &*slotRow);
+      std::copy(row, row + kNColumns, slotRow);
+   }
+
+   /// Move the content of the shuffle buffers and of the incomplete batches of all slots to complete batches.
+   void ProcessRemainders()
+   {
+      for (auto &s : fSlots) {
+         if (s.fBuffer != kNoBuffer) {
+            const float *data = fBuffers[s.fBuffer].GetData();
+            for (std::size_t i = 0; i < s.fBatchRows; ++i)
+               AppendRow(fRemainder, data + i * kNColumns);
+            ReleaseBuffer(s.fBuffer);
+            s.fBuffer = kNoBuffer;
+            s.fBatchRows = 0;
+         }
+         std::vector<std::size_t> order(s.fNShuffleRows);
+         std::iota(order.begin(), order.end(), 0);
+         std::shuffle(order.begin(), order.end(), s.fRng);
+         for (auto i : order)
+            AppendRow(fRemainder, s.fShuffleBuffer.data() + i * kNColumns);
+         s.fNShuffleRows = 0;
+      }
+      if (fRemainder.fBatchRows < fBatchSize && fDropRemainder)
+         fRemainder.fBatchRows = 0;
+      FlushBatch(fRemainder);
+   }
+
+   void RunEventLoop()
+   {
+      try {
+         fDataFrame.ForeachSlot(
+            [this](unsigned int slot, ColTypes... values) {
+               if (fStop) { // the epoch is being stopped: end the event loop
+                  ROOT::Internal::RDF::RequestStop(fDataFrame);
+                  return;
+               }
+               const float row[] = {static_cast<float>(values)...};
+               ProcessRow(slot, row);
+            },
+            fColumns);
+         ProcessRemainders();
+      } catch (...) {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fError = std::current_exception();
+      }
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fLoopDone = true;
+      }
+      fBatchReady.notify_all();
+   }
+
+public:
+   /// \param[in] rdf Node of the computation graph whose entries are streamed.
+   /// \param[in] columns Names of the columns, one per type in ColTypes.
+   /// \param[in] batchSize Number of rows per batch.
+   /// \param[in] shuffleBufferSize Number of rows kept to shuffle the entries, shared among the processing slots.
+   /// \param[in] maxQueuedBatches Maximum number of complete batches waiting for the consumer.
+   /// \param[in] shuffle Whether the rows are shuffled. If false, the rows of a batch are consecutive entries of the
+   /// dataset (in multi-thread runs, batches are still filled concurrently by different threads).
+   /// \param[in] seed Seed of the random number generators used for shuffling.
+   /// \param[in] dropRemainder Whether to drop the last batch of the epoch if it is incomplete.
+   RBatchGenerator(ROOT::RDF::RNode rdf, const std::vector<std::string> &columns, std::size_t batchSize,
+                   std::size_t shuffleBufferSize = 100000, std::size_t maxQueuedBatches = 4, bool shuffle = true,
+                   ULong64_t seed = 0, bool dropRemainder = true)
+      : fDataFrame(std::move(rdf)),
+        fColumns(columns),
+        fBatchSize(batchSize),
+        fShuffleBufferSize(shuffleBufferSize),
+        fMaxQueuedBatches(maxQueuedBatches),
+        fShuffle(shuffle && shuffleBufferSize > 0),
+        fDropRemainder(dropRemainder),
+        fSeed(seed)
+   {
+      if (fColumns.size() != kNColumns)
+         throw std::runtime_error("RBatchGenerator: " + std::to_string(fColumns.size()) +
+                                  " column names were passed for " + std::to_string(kNColumns) + " column types.");
+      if (fBatchSize == 0)
+         throw std::runtime_error("RBatchGenerator: the batch size must be larger than 0.");
+      if (fMaxQueuedBatches == 0)
+         throw std::runtime_error("RBatchGenerator: at least one batch must be allowed in the queue.");
+
+      const auto nSlots = fDataFrame.GetNSlots();
+      fSlots.resize(nSlots);
+      fShuffleBufferSize = std::max<std::size_t>(1, fShuffleBufferSize / nSlots);
+      if (fShuffle)
+         for (auto &s : fSlots)
+            s.fShuffleBuffer.resize(fShuffleBufferSize * kNColumns);
+
+      // one batch being filled per slot plus one for the remainders, the queued ones and the one of the consumer
+      const std::size_t nBuffers = nSlots + fMaxQueuedBatches + 2;
+      for (std::size_t i = 0; i < nBuffers; ++i)
+         fBuffers.emplace_back(RTensor<float>::Shape_t{fBatchSize, kNColumns});
+   }
+
+   RBatchGenerator(const RBatchGenerator &) = delete;
+   RBatchGenerator &operator=(const RBatchGenerator &) = delete;
+   ~RBatchGenerator() { StopEpoch(); }
+
+   /// Start the event loop that fills the batches of a new pass over the dataset, stopping the current one if needed.
+   /// Throws if other results are booked on the computation graph of the input node.
+   void StartEpoch()
+   {
+      StopEpoch();
+      if (ROOT::Internal::RDF::GetNBookedActions(fDataFrame) > 0)
+         throw std::runtime_error("RBatchGenerator: other results are booked on the computation graph of the input "
+                                  "node. They would be computed by the event loop of the generator, concurrently with "
+                                  "the rest of the program: compute them before starting an epoch.");
+      fFreeBuffers.clear();
+      for (std::size_t i = 0; i < fBuffers.size(); ++i)
+         fFreeBuffers.push_back(i);
+      fReadyBatches.clear();
+      fConsumerBuffer = kNoBuffer;
+      fError = nullptr;
+      fStop = false;
+      fLoopDone = false;
+      for (unsigned int slot = 0; slot < fSlots.size(); ++slot) {
+         std::seed_seq seq{fSeed, ULong64_t(fEpoch), ULong64_t(slot)};
+         fSlots[slot].fRng.seed(seq);
+      }
+      ++fEpoch;
+      fLoopThread = std::thread([this] { RunEventLoop(); });
+   }
+
+   /// Interrupt the event loop of the current epoch, if any, and wait for it to terminate.
+   void StopEpoch()
+   {
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fStop = true;
+      }
+      fBufferFreed.notify_all();
+      if (fLoopThread.joinable()) {
+         ROOT::Internal::RDF::RequestStop(fDataFrame);
+         fLoopThread.join();
+      }
+      for (auto &s : fSlots) {
+         s.fNShuffleRows = 0;
+         s.fBuffer = kNoBuffer;
+         s.fBatchRows = 0;
+      }
+      fRemainder.fBuffer = kNoBuffer;
+      fRemainder.fBatchRows = 0;
+   }
+
+   /// Return the next batch of the current epoch, waiting for it to be filled if needed.
+   /// At the end of the epoch, an empty tensor of shape `{0, nColumns}` is returned. The last batch of the epoch has
+   /// less than `batchSize` rows if `dropRemainder` is false. The returned tensor is a view on an internal buffer,
+   /// valid until the next call of GetNextBatch() or StopEpoch().
+   /// Errors that occurred during the event loop are rethrown here.
+   RTensor<float> GetNextBatch()
+   {
+      std::unique_lock<std::mutex> lock(fMutex);
+      if (fConsumerBuffer != kNoBuffer) {
+         fFreeBuffers.push_back(fConsumerBuffer);
+         fConsumerBuffer = kNoBuffer;
+         fBufferFreed.notify_one();
+      }
+      fBatchReady.wait(lock, [this] { return fLoopDone || !fReadyBatches.empty(); });
+      if (fReadyBatches.empty()) {
+         if (fError) {
+            auto error = fError;
+            fError = nullptr;
+            std::rethrow_exception(error);
+         }
+         return RTensor<float>(nullptr, {0, kNColumns});
+      }
+      const auto batch = fReadyBatches.front();
+      fReadyBatches.pop_front();
+      fConsumerBuffer = batch.first;
+      return RTensor<float>(fBuffers[batch.first].GetData(), {batch.second, kNColumns});
+   }
+
+   const std::vector<std::string> &GetColumnNames() const { return fColumns; }
+   std::size_t GetBatchSize() const { return fBatchSize; }
+};
+
+} // namespace Experimental
+} // namespace TMVA
+
+#endif // TMVA_RBATCHGENERATOR
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "TMVA/RBatchGenerator.hxx"
+#include "ROOT/RDataFrame.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+using namespace ROOT;
+using namespace TMVA::Experimental;
+
+namespace {
+
+/// Consume all batches of an epoch, checking their shape and content, and return the values of the first column.
+std::vector<float> ConsumeEpoch(RBatchGenerator<ULong64_t, int> &gen, std::size_t &nBatches)
+{
+   std::vector<float> values;
+   nBatches = 0;
+   gen.StartEpoch();
+   for (auto batch = gen.GetNextBatch(); batch.GetShape()[0] > 0; batch = gen.GetNextBatch()) {
+      EXPECT_EQ(batch.GetShape().size(), 2u);
+      EXPECT_EQ(batch.GetShape()[1], 2u);
+      EXPECT_LE(batch.GetShape()[0], gen.GetBatchSize());
+      for (std::size_t i = 0; i < batch.GetShape()[0]; i++) {
+         EXPECT_EQ(batch(i, 1), -batch(i, 0));
+         values.push_back(batch(i, 0));
+      }
+      ++nBatches;
+   }
+   return values;
+}
+
+} // namespace
+
+TEST(RBatchGenerator, Shuffled)
+{
+   const ULong64_t nEntries = 10007;
+   RDataFrame df(nEntries);
+   auto df2 = df.Define("x", [](ULong64_t e) { return e; }, {"rdfentry_"}).Define("y", [](ULong64_t e) {
+      return -int(e);
+   }, {"rdfentry_"});
+   RBatchGenerator<ULong64_t, int> gen(df2, {"x", "y"}, /*batchSize=*/100, /*shuffleBufferSize=*/1000,
+                                        /*maxQueuedBatches=*/2, /*shuffle=*/true, /*seed=*/42,
+                                        /*dropRemainder=*/false);
+
+   for (int epoch = 0; epoch < 2; ++epoch) {
+      std::size_t nBatches = 0;
+      auto values = ConsumeEpoch(gen, nBatches);
+      EXPECT_EQ(nBatches, 101u);
+      ASSERT_EQ(values.size(), nEntries);
+      EXPECT_FALSE(std::is_sorted(values.begin(), values.end()));
+      std::sort(values.begin(), values.end());
+      for (ULong64_t i = 0; i < nEntries; i++)
+         EXPECT_EQ(values[i], float(i));
+   }
+}
+
+TEST(RBatchGenerator, DropRemainder)
+{
+   RDataFrame df(1050);
+   auto df2 = df.Define("x", [](ULong64_t e) { return e; }, {"rdfentry_"}).Define("y", [](ULong64_t e) {
+      return -int(e);
+   }, {"rdfentry_"});
+   RBatchGenerator<ULong64_t, int> gen(df2, {"x", "y"}, /*batchSize=*/100, /*shuffleBufferSize=*/0);
+
+   std::size_t nBatches = 0;
+   auto values = ConsumeEpoch(gen, nBatches);
+   EXPECT_EQ(nBatches, 10u);
+   EXPECT_EQ(values.size(), 1000u);
+   // without shuffling and with a single thread, batches contain consecutive entries
+   EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+TEST(RBatchGenerator, StopEpoch)
+{
+   const ULong64_t nEntries = 100000;
+   std::atomic<ULong64_t> nRead{0};
+   RDataFrame df(nEntries);
+   auto df2 = df.Define("x",
+                        [&nRead](ULong64_t e) {
+                           ++nRead;
+                           return e;
+                        },
+                        {"rdfentry_"})
+                 .Define("y", [](ULong64_t e) { return -int(e); }, {"rdfentry_"});
+   RBatchGenerator<ULong64_t, int> gen(df2, {"x", "y"}, /*batchSize=*/64, /*shuffleBufferSize=*/256,
+                                        /*maxQueuedBatches=*/1);
+
+   // the event loop waits for the consumer, stopping the epoch must interrupt it
+   gen.StartEpoch();
+   for (int i = 0; i < 3; ++i)
+      EXPECT_EQ(gen.GetNextBatch().GetShape()[0], 64u);
+   gen.StopEpoch();
+   // the remaining entries are not read
+   EXPECT_LT(nRead, nEntries / 10);
+
+   std::size_t nBatches = 0;
+   auto values = ConsumeEpoch(gen, nBatches);
+   EXPECT_EQ(nBatches, nEntries / 64);
+   EXPECT_LT(nRead, nEntries + nEntries / 10);
+   std::sort(values.begin(), values.end());
+   EXPECT_TRUE(std::adjacent_find(values.begin(), values.end()) == values.end());
+}
+
+TEST(RBatchGenerator, WrongNumberOfColumns)
+{
+   RDataFrame df(1);
+   EXPECT_THROW((RBatchGenerator<ULong64_t, int>(df, {"rdfentry_"}, 1)), std::runtime_error);
+   // nothing was booked on the graph
+   EXPECT_TRUE(df.GetFilterNames().empty());
+   EXPECT_EQ(*df.Count(), 1ull);
+}
+
+TEST(RBatchGenerator, OtherBookedResults)
+{
+   RDataFrame df(1000);
+   auto df2 = df.Define("x", [](ULong64_t e) { return e; }, {"rdfentry_"}).Define("y", [](ULong64_t e) {
+      return -int(e);
+   }, {"rdfentry_"});
+   RBatchGenerator<ULong64_t, int> gen(df2, {"x", "y"}, /*batchSize=*/100);
+
+   // the generator would compute this result in its own thread
+   auto count = df2.Count();
+   EXPECT_THROW(gen.StartEpoch(), std::runtime_error);
+   EXPECT_EQ(*count, 1000ull);
+
+   std::size_t nBatches = 0;
+   auto values = ConsumeEpoch(gen, nBatches);
+   EXPECT_EQ(nBatches, 10u);
+}
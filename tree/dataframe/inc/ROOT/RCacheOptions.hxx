@@ -0,0 +1,35 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RCACHEOPTIONS
+#define ROOT_RCACHEOPTIONS
+
+#include "RtypesCore.h" // for ULong64_t
+
+#include <string>
+
+namespace ROOT {
+
+namespace RDF {
+/// A collection of options to steer the storage of cached columns, see RInterface::Cache().
+struct RCacheOptions {
+   RCacheOptions() = default;
+   RCacheOptions(ULong64_t memoryBudget, const std::string &spillDirectory = "")
+      : fMemoryBudget(memoryBudget), fSpillDirectory(spillDirectory)
+   {
+   }
+   /// Maximum size, in bytes, of the cached values kept in memory. If exceeded, the cache is moved to temporary files.
+   /// Zero means no limit: the cache is always kept in memory.
+   ULong64_t fMemoryBudget = 0;
+   /// Directory for the temporary files of a cache that exceeds its memory budget. Empty means the system default.
+   std::string fSpillDirectory;
+};
+} // ns RDF
+} // ns ROOT
+
+#endif
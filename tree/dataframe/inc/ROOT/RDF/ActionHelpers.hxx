@@ -37,6 +37,7 @@
 #include "TError.h" // for R__ASSERT, Warning
 #include "TFile.h" // for SnapshotHelper
 #include "TH1.h"
+#include "THnBase.h"
 #include "TGraph.h"
 #include "TGraphAsymmErrors.h"
 #include "TLeaf.h"
@@ -48,9 +49,11 @@
 #include "ROOT/RDF/RMergeableValue.hxx"
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -348,11 +351,55 @@ extern template void BufferedFillHelper::Exec(unsigned int, const std::vector<in
 extern template void
 BufferedFillHelper::Exec(unsigned int, const std::vector<unsigned int> &, const std::vector<unsigned int> &);
 
+/// Upper bound of the memory used by the bins of a histogram, to decide how FillHelper fills it.
+ULong64_t EstimateFillObjectSize(const TH1 &h);
+ULong64_t EstimateFillObjectSize(const THnBase &h);
+/// Number of objects that FillHelper should fill for an object of the given size: nSlots (one per slot) or fewer,
+/// shared between slots, if the per-slot copies would exceed RDataFrame.SharedFillThreshold.
+unsigned int GetNFillObjects(ULong64_t objectSize, unsigned int nSlots);
+/// Merge n objects pairwise in ceil(log2(n)) rounds, the merges of each round running in parallel, so that the result
+/// ends up in object 0. mergeInto(i, j) must merge object j into object i.
+/// Returns false without doing anything if implicit multi-threading is disabled or if there are less than 3 objects.
+bool ParallelTreeReduce(std::size_t n, const std::function<void(std::size_t, std::size_t)> &mergeInto);
+
 /// The generic Fill helper: it calls Fill on per-thread objects and then Merge to produce a final result.
 /// For one-dimensional histograms, if no axes are specified, RDataFrame uses BufferedFillHelper instead.
+///
+/// Histograms (TH1 and THnBase) that are so large that one copy per slot would exceed the memory budget set by
+/// RDataFrame.SharedFillThreshold are instead filled in "shared" mode: fewer copies are made, each shared by several
+/// slots and protected by a mutex. To keep lock contention low, slots buffer their fill values and flush them into
+/// the shared copy in batches.
 template <typename HIST = Hist_t>
 class R__CLING_PTRCHECK(off) FillHelper : public RActionImpl<FillHelper<HIST>> {
+   /// Number of Fill calls buffered by each slot before they are flushed into the shared object, in shared mode.
+   static constexpr std::size_t kSharedFillBufferSize = 1024;
+   using Flush_t = void (FillHelper::*)(unsigned int);
+
+   /// The objects being filled: one per slot, or in shared mode fewer, slot `s` filling fObjects[s % fObjects.size()].
    std::vector<HIST *> fObjects;
+   unsigned int fNSlots;
+   /// Whether several slots share each of fObjects. If false, all members below are unused.
+   bool fSharedFill = false;
+   std::unique_ptr<std::mutex[]> fMutexes;      ///< One per object in fObjects
+   std::vector<std::vector<double>> fFillBuffers; ///< Buffered fill values, per slot
+   std::vector<Flush_t> fFlushers;               ///< Function that flushes the fill buffer, per slot
+   std::vector<std::unique_ptr<HIST>> fPartialResults; ///< Snapshots of the shared objects returned by PartialUpdate
+
+   template <typename H>
+   using SupportsSharedFill =
+      std::integral_constant<bool, std::is_base_of<TH1, H>::value || std::is_base_of<THnBase, H>::value>;
+
+   template <typename H = HIST, std::enable_if_t<SupportsSharedFill<H>::value, int> = 0>
+   static unsigned int GetNObjects(const H &h, unsigned int nSlots)
+   {
+      return GetNFillObjects(EstimateFillObjectSize(h), nSlots);
+   }
+
+   template <typename H = HIST, std::enable_if_t<!SupportsSharedFill<H>::value, int> = 0>
+   static unsigned int GetNObjects(const H &, unsigned int nSlots)
+   {
+      return nSlots;
+   }
 
    template <typename H = HIST, typename = decltype(std::declval<H>().Reset())>
    void ResetIfPossible(H *h)
@@ -453,36 +500,109 @@ class R__CLING_PTRCHECK(off) FillHelper : public RActionImpl<FillHelper<HIST>> {
    template <std::size_t ColIdx, typename End_t, typename... Its>
    void ExecLoop(unsigned int slot, End_t end, Its... its)
    {
-      auto *thisSlotH = fObjects[slot];
       // loop increments all of the iterators while leaving scalars unmodified
       // TODO this could be simplified with fold expressions or std::apply in C++17
       auto nop = [](auto &&...) {};
       for (; GetNthElement<ColIdx>(its...) != end; nop(++its...)) {
-         thisSlotH->Fill(*its...);
+         FillObject(slot, *its...);
+      }
+   }
+
+   template <typename... Xs>
+   void FillObject(unsigned int slot, const Xs &...xs)
+   {
+      if (!fSharedFill) {
+         fObjects[slot]->Fill(xs...);
+         return;
+      }
+      // numerical values can be buffered, anything else (e.g. bin labels) is filled directly under the lock
+      using Bufferable_t = std::integral_constant<bool, SupportsSharedFill<HIST>::value &&
+                                                           !Disjunction<std::integral_constant<
+                                                              bool, !std::is_arithmetic<Xs>::value>...>::value>;
+      FillShared(slot, Bufferable_t{}, xs...);
+   }
+
+   template <typename... Xs>
+   void FillShared(unsigned int slot, std::true_type, const Xs &...xs)
+   {
+      auto &buffer = fFillBuffers[slot];
+      if (buffer.empty())
+         fFlushers[slot] = &FillHelper::FlushFillBuffer<sizeof...(Xs)>;
+      using expander = int[];
+      (void)expander{0, (buffer.push_back(static_cast<double>(xs)), 0)...};
+      if (buffer.size() >= kSharedFillBufferSize * sizeof...(Xs))
+         FlushFillBuffer<sizeof...(Xs)>(slot);
+   }
+
+   template <typename... Xs>
+   void FillShared(unsigned int slot, std::false_type, const Xs &...xs)
+   {
+      const auto idx = slot % fObjects.size();
+      std::lock_guard<std::mutex> lock(fMutexes[idx]);
+      fObjects[idx]->Fill(xs...);
+   }
+
+   template <std::size_t NArgs>
+   void FlushFillBuffer(unsigned int slot)
+   {
+      FlushFillBufferImpl(slot, std::make_index_sequence<NArgs>{});
+   }
+
+   template <std::size_t... S>
+   void FlushFillBufferImpl(unsigned int slot, std::index_sequence<S...>)
+   {
+      auto &buffer = fFillBuffers[slot];
+      if (buffer.empty())
+         return;
+      constexpr auto nArgs = sizeof...(S);
+      const auto idx = slot % fObjects.size();
+      {
+         std::lock_guard<std::mutex> lock(fMutexes[idx]);
+         auto *h = fObjects[idx];
+         for (std::size_t i = 0; i + nArgs <= buffer.size(); i += nArgs)
+            h->Fill(buffer[i + S]...);
       }
+      buffer.clear();
+   }
+
+   void FlushFillBuffer(unsigned int slot)
+   {
+      if (fSharedFill && fFlushers[slot] != nullptr)
+         (this->*fFlushers[slot])(slot);
    }
 
 public:
    FillHelper(FillHelper &&) = default;
    FillHelper(const FillHelper &) = delete;
 
-   FillHelper(const std::shared_ptr<HIST> &h, const unsigned int nSlots) : fObjects(nSlots, nullptr)
+   FillHelper(const std::shared_ptr<HIST> &h, const unsigned int nSlots)
+      : fObjects(GetNObjects(*h, nSlots), nullptr), fNSlots(nSlots)
    {
       fObjects[0] = h.get();
       // Initialize all other slots
-      for (unsigned int i = 1; i < nSlots; ++i) {
+      for (unsigned int i = 1; i < fObjects.size(); ++i) {
          fObjects[i] = new HIST(*fObjects[0]);
          UnsetDirectoryIfPossible(fObjects[i]);
       }
+
+      if (fObjects.size() < nSlots) {
+         fSharedFill = true;
+         fMutexes.reset(new std::mutex[fObjects.size()]);
+         fFillBuffers.resize(nSlots);
+         fFlushers.resize(nSlots, nullptr);
+         fPartialResults.resize(nSlots);
+      }
    }
 
    void InitTask(TTreeReader *, unsigned int) {}
 
+   void FinalizeTask(unsigned int slot) { FlushFillBuffer(slot); }
+
    // no container arguments
    template <typename... ValTypes, std::enable_if_t<!Disjunction<IsDataContainer<ValTypes>...>::value, int> = 0>
    auto Exec(unsigned int slot, const ValTypes &...x) -> decltype(fObjects[slot]->Fill(x...), void())
    {
-      fObjects[slot]->Fill(x...);
+      FillObject(slot, x...);
    }
 
    // at least one container argument
@@ -524,17 +644,40 @@ public:
 
    void Finalize()
    {
+      for (unsigned int slot = 0; slot < fFlushers.size(); ++slot)
+         FlushFillBuffer(slot);
+      fPartialResults.clear();
+
       if (fObjects.size() == 1)
          return;
 
-      Merge(fObjects, /*toselectcorrectoverload=*/0);
+      // with many large objects, merging pairs in parallel is much faster than merging all into the first one
+      auto mergeInto = [this](std::size_t to, std::size_t from) {
+         std::vector<HIST *> pair{fObjects[to], fObjects[from]};
+         Merge(pair, /*toselectcorrectoverload=*/0);
+      };
+      if (!ParallelTreeReduce(fObjects.size(), mergeInto))
+         Merge(fObjects, /*toselectcorrectoverload=*/0);
 
       // delete the copies we created for the slots other than the first
       for (auto it = ++fObjects.begin(); it != fObjects.end(); ++it)
          delete *it;
    }
 
-   HIST &PartialUpdate(unsigned int slot) { return *fObjects[slot]; }
+   /// In shared mode, the partial result is a snapshot of the object shared by this slot and others, so it also
+   /// contains the entries filled by other slots.
+   HIST &PartialUpdate(unsigned int slot)
+   {
+      if (!fSharedFill)
+         return *fObjects[slot];
+
+      FlushFillBuffer(slot);
+      const auto idx = slot % fObjects.size();
+      std::lock_guard<std::mutex> lock(fMutexes[idx]);
+      fPartialResults[slot].reset(new HIST(*fObjects[idx]));
+      UnsetDirectoryIfPossible(fPartialResults[slot].get());
+      return *fPartialResults[slot];
+   }
 
    // Helper functions for RMergeableValue
    std::unique_ptr<RMergeableValueBase> GetMergeableValue() const final
@@ -562,7 +705,7 @@ public:
       auto &result = *static_cast<std::shared_ptr<H> *>(newResult);
       ResetIfPossible(result.get());
       UnsetDirectoryIfPossible(result.get());
-      return FillHelper(result, fObjects.size());
+      return FillHelper(result, fNSlots);
    }
 };
 
@@ -784,7 +927,7 @@ class R__CLING_PTRCHECK(off) TakeHelper : public RActionImpl<TakeHelper<RealT_t,
 
 public:
    using ColumnTypes_t = TypeList<T>;
-   TakeHelper(const std::shared_ptr<COLL> &resultColl, const unsigned int nSlots)
+   TakeHelper(const std::shared_ptr<COLL> &resultColl, const unsigned int nSlots, ULong64_t /*sizeHint*/ = 0)
    {
       fColls.emplace_back(resultColl);
       for (unsigned int i = 1; i < nSlots; ++i)
@@ -825,32 +968,28 @@ public:
    }
 };
 
-// Case 2.: The column is not an RVec, the collection is a vector
-// Optimisations, no transformations: just copies.
-template <typename RealT_t, typename T>
-class R__CLING_PTRCHECK(off) TakeHelper<RealT_t, T, std::vector<T>>
-   : public RActionImpl<TakeHelper<RealT_t, T, std::vector<T>>> {
+/// Storage of the values taken into a std::vector by TakeHelper: every slot fills its own vector, and at the end of
+/// the event loop they are appended to the first one, which is the result.
+template <typename T>
+class TakeSlotVectors {
    Results<std::shared_ptr<std::vector<T>>> fColls;
 
 public:
-   using ColumnTypes_t = TypeList<T>;
-   TakeHelper(const std::shared_ptr<std::vector<T>> &resultColl, const unsigned int nSlots)
+   TakeSlotVectors(const std::shared_ptr<std::vector<T>> &resultColl, const unsigned int nSlots, ULong64_t sizeHint)
    {
       fColls.emplace_back(resultColl);
+      if (nSlots == 1 && sizeHint > 0)
+         resultColl->reserve(sizeHint);
       for (unsigned int i = 1; i < nSlots; ++i) {
          auto v = std::make_shared<std::vector<T>>();
          v->reserve(1024);
          fColls.emplace_back(v);
       }
    }
-   TakeHelper(TakeHelper &&);
-   TakeHelper(const TakeHelper &) = delete;
-
-   void InitTask(TTreeReader *, unsigned int) {}
 
-   void Exec(unsigned int slot, T &v) { FillColl(v, *fColls[slot]); }
+   void Initialize() {}
 
-   void Initialize() { /* noop */}
+   void Push(unsigned int slot, T &v) { FillColl(v, *fColls[slot]); }
 
    // This is optimised to treat vectors
    void Finalize()
@@ -867,6 +1006,187 @@ public:
    }
 
    std::vector<T> &PartialUpdate(unsigned int slot) { return *fColls[slot]; }
+};
+
+/// Storage of the values of a fundamental type taken into a std::vector by TakeHelper.
+/// All slots write into the result vector itself, so that the values are stored in a single contiguous buffer that
+/// can be handed over without copies (e.g. to numpy by AsNumpy) and the peak memory usage is not doubled by the
+/// concatenation of per-slot vectors at the end of the event loop.
+/// If the number of values is known in advance, the result is sized accordingly at the beginning of the event loop and
+/// the slots claim chunks of kChunkSize elements of it; the holes left by partially filled chunks are compacted at the
+/// end. Values that do not fit, or all values if their number is not known, are stored by each slot in blocks of
+/// kChunkSize elements (which, unlike growing vectors, are never reallocated) and appended to the result at the end.
+template <typename T>
+class TakeBuffer {
+public:
+   static constexpr ULong64_t kChunkSize = 8192;
+
+private:
+   /// State of one slot. Allocated separately for each slot to avoid false sharing.
+   struct RSlot {
+      ULong64_t fNext{0}; ///< Index of the result where the next value is written
+      ULong64_t fEnd{0};  ///< End of the chunk of the result claimed by this slot
+      bool fResultFull{false};
+      std::vector<std::pair<ULong64_t, ULong64_t>> fChunks; ///< Chunks of the result claimed by this slot
+      std::vector<std::vector<T>> fBlocks;                  ///< Values that did not fit in the result
+      std::vector<T> fPartial;                              ///< Values returned by PartialUpdate
+   };
+
+   std::shared_ptr<std::vector<T>> fResult;
+   std::vector<std::unique_ptr<RSlot>> fSlots;
+   std::atomic<ULong64_t> fNextChunk{0}; ///< Beginning of the next chunk of the result to be claimed by a slot
+   const ULong64_t fSizeHint;
+
+   bool ClaimChunk(RSlot &s)
+   {
+      if (s.fResultFull)
+         return false;
+      const ULong64_t size = fResult->size();
+      const ULong64_t begin = fNextChunk.fetch_add(kChunkSize, std::memory_order_relaxed);
+      if (begin >= size) {
+         s.fResultFull = true;
+         return false;
+      }
+      s.fNext = begin;
+      s.fEnd = std::min(begin + kChunkSize, size);
+      s.fChunks.emplace_back(s.fNext, s.fEnd);
+      return true;
+   }
+
+   /// Remove the unfilled parts of the claimed chunks from the result, moving values from its end into them.
+   void CompactResult()
+   {
+      auto &result = *fResult;
+      const auto used = std::min<ULong64_t>(fNextChunk.load(), result.size());
+      std::vector<std::pair<ULong64_t, ULong64_t>> holes;
+      ULong64_t nHoles = 0;
+      for (auto &s : fSlots) {
+         if (s->fNext < s->fEnd) {
+            holes.emplace_back(s->fNext, s->fEnd);
+            nHoles += s->fEnd - s->fNext;
+         }
+      }
+      std::sort(holes.begin(), holes.end());
+      const auto newSize = used - nHoles;
+      // the values beyond newSize (outside of holes) are as many as the hole elements before newSize
+      std::size_t srcHole = 0;
+      std::size_t dstHole = 0;
+      ULong64_t dst = holes.empty() ? 0 : holes[0].first;
+      for (ULong64_t src = newSize; src < used; ++src) {
+         while (srcHole < holes.size() && holes[srcHole].second <= src)
+            ++srcHole;
+         if (srcHole < holes.size() && holes[srcHole].first <= src) {
+            src = holes[srcHole].second - 1;
+            continue;
+         }
+         if (dst == holes[dstHole].second)
+            dst = holes[++dstHole].first;
+         result[dst++] = result[src];
+      }
+      result.resize(newSize);
+   }
+
+public:
+   TakeBuffer(const std::shared_ptr<std::vector<T>> &resultColl, const unsigned int nSlots, ULong64_t sizeHint)
+      : fResult(resultColl), fSizeHint(sizeHint)
+   {
+      for (unsigned int i = 0; i < nSlots; ++i)
+         fSlots.emplace_back(new RSlot());
+   }
+
+   void Initialize()
+   {
+      if (fSlots.size() == 1)
+         fResult->reserve(fSizeHint);
+      else
+         fResult->resize(fSizeHint);
+   }
+
+   void Push(unsigned int slot, T v)
+   {
+      if (fSlots.size() == 1) {
+         fResult->push_back(v);
+         return;
+      }
+      auto &s = *fSlots[slot];
+      if (s.fNext == s.fEnd && !ClaimChunk(s)) {
+         if (s.fBlocks.empty() || s.fBlocks.back().size() == kChunkSize) {
+            s.fBlocks.emplace_back();
+            s.fBlocks.back().reserve(kChunkSize);
+         }
+         s.fBlocks.back().push_back(v);
+         return;
+      }
+      (*fResult)[s.fNext++] = v;
+   }
+
+   void Finalize()
+   {
+      if (fSlots.size() == 1)
+         return;
+      CompactResult();
+      ULong64_t totSize = fResult->size();
+      for (auto &s : fSlots)
+         for (auto &block : s->fBlocks)
+            totSize += block.size();
+      fResult->reserve(totSize);
+      for (auto &s : fSlots) {
+         for (auto &block : s->fBlocks) {
+            fResult->insert(fResult->end(), block.begin(), block.end());
+            std::vector<T>().swap(block); // release the memory as soon as possible
+         }
+         s->fBlocks.clear();
+      }
+   }
+
+   /// Return the values taken so far by the slot. In multi-thread runs this is a copy.
+   std::vector<T> &PartialUpdate(unsigned int slot)
+   {
+      if (fSlots.size() == 1)
+         return *fResult;
+      auto &s = *fSlots[slot];
+      s.fPartial.clear();
+      for (const auto &chunk : s.fChunks) {
+         const auto end = chunk.second == s.fEnd ? s.fNext : chunk.second;
+         s.fPartial.insert(s.fPartial.end(), fResult->begin() + chunk.first, fResult->begin() + end);
+      }
+      for (const auto &block : s.fBlocks)
+         s.fPartial.insert(s.fPartial.end(), block.begin(), block.end());
+      return s.fPartial;
+   }
+};
+
+// Case 2.: The column is not an RVec, the collection is a vector
+// Optimisations, no transformations: just copies. Values of fundamental types (but bool, as std::vector<bool> does
+// not allow concurrent writes to different elements) are written by all slots into the same buffer, see TakeBuffer.
+template <typename RealT_t, typename T>
+class R__CLING_PTRCHECK(off) TakeHelper<RealT_t, T, std::vector<T>>
+   : public RActionImpl<TakeHelper<RealT_t, T, std::vector<T>>> {
+   using Storage_t = std::conditional_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, TakeBuffer<T>,
+                                        TakeSlotVectors<T>>;
+   std::unique_ptr<Storage_t> fStorage;
+   unsigned int fNSlots;
+   ULong64_t fSizeHint;
+
+public:
+   using ColumnTypes_t = TypeList<T>;
+   /// \param[in] sizeHint Number of values that are going to be taken, if known in advance, or 0.
+   TakeHelper(const std::shared_ptr<std::vector<T>> &resultColl, const unsigned int nSlots, ULong64_t sizeHint = 0)
+      : fStorage(new Storage_t(resultColl, nSlots, sizeHint)), fNSlots(nSlots), fSizeHint(sizeHint)
+   {
+   }
+   TakeHelper(TakeHelper &&);
+   TakeHelper(const TakeHelper &) = delete;
+
+   void InitTask(TTreeReader *, unsigned int) {}
+
+   void Exec(unsigned int slot, T &v) { fStorage->Push(slot, v); }
+
+   void Initialize() { fStorage->Initialize(); }
+
+   void Finalize() { fStorage->Finalize(); }
+
+   std::vector<T> &PartialUpdate(unsigned int slot) { return fStorage->PartialUpdate(slot); }
 
    std::string GetActionName() { return "Take"; }
 
@@ -874,7 +1194,7 @@ public:
    {
       auto &result = *static_cast<std::shared_ptr<std::vector<T>> *>(newResult);
       result->clear();
-      return TakeHelper(result, fColls.size());
+      return TakeHelper(result, fNSlots, fSizeHint);
    }
 };
 
@@ -887,7 +1207,7 @@ class R__CLING_PTRCHECK(off) TakeHelper<RealT_t, RVec<RealT_t>, COLL>
 
 public:
    using ColumnTypes_t = TypeList<RVec<RealT_t>>;
-   TakeHelper(const std::shared_ptr<COLL> &resultColl, const unsigned int nSlots)
+   TakeHelper(const std::shared_ptr<COLL> &resultColl, const unsigned int nSlots, ULong64_t /*sizeHint*/ = 0)
    {
       fColls.emplace_back(resultColl);
       for (unsigned int i = 1; i < nSlots; ++i)
@@ -933,7 +1253,8 @@ class R__CLING_PTRCHECK(off) TakeHelper<RealT_t, RVec<RealT_t>, std::vector<Real
 
 public:
    using ColumnTypes_t = TypeList<RVec<RealT_t>>;
-   TakeHelper(const std::shared_ptr<std::vector<std::vector<RealT_t>>> &resultColl, const unsigned int nSlots)
+   TakeHelper(const std::shared_ptr<std::vector<std::vector<RealT_t>>> &resultColl, const unsigned int nSlots,
+              ULong64_t /*sizeHint*/ = 0)
    {
       fColls.emplace_back(resultColl);
       for (unsigned int i = 1; i < nSlots; ++i) {
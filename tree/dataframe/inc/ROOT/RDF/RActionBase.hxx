@@ -34,6 +34,7 @@ namespace RDF {
 namespace GraphDrawing {
 class GraphNode;
 }
+class RProfiler;
 
 using namespace ROOT::Detail::RDF;
 
@@ -42,6 +43,8 @@ protected:
    /// A raw pointer to the RLoopManager at the root of this functional graph.
    /// Never null: children nodes have shared ownership of parent nodes in the graph.
    RLoopManager *fLoopManager;
+   RProfiler *fProfiler = nullptr; ///< Measures the executions of this action, if profiling is enabled.
+   unsigned int fProfilerId = 0;   ///< Id of this action in fProfiler.
 
 private:
    const unsigned int fNSlots; ///< Number of thread slots used by this node.
@@ -63,6 +66,13 @@ public:
    RColumnRegister &GetColRegister() { return fColRegister; }
    RLoopManager *GetLoopManager() { return fLoopManager; }
    unsigned int GetNSlots() const { return fNSlots; }
+   void SetProfiler(RProfiler *profiler, unsigned int id)
+   {
+      fProfiler = profiler;
+      fProfilerId = id;
+   }
+   /// Return the name of the action, as displayed e.g. in the computation graph.
+   virtual std::string GetActionName() = 0;
    virtual void Run(unsigned int slot, Long64_t entry) = 0;
    virtual void Initialize() = 0;
    virtual void InitSlot(TTreeReader *r, unsigned int slot) = 0;
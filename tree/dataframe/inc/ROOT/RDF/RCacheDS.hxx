@@ -0,0 +1,433 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RDF_RCACHEDS
+#define ROOT_RDF_RCACHEDS
+
+#include "ROOT/RCacheOptions.hxx"
+#include "ROOT/RDataSource.hxx"
+#include "ROOT/RDF/RActionImpl.hxx"
+#include "ROOT/RDF/Utils.hxx" // TypeID2TypeName
+#include "ROOT/RResultPtr.hxx"
+#include "ROOT/RVec.hxx"
+#include "ROOT/TSeq.hxx"
+#include "RtypesCore.h"
+#include "TChain.h"
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility> // std::index_sequence
+#include <vector>
+
+class TTreeReader;
+
+namespace ROOT {
+namespace Internal {
+namespace RDF {
+
+/// Approximate memory footprint of a cached value, used to enforce the memory budget of a cache.
+template <typename T>
+std::size_t CachedValueSize(const T &)
+{
+   return sizeof(T);
+}
+
+template <typename T, typename A>
+std::size_t CachedValueSize(const std::vector<T, A> &v)
+{
+   return sizeof(v) + v.capacity() * sizeof(T);
+}
+
+template <typename T>
+std::size_t CachedValueSize(const ROOT::VecOps::RVec<T> &v)
+{
+   return sizeof(v) + v.capacity() * sizeof(T);
+}
+
+/// Return the address of a cached value. std::vector<bool> does not store addressable bools, so those are copied.
+template <typename T>
+void *GetCachedValueAddress(std::vector<T> &v, std::size_t idx, T &)
+{
+   return &v[idx];
+}
+
+inline void *GetCachedValueAddress(std::vector<bool> &v, std::size_t idx, bool &copy)
+{
+   copy = v[idx];
+   return &copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief The storage of the columns cached by RInterface::Cache.
+///
+/// Values are appended to per-slot in-memory buffers. If the total size of the buffered values exceeds the memory
+/// budget, the buffers of the slots that hold at least their share of the budget are moved to a TTree in a per-slot
+/// temporary file.
+/// At the end of the event loop the cache is either entirely in memory or, if any slot spilled, entirely on disk.
+/// Temporary files are removed when the store is destroyed.
+template <typename... ColTypes>
+class RCacheStore {
+   using Buffers_t = std::tuple<std::vector<ColTypes>...>;
+   using Values_t = std::tuple<ColTypes...>;
+
+   std::vector<std::string> fColumnNames;
+   ULong64_t fMemoryBudget;
+   std::string fSpillDirectory;
+   std::vector<Buffers_t> fBuffers;       ///< Per-slot in-memory buffers
+   std::vector<ULong64_t> fBufferSizes;   ///< Per-slot approximate size of the buffered values, in bytes
+   std::atomic<ULong64_t> fTotalSize{0};  ///< Approximate size of all buffered values, in bytes
+   std::atomic<bool> fHasSpilled{false};  ///< True as soon as any slot moved its buffer to disk
+   std::vector<std::unique_ptr<TFile>> fSpillFiles; ///< Per-slot temporary files, open during the event loop
+   std::vector<TTree *> fSpillTrees;                ///< Per-slot trees, owned by the files
+   std::vector<Values_t> fSpillValues;              ///< Per-slot branch addresses of the spill trees
+   std::vector<std::string> fSpillFileNames;        ///< Names of all temporary files
+   std::mutex fSpillFileNamesMutex;
+   bool fIsOnDisk = false;
+
+   template <std::size_t... S>
+   void PushImpl(unsigned int slot, std::index_sequence<S...>, const ColTypes &...values)
+   {
+      std::initializer_list<int> expander{(std::get<S>(fBuffers[slot]).emplace_back(values), 0)...};
+      (void)expander; // avoid unused variable warnings
+   }
+
+   template <std::size_t... S>
+   void CreateSpillBranches(unsigned int slot, std::index_sequence<S...>)
+   {
+      std::initializer_list<int> expander{
+         (fSpillTrees[slot]->Branch(fColumnNames[S].c_str(), &std::get<S>(fSpillValues[slot])), 0)...};
+      (void)expander; // avoid unused variable warnings
+   }
+
+   template <std::size_t... S>
+   void FillSpillTree(unsigned int slot, std::size_t idx, std::index_sequence<S...>)
+   {
+      std::initializer_list<int> expander{
+         (std::get<S>(fSpillValues[slot]) = std::get<S>(fBuffers[slot])[idx], 0)...};
+      (void)expander; // avoid unused variable warnings
+      fSpillTrees[slot]->Fill();
+   }
+
+   void OpenSpillFile(unsigned int slot)
+   {
+      TString fileName("rdfcache");
+      FILE *f = gSystem->TempFileName(fileName, fSpillDirectory.empty() ? nullptr : fSpillDirectory.c_str());
+      if (!f)
+         throw std::runtime_error("RDataFrame::Cache: could not create a temporary file in directory \"" +
+                                  fSpillDirectory + "\".");
+      fclose(f);
+      {
+         std::lock_guard<std::mutex> lock(fSpillFileNamesMutex);
+         fSpillFileNames.emplace_back(fileName.Data());
+      }
+
+      TDirectory::TContext ctxt;
+      fSpillFiles[slot].reset(TFile::Open(fileName, "RECREATE"));
+      if (!fSpillFiles[slot] || fSpillFiles[slot]->IsZombie())
+         throw std::runtime_error(std::string("RDataFrame::Cache: could not open temporary file ") + fileName.Data());
+      fSpillTrees[slot] = new TTree(GetTreeName(), "RDataFrame cache");
+      fSpillTrees[slot]->SetDirectory(fSpillFiles[slot].get());
+      // the tree is filled from within the event loop, do not spawn further tasks
+      fSpillTrees[slot]->SetImplicitMT(false);
+      CreateSpillBranches(slot, std::index_sequence_for<ColTypes...>());
+   }
+
+   /// Move the buffered values of a slot to its temporary file.
+   void Spill(unsigned int slot)
+   {
+      if (!fSpillFiles[slot])
+         OpenSpillFile(slot);
+
+      auto &buffers = fBuffers[slot];
+      const auto nEntries = std::get<0>(buffers).size();
+      for (std::size_t i = 0u; i < nEntries; ++i)
+         FillSpillTree(slot, i, std::index_sequence_for<ColTypes...>());
+
+      // release the memory of the buffers, clear() would keep it allocated
+      Buffers_t().swap(buffers);
+      fTotalSize -= fBufferSizes[slot];
+      fBufferSizes[slot] = 0ull;
+      fHasSpilled = true;
+   }
+
+public:
+   RCacheStore(const std::vector<std::string> &columnNames, const ROOT::RDF::RCacheOptions &options,
+               unsigned int nSlots)
+      : fColumnNames(columnNames), fMemoryBudget(options.fMemoryBudget), fSpillDirectory(options.fSpillDirectory),
+        fBuffers(nSlots), fBufferSizes(nSlots, 0ull), fSpillFiles(nSlots), fSpillTrees(nSlots, nullptr),
+        fSpillValues(nSlots)
+   {
+   }
+   RCacheStore(const RCacheStore &) = delete;
+   RCacheStore &operator=(const RCacheStore &) = delete;
+
+   ~RCacheStore()
+   {
+      for (auto &file : fSpillFiles)
+         file.reset();
+      for (const auto &fileName : fSpillFileNames)
+         gSystem->Unlink(fileName.c_str());
+   }
+
+   static const char *GetTreeName() { return "rdfcache"; }
+
+   void Push(unsigned int slot, const ColTypes &...values)
+   {
+      PushImpl(slot, std::index_sequence_for<ColTypes...>(), values...);
+
+      std::size_t size = 0u;
+      std::initializer_list<int> expander{(size += CachedValueSize(values), 0)...};
+      (void)expander; // avoid unused variable warnings
+      fBufferSizes[slot] += size;
+      const auto totalSize = fTotalSize.fetch_add(size) + size;
+      // only slots that hold at least their share of the budget spill, lest a slot with an almost empty buffer
+      // moves single entries to disk while the memory is held by the other slots
+      if (fMemoryBudget > 0ull && totalSize > fMemoryBudget && fBufferSizes[slot] >= fMemoryBudget / fBuffers.size())
+         Spill(slot);
+   }
+
+   /// To be called at the end of the event loop. If the cache did not fit in memory, move what is left to disk.
+   void Finalize()
+   {
+      if (!fHasSpilled)
+         return;
+
+      for (auto slot : ROOT::TSeqU(fBuffers.size())) {
+         if (!std::get<0>(fBuffers[slot]).empty())
+            Spill(slot);
+         if (fSpillFiles[slot]) {
+            TDirectory::TContext ctxt(fSpillFiles[slot].get());
+            fSpillTrees[slot]->Write();
+            fSpillFiles[slot].reset();
+            fSpillTrees[slot] = nullptr;
+         }
+      }
+      fSpillValues.clear();
+      fIsOnDisk = true;
+   }
+
+   bool IsOnDisk() const { return fIsOnDisk; }
+   const std::vector<std::string> &GetSpillFileNames() const { return fSpillFileNames; }
+   const std::vector<std::string> &GetColumnNames() const { return fColumnNames; }
+   std::vector<Buffers_t> &GetBuffers() { return fBuffers; }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief The action that fills an RCacheStore.
+template <typename... ColTypes>
+class R__CLING_PTRCHECK(off) RCacheHelper : public ROOT::Detail::RDF::RActionImpl<RCacheHelper<ColTypes...>> {
+public:
+   using Result_t = RCacheStore<ColTypes...>;
+
+private:
+   std::shared_ptr<Result_t> fStore;
+
+public:
+   RCacheHelper(const std::shared_ptr<Result_t> &store) : fStore(store) {}
+   RCacheHelper(RCacheHelper &&) = default;
+   RCacheHelper(const RCacheHelper &) = delete;
+   std::shared_ptr<Result_t> GetResultPtr() const { return fStore; }
+   void Initialize() {}
+   void InitTask(TTreeReader *, unsigned int) {}
+   void Exec(unsigned int slot, const ColTypes &...values) { fStore->Push(slot, values...); }
+   void Finalize() { fStore->Finalize(); }
+   std::string GetActionName() { return "Cache"; }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief A RDataSource that reads the columns stored by RInterface::Cache in an RCacheStore.
+///
+/// Like RLazyDS, the event loop that fills the cache only starts when this data source is initialized.
+/// If the cache is in memory, the column readers point directly to the cached values. If it was moved to disk, each
+/// slot reads the temporary files through its own TChain. In both cases the entries are split in ranges that can be
+/// processed in parallel.
+template <typename... ColTypes>
+class RCacheDS final : public ROOT::RDF::RDataSource {
+   using Store_t = RCacheStore<ColTypes...>;
+   using Values_t = std::tuple<ColTypes...>;
+
+   ROOT::RDF::RResultPtr<Store_t> fStore;
+   const std::vector<std::string> fColNames;
+   const std::map<std::string, std::string> fColTypesMap;
+   unsigned int fNSlots{0};
+   std::vector<Values_t> fValues;               ///< Per-slot values read from disk (or copied, for bools)
+   std::vector<std::vector<void *>> fValuePtrs; ///< Per-column, per-slot addresses of the current values
+   std::vector<std::unique_ptr<TChain>> fChains; ///< Per-slot chains of the temporary files, if the cache is on disk
+   std::vector<ULong64_t> fBufferOffsets;        ///< First entry of each in-memory buffer
+   std::vector<std::pair<ULong64_t, ULong64_t>> fEntryRanges;
+
+   template <std::size_t... S>
+   void SetValuePtrs(unsigned int slot, std::index_sequence<S...>)
+   {
+      std::initializer_list<int> expander{(fValuePtrs[S][slot] = &std::get<S>(fValues[slot]), 0)...};
+      (void)expander; // avoid unused variable warnings
+   }
+
+   template <std::size_t... S>
+   void SetInMemoryEntry(unsigned int slot, std::size_t buffer, std::size_t idx, std::index_sequence<S...>)
+   {
+      auto &buffers = fStore->GetBuffers()[buffer];
+      std::initializer_list<int> expander{
+         (fValuePtrs[S][slot] = GetCachedValueAddress(std::get<S>(buffers), idx, std::get<S>(fValues[slot])), 0)...};
+      (void)expander; // avoid unused variable warnings
+   }
+
+   template <std::size_t... S>
+   void SetChainBranchAddresses(unsigned int slot, std::index_sequence<S...>)
+   {
+      std::initializer_list<int> expander{
+         (fChains[slot]->SetBranchAddress(fColNames[S].c_str(), &std::get<S>(fValues[slot])), 0)...};
+      (void)expander; // avoid unused variable warnings
+   }
+
+   /// Split [begin, end) in at most fNSlots ranges.
+   void AddEntryRanges(ULong64_t begin, ULong64_t end)
+   {
+      const auto nEntries = end - begin;
+      if (nEntries == 0ull)
+         return;
+      const auto nRanges = std::min<ULong64_t>(fNSlots, nEntries);
+      const auto rangeSize = nEntries / nRanges;
+      auto remainder = nEntries % nRanges;
+      for (auto i : ROOT::TSeqU(nRanges)) {
+         (void)i;
+         const auto rangeEnd = begin + rangeSize + (remainder > 0ull ? 1ull : 0ull);
+         if (remainder > 0ull)
+            --remainder;
+         fEntryRanges.emplace_back(begin, rangeEnd);
+         begin = rangeEnd;
+      }
+   }
+
+   Record_t GetColumnReadersImpl(std::string_view colName, const std::type_info &id) final
+   {
+      const auto colNameStr = std::string(colName);
+      auto it = fColTypesMap.find(colNameStr);
+      if (fColTypesMap.end() == it) {
+         std::string err = "The specified column name, \"" + colNameStr + "\" is not known to the data source.";
+         throw std::runtime_error(err);
+      }
+
+      const auto idName = ROOT::Internal::RDF::TypeID2TypeName(id);
+      if (it->second != idName) {
+         std::string err = "Column " + colNameStr + " has type " + it->second +
+                           " while the id specified is associated to type " + idName;
+         throw std::runtime_error(err);
+      }
+
+      const auto index = std::distance(fColNames.begin(), std::find(fColNames.begin(), fColNames.end(), colName));
+      Record_t ret(fNSlots);
+      for (auto slot : ROOT::TSeqU(fNSlots))
+         ret[slot] = &fValuePtrs[index][slot];
+      return ret;
+   }
+
+protected:
+   std::string AsString() final { return "cache data source"; };
+
+public:
+   RCacheDS(ROOT::RDF::RResultPtr<Store_t> store, const std::vector<std::string> &colNames)
+      : fStore(std::move(store)), fColNames(colNames),
+        fColTypesMap(MakeColTypesMap(colNames, std::index_sequence_for<ColTypes...>()))
+   {
+   }
+
+   template <std::size_t... S>
+   static std::map<std::string, std::string>
+   MakeColTypesMap(const std::vector<std::string> &colNames, std::index_sequence<S...>)
+   {
+      return {{colNames[S], ROOT::Internal::RDF::TypeID2TypeName(typeid(ColTypes))}...};
+   }
+
+   const std::vector<std::string> &GetColumnNames() const final { return fColNames; }
+
+   std::vector<std::pair<ULong64_t, ULong64_t>> GetEntryRanges() final
+   {
+      auto entryRanges(std::move(fEntryRanges)); // empty fEntryRanges
+      return entryRanges;
+   }
+
+   std::string GetTypeName(std::string_view colName) const final { return fColTypesMap.at(std::string(colName)); }
+
+   bool HasColumn(std::string_view colName) const final
+   {
+      return fColTypesMap.end() != fColTypesMap.find(std::string(colName));
+   }
+
+   bool SetEntry(unsigned int slot, ULong64_t entry) final
+   {
+      if (fStore->IsOnDisk()) {
+         fChains[slot]->GetEntry(entry);
+      } else {
+         const auto it = std::upper_bound(fBufferOffsets.begin(), fBufferOffsets.end(), entry);
+         const auto buffer = std::distance(fBufferOffsets.begin(), it) - 1;
+         SetInMemoryEntry(slot, buffer, entry - fBufferOffsets[buffer], std::index_sequence_for<ColTypes...>());
+      }
+      return true;
+   }
+
+   void SetNSlots(unsigned int nSlots) final
+   {
+      fNSlots = nSlots;
+      fValues.resize(fNSlots);
+      fValuePtrs.assign(sizeof...(ColTypes), std::vector<void *>(fNSlots, nullptr));
+      for (auto slot : ROOT::TSeqU(fNSlots))
+         SetValuePtrs(slot, std::index_sequence_for<ColTypes...>());
+      fChains.resize(fNSlots);
+   }
+
+   void Initialize() final
+   {
+      // this triggers the event loop that fills the cache, if it did not run yet
+      auto &store = *fStore;
+
+      fEntryRanges.clear();
+      if (store.IsOnDisk()) {
+         for (auto slot : ROOT::TSeqU(fNSlots)) {
+            if (fChains[slot])
+               continue;
+            fChains[slot] = std::make_unique<TChain>(Store_t::GetTreeName());
+            fChains[slot]->ResetBit(kMustCleanup);
+            for (const auto &fileName : store.GetSpillFileNames())
+               fChains[slot]->Add(fileName.c_str());
+            SetChainBranchAddresses(slot, std::index_sequence_for<ColTypes...>());
+         }
+         AddEntryRanges(0ull, fChains[0]->GetEntries());
+      } else {
+         fBufferOffsets.clear();
+         ULong64_t nEntries = 0ull;
+         for (auto &buffers : store.GetBuffers()) {
+            const auto bufferSize = std::get<0>(buffers).size();
+            fBufferOffsets.emplace_back(nEntries);
+            // ranges never cross buffer boundaries, so that SetEntry can look up the buffer of an entry
+            AddEntryRanges(nEntries, nEntries + bufferSize);
+            nEntries += bufferSize;
+         }
+      }
+   }
+
+   std::string GetLabel() final { return "CacheDS"; }
+};
+
+} // ns RDF
+} // ns Internal
+} // ns ROOT
+
+#endif
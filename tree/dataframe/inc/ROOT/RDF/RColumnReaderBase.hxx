@@ -14,6 +14,12 @@
 #include <Rtypes.h>
 
 namespace ROOT {
+namespace Internal {
+namespace RDF {
+class RProfiledColumnReader;
+}
+} // namespace Internal
+
 namespace Detail {
 namespace RDF {
 
@@ -39,6 +45,9 @@ public:
    }
 
 private:
+   // forwards GetImpl calls to the reader it wraps
+   friend class ROOT::Internal::RDF::RProfiledColumnReader;
+
    virtual void *GetImpl(Long64_t entry) = 0;
 };
 
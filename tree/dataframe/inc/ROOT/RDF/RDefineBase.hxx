@@ -29,6 +29,11 @@ namespace ROOT {
 namespace RDF {
 class RDataSource;
 }
+namespace Internal {
+namespace RDF {
+class RProfiler;
+}
+} // namespace Internal
 namespace Detail {
 namespace RDF {
 
@@ -48,6 +53,9 @@ protected:
    ROOT::RVecB fIsDefine;
    std::vector<std::string> fVariationDeps; ///< List of systematic variations that affect the value of this define.
    std::string fVariation;                  ///< This indicates for what variation this define evaluates values.
+   RDFInternal::RProfiler *fProfiler = nullptr; ///< Measures the evaluations of this define, if profiling is enabled.
+   unsigned int fProfilerId = 0;               ///< Id of this define in fProfiler.
+   std::string fExpression; ///< The expression of a jitted define, empty for defines booked with a C++ callable.
 
 public:
    RDefineBase(std::string_view name, std::string_view type, const RDFInternal::RColumnRegister &colRegister,
@@ -62,6 +70,16 @@ public:
    virtual const std::type_info &GetTypeId() const = 0;
    std::string GetName() const;
    std::string GetTypeName() const;
+   const ColumnNames_t &GetColumnNames() const { return fColumnNames; }
+   const RDFInternal::RColumnRegister &GetColRegister() const { return fColRegister; }
+   const std::string &GetVariation() const { return fVariation; }
+   const std::string &GetExpression() const { return fExpression; }
+   void SetExpression(const std::string &expression) { fExpression = expression; }
+   void SetProfiler(RDFInternal::RProfiler *profiler, unsigned int id)
+   {
+      fProfiler = profiler;
+      fProfilerId = id;
+   }
    /// Update the value at the address returned by GetValuePtr with the content corresponding to the given entry
    virtual void Update(unsigned int slot, Long64_t entry) = 0;
    /// Update function to be called once per sample, used if the derived type is a RDefinePerSample
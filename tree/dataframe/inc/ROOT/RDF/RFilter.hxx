@@ -17,6 +17,7 @@
 #include "ROOT/RDF/Utils.hxx"
 #include "ROOT/RDF/RFilterBase.hxx"
 #include "ROOT/RDF/RLoopManager.hxx"
+#include "ROOT/RDF/RProfiler.hxx"
 #include "ROOT/TypeTraits.hxx"
 #include "RtypesCore.h"
 
@@ -68,6 +69,15 @@ class R__CLING_PTRCHECK(off) RFilter final : public RFilterBase {
    std::vector<std::array<RColumnReaderBase *, ColumnTypes_t::list_size>> fValues;
    const std::shared_ptr<PrevNode_t> fPrevNodePtr;
    PrevNode_t &fPrevNode;
+   /// For varied filters, the nominal filter they were cloned from. Varied filters whose input values are not affected
+   /// by their variation (only upstream nodes are) reuse the evaluation of the nominal filter expression.
+   RFilter *fNominalFilter = nullptr;
+   /// Per slot: whether this varied filter reads the same column values as the nominal filter.
+   std::vector<char> fSharesNominalValues;
+   /// Per slot: last entry for which the filter expression was evaluated and its result, for sharing with varied
+   /// filters. Only used by filters that have varied clones.
+   std::vector<Long64_t> fLastEvaluatedEntry;
+   std::vector<int> fLastEvaluation;
 
 public:
    RFilter(FilterF f, const ROOT::RDF::ColumnNames_t &columns, std::shared_ptr<PrevNode_t> pd,
@@ -76,7 +86,9 @@ public:
       : RFilterBase(pd->GetLoopManagerUnchecked(), name, pd->GetLoopManagerUnchecked()->GetNSlots(), colRegister,
                     columns, pd->GetVariations(), variationName),
         fFilter(std::move(f)), fValues(pd->GetLoopManagerUnchecked()->GetNSlots()), fPrevNodePtr(std::move(pd)),
-        fPrevNode(*fPrevNodePtr)
+        fPrevNode(*fPrevNodePtr), fSharesNominalValues(fLoopManager->GetNSlots(), false),
+        fLastEvaluatedEntry(fLoopManager->GetNSlots() * RDFInternal::CacheLineStep<Long64_t>(), -1),
+        fLastEvaluation(fLoopManager->GetNSlots() * RDFInternal::CacheLineStep<int>(), 0)
    {
       fLoopManager->Register(this);
    }
@@ -97,7 +109,11 @@ public:
             fLastResult[slot * RDFInternal::CacheLineStep<int>()] = false;
          } else {
             // evaluate this filter, cache the result
-            auto passed = CheckFilterHelper(slot, entry, ColumnTypes_t{}, TypeInd_t{});
+            bool passed = false;
+            {
+               RDFInternal::RProfilerScope profile(fProfiler, slot, fProfilerId);
+               passed = EvalFilter(slot, entry);
+            }
             passed ? ++fAccepted[slot * RDFInternal::CacheLineStep<ULong64_t>()]
                    : ++fRejected[slot * RDFInternal::CacheLineStep<ULong64_t>()];
             fLastResult[slot * RDFInternal::CacheLineStep<int>()] = passed;
@@ -107,6 +123,25 @@ public:
       return fLastResult[slot * RDFInternal::CacheLineStep<int>()];
    }
 
+   /// Evaluate the filter expression (regardless of upstream filters) for the given entry.
+   /// With systematic variations, the evaluation is shared between the nominal filter and the varied filters that read
+   /// the same input values, so that it happens once per entry rather than once per variation.
+   bool EvalFilter(unsigned int slot, Long64_t entry)
+   {
+      if (fNominalFilter != nullptr && fSharesNominalValues[slot])
+         return fNominalFilter->EvalFilter(slot, entry);
+      if (fVariedFilters.empty())
+         return CheckFilterHelper(slot, entry, ColumnTypes_t{}, TypeInd_t{});
+
+      auto &lastEntry = fLastEvaluatedEntry[slot * RDFInternal::CacheLineStep<Long64_t>()];
+      auto &lastEvaluation = fLastEvaluation[slot * RDFInternal::CacheLineStep<int>()];
+      if (entry != lastEntry) {
+         lastEvaluation = CheckFilterHelper(slot, entry, ColumnTypes_t{}, TypeInd_t{});
+         lastEntry = entry;
+      }
+      return lastEvaluation;
+   }
+
    template <typename... ColTypes, std::size_t... S>
    bool CheckFilterHelper(unsigned int slot, Long64_t entry, TypeList<ColTypes...>, std::index_sequence<S...>)
    {
@@ -121,6 +156,12 @@ public:
       RDFInternal::RColumnReadersInfo info{fColumnNames, fColRegister, fIsDefine.data(), *fLoopManager};
       fValues[slot] = RDFInternal::GetColumnReaders(slot, r, ColumnTypes_t{}, info, fVariation);
       fLastCheckedEntry[slot * RDFInternal::CacheLineStep<Long64_t>()] = -1;
+      fLastEvaluatedEntry[slot * RDFInternal::CacheLineStep<Long64_t>()] = -1;
+      if (fNominalFilter != nullptr) {
+         // the readers are shared between variations, so the same readers mean the same values
+         fSharesNominalValues[slot] =
+            fValues[slot] == RDFInternal::GetColumnReaders(slot, r, ColumnTypes_t{}, info, "nominal");
+      }
    }
 
    // recursive chain of `Report`s
@@ -209,8 +250,9 @@ public:
 
       // the varied filters get a copy of the callable object.
       // TODO document this
-      auto variedFilter = std::unique_ptr<RFilterBase>(
-         new RFilter(fFilter, fColumnNames, std::move(prevNode), fColRegister, fName, variationName));
+      auto *variedFilterPtr = new RFilter(fFilter, fColumnNames, std::move(prevNode), fColRegister, fName, variationName);
+      variedFilterPtr->fNominalFilter = this;
+      auto variedFilter = std::unique_ptr<RFilterBase>(variedFilterPtr);
       auto e = fVariedFilters.insert({variationName, std::move(variedFilter)});
       return e.first->second;
    }
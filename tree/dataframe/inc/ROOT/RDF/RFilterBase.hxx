@@ -29,6 +29,12 @@ namespace RDF {
 class RCutFlowReport;
 } // ns RDF
 
+namespace Internal {
+namespace RDF {
+class RProfiler;
+} // ns RDF
+} // ns Internal
+
 namespace Detail {
 namespace RDF {
 namespace RDFInternal = ROOT::Internal::RDF;
@@ -48,6 +54,9 @@ protected:
    ROOT::RVecB fIsDefine;
    std::string fVariation; ///< This indicates for what variation this filter evaluates values.
    std::unordered_map<std::string, std::shared_ptr<RFilterBase>> fVariedFilters;
+   RDFInternal::RProfiler *fProfiler = nullptr; ///< Measures the evaluations of this filter, if profiling is enabled.
+   unsigned int fProfilerId = 0;               ///< Id of this filter in fProfiler.
+   std::string fExpression; ///< The expression of a jitted filter, empty for filters booked with a C++ callable.
 
 public:
    RFilterBase(RLoopManager *df, std::string_view name, const unsigned int nSlots,
@@ -60,6 +69,16 @@ public:
    virtual void InitSlot(TTreeReader *r, unsigned int slot) = 0;
    bool HasName() const;
    std::string GetName() const;
+   const ColumnNames_t &GetColumnNames() const { return fColumnNames; }
+   const RDFInternal::RColumnRegister &GetColRegister() const { return fColRegister; }
+   const std::string &GetVariation() const { return fVariation; }
+   const std::string &GetExpression() const { return fExpression; }
+   void SetExpression(const std::string &expression) { fExpression = expression; }
+   void SetProfiler(RDFInternal::RProfiler *profiler, unsigned int id)
+   {
+      fProfiler = profiler;
+      fProfilerId = id;
+   }
    virtual void FillReport(ROOT::RDF::RCutFlowReport &) const;
    virtual void TriggerChildrenCount() = 0;
    virtual void ResetReportCount()
@@ -11,6 +11,7 @@
 #ifndef ROOT_RDF_TINTERFACE
 #define ROOT_RDF_TINTERFACE
 
+#include "ROOT/RCacheOptions.hxx"
 #include "ROOT/RDataSource.hxx"
 #include "ROOT/RDF/ActionHelpers.hxx"
 #include "ROOT/RDF/HistoModels.hxx"
@@ -19,6 +20,7 @@
 #include "ROOT/RDF/RDefine.hxx"
 #include "ROOT/RDF/RDefinePerSample.hxx"
 #include "ROOT/RDF/RFilter.hxx"
+#include "ROOT/RDF/RCacheDS.hxx"
 #include "ROOT/RDF/RInterfaceBase.hxx"
 #include "ROOT/RDF/RVariation.hxx"
 #include "ROOT/RDF/RLazyDSImpl.hxx"
@@ -86,11 +88,20 @@ template <typename Proxied, typename DataSource>
 class RInterface;
 
 using RNode = RInterface<::ROOT::Detail::RDF::RNodeBase, void>;
+
+namespace Experimental {
+class RProfileReport;
+} // namespace Experimental
 } // namespace RDF
 
 namespace Internal {
 namespace RDF {
 void ChangeEmptyEntryRange(const ROOT::RDF::RNode &node, std::pair<ULong64_t, ULong64_t> &&newRange);
+void SetResultCache(const ROOT::RDF::RNode &node, const std::string &fileName, const std::string &tag);
+void SetProfiling(const ROOT::RDF::RNode &node, const std::string &traceFileName, unsigned int traceSamplingInterval);
+const ROOT::RDF::Experimental::RProfileReport &GetProfileReport(const ROOT::RDF::RNode &node);
+void RequestStop(const ROOT::RDF::RNode &node);
+std::size_t GetNBookedActions(const ROOT::RDF::RNode &node);
 } // namespace RDF
 } // namespace Internal
 
@@ -122,6 +133,12 @@ class RInterface : public RInterfaceBase {
 
    friend void RDFInternal::TriggerRun(RNode &node);
    friend void RDFInternal::ChangeEmptyEntryRange(const RNode &node, std::pair<ULong64_t, ULong64_t> &&newRange);
+   friend void RDFInternal::SetResultCache(const RNode &node, const std::string &fileName, const std::string &tag);
+   friend void
+   RDFInternal::SetProfiling(const RNode &node, const std::string &traceFileName, unsigned int traceSamplingInterval);
+   friend const ROOT::RDF::Experimental::RProfileReport &RDFInternal::GetProfileReport(const RNode &node);
+   friend void RDFInternal::RequestStop(const RNode &node);
+   friend std::size_t RDFInternal::GetNBookedActions(const RNode &node);
 
    std::shared_ptr<Proxied> fProxiedPtr; ///< Smart pointer to the graph node encapsulated by this RInterface.
 
@@ -1109,6 +1126,14 @@ public:
    /// Use `Cache` if you know you will only need a subset of the (`Filter`ed) data that
    /// fits in memory and that will be accessed many times.
    ///
+   /// If the data might not fit in memory, pass a RCacheOptions object with a memory budget (in bytes). If the cached
+   /// values exceed the budget, they are moved to a TTree in temporary files (in RCacheOptions::fSpillDirectory or in
+   /// the system's temporary directory), which are deleted together with the cached RDataFrame. The cached RDataFrame
+   /// then reads those files instead of the memory, with the same support for multi-thread event loops.
+   /// The memory footprint of the cached values is estimated from their `sizeof` (plus the size of the elements of
+   /// collections): objects that allocate further memory on the heap are only partially accounted for. Columns must
+   /// have a dictionary to be moved to disk.
+   ///
    /// \note Cache will refuse to process columns with names of the form `#columnname`. These are special columns
    /// made available by some data sources (e.g. RNTupleDS) that represent the size of column `columnname`, and are
    /// not meant to be written out with that name (which is not a valid C++ variable name). Instead, go through an
@@ -1130,20 +1155,26 @@ public:
    /// ~~~{.cpp}
    /// auto cache_all_cols_df = df.Cache(myRegexp);
    /// ~~~
+   ///
+   /// **At most 2 GB of memory, then spill to disk:**
+   /// ~~~{.cpp}
+   /// auto cache_df = df.Cache({"col0", "col1"}, ROOT::RDF::RCacheOptions(2000000000ull, "/scratch"));
+   /// ~~~
    template <typename... ColumnTypes>
-   RInterface<RLoopManager> Cache(const ColumnNames_t &columnList)
+   RInterface<RLoopManager> Cache(const ColumnNames_t &columnList, const RCacheOptions &options = RCacheOptions())
    {
       auto staticSeq = std::make_index_sequence<sizeof...(ColumnTypes)>();
-      return CacheImpl<ColumnTypes...>(columnList, staticSeq);
+      return CacheImpl<ColumnTypes...>(columnList, staticSeq, options);
    }
 
    ////////////////////////////////////////////////////////////////////////////
    /// \brief Save selected columns in memory.
    /// \param[in] columnList columns to be cached in memory
+   /// \param[in] options options to limit the memory used by the cache
    /// \return a `RDataFrame` that wraps the cached dataset.
    ///
    /// See the previous overloads for more information.
-   RInterface<RLoopManager> Cache(const ColumnNames_t &columnList)
+   RInterface<RLoopManager> Cache(const ColumnNames_t &columnList, const RCacheOptions &options = RCacheOptions())
    {
       // Early return: if the list of columns is empty, just return an empty RDF
       // If we proceed, the jitted call will not compile!
@@ -1176,7 +1207,8 @@ public:
       if (!columnListWithoutSizeColumns.empty())
          cacheCall.seekp(-2, cacheCall.cur);                         // remove the last ",
       cacheCall << ">(*reinterpret_cast<std::vector<std::string>*>(" // vector<string> should be ColumnNames_t
-                << RDFInternal::PrettyPrintAddr(&columnListWithoutSizeColumns) << "));";
+                << RDFInternal::PrettyPrintAddr(&columnListWithoutSizeColumns) << "), "
+                << "*reinterpret_cast<ROOT::RDF::RCacheOptions*>(" << RDFInternal::PrettyPrintAddr(&options) << "));";
 
       // book the code to jit with the RLoopManager and trigger the event loop
       fLoopManager->ToJitExec(cacheCall.str());
@@ -1188,11 +1220,12 @@ public:
    ////////////////////////////////////////////////////////////////////////////
    /// \brief Save selected columns in memory.
    /// \param[in] columnNameRegexp The regular expression to match the column names to be selected. The presence of a '^' and a '$' at the end of the string is implicitly assumed if they are not specified. The dialect supported is PCRE via the TPRegexp class. An empty string signals the selection of all columns.
+   /// \param[in] options options to limit the memory used by the cache
    /// \return a `RDataFrame` that wraps the cached dataset.
    ///
    /// The existing columns are matched against the regular expression. If the string provided
    /// is empty, all columns are selected. See the previous overloads for more information.
-   RInterface<RLoopManager> Cache(std::string_view columnNameRegexp = "")
+   RInterface<RLoopManager> Cache(std::string_view columnNameRegexp = "", const RCacheOptions &options = RCacheOptions())
    {
       const auto definedColumns = fColRegister.GetNames();
       auto *tree = fLoopManager->GetTree();
@@ -1209,19 +1242,21 @@ public:
       columnNames.insert(columnNames.end(), treeBranchNames.begin(), treeBranchNames.end());
       columnNames.insert(columnNames.end(), dsColumns.begin(), dsColumns.end());
       const auto selectedColumns = RDFInternal::ConvertRegexToColumns(columnNames, columnNameRegexp, "Cache");
-      return Cache(selectedColumns);
+      return Cache(selectedColumns, options);
    }
 
    ////////////////////////////////////////////////////////////////////////////
    /// \brief Save selected columns in memory.
    /// \param[in] columnList columns to be cached in memory.
+   /// \param[in] options options to limit the memory used by the cache
    /// \return a `RDataFrame` that wraps the cached dataset.
    ///
    /// See the previous overloads for more information.
-   RInterface<RLoopManager> Cache(std::initializer_list<std::string> columnList)
+   RInterface<RLoopManager>
+   Cache(std::initializer_list<std::string> columnList, const RCacheOptions &options = RCacheOptions())
    {
       ColumnNames_t selectedColumns(columnList);
-      return Cache(selectedColumns);
+      return Cache(selectedColumns, options);
    }
 
    // clang-format off
@@ -1444,9 +1479,11 @@ public:
       using Action_t = RDFInternal::RAction<Helper_t, Proxied>;
       auto valuesPtr = std::make_shared<COLL>();
       const auto nSlots = fLoopManager->GetNSlots();
+      // without Filters or Ranges upstream, every entry of the dataset contributes a value
+      const ULong64_t sizeHint = std::is_same<Proxied, RLoopManager>::value ? fLoopManager->GetNEntriesHint() : 0;
 
-      auto action =
-         std::make_unique<Action_t>(Helper_t(valuesPtr, nSlots), validColumnNames, fProxiedPtr, fColRegister);
+      auto action = std::make_unique<Action_t>(Helper_t(valuesPtr, nSlots, sizeHint), validColumnNames, fProxiedPtr,
+                                               fColRegister);
       return MakeResultPtr(valuesPtr, *fLoopManager, std::move(action));
    }
 
@@ -2852,7 +2889,8 @@ private:
    ////////////////////////////////////////////////////////////////////////////
    /// \brief Implementation of cache.
    template <typename... ColTypes, std::size_t... S>
-   RInterface<RLoopManager> CacheImpl(const ColumnNames_t &columnList, std::index_sequence<S...>)
+   RInterface<RLoopManager>
+   CacheImpl(const ColumnNames_t &columnList, std::index_sequence<S...>, const RCacheOptions &options)
    {
       const auto columnListWithoutSizeColumns = RDFInternal::FilterArraySizeColNames(columnList, "Snapshot");
 
@@ -2863,6 +2901,17 @@ private:
 
       RDFInternal::CheckTypesAndPars(sizeof...(ColTypes), columnListWithoutSizeColumns.size());
 
+      if (options.fMemoryBudget > 0ull) {
+         // the cache might not fit in memory: fill a store that can spill to disk
+         using Store_t = RDFInternal::RCacheStore<ColTypes...>;
+         auto store =
+            std::make_shared<Store_t>(columnListWithoutSizeColumns, options, fLoopManager->GetNSlots());
+         auto storePtr = this->template Book<ColTypes...>(RDFInternal::RCacheHelper<ColTypes...>(store),
+                                                          columnListWithoutSizeColumns);
+         auto ds = std::make_unique<RDFInternal::RCacheDS<ColTypes...>>(storePtr, columnListWithoutSizeColumns);
+         return RInterface<RLoopManager>(std::make_shared<RLoopManager>(std::move(ds), columnListWithoutSizeColumns));
+      }
+
       auto colHolders = std::make_tuple(Take<ColTypes>(columnListWithoutSizeColumns[S])...);
       auto ds = std::make_unique<RLazyDS<ColTypes...>>(
          std::make_pair(columnListWithoutSizeColumns[S], std::get<S>(colHolders))...);
@@ -18,6 +18,7 @@
 #include "ROOT/RDF/RNewSampleNotifier.hxx"
 #include "ROOT/RDF/RSampleInfo.hxx"
 
+#include <atomic>
 #include <functional>
 #include <limits>
 #include <map>
@@ -27,6 +28,7 @@
 #include <vector>
 
 // forward declarations
+class TObject;
 class TTree;
 class TTreeReader;
 class TDirectory;
@@ -35,6 +37,9 @@ namespace ROOT {
 namespace RDF {
 class RCutFlowReport;
 class RDataSource;
+namespace Experimental {
+class RProfileReport;
+} // ns Experimental
 } // ns RDF
 
 namespace Internal {
@@ -44,6 +49,7 @@ std::vector<std::string> GetBranchNames(TTree &t, bool allowDuplicates = true);
 class GraphNode;
 class RActionBase;
 class RVariationBase;
+class RProfiler;
 
 namespace GraphDrawing {
 class GraphCreatorHelper;
@@ -157,12 +163,28 @@ class RLoopManager : public RNodeBase {
 
    ROOT::Internal::TreeUtils::RNoCleanupNotifier fNoCleanupNotifier;
 
+   /// Name of the file used as persistent cache of action results. Empty if the result cache is disabled.
+   std::string fResultCacheFileName;
+   /// User-provided string that is mixed into the keys of the result cache.
+   std::string fResultCacheTag;
+   /// Actions whose results can be stored in the result cache, together with their results.
+   std::vector<std::pair<std::weak_ptr<RDFInternal::RActionBase>, std::weak_ptr<TObject>>> fCacheableResults;
+
+   /// Collects per-node timing and I/O statistics of the event loops. Null if profiling is disabled.
+   std::unique_ptr<RDFInternal::RProfiler> fProfiler;
+
+   /// Set by RequestStop() to end the running event loop early, reset at the beginning of every event loop.
+   std::atomic<bool> fStopRequested{false};
+
    void RunEmptySourceMT();
    void RunEmptySource();
    void RunTreeProcessorMT();
    void RunTreeReader();
    void RunDataSourceMT();
    void RunDataSource();
+   static void RunSharedTreeReader(const std::vector<RLoopManager *> &loopManagers);
+   static void RunSharedTreeProcessorMT(const std::vector<RLoopManager *> &loopManagers);
+   static std::vector<std::string> GetCacheDeferredBranches(const std::vector<RLoopManager *> &loopManagers);
    void RunAndCheckFilters(unsigned int slot, Long64_t entry);
    void InitNodeSlots(TTreeReader *r, unsigned int slot);
    void InitNodes();
@@ -172,6 +194,12 @@ class RLoopManager : public RNodeBase {
    void SetupSampleCallbacks(TTreeReader *r, unsigned int slot);
    void UpdateSampleInfo(unsigned int slot, const std::pair<ULong64_t, ULong64_t> &range);
    void UpdateSampleInfo(unsigned int slot, TTreeReader &r);
+   std::string GetDatasetSignature() const;
+   std::string GetResultCacheKey(RDFInternal::RActionBase &action, const TObject &result);
+   std::vector<std::pair<std::string, std::shared_ptr<TObject>>> RestoreCachedResults();
+   void StoreCachedResults(const std::vector<std::pair<std::string, std::shared_ptr<TObject>>> &results);
+   void BeginProfiling();
+   void EndProfiling();
 
 public:
    RLoopManager(TTree *tree, const ColumnNames_t &defaultBranches);
@@ -180,15 +208,19 @@ public:
    RLoopManager(ROOT::RDF::Experimental::RDatasetSpec &&spec);
    RLoopManager(const RLoopManager &) = delete;
    RLoopManager &operator=(const RLoopManager &) = delete;
+   ~RLoopManager();
 
    void JitDeclarations();
    void Jit();
    RLoopManager *GetLoopManagerUnchecked() final { return this; }
    void Run(bool jit = true);
+   static void RunSharedScan(const std::vector<RLoopManager *> &loopManagers, bool jit = true);
+   std::string GetSharedScanKey() const;
    const ColumnNames_t &GetDefaultColumnNames() const;
    TTree *GetTree() const;
    ::TDirectory *GetDirectory() const;
    ULong64_t GetNEmptyEntries() const { return fEmptyEntryRange.second - fEmptyEntryRange.first; }
+   ULong64_t GetNEntriesHint() const;
    RDataSource *GetDataSource() const { return fDataSource.get(); }
    void Register(RDFInternal::RActionBase *actionPtr);
    void Deregister(RDFInternal::RActionBase *actionPtr);
@@ -208,6 +240,10 @@ public:
    void SetTree(std::shared_ptr<TTree> tree);
    void IncrChildrenCount() final { ++fNChildren; }
    void StopProcessing() final { ++fNStopsReceived; }
+   /// Ask the running event loop to end as soon as possible; can be called from any thread. Entries that are being
+   /// processed are completed, the remaining ones are skipped. Single event loops only, RunGraphs ignores it.
+   void RequestStop() { fStopRequested = true; }
+   std::size_t GetNBookedActions() const { return fBookedActions.size(); }
    void ToJitExec(const std::string &) const;
    void RegisterCallback(ULong64_t everyNEvents, std::function<void(unsigned int)> &&f);
    unsigned int GetNRuns() const { return fNRuns; }
@@ -238,6 +274,15 @@ public:
    void AddSampleCallback(void *nodePtr, ROOT::RDF::SampleCallback_t &&callback);
 
    void SetEmptyEntryRange(std::pair<ULong64_t, ULong64_t> &&newRange);
+
+   void SetResultCache(const std::string &fileName, const std::string &tag);
+   bool IsResultCacheEnabled() const { return !fResultCacheFileName.empty(); }
+   void RegisterCacheableResult(const std::shared_ptr<RDFInternal::RActionBase> &actionPtr,
+                                const std::shared_ptr<TObject> &result);
+
+   void SetProfiling(const std::string &traceFileName, unsigned int traceSamplingInterval);
+   RDFInternal::RProfiler *GetProfiler() const { return fProfiler.get(); }
+   const ROOT::RDF::Experimental::RProfileReport &GetProfileReport() const;
 };
 
 } // ns RDF
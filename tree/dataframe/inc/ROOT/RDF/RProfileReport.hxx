@@ -0,0 +1,68 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RDF_RPROFILEREPORT
+#define ROOT_RDF_RPROFILEREPORT
+
+#include "RtypesCore.h"
+
+#include <string>
+#include <vector>
+
+namespace ROOT {
+namespace RDF {
+namespace Experimental {
+
+/**
+\class ROOT::RDF::Experimental::RProfileReport
+\ingroup dataframe
+\brief Where the time of an RDataFrame event loop went, node by node.
+
+Produced by the profiling mode enabled with ROOT::RDF::Experimental::EnableProfiling and retrieved with
+ROOT::RDF::Experimental::GetProfileReport. There is one entry per Filter, Define, action and dataset column that was
+evaluated during the last event loop, sorted by decreasing self time.
+*/
+class RProfileReport {
+public:
+   /// Profile of one node of the computation graph, summed over all processing slots.
+   struct RNodeProfile {
+      std::string fKind;  ///< "Filter", "Define", "Action" or "Column"
+      std::string fName;  ///< Filter name, Define'd column name, action name or dataset column name
+      ULong64_t fCalls{0}; ///< Number of evaluations. For columns, number of times a value was retrieved.
+      /// Wall time in seconds, including the nodes evaluated on demand from within this one
+      /// (e.g. the Defines and columns read by a Filter).
+      double fTotalTime{0.};
+      double fSelfTime{0.};     ///< Wall time in seconds, excluding nested nodes.
+      ULong64_t fBytesRead{0};  ///< Bytes read from storage while retrieving the values of this column.
+      double fUnzipTime{0.};    ///< Seconds spent decompressing data while retrieving the values of this column.
+      std::vector<double> fSelfTimePerSlot; ///< fSelfTime broken down by processing slot.
+   };
+
+private:
+   std::vector<RNodeProfile> fNodes;
+   double fEventLoopTime{0.};
+   ULong64_t fNEntries{0};
+
+public:
+   RProfileReport() = default;
+   RProfileReport(std::vector<RNodeProfile> &&nodes, double eventLoopTime, ULong64_t nEntries);
+
+   const std::vector<RNodeProfile> &GetNodes() const { return fNodes; }
+   /// Wall time of the event loop in seconds.
+   double GetEventLoopTime() const { return fEventLoopTime; }
+   /// Number of entries processed by the event loop.
+   ULong64_t GetNEntries() const { return fNEntries; }
+   std::string AsString() const;
+   void Print() const;
+};
+
+} // namespace Experimental
+} // namespace RDF
+} // namespace ROOT
+
+#endif // ROOT_RDF_RPROFILEREPORT
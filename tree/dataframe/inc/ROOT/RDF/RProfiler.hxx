@@ -0,0 +1,213 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_RDF_RPROFILER
+#define ROOT_RDF_RPROFILER
+
+#include "ROOT/RDF/RColumnReaderBase.hxx"
+#include "ROOT/RDF/RProfileReport.hxx"
+#include "RtypesCore.h"
+#include "TVirtualPerfStats.h"
+
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ROOT {
+namespace Internal {
+namespace RDF {
+
+/**
+\class ROOT::Internal::RDF::RProfiler
+\ingroup dataframe
+\brief Collect per-node timing and I/O statistics during the event loops of an RLoopManager.
+
+Created by ROOT::RDF::Experimental::EnableProfiling. Before each event loop, RLoopManager assigns an id to every Filter,
+Define and action node; dataset column readers are wrapped in a RProfiledColumnReader and get an id when they are
+created. The nodes measure their evaluations with a RProfilerScope: call counts and wall times are accumulated per slot,
+and nested evaluations (e.g. a Define evaluated on demand by a Filter) are subtracted from the self time of the outer
+node. Bytes read and decompression time are collected through a thread-local gPerfStats monitor that is installed for
+the duration of each task, and attributed to the column whose read triggered them.
+One entry every fSamplingInterval (per slot) is also recorded in full as a sequence of trace events, which can be
+written out in the Chrome trace event format (viewable e.g. in chrome://tracing or Perfetto).
+*/
+class RProfiler {
+public:
+   using Clock_t = std::chrono::steady_clock;
+   enum class ENodeKind { kFilter, kDefine, kAction, kColumn };
+
+   /// Statistics of one node in one processing slot. Times are in nanoseconds.
+   struct RNodeStats {
+      ULong64_t fCalls{0};
+      ULong64_t fTotalTime{0};
+      ULong64_t fSelfTime{0};
+      ULong64_t fBytesRead{0};
+      ULong64_t fUnzipTime{0};
+   };
+
+   /// One interval of the trace: a node evaluation or, if fNodeId is kTaskId, the processing of a whole task.
+   struct RTraceEvent {
+      unsigned int fNodeId;
+      ULong64_t fStart;    ///< Nanoseconds since the beginning of the event loop
+      ULong64_t fDuration; ///< Nanoseconds
+   };
+
+   /// State of one processing slot. Only accessed by the thread that is currently processing the slot.
+   struct RSlotData {
+      std::vector<RNodeStats> fStats;    ///< Indexed by node id
+      std::vector<ULong64_t> fChildTime; ///< Time spent in nested nodes, one element per node being evaluated
+      std::vector<RTraceEvent> fTrace;
+      ULong64_t fNEntries{0};
+      bool fSampleEntry{false}; ///< Whether the current entry is recorded in the trace
+      Clock_t::time_point fTaskStart;
+      ULong64_t fBytesRead{0}; ///< Bytes read by this slot, as reported to gPerfStats
+      ULong64_t fUnzipTime{0}; ///< Nanoseconds spent decompressing by this slot, as reported to gPerfStats
+      std::unique_ptr<TVirtualPerfStats> fIOMonitor;
+      /// Profiling wrappers of the dataset column readers used in the current task, by wrapped reader.
+      std::unordered_map<ROOT::Detail::RDF::RColumnReaderBase *, std::unique_ptr<ROOT::Detail::RDF::RColumnReaderBase>>
+         fColumnReaders;
+   };
+
+   static constexpr unsigned int kTaskId = std::numeric_limits<unsigned int>::max();
+   /// Maximum number of trace events kept per slot, to bound memory usage.
+   static constexpr std::size_t kMaxTraceEvents = 1000000;
+
+private:
+   struct RNodeInfo {
+      ENodeKind fKind;
+      std::string fName;
+   };
+
+   std::string fTraceFileName;     ///< Where to write the Chrome trace at the end of each event loop, if not empty
+   unsigned int fSamplingInterval; ///< Record one entry every fSamplingInterval in the trace (0 to disable)
+   std::vector<RNodeInfo> fNodes;  ///< Indexed by node id
+   std::unordered_map<std::string, unsigned int> fColumnIds;
+   std::mutex fNodesMutex; ///< Protects fNodes and fColumnIds, columns are registered concurrently by several slots
+   std::vector<std::unique_ptr<RSlotData>> fSlots;
+   Clock_t::time_point fRunStart;
+   ROOT::RDF::Experimental::RProfileReport fReport;
+
+   unsigned int AddNode(ENodeKind kind, const std::string &name);
+   void UninstallIOMonitors();
+
+public:
+   RProfiler(const std::string &traceFileName, unsigned int samplingInterval);
+   RProfiler(const RProfiler &) = delete;
+   RProfiler &operator=(const RProfiler &) = delete;
+   ~RProfiler();
+
+   void BeginRun(unsigned int nSlots);
+   unsigned int RegisterNode(ENodeKind kind, const std::string &name);
+   void BeginTask(unsigned int slot);
+   void EndTask(unsigned int slot);
+   void EndRun();
+
+   void BeginEntry(unsigned int slot)
+   {
+      auto &s = *fSlots[slot];
+      s.fSampleEntry = fSamplingInterval > 0 && s.fNEntries % fSamplingInterval == 0;
+      ++s.fNEntries;
+   }
+
+   Clock_t::time_point Start(unsigned int slot)
+   {
+      fSlots[slot]->fChildTime.push_back(0);
+      return Clock_t::now();
+   }
+
+   void Stop(unsigned int slot, unsigned int nodeId, Clock_t::time_point start)
+   {
+      const auto stop = Clock_t::now();
+      const ULong64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+      auto &s = *fSlots[slot];
+      const auto childTime = s.fChildTime.back();
+      s.fChildTime.pop_back();
+      if (!s.fChildTime.empty())
+         s.fChildTime.back() += elapsed;
+      auto &stats = s.fStats[nodeId];
+      ++stats.fCalls;
+      stats.fTotalTime += elapsed;
+      stats.fSelfTime += elapsed > childTime ? elapsed - childTime : 0;
+      if (s.fSampleEntry && s.fTrace.size() < kMaxTraceEvents) {
+         const ULong64_t begin = std::chrono::duration_cast<std::chrono::nanoseconds>(start - fRunStart).count();
+         s.fTrace.push_back({nodeId, begin, elapsed});
+      }
+   }
+
+   RSlotData &GetSlotData(unsigned int slot) { return *fSlots[slot]; }
+
+   ROOT::Detail::RDF::RColumnReaderBase *
+   WrapColumnReader(unsigned int slot, const std::string &colName, ROOT::Detail::RDF::RColumnReaderBase *reader);
+
+   const ROOT::RDF::Experimental::RProfileReport &GetReport() const { return fReport; }
+   void WriteChromeTrace(const std::string &fileName) const;
+};
+
+/// Measure the evaluation of a node for the RProfiler, if any, for the lifetime of this object.
+class RProfilerScope {
+   RProfiler *fProfiler;
+   unsigned int fSlot;
+   unsigned int fNodeId;
+   RProfiler::Clock_t::time_point fStart;
+
+public:
+   RProfilerScope(RProfiler *profiler, unsigned int slot, unsigned int nodeId)
+      : fProfiler(profiler), fSlot(slot), fNodeId(nodeId)
+   {
+      if (fProfiler)
+         fStart = fProfiler->Start(fSlot);
+   }
+   RProfilerScope(const RProfilerScope &) = delete;
+   RProfilerScope &operator=(const RProfilerScope &) = delete;
+   ~RProfilerScope()
+   {
+      if (fProfiler)
+         fProfiler->Stop(fSlot, fNodeId, fStart);
+   }
+};
+
+/// Column reader that forwards to a dataset column reader, measuring time and I/O for the RProfiler.
+class R__CLING_PTRCHECK(off) RProfiledColumnReader final : public ROOT::Detail::RDF::RColumnReaderBase {
+   RProfiler &fProfiler;
+   ROOT::Detail::RDF::RColumnReaderBase &fReader;
+   unsigned int fSlot;
+   unsigned int fNodeId;
+
+   void *GetImpl(Long64_t entry) final
+   {
+      auto &slotData = fProfiler.GetSlotData(fSlot);
+      const auto bytesRead = slotData.fBytesRead;
+      const auto unzipTime = slotData.fUnzipTime;
+      void *value = nullptr;
+      {
+         RProfilerScope scope(&fProfiler, fSlot, fNodeId);
+         value = fReader.GetImpl(entry);
+      }
+      auto &stats = slotData.fStats[fNodeId];
+      stats.fBytesRead += slotData.fBytesRead - bytesRead;
+      stats.fUnzipTime += slotData.fUnzipTime - unzipTime;
+      return value;
+   }
+
+public:
+   RProfiledColumnReader(RProfiler &profiler, ROOT::Detail::RDF::RColumnReaderBase &reader, unsigned int slot,
+                         unsigned int nodeId)
+      : fProfiler(profiler), fReader(reader), fSlot(slot), fNodeId(nodeId)
+   {
+   }
+};
+
+} // namespace RDF
+} // namespace Internal
+} // namespace ROOT
+
+#endif // ROOT_RDF_RPROFILER
@@ -50,6 +50,9 @@ public:
    ~RRangeBase() override;
 
    void InitNode();
+   unsigned int GetStart() const { return fStart; }
+   unsigned int GetStop() const { return fStop; }
+   unsigned int GetStride() const { return fStride; }
 };
 
 } // ns RDF
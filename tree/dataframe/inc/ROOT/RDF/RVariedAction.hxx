@@ -16,6 +16,7 @@
 #include "RActionBase.hxx"
 #include "RColumnReaderBase.hxx"
 #include "RLoopManager.hxx"
+#include "RProfiler.hxx"
 #include "RJittedFilter.hxx"
 #include "ROOT/RDF/RMergeableValue.hxx"
 
@@ -45,6 +46,12 @@ class R__CLING_PTRCHECK(off) RVariedAction final : public RActionBase {
    std::vector<Helper> fHelpers; ///< Action helpers per variation.
    /// Owning pointers to upstream nodes for each systematic variation (with the "nominal" at index 0).
    std::vector<std::shared_ptr<PrevNodeType>> fPrevNodes;
+   /// The distinct upstream nodes: variations that do not affect the upstream filters share the nominal one.
+   std::vector<PrevNodeType *> fUniquePrevNodes;
+   /// Index in fUniquePrevNodes of the upstream node of each variation.
+   std::vector<std::size_t> fPrevNodeIdx;
+   /// Per slot (outer dimension) result of the upstream filters for the last entry, per element of fUniquePrevNodes.
+   std::vector<std::vector<char>> fPrevNodesPassed;
 
    /// Column readers per slot (outer dimension), per variation and per input column (inner dimension, std::array).
    std::vector<std::vector<std::array<RColumnReaderBase *, ColumnTypes_t::list_size>>> fInputValues;
@@ -75,13 +82,27 @@ class R__CLING_PTRCHECK(off) RVariedAction final : public RActionBase {
       return prevFilters;
    }
 
+   void SetUniquePrevNodes()
+   {
+      for (const auto &prevNode : fPrevNodes) {
+         auto it = std::find(fUniquePrevNodes.begin(), fUniquePrevNodes.end(), prevNode.get());
+         fPrevNodeIdx.emplace_back(std::distance(fUniquePrevNodes.begin(), it));
+         if (it == fUniquePrevNodes.end())
+            fUniquePrevNodes.emplace_back(prevNode.get());
+      }
+      for (auto &passed : fPrevNodesPassed)
+         passed.resize(fUniquePrevNodes.size());
+   }
+
 public:
    RVariedAction(std::vector<Helper> &&helpers, const ColumnNames_t &columns, std::shared_ptr<PrevNode> prevNode,
                  const RColumnRegister &colRegister)
       : RActionBase(prevNode->GetLoopManagerUnchecked(), columns, colRegister, prevNode->GetVariations()),
-        fHelpers(std::move(helpers)), fPrevNodes(MakePrevFilters(prevNode)), fInputValues(GetNSlots())
+        fHelpers(std::move(helpers)), fPrevNodes(MakePrevFilters(prevNode)), fPrevNodesPassed(GetNSlots()),
+        fInputValues(GetNSlots())
    {
       fLoopManager->Register(this);
+      SetUniquePrevNodes();
 
       for (auto i = 0u; i < columns.size(); ++i) {
          auto *define = colRegister.GetDefine(columns[i]);
@@ -122,12 +143,26 @@ public:
 
    void Run(unsigned int slot, Long64_t entry) final
    {
-      for (auto varIdx = 0u; varIdx < GetVariations().size(); ++varIdx) {
-         if (fPrevNodes[varIdx]->CheckFilters(slot, entry))
+      // evaluate each distinct chain of upstream filters once, then execute the helpers of the variations that pass
+      auto &passed = fPrevNodesPassed[slot];
+      bool anyPassed = false;
+      for (auto i = 0u; i < fUniquePrevNodes.size(); ++i) {
+         passed[i] = fUniquePrevNodes[i]->CheckFilters(slot, entry);
+         anyPassed |= passed[i];
+      }
+      if (!anyPassed)
+         return;
+
+      RProfilerScope profile(fProfiler, slot, fProfilerId);
+      const auto nVariations = fHelpers.size();
+      for (auto varIdx = 0u; varIdx < nVariations; ++varIdx) {
+         if (passed[fPrevNodeIdx[varIdx]])
             CallExec(slot, varIdx, entry, ColumnTypes_t{}, TypeInd_t{});
       }
    }
 
+   std::string GetActionName() final { return "Varied " + fHelpers[0].GetActionName(); }
+
    void TriggerChildrenCount() final
    {
       std::for_each(fPrevNodes.begin(), fPrevNodes.end(), [](auto &f) { f->IncrChildrenCount(); });
@@ -15,6 +15,7 @@
 
 #include <ROOT/RDF/GraphUtils.hxx>
 #include <ROOT/RDF/RActionBase.hxx>
+#include <ROOT/RDF/RProfileReport.hxx>
 #include <ROOT/RDF/RResultMap.hxx>
 #include <ROOT/RResultHandle.hxx> // users of RunGraphs might rely on this transitive include
 #include <ROOT/TypeTraits.hxx>
@@ -176,11 +177,103 @@ RNode AsRNode(NodeType node)
 /// // RResultPtr -> RResultHandle conversion is automatic
 /// ROOT::RDF::RunGraphs({r1, r2});
 /// ~~~
+///
+/// Computation graphs of different RDataFrames that read the same TTree or TChain (same tree name, same files and
+/// same entry range, no friends or entry lists) are fused into a single event loop: every entry is read and
+/// decompressed once and then processed by all of these graphs, one after the other. In this case the input files
+/// are only read once, regardless of the number of RDataFrames that use them:
+///
+/// ~~~{.cpp}
+/// ROOT::RDataFrame dfA("events", {"f1.root", "f2.root"});
+/// ROOT::RDataFrame dfB("events", {"f1.root", "f2.root"});
+/// auto hA = dfA.Filter("nMuon == 2").Histo1D("Muon_pt");
+/// auto hB = dfB.Filter("nElectron > 0").Histo1D("Electron_pt");
+/// ROOT::RDF::RunGraphs({hA, hB}); // one pass over f1.root and f2.root
+/// ~~~
 // clang-format on
 void RunGraphs(std::vector<RResultHandle> handles);
 
 namespace Experimental {
 
+// clang-format off
+/// \brief Store the results of a computation graph in a file and restore them instead of recomputing them in later runs.
+/// \param[in] node Any node of the computation graph. The cache is enabled for the whole graph.
+/// \param[in] fileName Path of the ROOT file used as cache. It is created if it does not exist.
+/// \param[in] tag An optional string that is mixed into the cache keys, e.g. to mark a change in the analysis code.
+///
+/// When the event loop starts, the result of each booked action is looked up in the cache file. Results that are found
+/// are read back from the file and their actions do not run; the others are computed as usual and written to the file
+/// at the end of the event loop. If all results can be restored, the dataset is not read at all.
+/// Iterating on an analysis, e.g. by adding a new histogram to a long list of existing ones, then only costs an event
+/// loop for the new results.
+///
+/// Each result is identified by a hash of:
+/// - the input dataset: tree name, names of the input files and, for local files, their size and modification time,
+///   friend trees, entry list and entry range (or number of entries for empty sources);
+/// - the branch of the computation graph that leads to the action, as represented by SaveGraph(): for example Filter
+///   names, names of Defined columns, action kind and name of the result histogram;
+/// - the string expressions of the Filters up to the action;
+/// - the input columns of the action and the names, types and string expressions of all columns Defined up to the
+///   action;
+/// - the model of the result: its name and, for histograms, title and binning;
+/// - the `tag` argument.
+///
+/// The code of Filters and Defines booked with a C++ callable is not part of the key: a change in the body of such a
+/// function that does not change names or types of columns is not detected. Change `tag` (or remove the cache file) in
+/// that case.
+/// RDataFrames that read from an RDataSource only have access to the label of the data source, so they must provide
+/// a `tag` that identifies the dataset, otherwise their results are not cached.
+///
+/// Only results of types that inherit from TObject (e.g. histograms, profiles and graphs) are cached. The cache must be
+/// enabled before booking the actions whose results should be cached.
+///
+/// ~~~{.cpp}
+/// ROOT::RDataFrame df("events", "data_*.root");
+/// ROOT::RDF::Experimental::EnableResultCache(df, "results_cache.root");
+/// auto selected = df.Filter("pt > 20");
+/// auto h1 = selected.Histo1D({"h1", "h1", 100, 0, 100}, "pt");
+/// auto h2 = selected.Histo1D({"h2", "h2", 100, -5, 5}, "eta");
+/// h1->Draw(); // in a second run of this program, h1 and h2 are read from the cache file
+/// ~~~
+// clang-format on
+void EnableResultCache(RNode node, std::string_view fileName, std::string_view tag = "");
+
+// clang-format off
+/// \brief Measure where the time of the event loops of a computation graph goes, node by node.
+/// \param[in] node Any node of the computation graph. Profiling is enabled for the whole graph.
+/// \param[in] traceFileName If not empty, a trace of the event loop is written to this file in the Chrome trace event
+///            format, which can be inspected with chrome://tracing or https://ui.perfetto.dev.
+/// \param[in] traceSamplingInterval One entry every traceSamplingInterval (per processing slot) is recorded in the trace.
+///            Lower values give more detailed traces but slow down the event loop more. 0 disables the per-entry trace.
+///
+/// During each event loop, every Filter, Define and action of the graph counts its evaluations and measures their wall
+/// time, per processing slot. Dataset columns are measured too, together with the bytes they read from storage and the
+/// time spent decompressing them. Times are reported both including and excluding the nodes evaluated from within a
+/// node: for example the time of a Filter includes the Defines and columns it reads, its self time does not.
+/// At the end of the event loop the report is logged at info level on the RDataFrame log channel and can be retrieved
+/// with GetProfileReport().
+///
+/// Profiling adds a small overhead to every node evaluation, so it is meant for performance investigations rather
+/// than production runs. Decompression done in background threads (TTreeCacheUnzip) is not attributed to columns.
+/// I/O triggered by the first column read of a TTree cluster, such as filling the TTreeCache, is attributed to that
+/// column.
+///
+/// ~~~{.cpp}
+/// ROOT::RDataFrame df("events", "data_*.root");
+/// ROOT::RDF::Experimental::EnableProfiling(df, "trace.json");
+/// auto h = df.Filter("pt > 20").Define("pt2", "pt * pt").Histo1D("pt2");
+/// h->Draw();
+/// ROOT::RDF::Experimental::GetProfileReport(df).Print();
+/// ~~~
+// clang-format on
+void EnableProfiling(RNode node, std::string_view traceFileName = "", unsigned int traceSamplingInterval = 1000);
+
+/// \brief Return the profile of the last event loop of a computation graph for which EnableProfiling was called.
+/// \param[in] node Any node of the computation graph.
+///
+/// Throws if profiling was not enabled. The report is empty if no event loop has run yet.
+RProfileReport GetProfileReport(RNode node);
+
 /// \brief Produce all required systematic variations for the given result.
 /// \param[in] resPtr The result for which variations should be produced.
 /// \return A \ref ROOT::RDF::Experimental::RResultMap "RResultMap" object with full variation names as strings
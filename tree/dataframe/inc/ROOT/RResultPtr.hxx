@@ -19,7 +19,9 @@
 
 #include <memory>
 #include <functional>
-#include <type_traits> // std::is_constructible
+#include <type_traits> // std::is_constructible, std::is_base_of
+
+class TObject;
 
 namespace ROOT {
 namespace RDF {
@@ -402,12 +404,27 @@ bool operator!=(std::nullptr_t lhs, const RResultPtr<T1> &rhs)
 
 namespace Detail {
 namespace RDF {
+/// Results that inherit from TObject can be written to file, hence they can be stored in the result cache.
+template <typename T, std::enable_if_t<std::is_base_of<TObject, T>::value, int> = 0>
+void RegisterCacheableResult(const std::shared_ptr<T> &r, RLoopManager &lm,
+                             const std::shared_ptr<RDFInternal::RActionBase> &actionPtr)
+{
+   lm.RegisterCacheableResult(actionPtr, r);
+}
+
+template <typename T, std::enable_if_t<!std::is_base_of<TObject, T>::value, int> = 0>
+void RegisterCacheableResult(const std::shared_ptr<T> &, RLoopManager &,
+                             const std::shared_ptr<RDFInternal::RActionBase> &)
+{
+}
+
 /// Create a RResultPtr and set its pointer to the corresponding RAction
 /// This overload is invoked by non-jitted actions, as they have access to RAction before constructing RResultPtr.
 template <typename T>
 RResultPtr<T>
 MakeResultPtr(const std::shared_ptr<T> &r, RLoopManager &lm, std::shared_ptr<RDFInternal::RActionBase> actionPtr)
 {
+   RegisterCacheableResult(r, lm, actionPtr);
    return RResultPtr<T>(r, &lm, std::move(actionPtr));
 }
 
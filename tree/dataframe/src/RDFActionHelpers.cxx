@@ -10,6 +10,16 @@
 
 #include "ROOT/RDF/ActionHelpers.hxx"
 #include "ROOT/RDF/Utils.hxx" // CacheLineStep
+#include "RConfigure.h"       // R__USE_IMT
+#include "TEnv.h"
+#include "TROOT.h" // IsImplicitMTEnabled
+#include "TSystem.h"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <algorithm>
+#include <cstdlib>
 
 namespace ROOT {
 namespace Internal {
@@ -279,6 +289,67 @@ void ValidateSnapshotOutput(const RSnapshotOptions &opts, const std::string &tre
    }
 }
 
+ULong64_t EstimateFillObjectSize(const TH1 &h)
+{
+   // bin contents take at most 8 bytes, and so do the sums of squared weights if they are stored;
+   // profiles also store the bin entries and their sums of squared weights
+   ULong64_t nArrays = h.GetSumw2N() > 0 ? 2 : 1;
+   if (h.InheritsFrom("TProfile") || h.InheritsFrom("TProfile2D") || h.InheritsFrom("TProfile3D"))
+      nArrays += 2;
+   return static_cast<ULong64_t>(h.GetNcells()) * sizeof(Double_t) * nArrays;
+}
+
+ULong64_t EstimateFillObjectSize(const THnBase &h)
+{
+   // for THnSparse this is the size the histogram would have if all bins were filled, as we cannot know in advance
+   long double nBins = 1.;
+   for (Int_t dim = 0; dim < h.GetNdimensions(); ++dim)
+      nBins *= h.GetAxis(dim)->GetNbins() + 2;
+   const long double size = nBins * sizeof(Double_t) * (h.GetCalculateErrors() ? 2 : 1);
+   const auto maxSize = static_cast<long double>(std::numeric_limits<ULong64_t>::max());
+   return size >= maxSize ? std::numeric_limits<ULong64_t>::max() : static_cast<ULong64_t>(size);
+}
+
+/// The memory budget is read from the environment variable ROOT_RDF_SHAREDFILLTHRESHOLD or from the
+/// RDataFrame.SharedFillThreshold rootrc setting, in MB. 0 means unlimited, i.e. always one object per slot.
+unsigned int GetNFillObjects(ULong64_t objectSize, unsigned int nSlots)
+{
+   Long64_t thresholdMB = 0;
+   const char *env = gSystem->Getenv("ROOT_RDF_SHAREDFILLTHRESHOLD");
+   if (env && *env)
+      thresholdMB = std::atoll(env);
+   else
+      thresholdMB = gEnv->GetValue("RDataFrame.SharedFillThreshold", 256);
+
+   if (nSlots <= 1 || thresholdMB <= 0 || objectSize == 0)
+      return nSlots;
+   const auto threshold = static_cast<ULong64_t>(thresholdMB) * 1024 * 1024;
+   if (objectSize <= threshold / (nSlots - 1))
+      return nSlots;
+   return static_cast<unsigned int>(std::max<ULong64_t>(1, threshold / objectSize));
+}
+
+bool ParallelTreeReduce(std::size_t n, const std::function<void(std::size_t, std::size_t)> &mergeInto)
+{
+#ifdef R__USE_IMT
+   if (n < 3 || !ROOT::IsImplicitMTEnabled())
+      return false;
+
+   ROOT::TThreadExecutor pool;
+   for (std::size_t stride = 1; stride < n; stride *= 2) {
+      std::vector<std::size_t> targets;
+      for (std::size_t i = 0; i + stride < n; i += 2 * stride)
+         targets.push_back(i);
+      pool.Foreach([&](std::size_t i) { mergeInto(i, i + stride); }, targets);
+   }
+   return true;
+#else
+   (void)n;
+   (void)mergeInto;
+   return false;
+#endif
+}
+
 } // end NS RDF
 } // end NS Internal
 } // end NS ROOT
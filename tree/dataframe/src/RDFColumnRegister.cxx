@@ -37,8 +37,13 @@ RDefineReader &RDefinesWithReaders::GetReader(unsigned int slot, const std::stri
       return *it->second;
 
    auto *define = fDefine.get();
-   if (variationName != "nominal")
+   if (variationName != "nominal") {
       define = &define->GetVariedDefine(variationName);
+      // the define does not depend on this variation: share the nominal reader, so that nodes can tell that the values
+      // they read are the same as in the nominal case
+      if (define == fDefine.get())
+         return GetReader(slot, "nominal");
+   }
 
 #if !defined(__clang__) && __GNUC__ >= 7 && __GNUC_MINOR__ >= 3
    const auto insertion = defineReaders.insert({variationName, std::make_unique<RDefineReader>(slot, *define)});
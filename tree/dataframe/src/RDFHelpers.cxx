@@ -22,6 +22,7 @@
 #endif // R__USE_IMT
 
 #include <algorithm>
+#include <map>
 #include <set>
 
 using ROOT::RDF::RResultHandle;
@@ -71,19 +72,38 @@ void ROOT::RDF::RunGraphs(std::vector<RResultHandle> handles)
       << " unique computation graphs) completed"
       << (sw.RealTime() > 1e-3 ? " in " + std::to_string(sw.RealTime()) + " seconds." : " in less than 1ms.");
 
-   // Trigger the unique event loops
-   auto run = [](RResultHandle &h) {
-      if (h.fLoopManager)
-         h.fLoopManager->Run(/*jit=*/false);
+   // Computation graphs that read the same dataset share a single event loop, so that the data is read only once
+   std::map<std::string, std::vector<ROOT::Detail::RDF::RLoopManager *>> sharedScans;
+   std::vector<std::vector<ROOT::Detail::RDF::RLoopManager *>> scans;
+   for (auto &h : uniqueLoops) {
+      if (!h.fLoopManager)
+         continue;
+      const auto key = h.fLoopManager->GetSharedScanKey();
+      if (key.empty())
+         scans.push_back({h.fLoopManager});
+      else
+         sharedScans[key].emplace_back(h.fLoopManager);
+   }
+   for (auto &scan : sharedScans)
+      scans.emplace_back(std::move(scan.second));
+   if (scans.size() < uniqueLoops.size()) {
+      R__LOG_INFO(ROOT::Detail::RDF::RDFLogChannel())
+         << "RunGraphs will run " << scans.size() << " event loops for " << uniqueLoops.size()
+         << " unique computation graphs.";
+   }
+
+   // Trigger the event loops
+   auto run = [](std::vector<ROOT::Detail::RDF::RLoopManager *> &scan) {
+      ROOT::Detail::RDF::RLoopManager::RunSharedScan(scan, /*jit=*/false);
    };
 
    sw.Start();
 #ifdef R__USE_IMT
    if (ROOT::IsImplicitMTEnabled()) {
-      ROOT::TThreadExecutor{}.Foreach(run, uniqueLoops);
+      ROOT::TThreadExecutor{}.Foreach(run, scans);
    } else {
 #endif
-      std::for_each(uniqueLoops.begin(), uniqueLoops.end(), run);
+      std::for_each(scans.begin(), scans.end(), run);
 #ifdef R__USE_IMT
    }
 #endif
@@ -92,3 +112,19 @@ void ROOT::RDF::RunGraphs(std::vector<RResultHandle> handles)
       << "Finished RunGraphs run (" << uniqueLoops.size() << " unique computation graphs, " << sw.CpuTime() << "s CPU, "
       << sw.RealTime() << "s elapsed).";
 }
+
+void ROOT::RDF::Experimental::EnableResultCache(RNode node, std::string_view fileName, std::string_view tag)
+{
+   ROOT::Internal::RDF::SetResultCache(node, std::string(fileName), std::string(tag));
+}
+
+void ROOT::RDF::Experimental::EnableProfiling(RNode node, std::string_view traceFileName,
+                                              unsigned int traceSamplingInterval)
+{
+   ROOT::Internal::RDF::SetProfiling(node, std::string(traceFileName), traceSamplingInterval);
+}
+
+ROOT::RDF::Experimental::RProfileReport ROOT::RDF::Experimental::GetProfileReport(RNode node)
+{
+   return ROOT::Internal::RDF::GetProfileReport(node);
+}
@@ -16,3 +16,30 @@ void ROOT::Internal::RDF::ChangeEmptyEntryRange(const ROOT::RDF::RNode &node,
    R__ASSERT(newRange.second >= newRange.first && "end is less than begin in the passed entry range!");
    node.GetLoopManager()->SetEmptyEntryRange(std::move(newRange));
 }
+
+void ROOT::Internal::RDF::SetResultCache(const ROOT::RDF::RNode &node, const std::string &fileName,
+                                         const std::string &tag)
+{
+   node.GetLoopManager()->SetResultCache(fileName, tag);
+}
+
+void ROOT::Internal::RDF::SetProfiling(const ROOT::RDF::RNode &node, const std::string &traceFileName,
+                                       unsigned int traceSamplingInterval)
+{
+   node.GetLoopManager()->SetProfiling(traceFileName, traceSamplingInterval);
+}
+
+const ROOT::RDF::Experimental::RProfileReport &ROOT::Internal::RDF::GetProfileReport(const ROOT::RDF::RNode &node)
+{
+   return node.GetLoopManager()->GetProfileReport();
+}
+
+void ROOT::Internal::RDF::RequestStop(const ROOT::RDF::RNode &node)
+{
+   node.GetLoopManager()->RequestStop();
+}
+
+std::size_t ROOT::Internal::RDF::GetNBookedActions(const ROOT::RDF::RNode &node)
+{
+   return node.GetLoopManager()->GetNBookedActions();
+}
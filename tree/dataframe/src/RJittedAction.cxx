@@ -109,6 +109,12 @@ void *RJittedAction::PartialUpdate(unsigned int slot)
    return fConcreteAction->PartialUpdate(slot);
 }
 
+std::string RJittedAction::GetActionName()
+{
+   // the action might not have been jitted yet
+   return fConcreteAction != nullptr ? fConcreteAction->GetActionName() : "JittedAction";
+}
+
 bool RJittedAction::HasRun() const
 {
    if (fConcreteAction != nullptr) {
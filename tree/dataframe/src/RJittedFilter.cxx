@@ -45,6 +45,7 @@ void RJittedFilter::SetFilter(std::unique_ptr<RFilterBase> f)
    // the concrete filter has been registered with RLoopManager on creation, so let's deregister ourselves
    fLoopManager->Deregister(this);
    fConcreteFilter = std::move(f);
+   fConcreteFilter->SetExpression(fExpression);
 }
 
 void RJittedFilter::InitSlot(TTreeReader *r, unsigned int slot)
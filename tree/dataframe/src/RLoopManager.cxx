@@ -14,6 +14,7 @@
 #include "ROOT/RDF/RDefineBase.hxx"
 #include "ROOT/RDF/RFilterBase.hxx"
 #include "ROOT/RDF/RLoopManager.hxx"
+#include "ROOT/RDF/RProfiler.hxx"
 #include "ROOT/RDF/RRangeBase.hxx"
 #include "ROOT/RDF/RVariationBase.hxx"
 #include "ROOT/RLogger.hxx"
@@ -22,10 +23,17 @@
 #include "TBranchElement.h"
 #include "TBranchObject.h"
 #include "TChain.h"
+#include "TDirectory.h"
 #include "TEntryList.h"
+#include "TEnv.h"
+#include "TError.h" // Warning
 #include "TFile.h"
 #include "TFriendElement.h"
+#include "TH1.h"
+#include "TKey.h"
+#include "TMD5.h"
 #include "TROOT.h" // IsImplicitMTEnabled
+#include "TSystem.h" // GetPathInfo
 #include "TTreeReader.h"
 #include "TTree.h" // For MaxTreeSizeRAII. Revert when #6640 will be solved.
 
@@ -39,8 +47,10 @@
 #include <atomic>
 #include <cassert>
 #include <functional>
+#include <iterator>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <sstream>
@@ -263,6 +273,21 @@ std::string LogRangeProcessing(const DatasetLogInfo &info)
    return msg.str();
 }
 
+/// Add to `out` the dataset columns that `columns` depend on, following Defines (and aliases) recursively.
+void CollectDatasetColumns(const ColumnNames_t &columns, const RColumnRegister &colRegister,
+                           std::set<std::string> &out, std::set<const RDefineBase *> &visitedDefines)
+{
+   for (const auto &c : columns) {
+      const auto col = colRegister.ResolveAlias(c);
+      if (auto *define = colRegister.GetDefine(col)) {
+         if (visitedDefines.insert(define).second)
+            CollectDatasetColumns(define->GetColumnNames(), define->GetColRegister(), out, visitedDefines);
+      } else {
+         out.insert(col);
+      }
+   }
+}
+
 DatasetLogInfo TreeDatasetLogInfo(const TTreeReader &r, unsigned int slot)
 {
    const auto tree = r.GetTree();
@@ -307,6 +332,13 @@ static auto MakeDatasetColReadersKey(const std::string &colName, const std::type
    //    df.Sum<RVecI>("stdVectorBranch");
    return colName + ':' + ti.name();
 }
+
+/// Serializes accesses to result cache files, which might be shared by RDataFrames that run concurrently in RunGraphs.
+std::mutex &GetResultCacheMutex()
+{
+   static std::mutex m;
+   return m;
+}
 } // anonymous namespace
 
 namespace ROOT {
@@ -406,6 +438,9 @@ RLoopManager::RLoopManager(ROOT::RDF::Experimental::RDatasetSpec &&spec)
    }
 }
 
+// outlined so that RProfiler can be an incomplete type in the header
+RLoopManager::~RLoopManager() = default;
+
 /// Run event loop with no source files, in parallel.
 void RLoopManager::RunEmptySourceMT()
 {
@@ -437,7 +472,7 @@ void RLoopManager::RunEmptySourceMT()
       R__LOG_DEBUG(0, RDFLogChannel()) << LogRangeProcessing({"an empty source", range.first, range.second, slot});
       try {
          UpdateSampleInfo(slot, range);
-         for (auto currEntry = range.first; currEntry < range.second; ++currEntry) {
+         for (auto currEntry = range.first; currEntry < range.second && !fStopRequested; ++currEntry) {
             RunAndCheckFilters(slot, currEntry);
          }
       } catch (...) {
@@ -463,7 +498,7 @@ void RLoopManager::RunEmptySource()
    try {
       UpdateSampleInfo(/*slot*/ 0, fEmptyEntryRange);
       for (ULong64_t currEntry = fEmptyEntryRange.first;
-           currEntry < fEmptyEntryRange.second && fNStopsReceived < fNChildren; ++currEntry) {
+           currEntry < fEmptyEntryRange.second && fNStopsReceived < fNChildren && !fStopRequested; ++currEntry) {
          RunAndCheckFilters(0, currEntry);
       }
    } catch (...) {
@@ -486,9 +521,12 @@ void RLoopManager::RunTreeProcessorMT()
 
    std::atomic<ULong64_t> entryCount(0ull);
 
-   tp->Process([this, &slotStack, &entryCount](TTreeReader &r) -> void {
+   const auto deferredBranches = GetCacheDeferredBranches({this});
+
+   tp->Process([this, &slotStack, &entryCount, &deferredBranches](TTreeReader &r) -> void {
       ROOT::Internal::RSlotStackRAII slotRAII(slotStack);
       auto slot = slotRAII.fSlot;
+      r.SetCacheDeferredBranches(deferredBranches);
       RCallCleanUpTask cleanup(*this, slot, &r);
       InitNodeSlots(&r, slot);
       R__LOG_DEBUG(0, RDFLogChannel()) << LogRangeProcessing(TreeDatasetLogInfo(r, slot));
@@ -497,7 +535,7 @@ void RLoopManager::RunTreeProcessorMT()
       auto count = entryCount.fetch_add(nEntries);
       try {
          // recursive call to check filters and conditionally execute actions
-         while (r.Next()) {
+         while (!fStopRequested && r.Next()) {
             if (fNewSampleNotifier.CheckFlag(slot)) {
                UpdateSampleInfo(slot, r);
             }
@@ -507,9 +545,9 @@ void RLoopManager::RunTreeProcessorMT()
          std::cerr << "RDataFrame::Run: event loop was interrupted\n";
          throw;
       }
-      // fNStopsReceived < fNChildren is always true at the moment as we don't support event loop early quitting in
-      // multi-thread runs, but it costs nothing to be safe and future-proof in case we add support for that later.
-      if (r.GetEntryStatus() != TTreeReader::kEntryBeyondEnd && fNStopsReceived < fNChildren) {
+      // fNStopsReceived < fNChildren is always true at the moment as Ranges are not supported in multi-thread runs,
+      // but it costs nothing to be safe and future-proof in case we add support for that later.
+      if (r.GetEntryStatus() != TTreeReader::kEntryBeyondEnd && fNStopsReceived < fNChildren && !fStopRequested) {
          // something went wrong in the TTreeReader event loop
          throw std::runtime_error("An error was encountered while processing the data. TTreeReader status code is: " +
                                   std::to_string(r.GetEntryStatus()));
@@ -530,6 +568,7 @@ void RLoopManager::RunTreeReader()
    if (fBeginEntry != 0 || fEndEntry != std::numeric_limits<Long64_t>::max())
       if (r.SetEntriesRange(fBeginEntry, fEndEntry) != TTreeReader::kEntryValid)
          throw std::logic_error("Something went wrong in initializing the TTreeReader.");
+   r.SetCacheDeferredBranches(GetCacheDeferredBranches({this}));
 
    RCallCleanUpTask cleanup(*this, 0u, &r);
    InitNodeSlots(&r, 0);
@@ -538,7 +577,7 @@ void RLoopManager::RunTreeReader()
    // recursive call to check filters and conditionally execute actions
    // in the non-MT case processing can be stopped early by ranges, hence the check on fNStopsReceived
    try {
-      while (r.Next() && fNStopsReceived < fNChildren) {
+      while (!fStopRequested && r.Next() && fNStopsReceived < fNChildren) {
          if (fNewSampleNotifier.CheckFlag(0)) {
             UpdateSampleInfo(/*slot*/0, r);
          }
@@ -548,20 +587,179 @@ void RLoopManager::RunTreeReader()
       std::cerr << "RDataFrame::Run: event loop was interrupted\n";
       throw;
    }
-   if (r.GetEntryStatus() != TTreeReader::kEntryBeyondEnd && fNStopsReceived < fNChildren) {
+   if (r.GetEntryStatus() != TTreeReader::kEntryBeyondEnd && fNStopsReceived < fNChildren && !fStopRequested) {
       // something went wrong in the TTreeReader event loop
       throw std::runtime_error("An error was encountered while processing the data. TTreeReader status code is: " +
                                std::to_string(r.GetEntryStatus()));
    }
 }
 
+/// Run a single event loop over one or multiple ROOT files, in parallel, on behalf of several loop managers.
+/// All loop managers must read the same dataset (see GetSharedScanKey): the first one drives the TTreeProcessorMT,
+/// the others attach their nodes to the same TTreeReader, so that each branch is read and decompressed only once.
+void RLoopManager::RunSharedTreeProcessorMT(const std::vector<RLoopManager *> &loopManagers)
+{
+#ifdef R__USE_IMT
+   auto &leader = *loopManagers.front();
+   if (leader.fEndEntry == leader.fBeginEntry) // empty range => no work needed
+      return;
+   ROOT::Internal::RSlotStack slotStack(leader.fNSlots);
+   const auto &entryList = leader.fTree->GetEntryList() ? *leader.fTree->GetEntryList() : TEntryList();
+   auto tp = (leader.fBeginEntry != 0 || leader.fEndEntry != std::numeric_limits<Long64_t>::max())
+                ? std::make_unique<ROOT::TTreeProcessorMT>(*leader.fTree, leader.fNSlots,
+                                                           std::make_pair(leader.fBeginEntry, leader.fEndEntry))
+                : std::make_unique<ROOT::TTreeProcessorMT>(*leader.fTree, entryList, leader.fNSlots);
+
+   std::atomic<ULong64_t> entryCount(0ull);
+
+   const auto deferredBranches = GetCacheDeferredBranches(loopManagers);
+
+   tp->Process([&loopManagers, &slotStack, &entryCount, &deferredBranches](TTreeReader &r) -> void {
+      ROOT::Internal::RSlotStackRAII slotRAII(slotStack);
+      auto slot = slotRAII.fSlot;
+      r.SetCacheDeferredBranches(deferredBranches);
+      std::vector<std::unique_ptr<RCallCleanUpTask>> cleanups;
+      cleanups.reserve(loopManagers.size());
+      for (auto *lm : loopManagers) {
+         cleanups.emplace_back(std::make_unique<RCallCleanUpTask>(*lm, slot, &r));
+         lm->InitNodeSlots(&r, slot);
+      }
+      R__LOG_DEBUG(0, RDFLogChannel()) << LogRangeProcessing(TreeDatasetLogInfo(r, slot));
+      const auto entryRange = r.GetEntriesRange(); // we trust TTreeProcessorMT to call SetEntriesRange
+      const auto nEntries = entryRange.second - entryRange.first;
+      auto count = entryCount.fetch_add(nEntries);
+      try {
+         while (r.Next()) {
+            for (auto *lm : loopManagers) {
+               if (lm->fNewSampleNotifier.CheckFlag(slot)) {
+                  lm->UpdateSampleInfo(slot, r);
+               }
+               lm->RunAndCheckFilters(slot, count);
+            }
+            ++count;
+         }
+      } catch (...) {
+         std::cerr << "RDataFrame::Run: event loop was interrupted\n";
+         throw;
+      }
+      if (r.GetEntryStatus() != TTreeReader::kEntryBeyondEnd) {
+         // something went wrong in the TTreeReader event loop
+         throw std::runtime_error("An error was encountered while processing the data. TTreeReader status code is: " +
+                                  std::to_string(r.GetEntryStatus()));
+      }
+   });
+#else
+   (void)loopManagers;
+#endif // no-op otherwise (will not be called)
+}
+
+/// Run a single event loop over one or multiple ROOT files, in sequence, on behalf of several loop managers.
+/// See RunSharedTreeProcessorMT. The loop stops early only once all loop managers have been stopped by their Ranges.
+void RLoopManager::RunSharedTreeReader(const std::vector<RLoopManager *> &loopManagers)
+{
+   auto &leader = *loopManagers.front();
+   TTreeReader r(leader.fTree.get(), leader.fTree->GetEntryList());
+   if (0 == leader.fTree->GetEntriesFast() || leader.fBeginEntry == leader.fEndEntry)
+      return;
+   if (leader.fBeginEntry != 0 || leader.fEndEntry != std::numeric_limits<Long64_t>::max())
+      if (r.SetEntriesRange(leader.fBeginEntry, leader.fEndEntry) != TTreeReader::kEntryValid)
+         throw std::logic_error("Something went wrong in initializing the TTreeReader.");
+   r.SetCacheDeferredBranches(GetCacheDeferredBranches(loopManagers));
+
+   std::vector<std::unique_ptr<RCallCleanUpTask>> cleanups;
+   cleanups.reserve(loopManagers.size());
+   for (auto *lm : loopManagers) {
+      cleanups.emplace_back(std::make_unique<RCallCleanUpTask>(*lm, 0u, &r));
+      lm->InitNodeSlots(&r, 0);
+   }
+   R__LOG_DEBUG(0, RDFLogChannel()) << LogRangeProcessing(TreeDatasetLogInfo(r, 0u));
+
+   auto isActive = [](const RLoopManager *lm) { return lm->fNStopsReceived < lm->fNChildren; };
+   bool anyActive = true;
+   try {
+      while (anyActive && r.Next()) {
+         anyActive = false;
+         for (auto *lm : loopManagers) {
+            if (!isActive(lm))
+               continue;
+            if (lm->fNewSampleNotifier.CheckFlag(0)) {
+               lm->UpdateSampleInfo(/*slot*/ 0, r);
+            }
+            lm->RunAndCheckFilters(0, r.GetCurrentEntry());
+            anyActive |= isActive(lm);
+         }
+      }
+   } catch (...) {
+      std::cerr << "RDataFrame::Run: event loop was interrupted\n";
+      throw;
+   }
+   if (r.GetEntryStatus() != TTreeReader::kEntryBeyondEnd && anyActive) {
+      // something went wrong in the TTreeReader event loop
+      throw std::runtime_error("An error was encountered while processing the data. TTreeReader status code is: " +
+                               std::to_string(r.GetEntryStatus()));
+   }
+}
+
+/// Return the branches that the TTreeCache should read on demand rather than prefetch with every cluster.
+/// These are the dataset columns that are only read (possibly through Defines) by actions that are downstream of a
+/// Filter: such "payload" columns are only needed for the entries that pass the selection, so with a selective cut
+/// most of their baskets never need to be read. Columns read by Filters, systematic variations or by actions that
+/// see every entry are prefetched as usual. Setting the rootrc entry RDataFrame.DeferPayloadBranches to 0 makes
+/// the TTreeCache prefetch all the branches.
+std::vector<std::string> RLoopManager::GetCacheDeferredBranches(const std::vector<RLoopManager *> &loopManagers)
+{
+   if (gEnv->GetValue("RDataFrame.DeferPayloadBranches", 1) == 0)
+      return {};
+
+   const bool hasFilters = std::any_of(loopManagers.begin(), loopManagers.end(),
+                                       [](const RLoopManager *lm) { return !lm->fBookedFilters.empty(); });
+   if (!hasFilters)
+      return {};
+
+   // columns needed for every entry
+   std::set<std::string> eagerColumns;
+   std::set<const RDefineBase *> eagerDefines;
+   // columns needed only for the entries that pass some Filter
+   std::set<std::string> payloadColumns;
+   std::set<const RDefineBase *> payloadDefines;
+   for (const auto *lm : loopManagers) {
+      for (const auto *filter : lm->fBookedFilters)
+         CollectDatasetColumns(filter->GetColumnNames(), filter->GetColRegister(), eagerColumns, eagerDefines);
+      for (const auto *variation : lm->fBookedVariations)
+         CollectDatasetColumns(variation->GetInputColumnNames(), variation->GetColRegister(), eagerColumns,
+                               eagerDefines);
+      for (auto *action : lm->fBookedActions) {
+         // the graph of an action contains all of its upstream nodes
+         std::unordered_map<void *, std::shared_ptr<GraphDrawing::GraphNode>> visitedMap;
+         action->GetGraph(visitedMap);
+         const bool isFiltered = std::any_of(lm->fBookedFilters.begin(), lm->fBookedFilters.end(),
+                                             [&visitedMap](RFilterBase *f) { return visitedMap.count(f) > 0; });
+         if (isFiltered)
+            CollectDatasetColumns(action->GetColumnNames(), action->GetColRegister(), payloadColumns, payloadDefines);
+         else
+            CollectDatasetColumns(action->GetColumnNames(), action->GetColRegister(), eagerColumns, eagerDefines);
+      }
+   }
+
+   std::vector<std::string> deferred;
+   std::set_difference(payloadColumns.begin(), payloadColumns.end(), eagerColumns.begin(), eagerColumns.end(),
+                       std::back_inserter(deferred));
+   if (!deferred.empty()) {
+      std::string msg = "Branches read on demand by the TTreeCache (not prefetched):";
+      for (const auto &b : deferred)
+         msg += " " + b;
+      R__LOG_DEBUG(0, RDFLogChannel()) << msg;
+   }
+   return deferred;
+}
+
 /// Run event loop over data accessed through a DataSource, in sequence.
 void RLoopManager::RunDataSource()
 {
    assert(fDataSource != nullptr);
    fDataSource->Initialize();
    auto ranges = fDataSource->GetEntryRanges();
-   while (!ranges.empty() && fNStopsReceived < fNChildren) {
+   while (!ranges.empty() && fNStopsReceived < fNChildren && !fStopRequested) {
       InitNodeSlots(nullptr, 0u);
       fDataSource->InitSlot(0u, 0ull);
       RCallCleanUpTask cleanup(*this);
@@ -570,7 +768,7 @@ void RLoopManager::RunDataSource()
             const auto start = range.first;
             const auto end = range.second;
             R__LOG_DEBUG(0, RDFLogChannel()) << LogRangeProcessing({fDataSource->GetLabel(), start, end, 0u});
-            for (auto entry = start; entry < end && fNStopsReceived < fNChildren; ++entry) {
+            for (auto entry = start; entry < end && fNStopsReceived < fNChildren && !fStopRequested; ++entry) {
                if (fDataSource->SetEntry(0u, entry)) {
                   RunAndCheckFilters(0u, entry);
                }
@@ -605,7 +803,7 @@ void RLoopManager::RunDataSourceMT()
       const auto end = range.second;
       R__LOG_DEBUG(0, RDFLogChannel()) << LogRangeProcessing({fDataSource->GetLabel(), start, end, slot});
       try {
-         for (auto entry = start; entry < end; ++entry) {
+         for (auto entry = start; entry < end && !fStopRequested; ++entry) {
             if (fDataSource->SetEntry(slot, entry)) {
                RunAndCheckFilters(slot, entry);
             }
@@ -619,7 +817,7 @@ void RLoopManager::RunDataSourceMT()
 
    fDataSource->Initialize();
    auto ranges = fDataSource->GetEntryRanges();
-   while (!ranges.empty()) {
+   while (!ranges.empty() && !fStopRequested) {
       pool.Foreach(runOnRange, ranges);
       ranges = fDataSource->GetEntryRanges();
    }
@@ -631,6 +829,9 @@ void RLoopManager::RunDataSourceMT()
 /// Named filters must be called even if the analysis logic would not require it, lest they report confusing results.
 void RLoopManager::RunAndCheckFilters(unsigned int slot, Long64_t entry)
 {
+   if (fProfiler)
+      fProfiler->BeginEntry(slot);
+
    // data-block callbacks run before the rest of the graph
    if (fNewSampleNotifier.CheckFlag(slot)) {
       for (auto &callback : fSampleCallbacks)
@@ -651,6 +852,9 @@ void RLoopManager::RunAndCheckFilters(unsigned int slot, Long64_t entry)
 /// calls their `InitSlot` method, to get them ready for running a task.
 void RLoopManager::InitNodeSlots(TTreeReader *r, unsigned int slot)
 {
+   // the I/O monitor must be in place before the column readers are created
+   if (fProfiler)
+      fProfiler->BeginTask(slot);
    SetupSampleCallbacks(r, slot);
    for (auto *ptr : fBookedActions)
       ptr->InitSlot(r, slot);
@@ -707,6 +911,7 @@ void RLoopManager::UpdateSampleInfo(unsigned int slot, TTreeReader &r) {
 /// that are common for all threads).
 void RLoopManager::InitNodes()
 {
+   fStopRequested = false;
    EvalChildrenCounts();
    for (auto *filter : fBookedFilters)
       filter->InitNode();
@@ -759,6 +964,9 @@ void RLoopManager::CleanUpTask(TTreeReader *r, unsigned int slot)
       for (auto &v : fDatasetColumnReaders[slot])
          v.second.reset();
    }
+
+   if (fProfiler)
+      fProfiler->EndTask(slot);
 }
 
 /// Add RDF nodes that require just-in-time compilation to the computation graph.
@@ -812,28 +1020,131 @@ void RLoopManager::Run(bool jit)
    if (jit)
       Jit();
 
+   const auto nBookedActions = fBookedActions.size();
+   const auto resultsToCache = RestoreCachedResults();
+   // if all results could be retrieved from the cache there is no need to read the data at all
+   const bool skipEventLoop =
+      nBookedActions > 0 && fBookedActions.empty() && (fBookedNamedFilters.empty() || !fMustRunNamedFilters);
+
    InitNodes();
+   BeginProfiling();
 
    TStopwatch s;
    s.Start();
-   switch (fLoopType) {
-   case ELoopType::kNoFilesMT: RunEmptySourceMT(); break;
-   case ELoopType::kROOTFilesMT: RunTreeProcessorMT(); break;
-   case ELoopType::kDataSourceMT: RunDataSourceMT(); break;
-   case ELoopType::kNoFiles: RunEmptySource(); break;
-   case ELoopType::kROOTFiles: RunTreeReader(); break;
-   case ELoopType::kDataSource: RunDataSource(); break;
+   if (skipEventLoop) {
+      R__LOG_INFO(RDFLogChannel()) << "All results were restored from the result cache, skipping the event loop.";
+   } else {
+      switch (fLoopType) {
+      case ELoopType::kNoFilesMT: RunEmptySourceMT(); break;
+      case ELoopType::kROOTFilesMT: RunTreeProcessorMT(); break;
+      case ELoopType::kDataSourceMT: RunDataSourceMT(); break;
+      case ELoopType::kNoFiles: RunEmptySource(); break;
+      case ELoopType::kROOTFiles: RunTreeReader(); break;
+      case ELoopType::kDataSource: RunDataSource(); break;
+      }
    }
    s.Stop();
 
+   EndProfiling();
    CleanUpNodes();
 
+   StoreCachedResults(resultsToCache);
+
    fNRuns++;
 
    R__LOG_INFO(RDFLogChannel()) << "Finished event loop number " << fNRuns - 1 << " (" << s.CpuTime() << "s CPU, "
                                 << s.RealTime() << "s elapsed).";
 }
 
+/// Run the event loops of several loop managers that read the same dataset as a single event loop.
+/// The loop managers must have the same non-empty GetSharedScanKey(): the dataset is read through the TTreeReader(s)
+/// of the first loop manager and every entry is passed to the computation graphs of all loop managers in turn, so
+/// that each branch is read and decompressed once, however many graphs use it.
+/// The jitting phase is skipped if the `jit` parameter is `false` (unsafe, use with care).
+void RLoopManager::RunSharedScan(const std::vector<RLoopManager *> &loopManagers, bool jit)
+{
+   if (loopManagers.empty())
+      return;
+   if (loopManagers.size() == 1u) {
+      loopManagers.front()->Run(jit);
+      return;
+   }
+
+   const auto key = loopManagers.front()->GetSharedScanKey();
+   for (auto *lm : loopManagers) {
+      if (key.empty() || lm->GetSharedScanKey() != key)
+         throw std::logic_error("RunSharedScan: the event loops of the given RDataFrames cannot be shared.");
+   }
+
+   // Change value of TTree::GetMaxTreeSize only for this scope. Revert when #6640 will be solved.
+   MaxTreeSizeRAII ctxtmts;
+
+   R__LOG_INFO(RDFLogChannel()) << "Starting shared event loop for " << loopManagers.size()
+                                << " computation graphs.";
+
+   ThrowIfNSlotsChanged(loopManagers.front()->GetNSlots());
+
+   if (jit)
+      loopManagers.front()->Jit();
+
+   std::vector<std::vector<std::pair<std::string, std::shared_ptr<TObject>>>> resultsToCache;
+   std::vector<RLoopManager *> toRun;
+   for (auto *lm : loopManagers) {
+      const auto nBookedActions = lm->fBookedActions.size();
+      resultsToCache.emplace_back(lm->RestoreCachedResults());
+      const bool allRestored = nBookedActions > 0 && lm->fBookedActions.empty() &&
+                               (lm->fBookedNamedFilters.empty() || !lm->fMustRunNamedFilters);
+      lm->InitNodes();
+      lm->BeginProfiling();
+      if (!allRestored)
+         toRun.emplace_back(lm);
+   }
+
+   TStopwatch s;
+   s.Start();
+   if (!toRun.empty()) {
+      // the first loop manager that still has work to do drives the event loop
+      if (toRun.front()->fLoopType == ELoopType::kROOTFilesMT)
+         RunSharedTreeProcessorMT(toRun);
+      else
+         RunSharedTreeReader(toRun);
+   }
+   s.Stop();
+
+   for (std::size_t i = 0u; i < loopManagers.size(); ++i) {
+      auto *lm = loopManagers[i];
+      lm->EndProfiling();
+      lm->CleanUpNodes();
+      lm->StoreCachedResults(resultsToCache[i]);
+      lm->fNRuns++;
+   }
+
+   R__LOG_INFO(RDFLogChannel()) << "Finished shared event loop for " << loopManagers.size() << " computation graphs ("
+                                << s.CpuTime() << "s CPU, " << s.RealTime() << "s elapsed).";
+}
+
+/// Return a string that identifies the dataset read by this loop manager and how it is processed, or an empty string
+/// if the event loop cannot be shared with other loop managers.
+/// Loop managers with the same non-empty key can run their event loops together via RunSharedScan. Only TTree and
+/// TChain inputs without friends or entry lists are supported.
+std::string RLoopManager::GetSharedScanKey() const
+{
+   if (fLoopType != ELoopType::kROOTFiles && fLoopType != ELoopType::kROOTFilesMT)
+      return "";
+   if (fTree->GetEntryList() != nullptr)
+      return "";
+   if (auto *friends = fTree->GetListOfFriends()) {
+      if (friends->GetEntries() > 0)
+         return "";
+   }
+   // in-memory trees have no file to identify them: only the very same tree can be shared
+   if (fTree->GetCurrentFile() == nullptr && dynamic_cast<TChain *>(fTree.get()) == nullptr)
+      return "";
+
+   // all graphs in a shared event loop use the processing slots of the loop manager that drives it
+   return GetDatasetSignature() + "\nslots " + std::to_string(fNSlots);
+}
+
 /// Return the list of default columns -- empty if none was provided when constructing the RDataFrame
 const ColumnNames_t &RLoopManager::GetDefaultColumnNames() const
 {
@@ -845,6 +1156,26 @@ TTree *RLoopManager::GetTree() const
    return fTree.get();
 }
 
+/// Return the number of entries the event loop will process, if it is known without reading any data, or 0 otherwise.
+/// This is an upper bound for the number of entries that reach a node of the computation graph, and the exact number
+/// for nodes that have no Filter or Range upstream. It is unknown for data sources, for trees with an entry list and
+/// for chains whose number of entries has not been computed yet.
+ULong64_t RLoopManager::GetNEntriesHint() const
+{
+   if (fDataSource)
+      return 0;
+   if (!fTree)
+      return GetNEmptyEntries();
+   if (fTree->GetEntryList())
+      return 0;
+   const Long64_t nEntries = fTree->GetEntriesFast();
+   if (nEntries == TTree::kMaxEntries)
+      return 0;
+   const auto begin = std::min(fBeginEntry, nEntries);
+   const auto end = std::min(fEndEntry, nEntries);
+   return end > begin ? end - begin : 0;
+}
+
 void RLoopManager::Register(RDFInternal::RActionBase *actionPtr)
 {
    fBookedActions.emplace_back(actionPtr);
@@ -1035,6 +1366,8 @@ RColumnReaderBase *RLoopManager::AddTreeColumnReader(unsigned int slot, const st
    assert(readers.find(key) == readers.end() || readers[key] == nullptr);
    auto *rptr = reader.get();
    readers[key] = std::move(reader);
+   if (fProfiler)
+      return fProfiler->WrapColumnReader(slot, col, rptr);
    return rptr;
 }
 
@@ -1043,10 +1376,11 @@ RLoopManager::GetDatasetColumnReader(unsigned int slot, const std::string &col,
 {
    const auto key = MakeDatasetColReadersKey(col, ti);
    auto it = fDatasetColumnReaders[slot].find(key);
-   if (it != fDatasetColumnReaders[slot].end())
-      return it->second.get();
-   else
+   if (it == fDatasetColumnReaders[slot].end() || it->second == nullptr)
       return nullptr;
+   if (fProfiler)
+      return fProfiler->WrapColumnReader(slot, col, it->second.get());
+   return it->second.get();
 }
 
 void RLoopManager::AddSampleCallback(void *nodePtr, SampleCallback_t &&callback)
@@ -1059,3 +1393,284 @@ void RLoopManager::SetEmptyEntryRange(std::pair<ULong64_t, ULong64_t> &&newRange
 {
    fEmptyEntryRange = std::move(newRange);
 }
+
+/// Enable the persistent result cache for this computation graph.
+/// See ROOT::RDF::Experimental::EnableResultCache for more information.
+void RLoopManager::SetResultCache(const std::string &fileName, const std::string &tag)
+{
+   fResultCacheFileName = fileName;
+   fResultCacheTag = tag;
+   if (fileName.empty())
+      fCacheableResults.clear();
+}
+
+/// Register an action whose result can be stored in the result cache. No-op if the result cache is not enabled.
+void RLoopManager::RegisterCacheableResult(const std::shared_ptr<RDFInternal::RActionBase> &actionPtr,
+                                           const std::shared_ptr<TObject> &result)
+{
+   if (!IsResultCacheEnabled())
+      return;
+   fCacheableResults.emplace_back(actionPtr, result);
+}
+
+/// Enable per-node profiling of the event loops of this computation graph.
+/// See ROOT::RDF::Experimental::EnableProfiling for more information.
+void RLoopManager::SetProfiling(const std::string &traceFileName, unsigned int traceSamplingInterval)
+{
+   fProfiler = std::make_unique<RDFInternal::RProfiler>(traceFileName, traceSamplingInterval);
+}
+
+/// Return the profile of the last event loop. Throws if profiling is not enabled.
+const ROOT::RDF::Experimental::RProfileReport &RLoopManager::GetProfileReport() const
+{
+   if (!fProfiler)
+      throw std::runtime_error("GetProfileReport: profiling is not enabled for this computation graph, "
+                               "call ROOT::RDF::Experimental::EnableProfiling before running the event loop.");
+   return fProfiler->GetReport();
+}
+
+/// Register the booked Filters, Defines and actions with the profiler, if profiling is enabled.
+/// To be called right before the event loop, after jitting, so that all nodes are in their final form.
+void RLoopManager::BeginProfiling()
+{
+   if (!fProfiler)
+      return;
+
+   using ENodeKind = RDFInternal::RProfiler::ENodeKind;
+   auto columnList = [](const ColumnNames_t &columns) {
+      std::string list = "(";
+      for (const auto &c : columns)
+         list += (list.size() > 1 ? ", " : "") + c;
+      return list + ")";
+   };
+   auto variationSuffix = [](const std::string &variation) {
+      return variation == "nominal" ? std::string() : " [" + variation + "]";
+   };
+
+   fProfiler->BeginRun(fNSlots);
+   for (auto *filter : fBookedFilters) {
+      const auto name = filter->HasName() ? filter->GetName() : "Filter" + columnList(filter->GetColumnNames());
+      filter->SetProfiler(fProfiler.get(),
+                          fProfiler->RegisterNode(ENodeKind::kFilter, name + variationSuffix(filter->GetVariation())));
+   }
+   for (auto *define : fBookedDefines) {
+      const auto name = define->GetName() + variationSuffix(define->GetVariation());
+      define->SetProfiler(fProfiler.get(), fProfiler->RegisterNode(ENodeKind::kDefine, name));
+   }
+   for (auto *action : fBookedActions) {
+      const auto name = action->GetActionName() + columnList(action->GetColumnNames());
+      action->SetProfiler(fProfiler.get(), fProfiler->RegisterNode(ENodeKind::kAction, name));
+   }
+}
+
+/// Build the profile report of the event loop that just finished and log it, if profiling is enabled.
+void RLoopManager::EndProfiling()
+{
+   if (!fProfiler)
+      return;
+
+   fProfiler->EndRun();
+   R__LOG_INFO(RDFLogChannel()) << "Profile of event loop number " << fNRuns << ":\n"
+                                << fProfiler->GetReport().AsString();
+}
+
+/// Return a string that identifies the input dataset of this computation graph, to be used in result cache keys.
+/// For local files, size and modification time are included so that a change of the input files invalidates the cache.
+/// A TTree is identified by its path in its file and by the UUID of the file, which changes when it is recreated.
+std::string RLoopManager::GetDatasetSignature() const
+{
+   if (fDataSource)
+      return "datasource " + fDataSource->GetLabel();
+
+   if (!fTree) {
+      return "empty source [" + std::to_string(fEmptyEntryRange.first) + ", " +
+             std::to_string(fEmptyEntryRange.second) + ")";
+   }
+
+   std::string signature;
+   auto addFile = [&signature](const std::string &fileName) {
+      signature += "\n" + fileName;
+      FileStat_t stat;
+      if (gSystem->GetPathInfo(fileName.c_str(), stat) == 0)
+         signature += " " + std::to_string(stat.fSize) + " " + std::to_string(stat.fMtime);
+   };
+   if (auto *chain = dynamic_cast<TChain *>(fTree.get())) {
+      // the title of a chain element is the file name, its name the path of the tree in the file
+      signature = "chain " + std::string(chain->GetName());
+      for (const auto *element : *chain->GetListOfFiles()) {
+         addFile(element->GetTitle());
+         signature += " tree " + std::string(element->GetName());
+      }
+   } else {
+      // the path of the directory is "file:/dir/subdir", keep the part in the file
+      std::string path = fTree->GetDirectory() ? fTree->GetDirectory()->GetPath() : "";
+      const auto colon = path.find(":/");
+      path = colon == std::string::npos ? "" : path.substr(colon + 2);
+      signature = "tree " + (path.empty() ? path : path + "/") + fTree->GetName();
+      if (auto *file = fTree->GetCurrentFile()) {
+         addFile(file->GetName());
+         signature += " " + std::string(file->GetUUID().AsString());
+      }
+   }
+   if (auto *friends = fTree->GetListOfFriends()) {
+      // the title of a friend element is the name of its file, if any
+      for (const auto *fe : *friends) {
+         signature += "\nfriend " + std::string(fe->GetName()) + " " +
+                      static_cast<const TFriendElement *>(fe)->GetTreeName() + " " + fe->GetTitle();
+      }
+   }
+   if (auto *entryList = fTree->GetEntryList())
+      signature += "\nentry list " + std::string(entryList->GetName()) + " " + std::to_string(entryList->GetN());
+   signature += "\nentries [" + std::to_string(fBeginEntry) + ", " + std::to_string(fEndEntry) + ")";
+   return signature;
+}
+
+/// Compute the key under which the result of the given action is stored in the result cache.
+/// The key is a hash of the input dataset, of the branch of the computation graph that leads to the action
+/// (as represented by the graph drawing machinery, plus the input columns and the expressions of jitted Filters and the
+/// begin, end and stride of Ranges), of the action's input columns, of the types, input columns and expressions of all
+/// Defines visible from the action and of the model of the result (name, title and binning for histograms).
+std::string RLoopManager::GetResultCacheKey(RDFInternal::RActionBase &action, const TObject &result)
+{
+   std::string signature = GetDatasetSignature() + "\ntag " + fResultCacheTag;
+
+   std::unordered_map<void *, std::shared_ptr<GraphDrawing::GraphNode>> visitedMap;
+   const auto leaf = action.GetGraph(visitedMap);
+   // graph nodes of Filters are all called "Filter" unless the Filter is named, and the ones of Ranges "Range":
+   // describe them with their columns and expressions, and with their begin, end and stride
+   auto columnList = [](const ColumnNames_t &columns) {
+      std::string list;
+      for (const auto &col : columns)
+         list += " " + col;
+      return list;
+   };
+   std::unordered_map<const GraphDrawing::GraphNode *, std::string> nodeDetails;
+   for (const auto *filter : fBookedFilters) {
+      auto it = visitedMap.find((void *)filter);
+      if (it != visitedMap.end())
+         nodeDetails[it->second.get()] = columnList(filter->GetColumnNames()) + " : " + filter->GetExpression();
+   }
+   for (const auto *range : fBookedRanges) {
+      auto it = visitedMap.find((void *)range);
+      if (it != visitedMap.end())
+         nodeDetails[it->second.get()] = " " + std::to_string(range->GetStart()) + " " +
+                                         std::to_string(range->GetStop()) + " " + std::to_string(range->GetStride());
+   }
+   for (const auto *node = leaf.get(); node != nullptr; node = node->GetPrevNode()) {
+      signature += "\nnode " + node->GetName();
+      auto it = nodeDetails.find(node);
+      if (it != nodeDetails.end())
+         signature += it->second;
+   }
+
+   for (const auto &col : action.GetColumnNames())
+      signature += "\ncolumn " + col;
+
+   const auto &colRegister = action.GetColRegister();
+   for (const auto &name : colRegister.GetNames()) {
+      const auto *define = colRegister.GetDefine(name);
+      signature += "\ndefine " + name + " " +
+                   (define ? define->GetTypeName() + columnList(define->GetColumnNames()) + " : " +
+                                define->GetExpression()
+                           : std::string("(alias)"));
+   }
+
+   signature += "\nresult " + std::string(result.IsA()->GetName()) + " " + result.GetName();
+   if (const auto *h = dynamic_cast<const TH1 *>(&result)) {
+      signature += " " + std::string(h->GetTitle());
+      const TAxis *axes[] = {h->GetXaxis(), h->GetYaxis(), h->GetZaxis()};
+      for (int i = 0; i < h->GetDimension(); ++i) {
+         signature += "\naxis " + std::to_string(axes[i]->GetNbins()) + " " + std::to_string(axes[i]->GetXmin()) +
+                      " " + std::to_string(axes[i]->GetXmax());
+         const auto *edges = axes[i]->GetXbins();
+         for (int j = 0; j < edges->GetSize(); ++j)
+            signature += " " + std::to_string(edges->GetAt(j));
+      }
+   }
+
+   TMD5 md5;
+   md5.Update(reinterpret_cast<const UChar_t *>(signature.data()), signature.size());
+   md5.Final();
+   return std::string("rdfresult_") + md5.AsString();
+}
+
+/// Restore the results of booked actions that are present in the result cache.
+/// Restored actions are marked as run and removed from the list of booked actions.
+/// \return The cache keys and results of the cacheable actions that still have to run.
+std::vector<std::pair<std::string, std::shared_ptr<TObject>>> RLoopManager::RestoreCachedResults()
+{
+   std::vector<std::pair<std::string, std::shared_ptr<TObject>>> toStore;
+   if (!IsResultCacheEnabled())
+      return toStore;
+
+   if (fDataSource && fResultCacheTag.empty()) {
+      Warning("RLoopManager::Run",
+              "The result cache cannot identify the input data of an RDataFrame that reads from a data source (%s). "
+              "Pass a tag that identifies the dataset to EnableResultCache to use it. Results will not be cached.",
+              fDataSource->GetLabel().c_str());
+      return toStore;
+   }
+
+   // forget actions that went out of scope
+   fCacheableResults.erase(std::remove_if(fCacheableResults.begin(), fCacheableResults.end(),
+                                          [](const auto &p) { return p.first.expired() || p.second.expired(); }),
+                           fCacheableResults.end());
+
+   std::lock_guard<std::mutex> lock(GetResultCacheMutex());
+   TDirectory::TContext ctxt;
+   std::unique_ptr<TFile> cacheFile;
+   if (!gSystem->AccessPathName(fResultCacheFileName.c_str()))
+      cacheFile.reset(TFile::Open(fResultCacheFileName.c_str(), "READ"));
+
+   for (const auto &entry : fCacheableResults) {
+      auto action = entry.first.lock();
+      auto result = entry.second.lock();
+      if (action->HasRun())
+         continue;
+
+      auto key = GetResultCacheKey(*action, *result);
+      auto *cachedKey = cacheFile ? cacheFile->GetKey(key.c_str()) : nullptr;
+      if (cachedKey == nullptr || std::string(cachedKey->GetClassName()) != result->IsA()->GetName()) {
+         toStore.emplace_back(std::move(key), std::move(result));
+         continue;
+      }
+
+      // The action will not run: let it finalize its (empty) partial results, then overwrite them with the cached
+      // value. TKey::Read might attach the object to the cache file, so we detach it right away.
+      action->Initialize();
+      action->Finalize();
+      cachedKey->Read(result.get());
+      if (auto addToDir = result->IsA()->GetDirectoryAutoAdd())
+         addToDir(result.get(), nullptr);
+      R__LOG_INFO(RDFLogChannel()) << "Restored result " << key << " from result cache " << fResultCacheFileName
+                                   << '.';
+   }
+
+   // restored actions have been finalized, and are now considered as run
+   const auto restoredBegin = std::stable_partition(fBookedActions.begin(), fBookedActions.end(),
+                                                    [](RDFInternal::RActionBase *a) { return !a->HasRun(); });
+   for (auto it = restoredBegin; it != fBookedActions.end(); ++it)
+      fSampleCallbacks.erase(*it);
+   fRunActions.insert(fRunActions.begin(), restoredBegin, fBookedActions.end());
+   fBookedActions.erase(restoredBegin, fBookedActions.end());
+
+   return toStore;
+}
+
+/// Write the given results to the result cache, overwriting previous results with the same keys.
+void RLoopManager::StoreCachedResults(const std::vector<std::pair<std::string, std::shared_ptr<TObject>>> &results)
+{
+   if (results.empty())
+      return;
+
+   std::lock_guard<std::mutex> lock(GetResultCacheMutex());
+   TDirectory::TContext ctxt;
+   std::unique_ptr<TFile> cacheFile(TFile::Open(fResultCacheFileName.c_str(), "UPDATE"));
+   if (!cacheFile || cacheFile->IsZombie()) {
+      Warning("RLoopManager::Run", "Could not open result cache file %s for writing, results will not be cached.",
+              fResultCacheFileName.c_str());
+      return;
+   }
+   for (const auto &r : results)
+      cacheFile->WriteTObject(r.second.get(), r.first.c_str(), "Overwrite");
+}
@@ -0,0 +1,54 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/RDF/RProfileReport.hxx"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace ROOT {
+namespace RDF {
+namespace Experimental {
+
+RProfileReport::RProfileReport(std::vector<RNodeProfile> &&nodes, double eventLoopTime, ULong64_t nEntries)
+   : fNodes(std::move(nodes)), fEventLoopTime(eventLoopTime), fNEntries(nEntries)
+{
+}
+
+/// Return a table with one line per node: self and total time, fraction of the event loop time spent in the node,
+/// number of calls and, for dataset columns, the bytes read and the decompression time.
+std::string RProfileReport::AsString() const
+{
+   std::ostringstream os;
+   os << "Event loop: " << fNEntries << " entries in " << fEventLoopTime << " s";
+   if (fEventLoopTime > 0.)
+      os << " (" << fNEntries / fEventLoopTime << " entries/s)";
+   os << '\n';
+   os << std::left << std::setw(8) << "Kind" << std::setw(40) << "Name" << std::right << std::setw(12) << "Self [s]"
+      << std::setw(12) << "Total [s]" << std::setw(9) << "Self %" << std::setw(14) << "Calls" << std::setw(14)
+      << "Read [B]" << std::setw(12) << "Unzip [s]" << '\n';
+   for (const auto &n : fNodes) {
+      const double frac = fEventLoopTime > 0. ? 100. * n.fSelfTime / fEventLoopTime : 0.;
+      os << std::left << std::setw(8) << n.fKind << std::setw(40) << n.fName << std::right << std::fixed
+         << std::setprecision(6) << std::setw(12) << n.fSelfTime << std::setw(12) << n.fTotalTime
+         << std::setprecision(2) << std::setw(9) << frac << std::setw(14) << n.fCalls << std::setw(14) << n.fBytesRead
+         << std::setprecision(6) << std::setw(12) << n.fUnzipTime << '\n';
+      os.unsetf(std::ios_base::floatfield);
+   }
+   return os.str();
+}
+
+void RProfileReport::Print() const
+{
+   std::cout << AsString();
+}
+
+} // namespace Experimental
+} // namespace RDF
+} // namespace ROOT
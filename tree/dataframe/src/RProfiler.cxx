@@ -0,0 +1,389 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/RDF/RProfiler.hxx"
+#include "TTimeStamp.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+using ROOT::Internal::RDF::RProfiler;
+
+/// gPerfStats implementation installed by RProfiler for the duration of a task. It counts the bytes read and the time
+/// spent decompressing by the processing slot and forwards all events to the perfstats that was installed before.
+/// Monitors of different RProfilers can be stacked on the same thread, e.g. during a shared event loop: then the I/O is
+/// accounted to all of them, as any of them could be measuring the column read that triggered it.
+class RIOMonitor final : public TVirtualPerfStats {
+   RProfiler::RSlotData &fSlotData;
+   TVirtualPerfStats *fPrevious = nullptr; ///< The gPerfStats installed before this one
+   TVirtualPerfStats *fForward = nullptr;  ///< The first perfstats down the chain that is not a RIOMonitor
+
+   void SetFile(TFile *) final {}
+
+public:
+   explicit RIOMonitor(RProfiler::RSlotData &slotData) : fSlotData(slotData) {}
+
+   TVirtualPerfStats *GetPrevious() const { return fPrevious; }
+   void SetPrevious(TVirtualPerfStats *previous)
+   {
+      fPrevious = previous;
+      auto *prevMonitor = dynamic_cast<RIOMonitor *>(previous);
+      fForward = prevMonitor ? prevMonitor->fForward : previous;
+   }
+
+   void AddIO(ULong64_t bytesRead, ULong64_t unzipTime)
+   {
+      fSlotData.fBytesRead += bytesRead;
+      fSlotData.fUnzipTime += unzipTime;
+      if (auto *prevMonitor = dynamic_cast<RIOMonitor *>(fPrevious))
+         prevMonitor->AddIO(bytesRead, unzipTime);
+   }
+
+   void SimpleEvent(EEventType type) final
+   {
+      if (fForward)
+         fForward->SimpleEvent(type);
+   }
+   void PacketEvent(const char *slave, const char *slavename, const char *filename, Long64_t eventsprocessed,
+                    Double_t latency, Double_t proctime, Double_t cputime, Long64_t bytesRead) final
+   {
+      if (fForward)
+         fForward->PacketEvent(slave, slavename, filename, eventsprocessed, latency, proctime, cputime, bytesRead);
+   }
+   void FileEvent(const char *slave, const char *slavename, const char *nodename, const char *filename,
+                  Bool_t isStart) final
+   {
+      if (fForward)
+         fForward->FileEvent(slave, slavename, nodename, filename, isStart);
+   }
+   void FileOpenEvent(TFile *file, const char *filename, Double_t start) final
+   {
+      if (fForward)
+         fForward->FileOpenEvent(file, filename, start);
+   }
+   void FileReadEvent(TFile *file, Int_t len, Double_t start) final
+   {
+      AddIO(len, 0);
+      if (fForward)
+         fForward->FileReadEvent(file, len, start);
+   }
+   void UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen) final
+   {
+      const double elapsed = TTimeStamp().AsDouble() - start;
+      if (elapsed > 0.)
+         AddIO(0, static_cast<ULong64_t>(elapsed * 1e9));
+      if (fForward)
+         fForward->UnzipEvent(tree, pos, start, complen, objlen);
+   }
+   void RateEvent(Double_t proctime, Double_t deltatime, Long64_t eventsprocessed, Long64_t bytesRead) final
+   {
+      if (fForward)
+         fForward->RateEvent(proctime, deltatime, eventsprocessed, bytesRead);
+   }
+
+   void SetBytesRead(Long64_t num) final
+   {
+      if (fForward)
+         fForward->SetBytesRead(num);
+   }
+   Long64_t GetBytesRead() const final { return fForward ? fForward->GetBytesRead() : 0; }
+   void SetNumEvents(Long64_t num) final
+   {
+      if (fForward)
+         fForward->SetNumEvents(num);
+   }
+   Long64_t GetNumEvents() const final { return fForward ? fForward->GetNumEvents() : 0; }
+
+   void PrintBasketInfo(Option_t *option = "") const final
+   {
+      if (fForward)
+         fForward->PrintBasketInfo(option);
+   }
+   void SetLoaded(TBranch *b, size_t basketNumber) final
+   {
+      if (fForward)
+         fForward->SetLoaded(b, basketNumber);
+   }
+   void SetLoaded(size_t bi, size_t basketNumber) final
+   {
+      if (fForward)
+         fForward->SetLoaded(bi, basketNumber);
+   }
+   void SetLoadedMiss(TBranch *b, size_t basketNumber) final
+   {
+      if (fForward)
+         fForward->SetLoadedMiss(b, basketNumber);
+   }
+   void SetLoadedMiss(size_t bi, size_t basketNumber) final
+   {
+      if (fForward)
+         fForward->SetLoadedMiss(bi, basketNumber);
+   }
+   void SetMissed(TBranch *b, size_t basketNumber) final
+   {
+      if (fForward)
+         fForward->SetMissed(b, basketNumber);
+   }
+   void SetMissed(size_t bi, size_t basketNumber) final
+   {
+      if (fForward)
+         fForward->SetMissed(bi, basketNumber);
+   }
+   void SetUsed(TBranch *b, size_t basketNumber) final
+   {
+      if (fForward)
+         fForward->SetUsed(b, basketNumber);
+   }
+   void SetUsed(size_t bi, size_t basketNumber) final
+   {
+      if (fForward)
+         fForward->SetUsed(bi, basketNumber);
+   }
+   void UpdateBranchIndices(TObjArray *branches) final
+   {
+      if (fForward)
+         fForward->UpdateBranchIndices(branches);
+   }
+};
+
+const char *KindName(RProfiler::ENodeKind kind)
+{
+   switch (kind) {
+   case RProfiler::ENodeKind::kFilter: return "Filter";
+   case RProfiler::ENodeKind::kDefine: return "Define";
+   case RProfiler::ENodeKind::kAction: return "Action";
+   case RProfiler::ENodeKind::kColumn: return "Column";
+   }
+   return "";
+}
+
+std::string EscapeJSON(const std::string &s)
+{
+   std::string out;
+   out.reserve(s.size());
+   for (const char c : s) {
+      switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\t': out += "\\t"; break;
+      default:
+         if (static_cast<unsigned char>(c) < 0x20)
+            out += ' ';
+         else
+            out += c;
+      }
+   }
+   return out;
+}
+
+} // anonymous namespace
+
+namespace ROOT {
+namespace Internal {
+namespace RDF {
+
+RProfiler::RProfiler(const std::string &traceFileName, unsigned int samplingInterval)
+   : fTraceFileName(traceFileName), fSamplingInterval(samplingInterval)
+{
+}
+
+RProfiler::~RProfiler()
+{
+   UninstallIOMonitors();
+}
+
+/// Make sure that no I/O monitor of this profiler is still installed as gPerfStats of the current thread, which can
+/// happen if a task threw before reaching EndTask.
+void RProfiler::UninstallIOMonitors()
+{
+   for (unsigned int slot = 0u; slot < fSlots.size(); ++slot) {
+      if (fSlots[slot] && fSlots[slot]->fIOMonitor && gPerfStats == fSlots[slot]->fIOMonitor.get())
+         EndTask(slot);
+   }
+}
+
+unsigned int RProfiler::AddNode(ENodeKind kind, const std::string &name)
+{
+   fNodes.push_back({kind, name});
+   return fNodes.size() - 1;
+}
+
+/// Reset all statistics and prepare the per-slot storage. Must be called before the nodes are registered.
+void RProfiler::BeginRun(unsigned int nSlots)
+{
+   UninstallIOMonitors();
+   fNodes.clear();
+   fColumnIds.clear();
+   fSlots.clear();
+   for (auto i = 0u; i < nSlots; ++i)
+      fSlots.emplace_back(new RSlotData());
+   fRunStart = Clock_t::now();
+}
+
+/// Register a Filter, Define or action node, return its id.
+unsigned int RProfiler::RegisterNode(ENodeKind kind, const std::string &name)
+{
+   const auto id = AddNode(kind, name);
+   for (auto &s : fSlots)
+      s->fStats.resize(fNodes.size());
+   return id;
+}
+
+/// Install the I/O monitor of this slot as gPerfStats of the current thread and start measuring the task.
+void RProfiler::BeginTask(unsigned int slot)
+{
+   auto &s = *fSlots[slot];
+   if (!s.fIOMonitor)
+      s.fIOMonitor.reset(new RIOMonitor(s));
+   auto *monitor = static_cast<RIOMonitor *>(s.fIOMonitor.get());
+   monitor->SetPrevious(gPerfStats);
+   gPerfStats = monitor;
+   s.fTaskStart = Clock_t::now();
+}
+
+/// Restore the gPerfStats that was installed before BeginTask and record the task in the trace.
+void RProfiler::EndTask(unsigned int slot)
+{
+   auto &s = *fSlots[slot];
+   auto *monitor = static_cast<RIOMonitor *>(s.fIOMonitor.get());
+   if (!monitor)
+      return;
+   if (gPerfStats == monitor) {
+      gPerfStats = monitor->GetPrevious();
+   } else {
+      // someone installed another perfstats on top of ours in the meantime: unlink ours from the chain, if we can
+      for (auto *p = dynamic_cast<RIOMonitor *>(gPerfStats); p; p = dynamic_cast<RIOMonitor *>(p->GetPrevious())) {
+         if (p->GetPrevious() == monitor) {
+            p->SetPrevious(monitor->GetPrevious());
+            break;
+         }
+      }
+   }
+   monitor->SetPrevious(nullptr);
+
+   if (fSamplingInterval > 0 && s.fTrace.size() < kMaxTraceEvents) {
+      const auto now = Clock_t::now();
+      const ULong64_t begin = std::chrono::duration_cast<std::chrono::nanoseconds>(s.fTaskStart - fRunStart).count();
+      const ULong64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - s.fTaskStart).count();
+      s.fTrace.push_back({kTaskId, begin, duration});
+   }
+   // the nodes forget their column readers at the end of each task, and the tree readers are re-created for the next one
+   s.fColumnReaders.clear();
+}
+
+/// Return a profiling wrapper for the dataset column reader, owned by the profiler until the end of the task.
+ROOT::Detail::RDF::RColumnReaderBase *
+RProfiler::WrapColumnReader(unsigned int slot, const std::string &colName, ROOT::Detail::RDF::RColumnReaderBase *reader)
+{
+   if (!reader)
+      return reader;
+   auto &s = *fSlots[slot];
+   auto &wrapper = s.fColumnReaders[reader];
+   if (wrapper)
+      return wrapper.get();
+
+   unsigned int id = 0;
+   std::size_t nNodes = 0;
+   {
+      std::lock_guard<std::mutex> lock(fNodesMutex);
+      auto it = fColumnIds.find(colName);
+      if (it == fColumnIds.end())
+         it = fColumnIds.emplace(colName, AddNode(ENodeKind::kColumn, colName)).first;
+      id = it->second;
+      nNodes = fNodes.size();
+   }
+   // each slot only ever grows its own statistics
+   if (s.fStats.size() < nNodes)
+      s.fStats.resize(nNodes);
+   wrapper.reset(new RProfiledColumnReader(*this, *reader, slot, id));
+   return wrapper.get();
+}
+
+/// Sum the statistics of all slots into the report and write the trace, if requested.
+void RProfiler::EndRun()
+{
+   const double eventLoopTime =
+      std::chrono::duration_cast<std::chrono::duration<double>>(Clock_t::now() - fRunStart).count();
+   ULong64_t nEntries = 0;
+   for (const auto &s : fSlots)
+      nEntries += s->fNEntries;
+
+   std::vector<ROOT::RDF::Experimental::RProfileReport::RNodeProfile> profiles;
+   for (unsigned int id = 0u; id < fNodes.size(); ++id) {
+      ROOT::RDF::Experimental::RProfileReport::RNodeProfile p;
+      p.fKind = KindName(fNodes[id].fKind);
+      p.fName = fNodes[id].fName;
+      p.fSelfTimePerSlot.resize(fSlots.size());
+      for (unsigned int slot = 0u; slot < fSlots.size(); ++slot) {
+         const auto &stats = fSlots[slot]->fStats;
+         if (id >= stats.size())
+            continue;
+         const auto &st = stats[id];
+         p.fCalls += st.fCalls;
+         p.fTotalTime += st.fTotalTime * 1e-9;
+         p.fSelfTime += st.fSelfTime * 1e-9;
+         p.fBytesRead += st.fBytesRead;
+         p.fUnzipTime += st.fUnzipTime * 1e-9;
+         p.fSelfTimePerSlot[slot] = st.fSelfTime * 1e-9;
+      }
+      if (p.fCalls > 0)
+         profiles.emplace_back(std::move(p));
+   }
+   std::stable_sort(profiles.begin(), profiles.end(),
+                    [](const ROOT::RDF::Experimental::RProfileReport::RNodeProfile &a,
+                       const ROOT::RDF::Experimental::RProfileReport::RNodeProfile &b) {
+                       return a.fSelfTime > b.fSelfTime;
+                    });
+   fReport = ROOT::RDF::Experimental::RProfileReport(std::move(profiles), eventLoopTime, nEntries);
+
+   if (!fTraceFileName.empty())
+      WriteChromeTrace(fTraceFileName);
+}
+
+/// Write the sampled trace events of the last event loop in the Chrome trace event format, one thread per slot.
+/// The summary of each node is stored in the "otherData" section.
+void RProfiler::WriteChromeTrace(const std::string &fileName) const
+{
+   std::ofstream out(fileName);
+   if (!out)
+      throw std::runtime_error("RDataFrame: cannot open file \"" + fileName + "\" to write the profiling trace.");
+
+   out << "{\"traceEvents\":[";
+   bool first = true;
+   for (unsigned int slot = 0u; slot < fSlots.size(); ++slot) {
+      for (const auto &e : fSlots[slot]->fTrace) {
+         const bool isTask = e.fNodeId == kTaskId;
+         out << (first ? "\n" : ",\n");
+         first = false;
+         out << "{\"name\":\"" << (isTask ? std::string("Task") : EscapeJSON(fNodes[e.fNodeId].fName))
+             << "\",\"cat\":\"" << (isTask ? "Task" : KindName(fNodes[e.fNodeId].fKind))
+             << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << slot << ",\"ts\":" << e.fStart / 1000.
+             << ",\"dur\":" << e.fDuration / 1000. << '}';
+      }
+   }
+   out << "\n],\n\"displayTimeUnit\":\"ns\",\n\"otherData\":{\"samplingInterval\":" << fSamplingInterval
+       << ",\"eventLoopTime\":" << fReport.GetEventLoopTime() << ",\"entries\":" << fReport.GetNEntries()
+       << ",\"nodes\":[";
+   first = true;
+   for (const auto &n : fReport.GetNodes()) {
+      out << (first ? "\n" : ",\n");
+      first = false;
+      out << "{\"kind\":\"" << n.fKind << "\",\"name\":\"" << EscapeJSON(n.fName) << "\",\"calls\":" << n.fCalls
+          << ",\"selfTime\":" << n.fSelfTime << ",\"totalTime\":" << n.fTotalTime << ",\"bytesRead\":" << n.fBytesRead
+          << ",\"unzipTime\":" << n.fUnzipTime << '}';
+   }
+   out << "\n]}}\n";
+}
+
+} // namespace RDF
+} // namespace Internal
+} // namespace ROOT
@@ -336,3 +336,55 @@ TEST(Cache, Alias)
    auto df4 = df3.Cache({"y"});
    EXPECT_EQ(df4.Sum("y").GetValue(), 3u);
 }
+
+static unsigned int CountFilesInDirectory(const char *dirName)
+{
+   unsigned int nFiles = 0u;
+   void *dir = gSystem->OpenDirectory(dirName);
+   while (const char *entry = gSystem->GetDirEntry(dir)) {
+      if (std::string(entry) != "." && std::string(entry) != "..")
+         ++nFiles;
+   }
+   gSystem->FreeDirectory(dir);
+   return nFiles;
+}
+
+TEST(Cache, MemoryBudget)
+{
+   const auto spillDir = "dataframe_cache_memorybudget";
+   gSystem->mkdir(spillDir);
+
+   ROOT::RDataFrame df(100);
+   auto d = df.Define("x", [](ULong64_t e) { return int(e); }, {"rdfentry_"})
+               .Define("v", [](ULong64_t e) { return RVec<double>(e % 4, double(e)); }, {"rdfentry_"});
+
+   // the budget is large enough: the cache stays in memory
+   {
+      auto cached = d.Cache<int, RVec<double>>({"x", "v"}, RCacheOptions(1000000ull, spillDir));
+      EXPECT_EQ(4950, *cached.Sum<int>("x"));
+      EXPECT_EQ(0u, CountFilesInDirectory(spillDir));
+   }
+
+   // the budget is exceeded: the cache is moved to disk, and removed together with the cached RDataFrame
+   {
+      auto cached = d.Cache<int, RVec<double>>({"x", "v"}, RCacheOptions(64ull, spillDir));
+      auto xs = *cached.Take<int>("x");
+      auto sumV = cached.Define("sumv", [](const RVec<double> &v) { return Sum(v); }, {"v"}).Sum<double>("sumv");
+      std::sort(xs.begin(), xs.end());
+      ASSERT_EQ(100u, xs.size());
+      for (auto i : ROOT::TSeqI(100))
+         EXPECT_EQ(i, xs[i]);
+      double expected = 0.;
+      for (auto i : ROOT::TSeqI(100))
+         expected += (i % 4) * double(i);
+      EXPECT_DOUBLE_EQ(expected, *sumV);
+      EXPECT_LT(0u, CountFilesInDirectory(spillDir));
+
+      // jitted
+      auto cachedj = d.Cache({"x"}, RCacheOptions(64ull, spillDir));
+      EXPECT_EQ(4950, *cachedj.Sum<int>("x"));
+   }
+   EXPECT_EQ(0u, CountFilesInDirectory(spillDir));
+
+   gSystem->Unlink(spillDir);
+}
@@ -4,11 +4,16 @@
 #include <ROOT/RVec.hxx>
 #include <ROOT/RDFHelpers.hxx>
 #include <ROOT/RResultHandle.hxx>
+#include <TChain.h>
+#include <TFile.h>
 #include <TSystem.h>
+#include <TTree.h>
 #include <RConfigure.h>
 
 #include <algorithm>
 #include <deque>
+#include <fstream>
+#include <iterator>
 #include <vector>
 #include <string>
 
@@ -574,6 +579,236 @@ TEST(RDFHelpers, GraphAsymmErrorsRunTimeErrors)
    EXPECT_THROW(gr2.GetValue(), std::runtime_error);
 }
 
+TEST(RDFHelpers, ResultCache)
+{
+   const auto cacheFileName = "dataframe_helpers_resultcache.root";
+   gSystem->Unlink(cacheFileName);
+
+   unsigned int nEvaluations = 0u;
+   auto x = [&nEvaluations](ULong64_t e) {
+      ++nEvaluations;
+      return double(e);
+   };
+
+   // first run: nothing in the cache, the event loop runs and the result is stored
+   {
+      RDataFrame df(10);
+      ROOT::RDF::Experimental::EnableResultCache(df, cacheFileName);
+      auto h = df.Define("x", x, {"rdfentry_"}).Histo1D<double>({"h", "h", 10, 0, 10}, "x");
+      EXPECT_EQ(h->GetEntries(), 10);
+      EXPECT_EQ(nEvaluations, 10u);
+   }
+
+   // second run: h is restored, only the new result needs an event loop
+   {
+      RDataFrame df(10);
+      ROOT::RDF::Experimental::EnableResultCache(df, cacheFileName);
+      auto dx = df.Define("x", x, {"rdfentry_"});
+      auto h = dx.Histo1D<double>({"h", "h", 10, 0, 10}, "x");
+      auto h2 = dx.Filter([](double v) { return v > 4; }, {"x"}).Histo1D<double>({"h2", "h2", 10, 0, 10}, "x");
+      EXPECT_EQ(h->GetEntries(), 10);
+      EXPECT_DOUBLE_EQ(h->GetMean(), 4.5);
+      EXPECT_EQ(h2->GetEntries(), 5);
+      EXPECT_EQ(nEvaluations, 20u);
+   }
+
+   // third run: all results are restored, no event loop
+   {
+      RDataFrame df(10);
+      ROOT::RDF::Experimental::EnableResultCache(df, cacheFileName);
+      auto dx = df.Define("x", x, {"rdfentry_"});
+      auto h = dx.Histo1D<double>({"h", "h", 10, 0, 10}, "x");
+      auto h2 = dx.Filter([](double v) { return v > 4; }, {"x"}).Histo1D<double>({"h2", "h2", 10, 0, 10}, "x");
+      EXPECT_EQ(h->GetEntries(), 10);
+      EXPECT_EQ(h2->GetEntries(), 5);
+      EXPECT_TRUE(h.IsReady() && h2.IsReady());
+      EXPECT_EQ(nEvaluations, 20u);
+      EXPECT_EQ(h->GetDirectory(), nullptr);
+   }
+
+   // a different dataset does not hit the cache
+   {
+      RDataFrame df(20);
+      ROOT::RDF::Experimental::EnableResultCache(df, cacheFileName);
+      auto h = df.Define("x", x, {"rdfentry_"}).Histo1D<double>({"h", "h", 10, 0, 10}, "x");
+      EXPECT_EQ(h->GetEntries(), 20);
+      EXPECT_EQ(nEvaluations, 40u);
+   }
+
+   // graphs that only differ by their Range do not share results
+   auto runRange = [&](unsigned int begin, unsigned int end) {
+      RDataFrame df(10);
+      ROOT::RDF::Experimental::EnableResultCache(df, cacheFileName);
+      return df.Define("x", x, {"rdfentry_"}).Range(begin, end).Histo1D<double>({"h", "h", 10, 0, 10}, "x");
+   };
+   auto hFirst = runRange(0, 5);
+   auto hLast = runRange(5, 10);
+   EXPECT_EQ(hFirst->GetEntries(), 5);
+   EXPECT_EQ(hLast->GetEntries(), 5);
+   EXPECT_DOUBLE_EQ(hFirst->GetMean(), 2);
+   EXPECT_DOUBLE_EQ(hLast->GetMean(), 7);
+   const auto nEvaluationsRanges = nEvaluations;
+   EXPECT_DOUBLE_EQ(runRange(5, 10)->GetMean(), 7);
+   EXPECT_EQ(nEvaluations, nEvaluationsRanges);
+
+   gSystem->Unlink(cacheFileName);
+}
+
+TEST(RDFHelpers, ResultCacheTTree)
+{
+   const auto cacheFileName = "dataframe_helpers_resultcache_ttree.root";
+   const auto inputFileName = "dataframe_helpers_resultcache_ttree_input.root";
+   gSystem->Unlink(cacheFileName);
+   auto writeInput = [&](int nEntries) {
+      TFile f(inputFileName, "RECREATE");
+      TTree t("t", "t");
+      double x;
+      t.Branch("x", &x);
+      for (int i = 0; i < nEntries; ++i) {
+         x = i;
+         t.Fill();
+      }
+      t.Write();
+   };
+   writeInput(10);
+
+   unsigned int nEvaluations = 0u;
+   auto y = [&nEvaluations](double x) {
+      ++nEvaluations;
+      return x;
+   };
+   auto runHisto = [&](const std::string &cut, int nBins) {
+      RDataFrame df("t", inputFileName);
+      ROOT::RDF::Experimental::EnableResultCache(df, cacheFileName);
+      return df.Define("y", y, {"x"}).Filter(cut).Histo1D<double>({"h", "h", nBins, 0, 10}, "y");
+   };
+
+   EXPECT_EQ(runHisto("y > 4", 10)->GetEntries(), 5);
+   EXPECT_EQ(nEvaluations, 10u);
+   // same cut and binning: restored
+   EXPECT_EQ(runHisto("y > 4", 10)->GetEntries(), 5);
+   EXPECT_EQ(nEvaluations, 10u);
+   // a different cut does not hit the cache
+   EXPECT_EQ(runHisto("y > 6", 10)->GetEntries(), 3);
+   EXPECT_EQ(nEvaluations, 20u);
+   // a different binning does not hit the cache
+   auto h = runHisto("y > 4", 20);
+   EXPECT_EQ(h->GetEntries(), 5);
+   EXPECT_EQ(h->GetNbinsX(), 20);
+   EXPECT_EQ(nEvaluations, 30u);
+
+   // two results that only differ by their cut are stored separately
+   {
+      RDataFrame df("t", inputFileName);
+      ROOT::RDF::Experimental::EnableResultCache(df, cacheFileName);
+      auto dy = df.Define("y", y, {"x"});
+      auto h1 = dy.Filter("y > 1").Histo1D<double>({"h", "h", 10, 0, 10}, "y");
+      auto h2 = dy.Filter("y > 2").Histo1D<double>({"h", "h", 10, 0, 10}, "y");
+      EXPECT_EQ(h1->GetEntries(), 8);
+      EXPECT_EQ(h2->GetEntries(), 7);
+      EXPECT_EQ(nEvaluations, 40u);
+   }
+   {
+      RDataFrame df("t", inputFileName);
+      ROOT::RDF::Experimental::EnableResultCache(df, cacheFileName);
+      auto dy = df.Define("y", y, {"x"});
+      auto h1 = dy.Filter("y > 1").Histo1D<double>({"h", "h", 10, 0, 10}, "y");
+      auto h2 = dy.Filter("y > 2").Histo1D<double>({"h", "h", 10, 0, 10}, "y");
+      EXPECT_EQ(h1->GetEntries(), 8);
+      EXPECT_EQ(h2->GetEntries(), 7);
+      EXPECT_EQ(nEvaluations, 40u);
+   }
+
+   // a chain of a rewritten file does not hit the cache
+   auto runChain = [&]() {
+      TChain c("t");
+      c.Add(inputFileName);
+      RDataFrame df(c);
+      ROOT::RDF::Experimental::EnableResultCache(df, cacheFileName);
+      return df.Define("y", y, {"x"}).Histo1D<double>({"h", "h", 10, 0, 10}, "y")->GetEntries();
+   };
+   EXPECT_EQ(runChain(), 10);
+   EXPECT_EQ(nEvaluations, 50u);
+   EXPECT_EQ(runChain(), 10);
+   EXPECT_EQ(nEvaluations, 50u);
+   writeInput(20);
+   EXPECT_EQ(runChain(), 20);
+   EXPECT_EQ(nEvaluations, 70u);
+
+   // trees with the same name in different directories of a file are told apart
+   {
+      TFile f(inputFileName, "RECREATE");
+      for (int nEntries : {3, 4}) {
+         auto dir = f.mkdir(("d" + std::to_string(nEntries)).c_str());
+         dir->cd();
+         TTree t("t", "t");
+         double x;
+         t.Branch("x", &x);
+         for (int i = 0; i < nEntries; ++i) {
+            x = i;
+            t.Fill();
+         }
+         t.Write();
+      }
+   }
+   auto runDir = [&](const std::string &treeName) {
+      RDataFrame df(treeName, inputFileName);
+      ROOT::RDF::Experimental::EnableResultCache(df, cacheFileName);
+      return df.Define("y", y, {"x"}).Histo1D<double>({"h", "h", 10, 0, 10}, "y")->GetEntries();
+   };
+   EXPECT_EQ(runDir("d3/t"), 3);
+   EXPECT_EQ(runDir("d4/t"), 4);
+   EXPECT_EQ(nEvaluations, 77u);
+
+   gSystem->Unlink(cacheFileName);
+   gSystem->Unlink(inputFileName);
+}
+
+TEST(RDFHelpers, Profiling)
+{
+   using ROOT::RDF::Experimental::RProfileReport;
+   const auto traceFileName = "dataframe_helpers_profiling.json";
+   RDataFrame df(100);
+   EXPECT_THROW(ROOT::RDF::Experimental::GetProfileReport(df), std::runtime_error);
+
+   ROOT::RDF::Experimental::EnableProfiling(df, traceFileName, /*traceSamplingInterval=*/10);
+   auto dx = df.Define("x", [](ULong64_t e) { return double(e); }, {"rdfentry_"});
+   auto c = dx.Filter([](double x) { return x < 30; }, {"x"}, "xcut").Count();
+   EXPECT_EQ(*c, 30ull);
+
+   const auto report = ROOT::RDF::Experimental::GetProfileReport(df);
+   EXPECT_EQ(report.GetNEntries(), 100ull);
+   EXPECT_GT(report.GetEventLoopTime(), 0.);
+   auto findNode = [&report](const std::string &kind, const std::string &name) {
+      const auto &nodes = report.GetNodes();
+      auto it = std::find_if(nodes.begin(), nodes.end(), [&](const RProfileReport::RNodeProfile &n) {
+         return n.fKind == kind && n.fName == name;
+      });
+      return it == nodes.end() ? nullptr : &*it;
+   };
+   const auto *filter = findNode("Filter", "xcut");
+   const auto *define = findNode("Define", "x");
+   const auto *action = findNode("Action", "Count()");
+   ASSERT_NE(filter, nullptr);
+   ASSERT_NE(define, nullptr);
+   ASSERT_NE(action, nullptr);
+   EXPECT_EQ(filter->fCalls, 100ull);
+   EXPECT_EQ(define->fCalls, 100ull);
+   EXPECT_EQ(action->fCalls, 30ull);
+   // the Define is evaluated from within the Filter
+   EXPECT_GE(filter->fTotalTime, define->fTotalTime);
+   EXPECT_LE(filter->fSelfTime, filter->fTotalTime);
+   EXPECT_NE(report.AsString().find("xcut"), std::string::npos);
+
+   std::ifstream trace(traceFileName);
+   ASSERT_TRUE(trace.good());
+   const std::string content((std::istreambuf_iterator<char>(trace)), std::istreambuf_iterator<char>());
+   EXPECT_NE(content.find("\"traceEvents\""), std::string::npos);
+   EXPECT_NE(content.find("\"name\":\"xcut\""), std::string::npos);
+   trace.close();
+   gSystem->Unlink(traceFileName);
+}
+
 TEST(RunGraphs, RunGraphs)
 {
 #ifdef R__USE_IMT
@@ -682,3 +917,37 @@ TEST(RunGraphs, AlreadyRun)
    ROOT_EXPECT_WARNING(ROOT::RDF::RunGraphs({r1, r2, r3, r4}), "RunGraphs",
                        "Got 4 handles from which 2 link to results which are already ready.");
 }
+
+TEST(RunGraphs, SharedScan)
+{
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif // R__USE_IMT
+
+   const auto fileName = "dataframe_helpers_sharedscan.root";
+   ROOT::RDataFrame(10)
+      .Define("x", [](ULong64_t e) { return int(e); }, {"rdfentry_"})
+      .Snapshot<int>("t", fileName, {"x"});
+
+   // same dataset: the two graphs run in a single event loop, also when one of them stops early
+   ROOT::RDataFrame df1("t", fileName);
+   auto r1 = df1.Sum<int>("x");
+   ROOT::RDataFrame df2("t", fileName);
+   auto r2 = df2.Filter([](int x) { return x % 2 == 0; }, {"x"}).Count();
+   auto r3 = df2.Range(3).Take<int>("x");
+   // different dataset: runs on its own
+   ROOT::RDataFrame df3(4);
+   auto r4 = df3.Count();
+
+   ROOT::RDF::RunGraphs({r1, r2, r3, r4});
+
+   EXPECT_EQ(df1.GetNRuns(), 1u);
+   EXPECT_EQ(df2.GetNRuns(), 1u);
+   EXPECT_EQ(df3.GetNRuns(), 1u);
+   EXPECT_EQ(*r1, 45);
+   EXPECT_EQ(*r2, 5u);
+   EXPECT_EQ(*r3, std::vector<int>({0, 1, 2}));
+   EXPECT_EQ(*r4, 4u);
+
+   gSystem->Unlink(fileName);
+}
@@ -10,6 +10,7 @@
 #include <ROOT/RDataFrame.hxx>
 #include <ROOT/TSeq.hxx>
 #include <TChain.h>
+#include <TEnv.h>
 #include <TFile.h>
 #include <TGraph.h>
 #include <TInterpreter.h>
@@ -17,6 +18,7 @@
 #include <TROOT.h>
 #include <TSystem.h>
 #include <TTree.h>
+#include <TTreeCache.h>
 
 #include <algorithm> // std::sort
 #include <array>
@@ -385,6 +387,35 @@ TEST_P(RDFSimpleTests, DefineSlotEntry)
    }
 }
 
+TEST_P(RDFSimpleTests, TakeFundamentalSharedBuffer)
+{
+   // more entries than fit in a few chunks of the shared buffer, so that several tasks leave partially filled chunks
+   const ULong64_t nEntries = 100003ull;
+   RDataFrame df(nEntries);
+   auto d = df.DefineSlotEntry("e", [](unsigned int, ULong64_t e) { return e; });
+   // the number of values is known in advance: all slots write into the pre-sized result
+   auto all = d.Take<ULong64_t>("e");
+   // the number of values is not known: values are collected in blocks and appended at the end
+   auto odd = d.Filter([](ULong64_t e) { return e % 2 == 1; }, {"e"}).Take<ULong64_t>("e");
+   // Defines upstream do not change the number of values
+   auto asFloat = d.Define("f", [](ULong64_t e) { return float(e); }, {"e"}).Take<float>("f");
+
+   auto allValues = *all;
+   ASSERT_EQ(allValues.size(), nEntries);
+   std::sort(allValues.begin(), allValues.end());
+   for (ULong64_t i = 0; i < nEntries; ++i)
+      ASSERT_EQ(allValues[i], i);
+
+   auto oddValues = *odd;
+   ASSERT_EQ(oddValues.size(), nEntries / 2);
+   std::sort(oddValues.begin(), oddValues.end());
+   for (ULong64_t i = 0; i < nEntries / 2; ++i)
+      ASSERT_EQ(oddValues[i], 2 * i + 1);
+
+   EXPECT_EQ(asFloat->size(), nEntries);
+   EXPECT_DOUBLE_EQ(std::accumulate(asFloat->begin(), asFloat->end(), 0.), (nEntries - 1) * nEntries / 2.);
+}
+
 TEST_P(RDFSimpleTests, Define_Multiple)
 {
    RDataFrame tdf(3);
@@ -1014,6 +1045,134 @@ TEST_P(RDFSimpleTests, FillWithCustomClassJitted)
    EXPECT_EQ(h.GetEntries(), 10);
 }
 
+// Large histograms are filled in shared mode, with less copies than slots: results must not change
+TEST_P(RDFSimpleTests, SharedFillLargeHistograms)
+{
+   auto fill = [](const char *thresholdMB) {
+      gSystem->Setenv("ROOT_RDF_SHAREDFILLTHRESHOLD", thresholdMB);
+      auto df = ROOT::RDataFrame(10000)
+                   .Define("x", [](ULong64_t e) { return double(e % 400); }, {"rdfentry_"})
+                   .Define("y", [](ULong64_t e) { return double(e % 397); }, {"rdfentry_"})
+                   .Define("w", [](ULong64_t e) { return double(e % 3); }, {"rdfentry_"})
+                   .Define("v", [](ULong64_t e) { return ROOT::RVecD{double(e % 5), double(e % 7)}; }, {"rdfentry_"});
+      // ~1.3 MB of bins each
+      auto h2 = df.Histo2D<double, double, double>({"h2", "h2", 400, 0, 400, 400, 0, 400}, "x", "y", "w");
+      auto hv = df.Histo2D<ROOT::RVecD, ROOT::RVecD>({"hv", "hv", 400, 0, 400, 400, 0, 400}, "v", "v");
+      gSystem->Unsetenv("ROOT_RDF_SHAREDFILLTHRESHOLD");
+      return std::vector<ROOT::RDF::RResultPtr<TH2D>>{h2, hv};
+   };
+
+   auto perSlot = fill("0");
+   auto shared = fill("1");
+   for (std::size_t i = 0; i < perSlot.size(); ++i) {
+      EXPECT_EQ(perSlot[i]->GetEntries(), shared[i]->GetEntries());
+      EXPECT_DOUBLE_EQ(perSlot[i]->GetSumOfWeights(), shared[i]->GetSumOfWeights());
+      EXPECT_NEAR(perSlot[i]->GetMean(1), shared[i]->GetMean(1), 1e-9);
+      EXPECT_NEAR(perSlot[i]->GetMean(2), shared[i]->GetMean(2), 1e-9);
+      for (int bin = 0; bin < perSlot[i]->GetNcells(); ++bin)
+         ASSERT_DOUBLE_EQ(perSlot[i]->GetBinContent(bin), shared[i]->GetBinContent(bin));
+   }
+}
+
+// Only the branches read exclusively downstream of Filters are read on demand by the TTreeCache
+TEST(RDFSimpleTests, CacheDeferredBranches)
+{
+   const auto fileName = "dataframe_simple_cachedeferredbranches.root";
+   {
+      TFile f(fileName, "RECREATE");
+      TTree t("t", "t");
+      double a, b, c, d;
+      t.Branch("a", &a);
+      t.Branch("b", &b);
+      t.Branch("c", &c);
+      t.Branch("d", &d);
+      for (int i = 0; i < 100; ++i) {
+         a = b = c = d = i;
+         t.Fill();
+      }
+      t.Write();
+   }
+
+   TFile f(fileName);
+   auto *t = f.Get<TTree>("t");
+   std::set<std::string> deferred;
+   auto cut = [&](double a) {
+      if (auto *cache = t->GetReadCache(t->GetCurrentFile()))
+         for (auto *branch : cache->GetDeferredBranches())
+            deferred.insert(branch->GetName());
+      return a > 90;
+   };
+
+   RDataFrame df(*t);
+   auto filtered = df.Filter(cut, {"a"}).Define("e", [](double d) { return 2 * d; }, {"d"});
+   // b and d (through e) are only read for the entries that pass the Filter, c is also read for every entry
+   auto hb = filtered.Histo1D<double>("b");
+   auto he = filtered.Histo1D<double>("e");
+   auto hc = filtered.Histo1D<double>("c");
+   auto hcAll = df.Histo1D<double>("c");
+   EXPECT_EQ(hb->GetEntries(), 9);
+   EXPECT_EQ(hcAll->GetEntries(), 100);
+   EXPECT_EQ(deferred, (std::set<std::string>{"b", "d"}));
+
+   gSystem->Unlink(fileName);
+}
+
+// The baskets of a deferred branch are only read for the entries that pass the Filter, unless the deferral is
+// disabled in the rootrc
+TEST(RDFSimpleTests, CacheDeferredBranchesBytesRead)
+{
+   const auto fileName = "dataframe_simple_cachedeferredbytesread.root";
+   {
+      TFile f(fileName, "RECREATE");
+      TTree t("t", "t");
+      int a = 0;
+      double b = 0.;
+      t.Branch("a", &a);
+      t.Branch("b", &b)->SetBasketSize(4000); // many payload baskets per cluster
+      t.SetAutoFlush(10000);
+      TRandom rnd(42);
+      for (int i = 0; i < 100000; ++i) {
+         a = i;
+         b = rnd.Gaus();
+         t.Fill();
+      }
+      t.Write();
+   }
+
+   Long64_t zipBytesB = 0;
+   {
+      TFile f(fileName);
+      zipBytesB = f.Get<TTree>("t")->GetBranch("b")->GetZipBytes();
+   }
+
+   // The sum of b for the last 1000 entries, and the number of bytes read from the file to compute it
+   auto readSelected = [&]() {
+      TFile f(fileName);
+      auto *t = f.Get<TTree>("t");
+      RDataFrame df(*t);
+      auto sum = df.Filter([](int a) { return a >= 99000; }, {"a"}).Sum<double>("b");
+      const double value = *sum;
+      return std::make_pair(value, f.GetBytesRead());
+   };
+
+   const auto deferred = readSelected();
+   std::pair<double, Long64_t> prefetched;
+   {
+      struct DeferPayloadBranchesRAII {
+         DeferPayloadBranchesRAII() { gEnv->SetValue("RDataFrame.DeferPayloadBranches", 0); }
+         ~DeferPayloadBranchesRAII() { gEnv->SetValue("RDataFrame.DeferPayloadBranches", 1); }
+      } noDeferral;
+      prefetched = readSelected();
+   }
+
+   EXPECT_DOUBLE_EQ(deferred.first, prefetched.first);
+   // all the baskets of b are prefetched, but only the few holding the selected entries are read on demand
+   EXPECT_GE(prefetched.second, zipBytesB);
+   EXPECT_LT(deferred.second, prefetched.second - zipBytesB / 2);
+
+   gSystem->Unlink(fileName);
+}
+
 // run single-thread tests
 INSTANTIATE_TEST_SUITE_P(Seq, RDFSimpleTests, ::testing::Values(false));
 
@@ -3,6 +3,7 @@
 #include <ROOT/RDFHelpers.hxx>
 #include <TSystem.h>
 
+#include <atomic>
 #include <thread> // std::thread::hardware_concurrency
 
 #include "SimpleFiller.h" // for VaryFill
@@ -729,6 +730,32 @@ TEST_P(RDFVary, FilterChainDependingOnVariations)
    EXPECT_EQ(sums["y:1"], 30);
 }
 
+TEST_P(RDFVary, FilterEvaluatedOncePerEntry)
+{
+   // the second filter only depends on the variations through the first one: its varied clones read the same values
+   // as the nominal filter, so the filter expression is evaluated once per entry rather than once per variation
+   std::atomic<int> nEvaluations(0);
+   auto sum = ROOT::RDataFrame(10)
+                 .Define("x", [](ULong64_t e) { return int(e); }, {"rdfentry_"})
+                 .Define("y", [] { return 1; })
+                 .Vary("x", [](int x) { return ROOT::RVecI{x - 1, x + 1}; }, {"x"}, {"down", "up"})
+                 .Filter([](int x) { return x > 2; }, {"x"})
+                 .Filter(
+                    [&nEvaluations](int y) {
+                       ++nEvaluations;
+                       return y > 0;
+                    },
+                    {"y"})
+                 .Sum<int>("x");
+   auto sums = VariationsFor(sum);
+
+   EXPECT_EQ(sums["nominal"], 42);
+   EXPECT_EQ(sums["x:down"], 33);
+   EXPECT_EQ(sums["x:up"], 52);
+   // entries 2 to 9 pass the first filter in at least one variation
+   EXPECT_EQ(nEvaluations, 8);
+}
+
 TEST_P(RDFVary, JittedAction)
 {
    auto df = ROOT::RDataFrame(10).Define("x", [] { return 1; });
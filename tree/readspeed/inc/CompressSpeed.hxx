@@ -0,0 +1,96 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/* This header contains the building blocks of the rootcompressspeed program, which replays the baskets of the
+   branches of a TTree (or the pages of the fields of an RNTuple) through every compression setting. */
+
+#ifndef ROOTCOMPRESSSPEED
+#define ROOTCOMPRESSSPEED
+
+#include <RtypesCore.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class TBranch;
+
+namespace CompressSpeed {
+
+struct Data {
+   /// The input file.
+   std::string fFileName;
+   /// The name of the TTree or RNTuple in the file.
+   std::string fTreeName;
+   /// Branches (or fields) to replay; all the branches if empty. Selecting a branch selects its sub-branches.
+   std::vector<std::string> fBranchNames;
+   /// Compression settings to replay (algorithm * 100 + level, see Compression.h).
+   std::vector<int> fCompressionSettings = GetDefaultCompressionSettings();
+   /// Maximum number of baskets (or pages) replayed per branch, evenly spread over the branch; 0 replays them all.
+   unsigned int fMaxBuffers = 0;
+   /// Throughput of the storage in MB/s, used to recommend a setting; 0 recommends the smallest output.
+   double fBandwidth = 100.;
+
+   static std::vector<int> GetDefaultCompressionSettings();
+};
+
+/// The uncompressed content of the baskets of a branch, or of the pages of a field.
+struct BranchData {
+   std::string fName;
+   /// Compression settings of the branch in the file.
+   int fCompressionSettings = 0;
+   /// Size of the buffers as stored in the file.
+   ULong64_t fCompressedBytes = 0;
+   std::vector<std::vector<char>> fBuffers;
+
+   ULong64_t GetUncompressedBytes() const;
+};
+
+struct SettingResult {
+   int fCompressionSettings = 0;
+   ULong64_t fCompressedBytes = 0;
+   /// Time spent compressing the buffers, in seconds.
+   double fCompressionTime = 0.;
+   /// Time spent decompressing the buffers, in seconds.
+   double fDecompressionTime = 0.;
+};
+
+struct BranchResult {
+   std::string fName;
+   int fFileCompressionSettings = 0;
+   /// Number of baskets (or pages) replayed.
+   std::size_t fNBuffers = 0;
+   ULong64_t fUncompressedBytes = 0;
+   ULong64_t fFileCompressedBytes = 0;
+   std::vector<SettingResult> fResults;
+   /// Index in fResults of the recommended setting.
+   std::size_t fRecommended = 0;
+};
+
+using BranchVisitor_t = std::function<void(BranchData &&)>;
+
+BranchData ExtractBaskets(TBranch &branch, unsigned int maxBuffers);
+
+// Call visit with the baskets of every selected branch of the TTree d.fTreeName, one branch at a time.
+void VisitTreeBranches(const Data &d, const BranchVisitor_t &visit);
+
+// Call visit with the pages of every selected field of the RNTuple d.fTreeName, one field at a time.
+// Throws if ROOT was built without RNTuple support.
+void VisitNTupleFields(const Data &d, const BranchVisitor_t &visit);
+
+// Compress and decompress buffer `index` of data with the given compression settings.
+SettingResult ReplayBuffer(const BranchData &data, std::size_t index, int compressionSettings);
+
+// Index of the setting minimizing the time to read (at bandwidth MB/s) and decompress the data.
+std::size_t Recommend(const std::vector<SettingResult> &results, double bandwidth);
+
+std::vector<BranchResult> EvalCompression(const Data &d, unsigned int nThreads);
+
+} // namespace CompressSpeed
+
+#endif // ROOTCOMPRESSSPEED
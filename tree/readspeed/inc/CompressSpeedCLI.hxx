@@ -0,0 +1,34 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/* This header contains helper functions for the rootcompressspeed program
+   for CLI related actions, such as argument parsing and output printing. */
+
+#ifndef ROOTCOMPRESSSPEEDCLI
+#define ROOTCOMPRESSSPEEDCLI
+
+#include "CompressSpeed.hxx"
+
+#include <vector>
+
+namespace CompressSpeed {
+
+void PrintResults(const std::vector<BranchResult> &results, double bandwidth);
+
+struct Args {
+   Data fData;
+   unsigned int fNThreads = 0;
+   bool fShouldRun = false;
+};
+
+Args ParseArgs(const std::vector<std::string> &args);
+Args ParseArgs(int argc, char **argv);
+
+} // namespace CompressSpeed
+
+#endif // ROOTCOMPRESSSPEEDCLI
@@ -13,6 +13,7 @@
 
 #include <TFile.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <regex>
@@ -28,6 +29,10 @@ struct Data {
    std::vector<std::string> fBranchNames;
    /// If the branch names should use regex matching.
    bool fUseRegex = false;
+   /// Only read and decompress the baskets (or pages) of the branches, without deserializing the entries.
+   bool fDecompressionOnly = false;
+   /// Drop the input files from the page cache of the operating system before reading them.
+   bool fColdCache = false;
 };
 
 struct Result {
@@ -45,6 +50,28 @@ struct Result {
    ULong64_t fCompressedBytesRead;
    /// Size of ROOT's thread pool for the run (0 indicates a single-thread run with no thread pool present).
    unsigned int fThreadPoolSize;
+   /// Real time spent reading the compressed data from storage, summed over threads (decompression-only runs).
+   double fReadTime = 0.;
+   /// Real time spent decompressing the data, summed over threads (decompression-only runs).
+   double fDecompressionTime = 0.;
+};
+
+/// The throughput of a single branch (or RNTuple field), broken down in stages.
+struct BranchResult {
+   std::string fBranchName;
+   /// Number of compressed bytes of the baskets (or pages) read from storage.
+   ULong64_t fCompressedBytesRead = 0;
+   /// Number of bytes of the decompressed baskets (or pages).
+   ULong64_t fUncompressedBytesRead = 0;
+   /// Real time spent reading the compressed baskets (or pages) from storage, in seconds.
+   double fReadTime = 0.;
+   /// Real time spent decompressing the baskets (or pages), in seconds.
+   double fDecompressionTime = 0.;
+   /// Real time spent reading all the entries of the branch alone, in seconds; 0 for decompression-only runs.
+   double fTotalTime = 0.;
+
+   /// Estimate of the time spent deserializing the entries, in seconds.
+   double GetDeserializationTime() const { return std::max(0., fTotalTime - fReadTime - fDecompressionTime); }
 };
 
 struct EntryRange {
@@ -55,6 +82,10 @@ struct EntryRange {
 struct ByteData {
    ULong64_t fUncompressedBytesRead;
    ULong64_t fCompressedBytesRead;
+   /// Real time spent reading the compressed data from storage, only measured when reading baskets (or pages).
+   double fReadTime = 0.;
+   /// Real time spent decompressing the data, only measured when reading baskets (or pages).
+   double fDecompressionTime = 0.;
 };
 
 struct ReadSpeedRegex {
@@ -71,6 +102,32 @@ std::vector<std::string> GetMatchingBranchNames(const std::string &fileName, con
 ByteData ReadTree(TFile *file, const std::string &treeName, const std::vector<std::string> &branchNames,
                   EntryRange range = {-1, -1});
 
+// Read and decompress the baskets starting in range of the branches listed in branchNames (and of their
+// sub-branches), without deserializing them.
+ByteData ReadTreeBaskets(TFile *file, const std::string &treeName, const std::vector<std::string> &branchNames,
+                         EntryRange range = {-1, -1});
+
+// Return whether treeName in file is an RNTuple rather than a TTree.
+bool IsNTuple(TFile *file, const std::string &treeName);
+
+// The functions below throw if ROOT was built without RNTuple support.
+std::vector<std::string> GetNTupleFieldNames(const std::string &fileName, const std::string &ntupleName);
+
+std::vector<EntryRange> GetNTupleClusters(const std::string &fileName, const std::string &ntupleName);
+
+// Read the top-level fields listed in fieldNames of the entries in range (clusters starting in range) of RNTuple
+// ntupleName.
+ByteData ReadNTuple(const std::string &fileName, const std::string &ntupleName,
+                    const std::vector<std::string> &fieldNames, EntryRange range = {-1, -1});
+
+// Read and decompress the pages of the clusters starting in range of the fields listed in fieldNames (and of their
+// sub-fields), without deserializing them.
+ByteData ReadNTuplePages(const std::string &fileName, const std::string &ntupleName,
+                         const std::vector<std::string> &fieldNames, EntryRange range = {-1, -1});
+
+// Drop the file from the page cache of the operating system; does nothing for remote files.
+void DropFileCache(const std::string &fileName);
+
 Result EvalThroughputST(const Data &d);
 
 // Return a vector of EntryRanges per file, i.e. a vector of vectors of EntryRanges with outer size equal to
@@ -87,6 +144,9 @@ Result EvalThroughputMT(const Data &d, unsigned nThreads);
 
 Result EvalThroughput(const Data &d, unsigned nThreads);
 
+// Read every branch on its own, single-threaded, breaking down the time spent in each stage.
+std::vector<BranchResult> EvalBranchThroughput(const Data &d);
+
 } // namespace ReadSpeed
 
 #endif // ROOTREADSPEED
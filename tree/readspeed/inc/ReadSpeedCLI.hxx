@@ -16,17 +16,25 @@
 
 #include "ReadSpeed.hxx"
 
+#include <iostream>
 #include <vector>
 
 namespace ReadSpeed {
 
 void PrintThroughput(const Result &r);
+void PrintThroughputJSON(const Result &r, std::ostream &out = std::cout);
+void PrintBranchThroughput(const std::vector<BranchResult> &results);
+void PrintBranchThroughputJSON(const std::vector<BranchResult> &results, std::ostream &out = std::cout);
 
 struct Args {
    Data fData;
    unsigned int fNThreads = 0;
    bool fAllBranches = false;
    bool fShouldRun = false;
+   /// Report the throughput of every branch on its own.
+   bool fPerBranch = false;
+   /// Print the results as JSON.
+   bool fJSON = false;
 };
 
 Args ParseArgs(const std::vector<std::string> &args);
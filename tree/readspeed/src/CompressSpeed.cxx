@@ -0,0 +1,263 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "CompressSpeed.hxx"
+
+#include <ROOT/TSeq.hxx>
+
+#ifdef R__USE_IMT
+#include <ROOT/TThreadExecutor.hxx>
+#endif
+
+#include <Compression.h>
+#include <RZip.h>
+#include <TBasket.h>
+#include <TBranch.h>
+#include <TBuffer.h>
+#include <TFile.h>
+#include <TLeaf.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <numeric> // std::accumulate
+#include <set>
+#include <stdexcept>
+
+using namespace CompressSpeed;
+
+std::vector<int> Data::GetDefaultCompressionSettings()
+{
+   return {101, 104, 106, 109, 201, 204, 207, 209, 401, 404, 409, 501, 505, 509};
+}
+
+ULong64_t BranchData::GetUncompressedBytes() const
+{
+   return std::accumulate(fBuffers.begin(), fBuffers.end(), 0ull,
+                          [](ULong64_t sum, const std::vector<char> &b) { return sum + b.size(); });
+}
+
+BranchData CompressSpeed::ExtractBaskets(TBranch &branch, unsigned int maxBuffers)
+{
+   BranchData data;
+   data.fName = branch.GetFullName().Data();
+   data.fCompressionSettings = branch.GetCompressionSettings();
+
+   const Int_t nBaskets = branch.GetWriteBasket();
+   const Int_t stride = maxBuffers > 0 && Int_t(maxBuffers) < nBaskets ? (nBaskets + maxBuffers - 1) / maxBuffers : 1;
+   for (Int_t i = 0; i < nBaskets; i += stride) {
+      TBasket *basket = branch.GetBasket(i);
+      if (basket == nullptr)
+         throw std::runtime_error("Could not read basket " + std::to_string(i) + " of branch '" + data.fName + '\'');
+      // After reading, the buffer holds the key followed by the uncompressed content of the basket
+      const char *content = basket->GetBufferRef()->Buffer() + basket->GetKeylen();
+      if (basket->GetObjlen() > 0) {
+         data.fBuffers.emplace_back(content, content + basket->GetObjlen());
+         data.fCompressedBytes += basket->GetNbytes() - basket->GetKeylen();
+      }
+      branch.DropBaskets("all");
+   }
+   return data;
+}
+
+void CompressSpeed::VisitTreeBranches(const Data &d, const BranchVisitor_t &visit)
+{
+   std::unique_ptr<TFile> f(TFile::Open(d.fFileName.c_str(), "READ_WITHOUT_GLOBALREGISTRATION"));
+   if (f == nullptr || f->IsZombie())
+      throw std::runtime_error("Could not open file '" + d.fFileName + '\'');
+   auto *t = f->Get<TTree>(d.fTreeName.c_str()); // TFile owns this TTree
+   if (t == nullptr)
+      throw std::runtime_error("Could not retrieve tree '" + d.fTreeName + "' from file '" + d.fFileName + '\'');
+
+   // The baskets belong to the branches holding the leaves; a branch is also selected through its top-level branch
+   std::vector<TBranch *> branches;
+   std::set<std::string> usedNames;
+   for (auto *obj : *t->GetListOfLeaves()) {
+      auto *b = static_cast<TLeaf *>(obj)->GetBranch();
+      if (std::find(branches.begin(), branches.end(), b) != branches.end())
+         continue;
+      if (!d.fBranchNames.empty()) {
+         const auto name = std::find_if(d.fBranchNames.begin(), d.fBranchNames.end(), [b](const std::string &n) {
+            return n == b->GetName() || n == b->GetFullName().Data() || n == b->GetMother()->GetName();
+         });
+         if (name == d.fBranchNames.end())
+            continue;
+         usedNames.insert(*name);
+      }
+      branches.push_back(b);
+   }
+   for (const auto &name : d.fBranchNames) {
+      if (usedNames.count(name) == 0)
+         throw std::runtime_error("Could not retrieve branch '" + name + "' from tree '" + d.fTreeName +
+                                  "' in file '" + d.fFileName + '\'');
+   }
+
+   for (auto *b : branches)
+      visit(ExtractBaskets(*b, d.fMaxBuffers));
+}
+
+#ifndef R__READSPEED_NTUPLE
+void CompressSpeed::VisitNTupleFields(const Data &d, const BranchVisitor_t &)
+{
+   throw std::runtime_error("Could not retrieve tree '" + d.fTreeName + "' from file '" + d.fFileName +
+                            "' (ROOT was built without RNTuple support)");
+}
+#endif
+
+SettingResult CompressSpeed::ReplayBuffer(const BranchData &data, std::size_t index, int compressionSettings)
+{
+   using Clock_t = std::chrono::steady_clock;
+   const auto &buffer = data.fBuffers[index];
+   const auto algorithm = static_cast<ROOT::RCompressionSetting::EAlgorithm::EValues>(compressionSettings / 100);
+   const int level = compressionSettings % 100;
+   const int nbytes = buffer.size();
+   const int nChunks = nbytes > 0 ? 1 + (nbytes - 1) / kMAXZIPBUF : 0;
+
+   SettingResult result;
+   result.fCompressionSettings = compressionSettings;
+
+   // Compress in chunks of at most kMAXZIPBUF bytes like TBasket::WriteBuffer: if a chunk does not shrink, the
+   // whole buffer is stored uncompressed.
+   std::vector<char> zipped(nbytes);
+   std::vector<int> zippedLen(nChunks);
+   char *src = const_cast<char *>(buffer.data());
+   char *tgt = zipped.data();
+   bool stored = false;
+   auto start = Clock_t::now();
+   for (int c = 0; c < nChunks; ++c) {
+      int srcSize = std::min<int>(kMAXZIPBUF, nbytes - c * kMAXZIPBUF);
+      int tgtSize = srcSize;
+      int nout = 0;
+      R__zipMultipleAlgorithm(level, &srcSize, src + c * kMAXZIPBUF, &tgtSize, tgt, &nout, algorithm);
+      if (nout == 0 || nout >= srcSize) {
+         stored = true;
+         break;
+      }
+      zippedLen[c] = nout;
+      tgt += nout;
+   }
+   result.fCompressionTime = std::chrono::duration<double>(Clock_t::now() - start).count();
+   if (stored) {
+      result.fCompressedBytes = nbytes;
+      return result;
+   }
+   result.fCompressedBytes = tgt - zipped.data();
+
+   std::vector<char> unzipped(nbytes);
+   auto *zsrc = reinterpret_cast<unsigned char *>(zipped.data());
+   auto *dst = reinterpret_cast<unsigned char *>(unzipped.data());
+   start = Clock_t::now();
+   for (int c = 0; c < nChunks; ++c) {
+      int srcSize = zippedLen[c];
+      int tgtSize = std::min<int>(kMAXZIPBUF, nbytes - c * kMAXZIPBUF);
+      int nout = 0;
+      R__unzip(&srcSize, zsrc, &tgtSize, dst, &nout);
+      if (nout != tgtSize)
+         break;
+      zsrc += zippedLen[c];
+      dst += nout;
+   }
+   result.fDecompressionTime = std::chrono::duration<double>(Clock_t::now() - start).count();
+
+   if (unzipped != buffer)
+      throw std::runtime_error("Compression setting " + std::to_string(compressionSettings) +
+                               " did not reproduce a buffer of branch '" + data.fName + '\'');
+   return result;
+}
+
+std::size_t CompressSpeed::Recommend(const std::vector<SettingResult> &results, double bandwidth)
+{
+   auto cost = [bandwidth](const SettingResult &r) {
+      if (bandwidth <= 0.)
+         return double(r.fCompressedBytes);
+      return r.fCompressedBytes / (bandwidth * 1024 * 1024) + r.fDecompressionTime;
+   };
+   const auto best = std::min_element(results.begin(), results.end(),
+                                      [&cost](const auto &a, const auto &b) { return cost(a) < cost(b); });
+   return best - results.begin();
+}
+
+std::vector<BranchResult> CompressSpeed::EvalCompression(const Data &d, unsigned int nThreads)
+{
+   if (d.fCompressionSettings.empty())
+      throw std::runtime_error("Please provide at least one compression setting");
+   for (auto setting : d.fCompressionSettings) {
+      const auto algorithm = setting / 100;
+      const auto level = setting % 100;
+      const bool knownAlgorithm = algorithm == ROOT::RCompressionSetting::EAlgorithm::kZLIB ||
+                                  algorithm == ROOT::RCompressionSetting::EAlgorithm::kLZMA ||
+                                  algorithm == ROOT::RCompressionSetting::EAlgorithm::kLZ4 ||
+                                  algorithm == ROOT::RCompressionSetting::EAlgorithm::kZSTD;
+      if (!knownAlgorithm || level < 1 || level > 9)
+         throw std::runtime_error("Invalid compression setting " + std::to_string(setting));
+   }
+
+   bool isTree = false;
+   {
+      std::unique_ptr<TFile> f(TFile::Open(d.fFileName.c_str(), "READ_WITHOUT_GLOBALREGISTRATION"));
+      if (f == nullptr || f->IsZombie())
+         throw std::runtime_error("Could not open file '" + d.fFileName + '\'');
+      isTree = f->Get<TTree>(d.fTreeName.c_str()) != nullptr;
+   }
+
+#ifdef R__USE_IMT
+   std::unique_ptr<ROOT::TThreadExecutor> pool;
+   if (nThreads > 0)
+      pool = std::make_unique<ROOT::TThreadExecutor>(nThreads);
+#else
+   if (nThreads > 0)
+      throw std::runtime_error(std::to_string(nThreads) + " threads were requested, but ROOT was built without "
+                                                          "implicit multi-threading (IMT) support.");
+#endif
+
+   std::vector<BranchResult> results;
+   auto replay = [&](BranchData &&data) {
+      const auto nSettings = d.fCompressionSettings.size();
+      const auto nBuffers = data.fBuffers.size();
+      if (nBuffers == 0)
+         return;
+
+      // One task per buffer and setting
+      std::vector<SettingResult> replays(nSettings * nBuffers);
+      auto replayOne = [&](std::size_t i) {
+         replays[i] = ReplayBuffer(data, i % nBuffers, d.fCompressionSettings[i / nBuffers]);
+      };
+#ifdef R__USE_IMT
+      if (pool)
+         pool->Foreach(replayOne, ROOT::TSeqUL(replays.size()));
+      else
+#endif
+         for (auto i : ROOT::TSeqUL(replays.size()))
+            replayOne(i);
+
+      BranchResult r;
+      r.fName = data.fName;
+      r.fFileCompressionSettings = data.fCompressionSettings;
+      r.fNBuffers = nBuffers;
+      r.fUncompressedBytes = data.GetUncompressedBytes();
+      r.fFileCompressedBytes = data.fCompressedBytes;
+      r.fResults.resize(nSettings);
+      for (std::size_t i = 0; i < replays.size(); ++i) {
+         auto &sum = r.fResults[i / nBuffers];
+         sum.fCompressionSettings = replays[i].fCompressionSettings;
+         sum.fCompressedBytes += replays[i].fCompressedBytes;
+         sum.fCompressionTime += replays[i].fCompressionTime;
+         sum.fDecompressionTime += replays[i].fDecompressionTime;
+      }
+      r.fRecommended = Recommend(r.fResults, d.fBandwidth);
+      results.push_back(std::move(r));
+   };
+
+   if (isTree)
+      VisitTreeBranches(d, replay);
+   else
+      VisitNTupleFields(d, replay);
+
+   return results;
+}
@@ -0,0 +1,245 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "CompressSpeedCLI.hxx"
+
+#include <iomanip>
+#include <iostream>
+
+using namespace CompressSpeed;
+
+const auto usageText = "Usage:\n"
+                       " rootcompressspeed --file fname\n"
+                       "                   --tree tname\n"
+                       "                   [--branches bname1 [bname2 ...]]\n"
+                       "                   [--settings setting1 [setting2 ...]]\n"
+                       "                   [--max-baskets nbaskets]\n"
+                       "                   [--bandwidth MBps]\n"
+                       "                   [--threads nthreads]\n"
+                       " rootcompressspeed (--help|-h)\n"
+                       " \n"
+                       " Use -h for usage help, --help for detailed information.\n";
+
+const auto argUsageText =
+   "Arguments:\n"
+   "   --file fname\n"
+   "    The ROOT file to read from.\n"
+   "\n"
+   "   --tree tname\n"
+   "    The name of the TTree or RNTuple in the file.\n"
+   "\n"
+   "   --branches bname1 [bname2...]\n"
+   "    The branches (or fields) to replay, all of them by default. Selecting a branch selects its"
+   "    sub-branches.\n"
+   "\n"
+   "   --settings setting1 [setting2...]\n"
+   "    The compression settings to replay, as 100 * algorithm + level (see Compression.h), e.g. 101"
+   "    for ZLIB level 1, 207 for LZMA level 7, 404 for LZ4 level 4 or 505 for ZSTD level 5. By default"
+   "    levels 1 to 9 of all the algorithms are sampled.\n"
+   "\n"
+   "   --max-baskets nbaskets\n"
+   "    The maximum number of baskets (or pages) replayed per branch, evenly spread over the branch."
+   " All of them by default.\n"
+   "\n"
+   "   --bandwidth MBps\n"
+   "    The throughput of the storage the file will be read from, used to recommend a setting"
+   "    (100 MB/s by default). With 0, the setting giving the smallest output is recommended.\n"
+   "\n"
+   "   --threads nthreads\n"
+   "    The number of threads replaying the baskets. Will automatically cap to the number of"
+   "    available threads on the machine.";
+
+const auto fullUsageText =
+   "Description:\n"
+   " rootcompressspeed helps choosing the compression settings of a file from its actual content."
+   " It decompresses the baskets of every branch of a TTree (or the pages of every field of an RNTuple),"
+   " then compresses and decompresses them again with each compression setting, like ROOT does when"
+   " writing and reading the file."
+   "\n"
+   "\n"
+   " For every branch and setting it reports the compression ratio (uncompressed over compressed size)"
+   " and the compression and decompression throughputs, in uncompressed MB/s per thread."
+   "\n"
+   "\n"
+   "Recommended settings:\n"
+   " The recommended setting minimizes the time needed to read the compressed data at the given"
+   " bandwidth and to decompress it on one thread. The throughputs depend on the CPU and on the load"
+   " of the machine: the settings are replayed concurrently when running with several threads, and"
+   " the tool should be run on hardware similar to the one that will read the files.";
+
+void CompressSpeed::PrintResults(const std::vector<BranchResult> &results, double bandwidth)
+{
+   const double MB = 1024 * 1024;
+   auto printRow = [MB](const std::string &label, ULong64_t uncompressed, const SettingResult &r) {
+      std::cout << std::setw(10) << label << std::setw(10) << r.fCompressionSettings << std::setw(10)
+                << double(uncompressed) / r.fCompressedBytes << std::setw(16)
+                << (r.fCompressionTime > 0. ? uncompressed / r.fCompressionTime / MB : 0.) << std::setw(16)
+                << (r.fDecompressionTime > 0. ? uncompressed / r.fDecompressionTime / MB : 0.) << '\n';
+   };
+   auto printHeader = [] {
+      std::cout << std::setw(20) << "setting" << std::setw(10) << "ratio" << std::setw(16) << "compress MB/s"
+                << std::setw(16) << "decompress MB/s" << '\n';
+   };
+   std::cout << std::fixed << std::setprecision(2);
+
+   // Totals over all branches, to recommend a setting for the whole file
+   std::vector<SettingResult> totals;
+   ULong64_t totalUncompressed = 0;
+   ULong64_t totalFileCompressed = 0;
+   for (const auto &b : results) {
+      std::cout << "Branch '" << b.fName << "': " << b.fUncompressedBytes << " bytes in " << b.fNBuffers
+                << " buffers, ratio " << double(b.fUncompressedBytes) / b.fFileCompressedBytes << " with setting "
+                << b.fFileCompressionSettings << " in the file\n";
+      printHeader();
+      for (std::size_t i = 0; i < b.fResults.size(); ++i)
+         printRow(i == b.fRecommended ? "*" : "", b.fUncompressedBytes, b.fResults[i]);
+      std::cout << '\n';
+
+      totals.resize(b.fResults.size());
+      for (std::size_t i = 0; i < b.fResults.size(); ++i) {
+         totals[i].fCompressionSettings = b.fResults[i].fCompressionSettings;
+         totals[i].fCompressedBytes += b.fResults[i].fCompressedBytes;
+         totals[i].fCompressionTime += b.fResults[i].fCompressionTime;
+         totals[i].fDecompressionTime += b.fResults[i].fDecompressionTime;
+      }
+      totalUncompressed += b.fUncompressedBytes;
+      totalFileCompressed += b.fFileCompressedBytes;
+   }
+   if (results.empty()) {
+      std::cout << "No baskets to replay.\n";
+      return;
+   }
+
+   std::cout << "All branches: " << totalUncompressed << " bytes, ratio "
+             << double(totalUncompressed) / totalFileCompressed << " in the file\n";
+   printHeader();
+   const auto recommended = Recommend(totals, bandwidth);
+   for (std::size_t i = 0; i < totals.size(); ++i)
+      printRow(i == recommended ? "*" : "", totalUncompressed, totals[i]);
+
+   std::cout << "\nRecommended settings";
+   if (bandwidth > 0.)
+      std::cout << " for reading at " << bandwidth << " MB/s";
+   std::cout << ":\n";
+   for (const auto &b : results)
+      std::cout << "  " << b.fName << '\t' << b.fResults[b.fRecommended].fCompressionSettings << '\n';
+   std::cout << "  (whole file)\t" << totals[recommended].fCompressionSettings << '\n';
+   std::cout << "For details run with the --help command.\n";
+}
+
+Args CompressSpeed::ParseArgs(const std::vector<std::string> &args)
+{
+   // Print help message and exit if "--help"
+   const auto argsProvided = args.size() >= 2;
+   const auto helpUsed = argsProvided && (args[1] == "--help" || args[1] == "-h");
+   const auto longHelpUsed = argsProvided && args[1] == "--help";
+
+   if (!argsProvided || helpUsed) {
+      std::cout << usageText;
+      if (helpUsed)
+         std::cout << "\n" << argUsageText;
+      if (longHelpUsed)
+         std::cout << "\n\n" << fullUsageText;
+      std::cout << std::endl;
+
+      return {};
+   }
+
+   Data d;
+   unsigned int nThreads = 0;
+   bool defaultSettings = true;
+
+   enum class EArgState {
+      kNone,
+      kFile,
+      kTree,
+      kBranches,
+      kSettings,
+      kMaxBaskets,
+      kBandwidth,
+      kThreads
+   } argState = EArgState::kNone;
+
+   for (size_t i = 1; i < args.size(); ++i) {
+      const auto &arg = args[i];
+
+      if (arg == "--file") {
+         argState = EArgState::kFile;
+      } else if (arg == "--tree") {
+         argState = EArgState::kTree;
+      } else if (arg == "--branches") {
+         argState = EArgState::kBranches;
+      } else if (arg == "--settings") {
+         argState = EArgState::kSettings;
+      } else if (arg == "--max-baskets") {
+         argState = EArgState::kMaxBaskets;
+      } else if (arg == "--bandwidth") {
+         argState = EArgState::kBandwidth;
+      } else if (arg == "--threads") {
+         argState = EArgState::kThreads;
+      } else if (arg[0] == '-') {
+         std::cerr << "Unrecognized option '" << arg << "'\n";
+         return {};
+      } else {
+         try {
+            switch (argState) {
+            case EArgState::kFile:
+               d.fFileName = arg;
+               argState = EArgState::kNone;
+               break;
+            case EArgState::kTree:
+               d.fTreeName = arg;
+               argState = EArgState::kNone;
+               break;
+            case EArgState::kBranches: d.fBranchNames.emplace_back(arg); break;
+            case EArgState::kSettings:
+               if (defaultSettings)
+                  d.fCompressionSettings.clear();
+               defaultSettings = false;
+               d.fCompressionSettings.emplace_back(std::stoi(arg));
+               break;
+            case EArgState::kMaxBaskets:
+               d.fMaxBuffers = std::stoi(arg);
+               argState = EArgState::kNone;
+               break;
+            case EArgState::kBandwidth:
+               d.fBandwidth = std::stod(arg);
+               argState = EArgState::kNone;
+               break;
+            case EArgState::kThreads:
+               nThreads = std::stoi(arg);
+               argState = EArgState::kNone;
+               break;
+            default: std::cerr << "Unrecognized option '" << arg << "'\n"; return {};
+            }
+         } catch (const std::logic_error &) {
+            std::cerr << "Invalid value '" << arg << "'\n";
+            return {};
+         }
+      }
+   }
+
+   if (d.fFileName.empty() || d.fTreeName.empty()) {
+      std::cerr << "Please provide a file name and a tree name\n";
+      return {};
+   }
+
+   return Args{std::move(d), nThreads, /*fShouldRun=*/true};
+}
+
+Args CompressSpeed::ParseArgs(int argc, char **argv)
+{
+   std::vector<std::string> args;
+   args.reserve(argc);
+
+   for (int i = 0; i < argc; ++i) {
+      args.emplace_back(argv[i]);
+   }
+
+   return ParseArgs(args);
+}
@@ -0,0 +1,120 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "CompressSpeed.hxx"
+
+#include <ROOT/RColumnElement.hxx>
+#include <ROOT/RNTupleDescriptor.hxx>
+#include <ROOT/RNTupleZip.hxx>
+#include <ROOT/RPageStorage.hxx>
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+
+using namespace CompressSpeed;
+using ROOT::Experimental::DescriptorId_t;
+using ROOT::Experimental::RClusterIndex;
+using ROOT::Experimental::RNTupleDescriptor;
+using ROOT::Experimental::Detail::RColumnElementBase;
+using ROOT::Experimental::Detail::RNTupleDecompressor;
+using ROOT::Experimental::Detail::RPageSource;
+
+namespace {
+
+// Read and unpack the pages of the columns of a field, evenly spread over the field if maxBuffers > 0.
+BranchData ExtractPages(RPageSource &source, const RNTupleDescriptor &desc, DescriptorId_t fieldId,
+                        unsigned int maxBuffers)
+{
+   BranchData data;
+   data.fName = desc.GetQualifiedFieldName(fieldId);
+
+   struct RPageRef {
+      DescriptorId_t fColumnId;
+      DescriptorId_t fClusterId;
+      std::uint32_t fFirstElement;
+      std::size_t fUncompressedSize;
+   };
+   std::vector<RPageRef> pages;
+   for (const auto &column : desc.GetColumnIterable(fieldId)) {
+      // Alias columns (projected fields) have no pages of their own
+      if (column.GetLogicalId() != column.GetPhysicalId())
+         continue;
+      const auto columnId = column.GetPhysicalId();
+      const auto element = RColumnElementBase::Generate(column.GetModel().GetType());
+      for (const auto &cluster : desc.GetClusterIterable()) {
+         if (!cluster.ContainsColumn(columnId))
+            continue;
+         data.fCompressionSettings = cluster.GetColumnRange(columnId).fCompressionSettings;
+         std::uint32_t firstElement = 0;
+         for (const auto &pageInfo : cluster.GetPageRange(columnId).fPageInfos) {
+            pages.push_back({columnId, cluster.GetId(), firstElement, element->GetPackedSize(pageInfo.fNElements)});
+            firstElement += pageInfo.fNElements;
+         }
+      }
+   }
+
+   const std::size_t stride =
+      maxBuffers > 0 && maxBuffers < pages.size() ? (pages.size() + maxBuffers - 1) / maxBuffers : 1;
+   RNTupleDecompressor decompressor;
+   std::vector<unsigned char> sealedBuffer;
+   for (std::size_t i = 0; i < pages.size(); i += stride) {
+      const auto &page = pages[i];
+      if (page.fUncompressedSize == 0)
+         continue;
+      const RClusterIndex clusterIndex(page.fClusterId, page.fFirstElement);
+      RPageSource::RSealedPage sealedPage;
+      source.LoadSealedPage(page.fColumnId, clusterIndex, sealedPage);
+      sealedBuffer.resize(sealedPage.fSize);
+      sealedPage.fBuffer = sealedBuffer.data();
+      source.LoadSealedPage(page.fColumnId, clusterIndex, sealedPage);
+
+      std::vector<char> content(page.fUncompressedSize);
+      decompressor.Unzip(sealedBuffer.data(), sealedPage.fSize, content.size(), content.data());
+      data.fBuffers.emplace_back(std::move(content));
+      data.fCompressedBytes += sealedPage.fSize;
+   }
+   return data;
+}
+
+} // anonymous namespace
+
+void CompressSpeed::VisitNTupleFields(const Data &d, const BranchVisitor_t &visit)
+{
+   auto source = RPageSource::Create(d.fTreeName, d.fFileName);
+   source->Attach();
+   // The page source takes the descriptor lock while loading pages: work on a copy
+   const auto desc = source->GetSharedDescriptorGuard()->Clone();
+
+   // Depth-first list of the fields; a field is also selected through any of its parent fields
+   std::vector<DescriptorId_t> fieldIds;
+   std::set<std::string> usedNames;
+   auto addFields = [&](DescriptorId_t parentId, bool selected, auto &&self) -> void {
+      for (const auto &field : desc->GetFieldIterable(parentId)) {
+         bool fieldSelected = selected || d.fBranchNames.empty();
+         const auto name = desc->GetQualifiedFieldName(field.GetId());
+         if (std::find(d.fBranchNames.begin(), d.fBranchNames.end(), name) != d.fBranchNames.end()) {
+            usedNames.insert(name);
+            fieldSelected = true;
+         }
+         if (fieldSelected)
+            fieldIds.push_back(field.GetId());
+         self(field.GetId(), fieldSelected, self);
+      }
+   };
+   addFields(desc->GetFieldZeroId(), false, addFields);
+
+   for (const auto &name : d.fBranchNames) {
+      if (usedNames.count(name) == 0)
+         throw std::runtime_error("Could not retrieve field '" + name + "' from RNTuple '" + d.fTreeName +
+                                  "' in file '" + d.fFileName + '\'');
+   }
+
+   for (auto fieldId : fieldIds)
+      visit(ExtractPages(*source, *desc, fieldId, d.fMaxBuffers));
+}
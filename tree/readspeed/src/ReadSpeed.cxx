@@ -19,13 +19,24 @@
 #endif
 
 #include <ROOT/InternalTreeUtils.hxx> // for ROOT::Internal::TreeUtils::GetTopLevelBranchNames
+#include <Bytes.h>
+#include <RZip.h>
 #include <TBranch.h>
+#include <TKey.h>
 #include <TStopwatch.h>
 #include <TTree.h>
+#include <TUrl.h>
+
+#ifdef R__LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath> // std::ceil
+#include <cstring>
 #include <memory>
 #include <numeric> // std::accumulate
 #include <stdexcept>
@@ -40,11 +51,16 @@ std::vector<std::string> ReadSpeed::GetMatchingBranchNames(const std::string &fi
    const auto f = std::unique_ptr<TFile>(TFile::Open(fileName.c_str(), "READ_WITHOUT_GLOBALREGISTRATION"));
    if (f == nullptr || f->IsZombie())
       throw std::runtime_error("Could not open file '" + fileName + '\'');
-   std::unique_ptr<TTree> t(f->Get<TTree>(treeName.c_str()));
-   if (t == nullptr)
-      throw std::runtime_error("Could not retrieve tree '" + treeName + "' from file '" + fileName + '\'');
 
-   const auto unfilteredBranchNames = ROOT::Internal::TreeUtils::GetTopLevelBranchNames(*t);
+   std::vector<std::string> unfilteredBranchNames;
+   if (IsNTuple(f.get(), treeName)) {
+      unfilteredBranchNames = GetNTupleFieldNames(fileName, treeName);
+   } else {
+      std::unique_ptr<TTree> t(f->Get<TTree>(treeName.c_str()));
+      if (t == nullptr)
+         throw std::runtime_error("Could not retrieve tree '" + treeName + "' from file '" + fileName + '\'');
+      unfilteredBranchNames = ROOT::Internal::TreeUtils::GetTopLevelBranchNames(*t);
+   }
    std::set<ReadSpeedRegex> usedRegexes;
    std::vector<std::string> branchNames;
 
@@ -115,6 +131,19 @@ std::vector<std::vector<std::string>> GetPerFileBranchNames(const Data &d)
    return fileBranchNames;
 }
 
+std::vector<bool> GetPerFileIsNTuple(const Data &d)
+{
+   std::vector<bool> isNTuple;
+   for (auto fileIdx = 0u; fileIdx < d.fFileNames.size(); ++fileIdx) {
+      const auto &fileName = d.fFileNames[fileIdx];
+      std::unique_ptr<TFile> f(TFile::Open(fileName.c_str(), "READ_WITHOUT_GLOBALREGISTRATION"));
+      if (f == nullptr || f->IsZombie())
+         throw std::runtime_error("Could not open file '" + fileName + '\'');
+      isNTuple.push_back(IsNTuple(f.get(), d.fTreeNames.size() > 1 ? d.fTreeNames[fileIdx] : d.fTreeNames[0]));
+   }
+   return isNTuple;
+}
+
 ByteData SumBytes(const std::vector<ByteData> &bytesData) {
    const auto uncompressedBytes =
       std::accumulate(bytesData.begin(), bytesData.end(), 0ull,
@@ -122,8 +151,12 @@ ByteData SumBytes(const std::vector<ByteData> &bytesData) {
    const auto compressedBytes =
       std::accumulate(bytesData.begin(), bytesData.end(), 0ull,
                         [](ULong64_t sum, const ByteData &o) { return sum + o.fCompressedBytesRead; });
+   const auto readTime = std::accumulate(bytesData.begin(), bytesData.end(), 0.,
+                                         [](double sum, const ByteData &o) { return sum + o.fReadTime; });
+   const auto decompressionTime = std::accumulate(
+      bytesData.begin(), bytesData.end(), 0., [](double sum, const ByteData &o) { return sum + o.fDecompressionTime; });
 
-   return {uncompressedBytes, compressedBytes};
+   return {uncompressedBytes, compressedBytes, readTime, decompressionTime};
 };
 
 // Read branches listed in branchNames in tree treeName in file fileName, return number of uncompressed bytes read.
@@ -165,6 +198,163 @@ ByteData ReadSpeed::ReadTree(TFile *f, const std::string &treeName, const std::v
    return {bytesRead, fileBytesRead};
 }
 
+namespace {
+
+// Add branch and its sub-branches to branches
+void CollectBranches(TBranch *branch, std::vector<TBranch *> &branches)
+{
+   branches.push_back(branch);
+   for (auto *sub : *branch->GetListOfBranches())
+      CollectBranches(static_cast<TBranch *>(sub), branches);
+}
+
+// Decompress the basket in compressed, key included, into uncompressed; return the size of its content.
+Int_t UnzipBasket(std::vector<char> &compressed, std::vector<char> &uncompressed, const TBranch &branch)
+{
+   // The key starts with fNbytes, fVersion, fObjlen, fDatime and fKeylen
+   char *header = compressed.data();
+   Int_t nbytes = 0;
+   Version_t version = 0;
+   Int_t objlen = 0;
+   UInt_t datime = 0;
+   Short_t keylen = 0;
+   frombuf(header, &nbytes);
+   frombuf(header, &version);
+   frombuf(header, &objlen);
+   frombuf(header, &datime);
+   frombuf(header, &keylen);
+   uncompressed.resize(objlen);
+   if (objlen <= nbytes - keylen) {
+      // stored without compression
+      memcpy(uncompressed.data(), compressed.data() + keylen, objlen);
+      return objlen;
+   }
+
+   auto *src = reinterpret_cast<unsigned char *>(compressed.data() + keylen);
+   auto *tgt = reinterpret_cast<unsigned char *>(uncompressed.data());
+   Int_t noutot = 0;
+   while (noutot < objlen) {
+      Int_t nin = 0;
+      Int_t nbuf = 0;
+      Int_t nout = 0;
+      if (R__unzip_header(&nin, src, &nbuf) != 0)
+         break;
+      R__unzip(&nin, src, &nbuf, tgt, &nout);
+      if (nout == 0)
+         break;
+      src += nin;
+      tgt += nout;
+      noutot += nout;
+   }
+   if (noutot != objlen)
+      throw std::runtime_error("Could not decompress a basket of branch '" + std::string(branch.GetName()) + '\'');
+   return objlen;
+}
+
+} // anonymous namespace
+
+ByteData ReadSpeed::ReadTreeBaskets(TFile *f, const std::string &treeName, const std::vector<std::string> &branchNames,
+                                    EntryRange range)
+{
+   using Clock_t = std::chrono::steady_clock;
+
+   std::unique_ptr<TTree> t(f->Get<TTree>(treeName.c_str()));
+   if (t == nullptr)
+      throw std::runtime_error("Could not retrieve tree '" + treeName + "' from file '" + f->GetName() + '\'');
+
+   // The baskets of split branches belong to their sub-branches
+   std::vector<TBranch *> branches;
+   for (const auto &bName : branchNames) {
+      auto *b = t->GetBranch(bName.c_str());
+      if (b == nullptr)
+         throw std::runtime_error("Could not retrieve branch '" + bName + "' from tree '" + t->GetName() +
+                                  "' in file '" + f->GetName() + '\'');
+      CollectBranches(b, branches);
+   }
+
+   ByteData bytes{0, 0};
+   std::vector<char> compressed;
+   std::vector<char> uncompressed;
+   for (auto *b : branches) {
+      for (Int_t i = 0; i < b->GetWriteBasket(); ++i) {
+         const auto firstEntry = b->GetBasketEntry()[i];
+         if (range.fStart != -1ll && (firstEntry < range.fStart || firstEntry >= range.fEnd))
+            continue;
+         const Int_t len = b->GetBasketBytes()[i];
+         compressed.resize(len);
+         const auto start = Clock_t::now();
+         if (f->ReadBuffer(compressed.data(), b->GetBasketSeek(i), len))
+            throw std::runtime_error("Could not read basket " + std::to_string(i) + " of branch '" + b->GetName() +
+                                     "' in file '" + f->GetName() + '\'');
+         const auto read = Clock_t::now();
+         bytes.fUncompressedBytesRead += UnzipBasket(compressed, uncompressed, *b);
+         bytes.fCompressedBytesRead += len;
+         bytes.fReadTime += std::chrono::duration<double>(read - start).count();
+         bytes.fDecompressionTime += std::chrono::duration<double>(Clock_t::now() - read).count();
+      }
+   }
+   return bytes;
+}
+
+bool ReadSpeed::IsNTuple(TFile *f, const std::string &treeName)
+{
+   const auto slash = treeName.rfind('/');
+   TDirectory *dir = f;
+   if (slash != std::string::npos)
+      dir = f->GetDirectory(treeName.substr(0, slash).c_str());
+   auto *key = dir ? dir->GetKey(treeName.substr(slash + 1).c_str()) : nullptr;
+   return key && strcmp(key->GetClassName(), "ROOT::Experimental::RNTuple") == 0;
+}
+
+#ifndef R__READSPEED_NTUPLE
+[[noreturn]] static void ThrowNoNTupleSupport(const std::string &fileName, const std::string &ntupleName)
+{
+   throw std::runtime_error("Could not read RNTuple '" + ntupleName + "' from file '" + fileName +
+                            "': ROOT was built without RNTuple support");
+}
+
+std::vector<std::string> ReadSpeed::GetNTupleFieldNames(const std::string &fileName, const std::string &ntupleName)
+{
+   ThrowNoNTupleSupport(fileName, ntupleName);
+}
+
+std::vector<EntryRange> ReadSpeed::GetNTupleClusters(const std::string &fileName, const std::string &ntupleName)
+{
+   ThrowNoNTupleSupport(fileName, ntupleName);
+}
+
+ByteData ReadSpeed::ReadNTuple(const std::string &fileName, const std::string &ntupleName,
+                               const std::vector<std::string> &, EntryRange)
+{
+   ThrowNoNTupleSupport(fileName, ntupleName);
+}
+
+ByteData ReadSpeed::ReadNTuplePages(const std::string &fileName, const std::string &ntupleName,
+                                    const std::vector<std::string> &, EntryRange)
+{
+   ThrowNoNTupleSupport(fileName, ntupleName);
+}
+#endif
+
+void ReadSpeed::DropFileCache(const std::string &fileName)
+{
+   TUrl url(fileName.c_str(), kTRUE);
+   if (strcmp(url.GetProtocol(), "file") != 0)
+      return;
+#ifdef R__LINUX
+   const int fd = open(url.GetFile(), O_RDONLY);
+   if (fd < 0)
+      return;
+   posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+   close(fd);
+#else
+   static bool warned = false;
+   if (!warned)
+      std::cerr << "Dropping files from the page cache is only supported on Linux, running with a warm cache.\n";
+   warned = true;
+#endif
+}
+
 Result ReadSpeed::EvalThroughputST(const Data &d)
 {
    auto treeIdx = 0;
@@ -172,19 +362,38 @@ Result ReadSpeed::EvalThroughputST(const Data &d)
    ULong64_t uncompressedBytesRead = 0;
    ULong64_t compressedBytesRead = 0;
 
+   double readTime = 0.;
+   double decompressionTime = 0.;
+
    TStopwatch sw;
    const auto fileBranchNames = GetPerFileBranchNames(d);
+   const auto isNTuple = GetPerFileIsNTuple(d);
 
    for (const auto &fileName : d.fFileNames) {
-      auto f = std::unique_ptr<TFile>(TFile::Open(fileName.c_str(), "READ_WITHOUT_GLOBALREGISTRATION"));
-      if (f == nullptr || f->IsZombie())
-         throw std::runtime_error("Could not open file '" + fileName + '\'');
+      std::unique_ptr<TFile> f;
+      if (!isNTuple[fileIdx]) {
+         f.reset(TFile::Open(fileName.c_str(), "READ_WITHOUT_GLOBALREGISTRATION"));
+         if (f == nullptr || f->IsZombie())
+            throw std::runtime_error("Could not open file '" + fileName + '\'');
+      }
+      if (d.fColdCache)
+         DropFileCache(fileName);
 
       sw.Start(kFALSE);
 
-      const auto byteData = ReadTree(f.get(), d.fTreeNames[treeIdx], fileBranchNames[fileIdx]);
+      const auto &treeName = d.fTreeNames[treeIdx];
+      const auto &branchNames = fileBranchNames[fileIdx];
+      ByteData byteData{0, 0};
+      if (isNTuple[fileIdx])
+         byteData = d.fDecompressionOnly ? ReadNTuplePages(fileName, treeName, branchNames)
+                                         : ReadNTuple(fileName, treeName, branchNames);
+      else
+         byteData = d.fDecompressionOnly ? ReadTreeBaskets(f.get(), treeName, branchNames)
+                                         : ReadTree(f.get(), treeName, branchNames);
       uncompressedBytesRead += byteData.fUncompressedBytesRead;
       compressedBytesRead += byteData.fCompressedBytesRead;
+      readTime += byteData.fReadTime;
+      decompressionTime += byteData.fDecompressionTime;
 
       if (d.fTreeNames.size() > 1)
          ++treeIdx;
@@ -193,7 +402,8 @@ Result ReadSpeed::EvalThroughputST(const Data &d)
       sw.Stop();
    }
 
-   return {sw.RealTime(), sw.CpuTime(), 0., 0., uncompressedBytesRead, compressedBytesRead, 0};
+   return {sw.RealTime(), sw.CpuTime(), 0., 0., uncompressedBytesRead, compressedBytesRead, 0, readTime,
+           decompressionTime};
 }
 
 // Return a vector of EntryRanges per file, i.e. a vector of vectors of EntryRanges with outer size equal to
@@ -208,6 +418,10 @@ std::vector<std::vector<EntryRange>> ReadSpeed::GetClusters(const Data &d)
       if (f == nullptr || f->IsZombie())
          throw std::runtime_error("There was a problem opening file '" + fileName + '\'');
       const auto &treeName = d.fTreeNames.size() > 1 ? d.fTreeNames[fileIdx] : d.fTreeNames[0];
+      if (IsNTuple(f.get(), treeName)) {
+         ranges[fileIdx] = GetNTupleClusters(fileName, treeName);
+         continue;
+      }
       auto *t = f->Get<TTree>(treeName.c_str()); // TFile owns this TTree
       if (t == nullptr)
          throw std::runtime_error("There was a problem retrieving TTree '" + treeName + "' from file '" + fileName +
@@ -284,9 +498,11 @@ Result ReadSpeed::EvalThroughputMT(const Data &d, unsigned nThreads)
 
    const size_t nranges =
       std::accumulate(rangesPerFile.begin(), rangesPerFile.end(), 0u, [](size_t s, auto &r) { return s + r.size(); });
-   std::cout << "Total number of tasks: " << nranges << '\n';
+   // Not on stdout, where only the results are printed (e.g. as JSON)
+   std::cerr << "Total number of tasks: " << nranges << '\n';
 
    const auto fileBranchNames = GetPerFileBranchNames(d);
+   const auto isNTuple = GetPerFileIsNTuple(d);
 
    ROOT::Internal::RSlotStack slotStack(actualThreads);
    std::vector<int> lastFileIdxs(actualThreads, -1);
@@ -298,6 +514,11 @@ Result ReadSpeed::EvalThroughputMT(const Data &d, unsigned nThreads)
       const auto &branchNames = fileBranchNames[fileIdx];
 
       auto readRange = [&](const EntryRange &range) -> ByteData {
+         // Every task opens its own page source
+         if (isNTuple[fileIdx])
+            return d.fDecompressionOnly ? ReadNTuplePages(fileName, treeName, branchNames, range)
+                                        : ReadNTuple(fileName, treeName, branchNames, range);
+
          ROOT::Internal::RSlotStackRAII slotRAII(slotStack);
          auto slotIndex = slotRAII.fSlot;
          auto &file = lastTFiles[slotIndex];
@@ -311,7 +532,8 @@ Result ReadSpeed::EvalThroughputMT(const Data &d, unsigned nThreads)
          if (file == nullptr || file->IsZombie())
             throw std::runtime_error("Could not open file '" + fileName + '\'');
 
-         auto result = ReadTree(file.get(), treeName, branchNames, range);
+         auto result = d.fDecompressionOnly ? ReadTreeBaskets(file.get(), treeName, branchNames, range)
+                                            : ReadTree(file.get(), treeName, branchNames, range);
 
          return result;
       };
@@ -321,6 +543,11 @@ Result ReadSpeed::EvalThroughputMT(const Data &d, unsigned nThreads)
       return byteData;
    };
 
+   if (d.fColdCache) {
+      for (const auto &fileName : d.fFileNames)
+         DropFileCache(fileName);
+   }
+
    TStopwatch sw;
    sw.Start();
    const auto totalByteData = pool.MapReduce(processFile, ROOT::TSeqUL(d.fFileNames.size()), SumBytes);
@@ -332,7 +559,9 @@ Result ReadSpeed::EvalThroughputMT(const Data &d, unsigned nThreads)
            clsw.CpuTime(),
            totalByteData.fUncompressedBytesRead,
            totalByteData.fCompressedBytesRead,
-           actualThreads};
+           actualThreads,
+           totalByteData.fReadTime,
+           totalByteData.fDecompressionTime};
 #else
    (void)d;
    (void)nThreads;
@@ -340,7 +569,7 @@ Result ReadSpeed::EvalThroughputMT(const Data &d, unsigned nThreads)
 #endif // R__USE_IMT
 }
 
-Result ReadSpeed::EvalThroughput(const Data &d, unsigned nThreads)
+static void CheckData(const Data &d)
 {
    if (d.fTreeNames.empty()) {
       std::cerr << "Please provide at least one tree name\n";
@@ -358,6 +587,11 @@ Result ReadSpeed::EvalThroughput(const Data &d, unsigned nThreads)
       std::cerr << "Please provide either one tree name or as many as the file names\n";
       std::terminate();
    }
+}
+
+Result ReadSpeed::EvalThroughput(const Data &d, unsigned nThreads)
+{
+   CheckData(d);
 
 #ifdef R__USE_IMT
    return nThreads > 0 ? EvalThroughputMT(d, nThreads) : EvalThroughputST(d);
@@ -370,3 +604,59 @@ Result ReadSpeed::EvalThroughput(const Data &d, unsigned nThreads)
    return EvalThroughputST(d);
 #endif
 }
+
+std::vector<BranchResult> ReadSpeed::EvalBranchThroughput(const Data &d)
+{
+   CheckData(d);
+
+   const auto fileBranchNames = GetPerFileBranchNames(d);
+   const auto isNTuple = GetPerFileIsNTuple(d);
+
+   // One result per branch name, summed over the files
+   std::vector<BranchResult> results;
+   for (auto fileIdx = 0u; fileIdx < d.fFileNames.size(); ++fileIdx) {
+      const auto &fileName = d.fFileNames[fileIdx];
+      const auto &treeName = d.fTreeNames.size() > 1 ? d.fTreeNames[fileIdx] : d.fTreeNames[0];
+      for (const auto &bName : fileBranchNames[fileIdx]) {
+         auto r = std::find_if(results.begin(), results.end(),
+                               [&bName](const BranchResult &b) { return b.fBranchName == bName; });
+         if (r == results.end())
+            r = results.insert(results.end(), BranchResult{bName});
+
+         std::unique_ptr<TFile> f;
+         auto openFile = [&] {
+            if (isNTuple[fileIdx])
+               return;
+            f.reset(TFile::Open(fileName.c_str(), "READ_WITHOUT_GLOBALREGISTRATION"));
+            if (f == nullptr || f->IsZombie())
+               throw std::runtime_error("Could not open file '" + fileName + '\'');
+         };
+
+         // First the stages, reading the baskets (or pages) directly
+         openFile();
+         if (d.fColdCache)
+            DropFileCache(fileName);
+         const auto stages = isNTuple[fileIdx] ? ReadNTuplePages(fileName, treeName, {bName})
+                                               : ReadTreeBaskets(f.get(), treeName, {bName});
+         r->fCompressedBytesRead += stages.fCompressedBytesRead;
+         r->fUncompressedBytesRead += stages.fUncompressedBytesRead;
+         r->fReadTime += stages.fReadTime;
+         r->fDecompressionTime += stages.fDecompressionTime;
+         if (d.fDecompressionOnly)
+            continue;
+
+         // Then reading the entries the usual way
+         openFile();
+         if (d.fColdCache)
+            DropFileCache(fileName);
+         TStopwatch sw;
+         if (isNTuple[fileIdx])
+            ReadNTuple(fileName, treeName, {bName});
+         else
+            ReadTree(f.get(), treeName, {bName});
+         sw.Stop();
+         r->fTotalTime += sw.RealTime();
+      }
+   }
+   return results;
+}
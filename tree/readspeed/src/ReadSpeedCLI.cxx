@@ -14,7 +14,9 @@
 #include <ROOT/TTreeProcessorMT.hxx> // for TTreeProcessorMT::SetTasksPerWorkerHint
 #endif
 
+#include <iomanip>
 #include <iostream>
+#include <cstdio>
 #include <cstring>
 
 using namespace ReadSpeed;
@@ -26,6 +28,7 @@ const auto usageText = "Usage:\n"
                        "[bregex2 ...])\n"
                        "               [--threads nthreads]\n"
                        "               [--tasks-per-worker ntasks]\n"
+                       "               [--decompression-only] [--per-branch] [--cold-cache] [--json]\n"
                        " rootreadspeed (--help|-h)\n"
                        " \n"
                        " Use -h for usage help, --help for detailed information.\n";
@@ -39,7 +42,7 @@ const auto argUsageText =
    "   --trees tname1 [tname2...]\n"
    "    The list of trees to read from the files. If only one tree is provided then it will"
    "    be used for all files. If multiple trees are specified, each tree is read from the"
-   "    respective file."
+   "    respective file. RNTuples are read as well, their top-level fields being the branches."
    "\n"
    "\n"
    " Specifying branches:\n"
@@ -62,7 +65,24 @@ const auto argUsageText =
    "    available threads on the machine."
    "\n"
    "   --tasks-per-worker ntasks\n"
-   "    The number of tasks to generate for each worker thread when using multithreading.";
+   "    The number of tasks to generate for each worker thread when using multithreading."
+   "\n"
+   "\n"
+   " Measurement modes:\n"
+   "   --decompression-only\n"
+   "    Only read and decompress the baskets (or pages) of the branches, without deserializing the"
+   "    entries. The time spent reading from storage and decompressing is reported separately."
+   "\n"
+   "   --per-branch\n"
+   "    Read every branch on its own, single-threaded, and report its throughput and the time spent"
+   "    reading, decompressing and deserializing it."
+   "\n"
+   "   --cold-cache\n"
+   "    Drop the local input files from the page cache of the operating system before reading them"
+   "    (Linux only)."
+   "\n"
+   "   --json\n"
+   "    Print the results as JSON.";
 
 const auto fullUsageText =
    "Description:\n"
@@ -135,6 +155,15 @@ const auto fullUsageText =
    " On Linux this can be done by running 'echo 3 > /proc/sys/vm/drop_caches' as a superuser"
    " or a specific file can be dropped from the cache with"
    " `dd of=<FILENAME> oflag=nocache conv=notrunc,fdatasync count=0 > /dev/null 2>&1`."
+   " The --cold-cache option drops the local input files from the cache before every measurement."
+   "\n"
+   "\n"
+   "Stages of reading:\n"
+   " With --decompression-only or --per-branch, the baskets (or pages) are read from storage and decompressed"
+   " outside of the TTree (or RNTuple) machinery, timing the two stages separately. With --per-branch, the"
+   " branch is then read again entry by entry, and the time not spent reading or decompressing in that second"
+   " pass is reported as deserialization time. The latter is an estimate: caching and read-ahead make the"
+   " two passes differ somewhat."
    "\n"
    "\n"
    " Known overhead of TTreeReader, RDataFrame:\n"
@@ -146,6 +175,37 @@ const auto fullUsageText =
    " branch values selectively, based on event cuts, and this overhead will be reduced significantly when using RDataFrame "
    " in conjunction with RNTuple.";
 
+namespace {
+
+double Throughput(ULong64_t bytes, double time)
+{
+   return time > 0. ? bytes / time / 1024 / 1024 : 0.;
+}
+
+std::string EscapeJSON(const std::string &s)
+{
+   std::string escaped;
+   for (const char c : s) {
+      switch (c) {
+      case '"': escaped += "\\\""; break;
+      case '\\': escaped += "\\\\"; break;
+      case '\n': escaped += "\\n"; break;
+      case '\t': escaped += "\\t"; break;
+      default:
+         if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            escaped += buf;
+         } else {
+            escaped += c;
+         }
+      }
+   }
+   return escaped;
+}
+
+} // anonymous namespace
+
 void ReadSpeed::PrintThroughput(const Result &r)
 {
    std::cout << "Thread pool size:\t\t" << r.fThreadPoolSize << '\n';
@@ -161,6 +221,11 @@ void ReadSpeed::PrintThroughput(const Result &r)
    std::cout << "Uncompressed data read:\t\t" << r.fUncompressedBytesRead << " bytes\n";
    std::cout << "Compressed data read:\t\t" << r.fCompressedBytesRead << " bytes\n";
 
+   if (r.fReadTime > 0. || r.fDecompressionTime > 0.) {
+      std::cout << "Time reading from storage:\t" << r.fReadTime << " s\n";
+      std::cout << "Time decompressing:\t\t" << r.fDecompressionTime << " s\n";
+   }
+
    const unsigned int effectiveThreads = std::max(r.fThreadPoolSize, 1u);
 
    std::cout << "Uncompressed throughput:\t" << r.fUncompressedBytesRead / r.fRealTime / 1024 / 1024 << " MB/s\n";
@@ -184,6 +249,59 @@ void ReadSpeed::PrintThroughput(const Result &r)
    std::cout << "For details run with the --help command.\n";
 }
 
+void ReadSpeed::PrintThroughputJSON(const Result &r, std::ostream &out)
+{
+   out << "{\n"
+       << "  \"threadPoolSize\": " << r.fThreadPoolSize << ",\n"
+       << "  \"realTime\": " << r.fRealTime << ",\n"
+       << "  \"cpuTime\": " << r.fCpuTime << ",\n"
+       << "  \"mtSetupRealTime\": " << r.fMTSetupRealTime << ",\n"
+       << "  \"mtSetupCpuTime\": " << r.fMTSetupCpuTime << ",\n"
+       << "  \"uncompressedBytesRead\": " << r.fUncompressedBytesRead << ",\n"
+       << "  \"compressedBytesRead\": " << r.fCompressedBytesRead << ",\n"
+       << "  \"uncompressedThroughputMBps\": " << Throughput(r.fUncompressedBytesRead, r.fRealTime) << ",\n"
+       << "  \"compressedThroughputMBps\": " << Throughput(r.fCompressedBytesRead, r.fRealTime) << ",\n"
+       << "  \"readTime\": " << r.fReadTime << ",\n"
+       << "  \"decompressionTime\": " << r.fDecompressionTime << "\n"
+       << "}\n";
+}
+
+void ReadSpeed::PrintBranchThroughput(const std::vector<BranchResult> &results)
+{
+   std::cout << std::left << std::setw(30) << "branch" << std::right << std::setw(16) << "compressed B"
+             << std::setw(16) << "uncompressed B" << std::setw(10) << "read s" << std::setw(10) << "unzip s"
+             << std::setw(10) << "deser s" << std::setw(16) << "uncompr. MB/s" << '\n';
+   for (const auto &b : results) {
+      // Decompression-only runs do not read the entries: the throughput is that of reading and decompressing
+      const double time = b.fTotalTime > 0. ? b.fTotalTime : b.fReadTime + b.fDecompressionTime;
+      std::cout << std::left << std::setw(30) << b.fBranchName << std::right << std::setw(16) << b.fCompressedBytesRead
+                << std::setw(16) << b.fUncompressedBytesRead << std::fixed << std::setprecision(3) << std::setw(10)
+                << b.fReadTime << std::setw(10) << b.fDecompressionTime << std::setw(10)
+                << b.GetDeserializationTime() << std::setprecision(1) << std::setw(16)
+                << Throughput(b.fUncompressedBytesRead, time) << '\n';
+      std::cout.unsetf(std::ios::fixed);
+      std::cout << std::setprecision(6);
+   }
+   std::cout << "For details run with the --help command.\n";
+}
+
+void ReadSpeed::PrintBranchThroughputJSON(const std::vector<BranchResult> &results, std::ostream &out)
+{
+   out << "{\n  \"branches\": [";
+   for (std::size_t i = 0; i < results.size(); ++i) {
+      const auto &b = results[i];
+      out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << EscapeJSON(b.fBranchName) << "\""
+          << ", \"compressedBytesRead\": " << b.fCompressedBytesRead
+          << ", \"uncompressedBytesRead\": " << b.fUncompressedBytesRead << ", \"readTime\": " << b.fReadTime
+          << ", \"decompressionTime\": " << b.fDecompressionTime << ", \"totalTime\": " << b.fTotalTime
+          << ", \"deserializationTime\": " << b.GetDeserializationTime()
+          << ", \"compressedReadThroughputMBps\": " << Throughput(b.fCompressedBytesRead, b.fReadTime)
+          << ", \"decompressionThroughputMBps\": " << Throughput(b.fUncompressedBytesRead, b.fDecompressionTime)
+          << ", \"uncompressedThroughputMBps\": " << Throughput(b.fUncompressedBytesRead, b.fTotalTime) << "}";
+   }
+   out << (results.empty() ? "]\n}\n" : "\n  ]\n}\n");
+}
+
 Args ReadSpeed::ParseArgs(const std::vector<std::string> &args)
 {
    // Print help message and exit if "--help"
@@ -204,6 +322,8 @@ Args ReadSpeed::ParseArgs(const std::vector<std::string> &args)
 
    Data d;
    unsigned int nThreads = 0;
+   bool perBranch = false;
+   bool json = false;
 
    enum class EArgState { kNone, kTrees, kFiles, kBranches, kThreads, kTasksPerWorkerHint } argState = EArgState::kNone;
    enum class EBranchState { kNone, kRegular, kRegex, kAll } branchState = EBranchState::kNone;
@@ -245,6 +365,18 @@ Args ReadSpeed::ParseArgs(const std::vector<std::string> &args)
          argState = EArgState::kThreads;
       } else if (arg == "--tasks-per-worker") {
          argState = EArgState::kTasksPerWorkerHint;
+      } else if (arg == "--decompression-only") {
+         argState = EArgState::kNone;
+         d.fDecompressionOnly = true;
+      } else if (arg == "--per-branch") {
+         argState = EArgState::kNone;
+         perBranch = true;
+      } else if (arg == "--cold-cache") {
+         argState = EArgState::kNone;
+         d.fColdCache = true;
+      } else if (arg == "--json") {
+         argState = EArgState::kNone;
+         json = true;
       } else if (arg[0] == '-') {
          std::cerr << "Unrecognized option '" << arg << "'\n";
          return {};
@@ -271,7 +403,7 @@ Args ReadSpeed::ParseArgs(const std::vector<std::string> &args)
       }
    }
 
-   return Args{std::move(d), nThreads, branchState == EBranchState::kAll, /*fShouldRun=*/true};
+   return Args{std::move(d), nThreads, branchState == EBranchState::kAll, /*fShouldRun=*/true, perBranch, json};
 }
 
 Args ReadSpeed::ParseArgs(int argc, char **argv)
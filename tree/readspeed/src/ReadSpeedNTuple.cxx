@@ -0,0 +1,177 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ReadSpeed.hxx"
+
+#include <ROOT/RColumnElement.hxx>
+#include <ROOT/RField.hxx>
+#include <ROOT/RNTuple.hxx>
+#include <ROOT/RNTupleDescriptor.hxx>
+#include <ROOT/RNTupleModel.hxx>
+#include <ROOT/RNTupleZip.hxx>
+#include <ROOT/RPageStorage.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+
+using namespace ReadSpeed;
+using ROOT::Experimental::DescriptorId_t;
+using ROOT::Experimental::RClusterIndex;
+using ROOT::Experimental::RNTupleDescriptor;
+using ROOT::Experimental::RNTupleModel;
+using ROOT::Experimental::RNTupleReader;
+using ROOT::Experimental::Detail::RColumnElementBase;
+using ROOT::Experimental::Detail::RFieldBase;
+using ROOT::Experimental::Detail::RNTupleDecompressor;
+using ROOT::Experimental::Detail::RPageSource;
+
+namespace {
+
+std::unique_ptr<RNTupleDescriptor> GetDescriptor(RPageSource &source)
+{
+   source.Attach();
+   // The page source takes the descriptor lock while loading pages: work on a copy
+   return source.GetSharedDescriptorGuard()->Clone();
+}
+
+// The physical columns of the given top-level fields and of their sub-fields
+std::vector<DescriptorId_t> GetColumnIds(const RNTupleDescriptor &desc, const std::vector<std::string> &fieldNames,
+                                         const std::string &ntupleName)
+{
+   std::vector<DescriptorId_t> columnIds;
+   std::function<void(DescriptorId_t)> addColumns = [&](DescriptorId_t fieldId) {
+      for (const auto &column : desc.GetColumnIterable(fieldId)) {
+         // Alias columns (projected fields) have no pages of their own
+         if (column.GetLogicalId() == column.GetPhysicalId())
+            columnIds.push_back(column.GetPhysicalId());
+      }
+      for (const auto &field : desc.GetFieldIterable(fieldId))
+         addColumns(field.GetId());
+   };
+   for (const auto &name : fieldNames) {
+      const auto fieldId = desc.FindFieldId(name);
+      if (fieldId == ROOT::Experimental::kInvalidDescriptorId)
+         throw std::runtime_error("Could not retrieve field '" + name + "' from RNTuple '" + ntupleName + '\'');
+      addColumns(fieldId);
+   }
+   return columnIds;
+}
+
+// Call f(columnId, element, pageInfo, clusterIndex) for the pages of the given columns in the clusters
+// starting within range
+template <typename F>
+void ForEachPage(const RNTupleDescriptor &desc, const std::vector<DescriptorId_t> &columnIds, EntryRange range, F &&f)
+{
+   for (auto columnId : columnIds) {
+      const auto element = RColumnElementBase::Generate(desc.GetColumnDescriptor(columnId).GetModel().GetType());
+      for (const auto &cluster : desc.GetClusterIterable()) {
+         const auto firstEntry = static_cast<Long64_t>(cluster.GetFirstEntryIndex());
+         if (range.fStart != -1ll && (firstEntry < range.fStart || firstEntry >= range.fEnd))
+            continue;
+         if (!cluster.ContainsColumn(columnId))
+            continue;
+         std::uint32_t firstElement = 0;
+         for (const auto &pageInfo : cluster.GetPageRange(columnId).fPageInfos) {
+            f(columnId, *element, pageInfo, RClusterIndex(cluster.GetId(), firstElement));
+            firstElement += pageInfo.fNElements;
+         }
+      }
+   }
+}
+
+} // anonymous namespace
+
+std::vector<std::string> ReadSpeed::GetNTupleFieldNames(const std::string &fileName, const std::string &ntupleName)
+{
+   auto source = RPageSource::Create(ntupleName, fileName);
+   const auto desc = GetDescriptor(*source);
+   std::vector<std::string> fieldNames;
+   for (const auto &field : desc->GetTopLevelFields())
+      fieldNames.push_back(field.GetFieldName());
+   return fieldNames;
+}
+
+std::vector<EntryRange> ReadSpeed::GetNTupleClusters(const std::string &fileName, const std::string &ntupleName)
+{
+   auto source = RPageSource::Create(ntupleName, fileName);
+   const auto desc = GetDescriptor(*source);
+   std::vector<EntryRange> ranges;
+   for (const auto &cluster : desc->GetClusterIterable()) {
+      const auto start = static_cast<Long64_t>(cluster.GetFirstEntryIndex());
+      ranges.push_back({start, start + static_cast<Long64_t>(cluster.GetNEntries())});
+   }
+   std::sort(ranges.begin(), ranges.end(),
+             [](const EntryRange &a, const EntryRange &b) { return a.fStart < b.fStart; });
+   return ranges;
+}
+
+ByteData ReadSpeed::ReadNTuple(const std::string &fileName, const std::string &ntupleName,
+                               const std::vector<std::string> &fieldNames, EntryRange range)
+{
+   auto source = RPageSource::Create(ntupleName, fileName);
+   const auto desc = GetDescriptor(*source);
+
+   // A model with only the requested fields, so that only their pages are read
+   auto model = RNTupleModel::Create();
+   for (const auto &name : fieldNames) {
+      const auto fieldId = desc->FindFieldId(name);
+      if (fieldId == ROOT::Experimental::kInvalidDescriptorId)
+         throw std::runtime_error("Could not retrieve field '" + name + "' from RNTuple '" + ntupleName +
+                                  "' in file '" + fileName + '\'');
+      model->AddField(RFieldBase::Create(name, desc->GetFieldDescriptor(fieldId).GetTypeName()).Unwrap());
+   }
+
+   // The bytes of the pages of the clusters in range
+   ByteData bytes{0, 0};
+   ForEachPage(*desc, GetColumnIds(*desc, fieldNames, ntupleName), range,
+               [&bytes](DescriptorId_t, const RColumnElementBase &element, const auto &pageInfo, RClusterIndex) {
+                  bytes.fCompressedBytesRead += pageInfo.fLocator.fBytesOnStorage;
+                  bytes.fUncompressedBytesRead += element.GetPackedSize(pageInfo.fNElements);
+               });
+
+   auto reader = RNTupleReader::Open(std::move(model), ntupleName, fileName);
+   if (range.fStart == -1ll)
+      range = EntryRange{0ll, static_cast<Long64_t>(reader->GetNEntries())};
+   for (auto e = range.fStart; e < range.fEnd; ++e)
+      reader->LoadEntry(e);
+
+   return bytes;
+}
+
+ByteData ReadSpeed::ReadNTuplePages(const std::string &fileName, const std::string &ntupleName,
+                                    const std::vector<std::string> &fieldNames, EntryRange range)
+{
+   using Clock_t = std::chrono::steady_clock;
+
+   auto source = RPageSource::Create(ntupleName, fileName);
+   const auto desc = GetDescriptor(*source);
+
+   ByteData bytes{0, 0};
+   RNTupleDecompressor decompressor;
+   std::vector<unsigned char> sealedBuffer;
+   std::vector<unsigned char> content;
+   ForEachPage(*desc, GetColumnIds(*desc, fieldNames, ntupleName), range,
+               [&](DescriptorId_t columnId, const RColumnElementBase &element, const auto &pageInfo,
+                   RClusterIndex clusterIndex) {
+                  RPageSource::RSealedPage sealedPage;
+                  sealedBuffer.resize(pageInfo.fLocator.fBytesOnStorage);
+                  sealedPage.fBuffer = sealedBuffer.data();
+                  const auto start = Clock_t::now();
+                  source->LoadSealedPage(columnId, clusterIndex, sealedPage);
+                  const auto read = Clock_t::now();
+                  content.resize(element.GetPackedSize(pageInfo.fNElements));
+                  decompressor.Unzip(sealedBuffer.data(), sealedPage.fSize, content.size(), content.data());
+                  bytes.fReadTime += std::chrono::duration<double>(read - start).count();
+                  bytes.fDecompressionTime += std::chrono::duration<double>(Clock_t::now() - read).count();
+                  bytes.fCompressedBytesRead += sealedPage.fSize;
+                  bytes.fUncompressedBytesRead += content.size();
+               });
+   return bytes;
+}
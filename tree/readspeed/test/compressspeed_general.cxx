@@ -0,0 +1,208 @@
+#include "gtest/gtest.h"
+
+#include "CompressSpeed.hxx"
+#include "CompressSpeedCLI.hxx"
+
+#include "TFile.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+#ifdef R__READSPEED_NTUPLE
+#include <ROOT/RNTuple.hxx>
+#include <ROOT/RNTupleModel.hxx>
+#endif
+
+using namespace CompressSpeed;
+
+class CompressSpeedIntegration : public ::testing::Test {
+protected:
+   static void SetUpTestCase()
+   {
+      TFile f("compressspeedinput.root", "recreate");
+      TTree t("t", "t");
+      int x = 0;
+      double y = 0.;
+      t.Branch("x", &x);
+      t.Branch("y", &y);
+      for (int i = 0; i < 100000; ++i) {
+         x = i % 100;
+         y = i * 0.5;
+         t.Fill();
+      }
+      t.Write();
+   }
+
+   static void TearDownTestCase() { gSystem->Unlink("compressspeedinput.root"); }
+};
+
+TEST_F(CompressSpeedIntegration, Replay)
+{
+   Data d;
+   d.fFileName = "compressspeedinput.root";
+   d.fTreeName = "t";
+   d.fCompressionSettings = {101, 505};
+   const auto results = EvalCompression(d, 0);
+
+   ASSERT_EQ(results.size(), 2u);
+   EXPECT_EQ(results[0].fName, "x");
+   EXPECT_EQ(results[1].fName, "y");
+   for (const auto &b : results) {
+      EXPECT_GT(b.fNBuffers, 0u);
+      ASSERT_EQ(b.fResults.size(), 2u);
+      EXPECT_LT(b.fRecommended, 2u);
+      for (const auto &r : b.fResults) {
+         EXPECT_GT(r.fCompressedBytes, 0u);
+         EXPECT_LT(r.fCompressedBytes, b.fUncompressedBytes);
+      }
+      EXPECT_EQ(b.fResults[0].fCompressionSettings, 101);
+      EXPECT_EQ(b.fResults[1].fCompressionSettings, 505);
+   }
+   EXPECT_EQ(results[0].fUncompressedBytes, 100000u * sizeof(int));
+   EXPECT_EQ(results[1].fUncompressedBytes, 100000u * sizeof(double));
+
+   // replaying the setting the file was written with gives the same baskets
+   const auto fileSetting = results[0].fFileCompressionSettings;
+   if (fileSetting == 101 || fileSetting == 505) {
+      const auto &replay = results[0].fResults[fileSetting == 101 ? 0 : 1];
+      EXPECT_EQ(replay.fCompressedBytes, results[0].fFileCompressedBytes);
+   }
+}
+
+#ifdef R__USE_IMT
+TEST_F(CompressSpeedIntegration, MultiThread)
+{
+   Data d;
+   d.fFileName = "compressspeedinput.root";
+   d.fTreeName = "t";
+   d.fBranchNames = {"y"};
+   d.fCompressionSettings = {101, 404};
+   const auto st = EvalCompression(d, 0);
+   const auto mt = EvalCompression(d, 2);
+
+   ASSERT_EQ(st.size(), 1u);
+   ASSERT_EQ(mt.size(), 1u);
+   EXPECT_EQ(st[0].fUncompressedBytes, mt[0].fUncompressedBytes);
+   for (std::size_t i = 0; i < 2; ++i)
+      EXPECT_EQ(st[0].fResults[i].fCompressedBytes, mt[0].fResults[i].fCompressedBytes);
+}
+#endif
+
+TEST_F(CompressSpeedIntegration, MaxBaskets)
+{
+   Data d;
+   d.fFileName = "compressspeedinput.root";
+   d.fTreeName = "t";
+   d.fBranchNames = {"x"};
+   d.fCompressionSettings = {101};
+   d.fMaxBuffers = 1;
+   const auto results = EvalCompression(d, 0);
+
+   ASSERT_EQ(results.size(), 1u);
+   EXPECT_EQ(results[0].fNBuffers, 1u);
+}
+
+TEST_F(CompressSpeedIntegration, Errors)
+{
+   Data d;
+   d.fFileName = "compressspeedinput.root";
+   d.fTreeName = "t";
+   d.fBranchNames = {"z"};
+   EXPECT_THROW(EvalCompression(d, 0), std::runtime_error) << "Should throw for non-existent branch";
+
+   d.fBranchNames = {};
+   d.fCompressionSettings = {301};
+   EXPECT_THROW(EvalCompression(d, 0), std::runtime_error) << "Should throw for invalid compression setting";
+}
+
+#ifdef R__READSPEED_NTUPLE
+TEST(CompressSpeedNTuple, Replay)
+{
+   {
+      auto model = ROOT::Experimental::RNTupleModel::Create();
+      auto x = model->MakeField<int>("x");
+      auto y = model->MakeField<double>("y");
+      auto writer = ROOT::Experimental::RNTupleWriter::Recreate(std::move(model), "n", "compressspeedntuple.root");
+      for (int i = 0; i < 3000; ++i) {
+         *x = i % 100;
+         *y = i * 0.5;
+         writer->Fill();
+         if (i % 1000 == 999)
+            writer->CommitCluster();
+      }
+   }
+
+   Data d;
+   d.fFileName = "compressspeedntuple.root";
+   d.fTreeName = "n";
+   std::vector<BranchData> fields;
+   VisitNTupleFields(d, [&fields](BranchData &&data) { fields.push_back(std::move(data)); });
+   ASSERT_EQ(fields.size(), 2u);
+   EXPECT_EQ(fields[0].fName, "x");
+   EXPECT_EQ(fields[1].fName, "y");
+   // at least one page per cluster
+   EXPECT_GE(fields[0].fBuffers.size(), 3u);
+   EXPECT_EQ(fields[0].GetUncompressedBytes(), 3000u * sizeof(int));
+   EXPECT_EQ(fields[1].GetUncompressedBytes(), 3000u * sizeof(double));
+   EXPECT_GT(fields[0].fCompressedBytes, 0u);
+
+   d.fBranchNames = {"y"};
+   d.fCompressionSettings = {101, 505};
+   const auto results = EvalCompression(d, 0);
+   ASSERT_EQ(results.size(), 1u);
+   EXPECT_EQ(results[0].fName, "y");
+   EXPECT_EQ(results[0].fNBuffers, fields[1].fBuffers.size());
+   EXPECT_EQ(results[0].fUncompressedBytes, 3000u * sizeof(double));
+   EXPECT_EQ(results[0].fFileCompressedBytes, fields[1].fCompressedBytes);
+   ASSERT_EQ(results[0].fResults.size(), 2u);
+   for (const auto &r : results[0].fResults)
+      EXPECT_GT(r.fCompressedBytes, 0u);
+
+   d.fBranchNames = {"z"};
+   EXPECT_THROW(EvalCompression(d, 0), std::runtime_error) << "Should throw for non-existent field";
+
+   gSystem->Unlink("compressspeedntuple.root");
+}
+#endif
+
+TEST(CompressSpeed, ReplayLargeBuffer)
+{
+   // Buffers larger than kMAXZIPBUF are compressed in several chunks
+   BranchData data;
+   data.fName = "large";
+   data.fBuffers.emplace_back(20 * 1024 * 1024);
+   for (std::size_t i = 0; i < data.fBuffers[0].size(); ++i)
+      data.fBuffers[0][i] = static_cast<char>(i % 7);
+
+   const auto r = ReplayBuffer(data, 0, 404);
+   EXPECT_EQ(r.fCompressionSettings, 404);
+   EXPECT_GT(r.fCompressedBytes, 0u);
+   EXPECT_LT(r.fCompressedBytes, data.fBuffers[0].size() / 10);
+}
+
+TEST(CompressSpeed, Recommend)
+{
+   // 10 MB decompressed in 0.2 s, 20 MB decompressed in 0.01 s
+   const std::vector<SettingResult> results{{201, 10 * 1024 * 1024, 1., 0.2}, {404, 20 * 1024 * 1024, 0.1, 0.01}};
+   EXPECT_EQ(Recommend(results, 10.), 0u);   // 1.2 s vs 2.01 s
+   EXPECT_EQ(Recommend(results, 1000.), 1u); // 0.21 s vs 0.03 s
+   EXPECT_EQ(Recommend(results, 0.), 0u);
+}
+
+TEST(CompressSpeedCLI, Args)
+{
+   const auto parsedArgs = ParseArgs({"rootcompressspeed", "--file", "f.root", "--tree", "t", "--branches", "x", "y",
+                                      "--settings", "101", "505", "--max-baskets", "10", "--threads", "4"});
+
+   EXPECT_TRUE(parsedArgs.fShouldRun);
+   EXPECT_EQ(parsedArgs.fData.fFileName, "f.root");
+   EXPECT_EQ(parsedArgs.fData.fTreeName, "t");
+   EXPECT_EQ(parsedArgs.fData.fBranchNames, std::vector<std::string>({"x", "y"}));
+   EXPECT_EQ(parsedArgs.fData.fCompressionSettings, std::vector<int>({101, 505}));
+   EXPECT_EQ(parsedArgs.fData.fMaxBuffers, 10u);
+   EXPECT_EQ(parsedArgs.fNThreads, 4u);
+
+   EXPECT_EQ(ParseArgs({"rootcompressspeed", "--file", "f.root", "--tree", "t"}).fData.fCompressionSettings,
+             Data::GetDefaultCompressionSettings());
+   EXPECT_FALSE(ParseArgs({"rootcompressspeed", "--file", "f.root"}).fShouldRun);
+   EXPECT_FALSE(ParseArgs({"rootcompressspeed", "--help"}).fShouldRun);
+}
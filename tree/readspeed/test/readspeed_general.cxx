@@ -13,11 +13,18 @@
 #ifdef R__USE_IMT
 #include "ROOT/TTreeProcessorMT.hxx" // for TTreeProcessorMT::GetTasksPerWorkerHint
 #endif
+#ifdef R__READSPEED_NTUPLE
+#include <ROOT/RNTuple.hxx>
+#include <ROOT/RNTupleModel.hxx>
+#endif
 
 #include "TFile.h"
 #include "TSystem.h"
 #include "TTree.h"
 
+#include <regex>
+#include <sstream>
+
 using namespace ReadSpeed;
 
 // Helper function to generate a .root file with some dummy data in it.
@@ -84,6 +91,37 @@ TEST_F(ReadSpeedIntegration, MultiThread)
    EXPECT_EQ(result.fUncompressedBytesRead, 80000000) << "Wrong number of uncompressed bytes read";
    EXPECT_EQ(result.fCompressedBytesRead, 643934) << "Wrong number of compressed bytes read";
 }
+
+TEST_F(ReadSpeedIntegration, MultiThreadJSON)
+{
+   // What rootreadspeed --json --threads 2 prints on stdout
+   std::ostringstream out;
+   {
+      struct CoutRedirect {
+         std::streambuf *fOld;
+         CoutRedirect(std::streambuf *buf) : fOld(std::cout.rdbuf(buf)) {}
+         ~CoutRedirect() { std::cout.rdbuf(fOld); }
+      } redirect(out.rdbuf());
+      const auto result = EvalThroughput({{"t"}, {"readspeedinput1.root", "readspeedinput2.root"}, {"x"}}, 2);
+      PrintThroughputJSON(result);
+   }
+
+   // A single object with a number per line, and nothing else
+   const std::regex member("  \"[A-Za-z]+\": -?[0-9]+(\\.[0-9]+)?([eE][-+]?[0-9]+)?,?");
+   std::istringstream lines(out.str());
+   std::vector<std::string> members;
+   for (std::string line; std::getline(lines, line);)
+      members.push_back(line);
+   ASSERT_GE(members.size(), 3u) << out.str();
+   EXPECT_EQ(members.front(), "{") << out.str();
+   EXPECT_EQ(members.back(), "}") << out.str();
+   for (std::size_t i = 1; i + 1 < members.size(); ++i) {
+      EXPECT_TRUE(std::regex_match(members[i], member)) << members[i];
+      // all members but the last one are followed by a comma
+      EXPECT_EQ(members[i].back() == ',', i + 2 < members.size()) << members[i];
+   }
+   EXPECT_NE(out.str().find("\"uncompressedBytesRead\": 80000000,"), std::string::npos) << out.str();
+}
 #endif
 
 TEST_F(ReadSpeedIntegration, NonExistentFile)
@@ -144,6 +182,148 @@ TEST_F(ReadSpeedIntegration, AllBranches)
    EXPECT_EQ(result.fCompressedBytesRead, 1316837) << "Wrong number of compressed bytes read";
 }
 
+TEST_F(ReadSpeedIntegration, DecompressionOnly)
+{
+   Data d{{"t"}, {"readspeedinput1.root", "readspeedinput2.root"}, {"x"}};
+   d.fDecompressionOnly = true;
+   const auto result = EvalThroughput(d, 0);
+
+   EXPECT_EQ(result.fUncompressedBytesRead, 80000000) << "Wrong number of uncompressed bytes read";
+   EXPECT_GT(result.fCompressedBytesRead, 0u) << "No compressed bytes read";
+   EXPECT_LT(result.fCompressedBytesRead, result.fUncompressedBytesRead) << "Baskets not compressed";
+   EXPECT_GT(result.fDecompressionTime, 0.) << "Decompression time not measured";
+}
+
+#ifdef R__USE_IMT
+TEST_F(ReadSpeedIntegration, DecompressionOnlyMultiThread)
+{
+   Data d{{"t"}, {"readspeedinput1.root", "readspeedinput2.root"}, {"x"}};
+   d.fDecompressionOnly = true;
+   const auto result = EvalThroughput(d, 2);
+
+   EXPECT_EQ(result.fUncompressedBytesRead, 80000000) << "Wrong number of uncompressed bytes read";
+   EXPECT_EQ(result.fCompressedBytesRead, EvalThroughput(d, 0).fCompressedBytesRead)
+      << "Different number of compressed bytes read with and without threads";
+}
+#endif
+
+TEST_F(ReadSpeedIntegration, ColdCache)
+{
+   Data d{{"t"}, {"readspeedinput3.root"}, {"x"}};
+   d.fColdCache = true;
+   const auto result = EvalThroughput(d, 0);
+
+   EXPECT_EQ(result.fUncompressedBytesRead, 40000000) << "Wrong number of uncompressed bytes read";
+   EXPECT_EQ(result.fCompressedBytesRead, 321967) << "Wrong number of compressed bytes read";
+}
+
+TEST_F(ReadSpeedIntegration, PerBranch)
+{
+   const auto results = EvalBranchThroughput({{"t"}, {"readspeedinput3.root"}, {"x", "y_brunch"}});
+
+   ASSERT_EQ(results.size(), 2u) << "Wrong number of branches";
+   EXPECT_EQ(results[0].fBranchName, "x");
+   EXPECT_EQ(results[1].fBranchName, "y_brunch");
+   for (const auto &b : results) {
+      EXPECT_EQ(b.fUncompressedBytesRead, 40000000) << "Wrong number of uncompressed bytes read for " << b.fBranchName;
+      EXPECT_GT(b.fCompressedBytesRead, 0u) << "No compressed bytes read for " << b.fBranchName;
+      EXPECT_GT(b.fTotalTime, 0.) << "Total time not measured for " << b.fBranchName;
+   }
+}
+
+#ifdef R__READSPEED_NTUPLE
+// An RNTuple with an int and a double field, in 3 clusters of 1000 entries.
+class ReadSpeedNTuple : public ::testing::Test {
+protected:
+   static void SetUpTestSuite()
+   {
+      auto model = ROOT::Experimental::RNTupleModel::Create();
+      auto x = model->MakeField<int>("x");
+      auto y = model->MakeField<double>("y");
+      auto writer = ROOT::Experimental::RNTupleWriter::Recreate(std::move(model), "n", "readspeedntuple.root");
+      for (int i = 0; i < 3000; ++i) {
+         *x = i;
+         *y = i * 0.5;
+         writer->Fill();
+         if (i % 1000 == 999)
+            writer->CommitCluster();
+      }
+   }
+
+   static void TearDownTestSuite() { gSystem->Unlink("readspeedntuple.root"); }
+};
+
+TEST_F(ReadSpeedNTuple, FieldsAndClusters)
+{
+   EXPECT_EQ(GetNTupleFieldNames("readspeedntuple.root", "n"), (std::vector<std::string>{"x", "y"}));
+
+   const auto clusters = GetNTupleClusters("readspeedntuple.root", "n");
+   ASSERT_EQ(clusters.size(), 3u) << "Wrong number of clusters";
+   for (std::size_t i = 0; i < clusters.size(); ++i) {
+      EXPECT_EQ(clusters[i].fStart, static_cast<Long64_t>(1000 * i));
+      EXPECT_EQ(clusters[i].fEnd, static_cast<Long64_t>(1000 * (i + 1)));
+   }
+
+   std::unique_ptr<TFile> f(TFile::Open("readspeedntuple.root"));
+   EXPECT_TRUE(IsNTuple(f.get(), "n"));
+}
+
+TEST_F(ReadSpeedNTuple, Read)
+{
+   const auto all = ReadNTuple("readspeedntuple.root", "n", {"x", "y"});
+   EXPECT_EQ(all.fUncompressedBytesRead, 3000u * (sizeof(int) + sizeof(double)))
+      << "Wrong number of uncompressed bytes read";
+   EXPECT_GT(all.fCompressedBytesRead, 0u) << "No compressed bytes read";
+
+   // only the pages of the cluster starting in range
+   const auto cluster = ReadNTuple("readspeedntuple.root", "n", {"x"}, {1000, 2000});
+   EXPECT_EQ(cluster.fUncompressedBytesRead, 1000u * sizeof(int)) << "Wrong number of uncompressed bytes read";
+
+   // the same pages, without deserializing them
+   const auto pages = ReadNTuplePages("readspeedntuple.root", "n", {"x", "y"});
+   EXPECT_EQ(pages.fUncompressedBytesRead, all.fUncompressedBytesRead);
+   EXPECT_EQ(pages.fCompressedBytesRead, all.fCompressedBytesRead);
+
+   EXPECT_THROW(ReadNTuple("readspeedntuple.root", "n", {"z"}), std::runtime_error)
+      << "Should throw for non-existent field";
+}
+
+TEST_F(ReadSpeedNTuple, Throughput)
+{
+   const auto st = EvalThroughput({{"n"}, {"readspeedntuple.root"}, {"y"}}, 0);
+   EXPECT_EQ(st.fUncompressedBytesRead, 3000u * sizeof(double)) << "Wrong number of uncompressed bytes read";
+
+#ifdef R__USE_IMT
+   // one task per cluster
+   const auto mt = EvalThroughput({{"n"}, {"readspeedntuple.root"}, {"y"}}, 2);
+   EXPECT_EQ(mt.fUncompressedBytesRead, st.fUncompressedBytesRead);
+   EXPECT_EQ(mt.fCompressedBytesRead, st.fCompressedBytesRead);
+#endif
+}
+#endif
+
+TEST(ReadSpeedOutput, JSON)
+{
+   Result r{};
+   r.fRealTime = 2.;
+   r.fUncompressedBytesRead = 80000000;
+   r.fCompressedBytesRead = 643934;
+   std::ostringstream out;
+   PrintThroughputJSON(r, out);
+
+   EXPECT_NE(out.str().find("\"uncompressedBytesRead\": 80000000"), std::string::npos) << out.str();
+   EXPECT_NE(out.str().find("\"compressedBytesRead\": 643934"), std::string::npos) << out.str();
+
+   BranchResult b;
+   b.fBranchName = "a\"b";
+   b.fUncompressedBytesRead = 100;
+   std::ostringstream branchOut;
+   PrintBranchThroughputJSON({b}, branchOut);
+
+   EXPECT_NE(branchOut.str().find("\"name\": \"a\\\"b\""), std::string::npos) << branchOut.str();
+   EXPECT_NE(branchOut.str().find("\"uncompressedBytesRead\": 100"), std::string::npos) << branchOut.str();
+}
+
 TEST(ReadSpeedCLI, CheckFilenames)
 {
    const std::vector<std::string> baseArgs{"root-readspeed", "--trees", "t", "--branches", "x", "--files"};
@@ -295,3 +475,20 @@ TEST(ReadSpeedCLI, WorkerThreadsHint)
    EXPECT_EQ(newTasksPerWorker, oldTasksPerWorker + 10) << "Tasks per worker hint not updated correctly";
 }
 #endif
+
+TEST(ReadSpeedCLI, MeasurementModes)
+{
+   const std::vector<std::string> allArgs{
+      "root-readspeed",       "--files",      "doesnotexist.root", "--trees", "t", "--branches", "x",
+      "--decompression-only", "--per-branch", "--cold-cache",      "--json",
+   };
+
+   const auto parsedArgs = ParseArgs(allArgs);
+
+   EXPECT_TRUE(parsedArgs.fShouldRun) << "Program not running when given valid arguments";
+   EXPECT_TRUE(parsedArgs.fData.fDecompressionOnly) << "Decompression-only mode not set";
+   EXPECT_TRUE(parsedArgs.fData.fColdCache) << "Cold-cache mode not set";
+   EXPECT_TRUE(parsedArgs.fPerBranch) << "Per-branch mode not set";
+   EXPECT_TRUE(parsedArgs.fJSON) << "JSON output not set";
+   EXPECT_EQ(parsedArgs.fData.fBranchNames, std::vector<std::string>{"x"}) << "Flags consumed as branch names";
+}
@@ -31,6 +31,8 @@
 #include "Compression.h"
 #include "ROOT/TIOFeatures.hxx"
 
+#include <vector>
+
 class TTree;
 class TBasket;
 class TBranchElement;
@@ -78,6 +80,10 @@ public:
    Int_t GetEntriesSerialized(Long64_t evt, TBuffer &user_buf, TBuffer *count_buf);
    /// Return true if the branch can be read through the bulk interfaces.
    Bool_t SupportsBulkRead() const;
+   /// See TBranch::GetBulkJaggedEntries(Long64_t evt, TBuffer &user_buf, std::vector<Int_t> &offsets);
+   Int_t GetBulkJaggedEntries(Long64_t evt, TBuffer &user_buf, std::vector<Int_t> &offsets);
+   /// Return true if the branch can be read through GetBulkJaggedEntries.
+   Bool_t SupportsBulkJaggedRead() const;
 
 private:
    TBulkBranchRead(TBranch &parent)
@@ -177,11 +183,16 @@ protected:
    TString  GetRealFileName() const;
 
    virtual void SetAddressImpl(void *addr, Bool_t /* implied */) { SetAddress(addr); }
+   virtual Bool_t GetBulkJaggedLayout(EDataType &type, Int_t &headerSize) const;
+   static  Int_t  GetBulkJaggedTypeSize(EDataType type);
 
 private:
    Int_t    GetBasketAndFirst(TBasket*& basket, Long64_t& first, TBuffer* user_buffer);
    TBasket *GetBasketImpl(Int_t basket, TBuffer* user_buffer);
+   Int_t    LoadBulkBasket(Long64_t entry, TBuffer &user_buf, TBasket *&basket, const char *caller, Bool_t reportPartialCluster);
+   void     ReleaseBulkBasket(TBasket *basket);
    Int_t    GetBulkEntries(Long64_t, TBuffer&);
+   Int_t    GetBulkJaggedEntries(Long64_t, TBuffer&, std::vector<Int_t>&);
    Int_t    GetEntriesSerialized(Long64_t N, TBuffer& user_buf) {return GetEntriesSerialized(N, user_buf, nullptr);}
    Int_t    GetEntriesSerialized(Long64_t, TBuffer&, TBuffer*);
    Int_t    FillEntryBuffer(TBasket* basket,TBuffer* buf, Int_t& lnew);
@@ -287,6 +298,7 @@ public:
    virtual void      SetTree(TTree *tree) { fTree = tree; }
    virtual void      SetupAddresses();
            Bool_t    SupportsBulkRead() const;
+           Bool_t    SupportsBulkJaggedRead() const;
    virtual void      UpdateAddress() {}
    virtual void      UpdateFile();
 
@@ -321,6 +333,8 @@ inline Int_t  TBulkBranchRead::GetBulkEntries(Long64_t evt, TBuffer& user_buf) {
 inline Int_t  TBulkBranchRead::GetEntriesSerialized(Long64_t evt, TBuffer& user_buf) { return fParent.GetEntriesSerialized(evt, user_buf); }
 inline Int_t  TBulkBranchRead::GetEntriesSerialized(Long64_t evt, TBuffer& user_buf, TBuffer* count_buf) { return fParent.GetEntriesSerialized(evt, user_buf, count_buf); }
 inline Bool_t TBulkBranchRead::SupportsBulkRead() const { return fParent.SupportsBulkRead(); }
+inline Int_t  TBulkBranchRead::GetBulkJaggedEntries(Long64_t evt, TBuffer& user_buf, std::vector<Int_t>& offsets) { return fParent.GetBulkJaggedEntries(evt, user_buf, offsets); }
+inline Bool_t TBulkBranchRead::SupportsBulkJaggedRead() const { return fParent.SupportsBulkJaggedRead(); }
 
 }  // Internal
 }  // Experimental
@@ -21,14 +21,30 @@
 //                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
+#include "RConfigure.h"
 #include "TTree.h"
 
+#include <atomic>
+#include <memory>
+
 class TFile;
 class TBrowser;
 class TCut;
 class TEntryList;
 class TEventList;
 class TCollection;
+class TTreeCache;
+
+#ifdef R__USE_IMT
+namespace ROOT {
+namespace Experimental {
+class TTaskGroup;
+}
+namespace Internal {
+struct TTreeCacheReadAhead;
+}
+}
+#endif
 
 class TChain : public TTree {
 
@@ -44,12 +60,22 @@ protected:
    TList       *fStatus;           ///< -> List of active/inactive branches (TChainElement, owned)
    TChain      *fProofChain;       ///<! chain proxy when going to be processed by PROOF
    bool         fGlobalRegistration;  ///<! if true, bypass use of global lists
+   Bool_t       fOpenAhead = kFALSE;   ///<! If true, open the next file in the background when reading the chain sequentially (IMT only)
+#ifdef R__USE_IMT
+   std::unique_ptr<ROOT::Experimental::TTaskGroup> fOpenAheadTask; ///<! Task opening the next file in the background
+   std::atomic<TFile *> fOpenAheadFile{nullptr}; ///<! File opened in the background (owned)
+   Int_t        fOpenAheadTreeNumber = -1; ///<! Tree number of fOpenAheadFile
+   std::unique_ptr<ROOT::Internal::TTreeCacheReadAhead> fOpenAheadBaskets; ///<! First cluster of fOpenAheadFile, read for the cached branches
+#endif
 
 private:
    TChain(const TChain&);            // not implemented
    TChain& operator=(const TChain&); // not implemented
    void
    ParseTreeFilename(const char *name, TString &filename, TString &treename, TString &query, TString &suffix) const;
+   void ReadTreeHeaders();
+   void StartOpenAhead(Int_t treenum, TTreeCache *cache);
+   TFile *TakeOpenAheadFile(Int_t treenum);
 
 protected:
    void InvalidateCurrentTree();
@@ -97,6 +123,7 @@ public:
    Long64_t  GetChainEntryNumber(Long64_t entry) const override;
    TClusterIterator GetClusterIterator(Long64_t firstentry) override;
            Int_t     GetNtrees() const { return fNtrees; }
+           Bool_t    GetOpenAhead() const { return fOpenAhead; }
    Long64_t  GetEntries() const override;
    Long64_t  GetEntries(const char *sel) override { return TTree::GetEntries(sel); }
    Int_t     GetEntry(Long64_t entry=0, Int_t getall=0) override;
@@ -165,6 +192,7 @@ public:
    void      SetEventList(TEventList *evlist) override;
    void      SetMakeClass(Int_t make) override { TTree::SetMakeClass(make); if (fTree) fTree->SetMakeClass(make);}
    void      SetName(const char *name) override;
+           void      SetOpenAhead(Bool_t openahead = kTRUE);
    virtual void      SetPacketSize(Int_t size = 100);
    virtual void      SetProof(Bool_t on = kTRUE, Bool_t refresh = kFALSE, Bool_t gettreeheader = kFALSE);
    void      SetWeight(Double_t w=1, Option_t *option="") override;
@@ -14,6 +14,8 @@
 
 #include "TNamed.h"
 
+#include <vector>
+
 class TTree;
 class TDirectory;
 class TObjArray;
@@ -64,6 +66,7 @@ class TEntryList: public TNamed
    virtual void        Add(const TEntryList *elist);
    void                AddSubList(TEntryList *elist);
    virtual Int_t       Contains(Long64_t entry, TTree *tree = nullptr);
+   virtual void        Intersect(const TEntryList *elist);
    virtual void        DirectoryAutoAdd(TDirectory *);
    virtual Bool_t      Enter(Long64_t entry, TTree *tree = nullptr);
    virtual Bool_t      Enter(Long64_t localentry, const char *treename, const char *filename);
@@ -76,6 +79,7 @@ class TEntryList: public TNamed
    virtual TList      *GetLists() const { return fLists; }
    virtual TDirectory *GetDirectory() const { return fDirectory; }
    virtual Long64_t    GetN() const { return fN; }
+   std::vector<Long64_t> GetNEntriesBelow(const std::vector<Long64_t> &entries) const;
    virtual const char *GetTreeName() const { return fTreeName.Data(); }
    virtual const char *GetFileName() const { return fFileName.Data(); }
    virtual Int_t       GetTreeNumber() const { return fTreeNumber; }
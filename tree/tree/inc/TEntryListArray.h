@@ -82,6 +82,7 @@ public:
    void        SetTree(const TTree *tree) override {
       TEntryList::SetTree(tree);   // will take treename and filename from the tree and call the method above
    }
+   void        Intersect(const TEntryList *elist) override;
    void        Subtract(const TEntryList *elist) override;
    virtual TList* GetSubLists() const {
       return fSubLists;
@@ -14,21 +14,22 @@
 //
 // Used internally in TEntryList to store the entry numbers.
 //
-// There are 2 ways to represent entry numbers in a TEntryListBlock:
+// There are 3 ways to represent entry numbers in a TEntryListBlock:
 // 1) as bits, where passing entry numbers are assigned 1, not passing - 0
 // 2) as a simple array of entry numbers
-// In both cases, a UShort_t* is used. The second option is better in case
-// less than 1/16 of entries passes the selection, and the representation can be
-// changed by calling OptimizeStorage() function.
+// 3) as runs of consecutive passing entries (first and last entry of each run)
+// In all cases, a UShort_t* is used. OptimizeStorage() chooses the smallest
+// representation. The runs only exist in memory: such a block is written as
+// bits or as a list, which older versions of ROOT can read.
 // When the block is being filled, it's always stored as bits, and the OptimizeStorage()
 // function is called by TEntryList when it starts filling the next block. If
 // Enter() or Remove() is called after OptimizeStorage(), representation is
 // again changed to 1).
 //
 // Operations on blocks (see also function comments):
-// - Merge() - adds all entries from one block to the other. If the first block
-//             uses array representation, it's changed to bits representation only
-//             if the total number of passing entries is still less than kBlockSize
+// - Merge() - adds all entries from one block to the other. The blocks are
+//             combined word by word in bits representation
+// - Subtract(), Intersect() - remove the entries which are (not) in the other block
 // - GetEntry(n) - returns n-th non-zero entry.
 // - Next()      - return next non-zero entry. In case of representation 1), Next()
 //                 is faster than GetEntry()
@@ -45,9 +46,10 @@ class TEntryListBlock:public TObject
  protected:
    Int_t    fNPassed;           ///< number of entries in the entry list (if fPassing=0 - number of entries
                                 ///< not in the entry list
-   Int_t    fN;                 ///< size of fIndices for I/O  =fNPassed for list, fBlockSize for bits
+   Int_t    fN;                 ///< size of fIndices for I/O  =fNPassed for list, fBlockSize for bits,
+                                ///< twice the number of runs for runs
    UShort_t *fIndices;          ///<[fN]
-   Int_t    fType;              ///<0 - bits, 1 - list
+   Int_t    fType;              ///<0 - bits, 1 - list, 2 - runs (in memory only)
    Bool_t   fPassing;           ///<1 - stores entries that belong to the list
                                 ///<0 - stores entries that don't belong to the list
    UShort_t fCurrent;           ///<! to fasten  Contains() in list mode
@@ -55,6 +57,13 @@ class TEntryListBlock:public TObject
    Int_t    fLastIndexReturned; ///<! to optimize GetEntry() in a loop
 
    void Transform(Bool_t dir, UShort_t *indexnew);
+   void GetBits(UShort_t *bits) const;
+   void SetBits(UShort_t *bits);
+   void ToBits();
+   void ToRuns(Int_t nruns);
+   void OptimizeBitsOrList();
+   Int_t FindRun(Int_t entry) const;
+   Int_t Combine(const TEntryListBlock *block, Int_t op);
 
  public:
 
@@ -65,15 +74,19 @@ class TEntryListBlock:public TObject
    TEntryListBlock &operator=(const TEntryListBlock &rhs);
 
    Bool_t  Enter(Int_t entry);
+   Int_t   EnterRange(Int_t start, Int_t end);
    Bool_t  Remove(Int_t entry);
    Int_t   Contains(Int_t entry);
    void    OptimizeStorage();
    Int_t   Merge(TEntryListBlock *block);
+   Int_t   Subtract(TEntryListBlock *block);
+   Int_t   Intersect(TEntryListBlock *block);
    Int_t   Next();
    Int_t   GetEntry(Int_t entry);
    void    ResetIndices() {fLastIndexQueried = -1, fLastIndexReturned = -1;}
-   Int_t   GetType() { return fType; }
-   Int_t   GetNPassed();
+   Int_t   GetType() const { return fType; }
+   Int_t   GetNPassed() const;
+   Int_t   GetNPassedBelow(Int_t entry) const;
    void Print(const Option_t *option = "") const override;
    void    PrintWithShift(Int_t shift) const;
 
@@ -23,10 +23,24 @@
 
 #include "TFileCacheRead.h"
 
+#include <memory>
+#include <string>
 #include <vector>
 
 class TTree;
 class TBranch;
+
+namespace ROOT {
+namespace Internal {
+/// Baskets of a tree read before the tree is attached to a TTreeCache, see TTreeCache::ReadAhead.
+struct TTreeCacheReadAhead {
+   std::vector<Long64_t> fPos;    ///< Sorted positions of the baskets in the file
+   std::vector<Int_t> fLen;       ///< Lengths of the baskets
+   std::vector<Long64_t> fOffset; ///< Offsets of the baskets in fData
+   std::vector<char> fData;       ///< Content of the baskets
+};
+} // namespace Internal
+} // namespace ROOT
 class TObjArray;
 
 class TTreeCache : public TFileCacheRead {
@@ -104,6 +118,14 @@ protected:
 
    std::unique_ptr<MissCache> fMissCache; ///<! Cache contents for misses
 
+   // Deferred branches are known to the cache but their baskets are not
+   // prefetched with every cluster: they are fetched on demand, through the
+   // miss cache, only for the entries that are actually read.
+   std::vector<std::string> fDeferredBrNames; ///<! Names of the deferred branches
+   std::vector<TBranch *> fDeferredBranches;  ///<! Deferred branches of the current tree
+
+   std::unique_ptr<ROOT::Internal::TTreeCacheReadAhead> fReadAhead; ///<! Baskets of the first cluster read ahead of time
+
 private:
    TTreeCache(const TTreeCache &) = delete; ///< this class cannot be copied
    TTreeCache &operator=(const TTreeCache &) = delete;
@@ -123,6 +145,8 @@ private:
                                                           ///< (offset / size) of the corresponding basket.
    TBranch *CalculateMissEntries(Long64_t, int, bool);    ///< Given an file read, try to determine the corresponding branch.
    Bool_t   ProcessMiss(Long64_t pos, int len); ///<! Given a file read not in the miss cache, handle (possibly) loading the data.
+   Bool_t   IsDeferred(TBranch *b) const;       ///<! Whether the baskets of this branch are excluded from the prefetch.
+   Bool_t   ReadBufferReadAhead(char *buf, Long64_t pos, Int_t len); ///<! Read a basket from the read-ahead data.
 
 public:
 
@@ -133,10 +157,14 @@ public:
    Int_t                AddBranch(const char *branch, Bool_t subbranches = kFALSE) override;
    virtual Int_t        DropBranch(TBranch *b, Bool_t subbranches = kFALSE);
    virtual Int_t        DropBranch(const char *branch, Bool_t subbranches = kFALSE);
+   virtual Int_t        DeferBranch(TBranch *b, Bool_t subbranches = kFALSE);
+   virtual Int_t        DeferBranch(const char *branch, Bool_t subbranches = kFALSE);
    virtual void         Disable() {fEnabled = kFALSE;}
    virtual void         Enable() {fEnabled = kTRUE;}
    Bool_t               GetOptimizeMisses() const { return fOptimizeMisses; }
    const TObjArray     *GetCachedBranches() const { return fBranches; }
+   std::vector<std::string> GetCachedBranchNames() const;
+   const std::vector<TBranch *> &GetDeferredBranches() const { return fDeferredBranches; }
    EPrefillType         GetConfiguredPrefillType() const;
    Double_t             GetEfficiency() const;
    Double_t             GetEfficiencyRel() const;
@@ -159,6 +187,8 @@ public:
    Int_t                ReadBuffer(char *buf, Long64_t pos, Int_t len) override;
    virtual Int_t        ReadBufferNormal(char *buf, Long64_t pos, Int_t len);
    virtual Int_t        ReadBufferPrefetch(char *buf, Long64_t pos, Int_t len);
+   static std::unique_ptr<ROOT::Internal::TTreeCacheReadAhead>
+                        ReadAhead(TTree &tree, const std::vector<std::string> &branchNames, Long64_t maxBytes);
    virtual void         ResetCache();
    void                 ResetMissCache(); // Reset the miss cache.
    void                 SetAutoCreated(Bool_t val) {fAutoCreated = val;}
@@ -168,6 +198,7 @@ public:
    virtual void         SetLearnPrefill(EPrefillType type = kNoPrefill);
    static void          SetLearnEntries(Int_t n = 10);
    void                 SetOptimizeMisses(Bool_t opt);
+   void                 SetReadAhead(std::unique_ptr<ROOT::Internal::TTreeCacheReadAhead> readAhead);
    void                 StartLearningPhase();
    virtual void         StopLearningPhase();
    virtual void         UpdateBranches(TTree *tree);
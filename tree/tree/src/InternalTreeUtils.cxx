@@ -360,6 +360,8 @@ std::unique_ptr<TChain> MakeChainForMT(const std::string &name, const std::strin
 {
    auto c = std::make_unique<TChain>(name.c_str(), title.c_str(), TChain::kWithoutGlobalRegistration);
    c->ResetBit(TObject::kMustCleanup);
+   // These chains are read from tasks of the pool, which must not wait for other tasks
+   c->SetOpenAhead(false);
    return c;
 }
 
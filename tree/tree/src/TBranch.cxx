@@ -1422,6 +1422,87 @@ Int_t TBranch::GetBasketAndFirst(TBasket *&basket, Long64_t &first,
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Load the basket starting at `entry` into `user_buf` for the bulk IO
+/// interfaces, taking over the buffer of the basket instead of copying it
+/// when possible.
+///
+/// Returns -1 in case of a failure (`caller` is used in the error messages).
+/// On success, returns the number of entries in the basket, with `basket`
+/// set and the offset of `user_buf` at the beginning of the entries; the
+/// caller must then call ReleaseBulkBasket().
+
+Int_t TBranch::LoadBulkBasket(Long64_t entry, TBuffer &user_buf, TBasket *&basket, const char *caller,
+                              Bool_t reportPartialCluster)
+{
+   // Remember which entry we are reading.
+   fReadEntry = entry;
+
+   Bool_t enabled = !TestBit(kDoNotProcess);
+   if (R__unlikely(!enabled)) return -1;
+   Long64_t first;
+   Int_t result = GetBasketAndFirst(basket, first, &user_buf);
+   if (R__unlikely(result < 0)) return -1;
+   // Only support reading from full clusters.
+   if (R__unlikely(entry != first)) {
+      if (reportPartialCluster)
+         Error(caller, "Failed to read from full cluster; first entry is %lld; requested entry is %lld.\n", first, entry);
+      return -1;
+   }
+
+   basket->PrepareBasket(entry);
+   TBuffer* buf = basket->GetBufferRef();
+
+   // Test for very old ROOT files.
+   if (R__unlikely(!buf)) {
+      Error(caller, "Failed to get a new buffer.\n");
+      return -1;
+   }
+   // Test for displacements, which aren't supported in fast mode.
+   if (R__unlikely(basket->GetDisplacement())) {
+      Error(caller, "Basket has displacement.\n");
+      return -1;
+   }
+
+   if (&user_buf != buf) {
+      // The basket was already in memory and might (and might not) be backed by persistent
+      // storage.
+      R__ASSERT(result == fReadBasket);
+      if (fBasketSeek[fReadBasket]) {
+         // It is backed, so we can be destructive
+         user_buf.SetBuffer(buf->Buffer(), buf->BufferSize());
+         buf->ResetBit(TBufferIO::kIsOwner);
+         fCurrentBasket = nullptr;
+         fBaskets[fReadBasket] = nullptr;
+      } else {
+         // This is the only copy, we can't return it as is to the user, just make a copy.
+         if (user_buf.BufferSize() < buf->BufferSize()) {
+            user_buf.AutoExpand(buf->BufferSize());
+         }
+         memcpy(user_buf.Buffer(), buf->Buffer(), buf->BufferSize());
+      }
+   }
+
+   Int_t bufbegin = basket->GetKeylen();
+   user_buf.SetBufferOffset(bufbegin);
+
+   return ((fNextBasketEntry < 0) ? fEntryNumber : fNextBasketEntry) - first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Complete a bulk read started with LoadBulkBasket(): if the buffer of the
+/// basket was handed over to the user buffer, keep the basket aside so that
+/// it does not delete it.
+
+void TBranch::ReleaseBulkBasket(TBasket *basket)
+{
+   if (fCurrentBasket == nullptr) {
+      R__ASSERT(fExtraBasket == nullptr && "fExtraBasket should have been set to nullptr by GetFreshBasket");
+      fExtraBasket = basket;
+      basket->DisownBuffer();
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns true if this branch supports bulk IO, false otherwise.
 ///
@@ -1475,70 +1556,19 @@ Int_t TBranch::GetBulkEntries(Long64_t entry, TBuffer &user_buf)
       return -1;
    }
 
-   // Remember which entry we are reading.
-   fReadEntry = entry;
-
-   Bool_t enabled = !TestBit(kDoNotProcess);
-   if (R__unlikely(!enabled)) return -1;
    TBasket *basket = nullptr;
-   Long64_t first;
-   Int_t result = GetBasketAndFirst(basket, first, &user_buf);
-   if (R__unlikely(result < 0)) return -1;
-   // Only support reading from full clusters.
-   if (R__unlikely(entry != first)) {
-       //printf("Failed to read from full cluster; first entry is %ld; requested entry is %ld.\n", first, entry);
-       return -1;
-   }
+   Int_t N = LoadBulkBasket(entry, user_buf, basket, "GetBulkEntries", kFALSE);
+   if (R__unlikely(N < 0)) return -1;
+   Int_t bufbegin = user_buf.Length();
 
-   basket->PrepareBasket(entry);
-   TBuffer* buf = basket->GetBufferRef();
-
-   // Test for very old ROOT files.
-   if (R__unlikely(!buf)) {
-      Error("GetBulkEntries", "Failed to get a new buffer.\n");
-      return -1;
-   }
-   // Test for displacements, which aren't supported in fast mode.
-   if (R__unlikely(basket->GetDisplacement())) {
-      Error("GetBulkEntries", "Basket has displacement.\n");
-      return -1;
-   }
-
-   if (&user_buf != buf) {
-      // The basket was already in memory and might (and might not) be backed by persistent
-      // storage.
-      R__ASSERT(result == fReadBasket);
-      if (fBasketSeek[fReadBasket]) {
-         // It is backed, so we can be destructive
-         user_buf.SetBuffer(buf->Buffer(), buf->BufferSize());
-         buf->ResetBit(TBufferIO::kIsOwner);
-         fCurrentBasket = nullptr;
-         fBaskets[fReadBasket] = nullptr;
-      } else {
-         // This is the only copy, we can't return it as is to the user, just make a copy.
-         if (user_buf.BufferSize() < buf->BufferSize()) {
-            user_buf.AutoExpand(buf->BufferSize());
-         }
-         memcpy(user_buf.Buffer(), buf->Buffer(), buf->BufferSize());
-      }
-   }
-
-   Int_t bufbegin = basket->GetKeylen();
-   user_buf.SetBufferOffset(bufbegin);
-
-   Int_t N = ((fNextBasketEntry < 0) ? fEntryNumber : fNextBasketEntry) - first;
-   //printf("Requesting %d events; fNextBasketEntry=%lld; first=%lld.\n", N, fNextBasketEntry, first);
+   //printf("Requesting %d events; fNextBasketEntry=%lld; first=%lld.\n", N, fNextBasketEntry, entry);
    if (R__unlikely(!leaf->ReadBasketFast(user_buf, N))) {
       Error("GetBulkEntries", "Leaf failed to read.\n");
       return -1;
    }
    user_buf.SetBufferOffset(bufbegin);
 
-   if (fCurrentBasket == nullptr) {
-      R__ASSERT(fExtraBasket == nullptr && "fExtraBasket should have been set to nullptr by GetFreshBasket");
-      fExtraBasket = basket;
-      basket->DisownBuffer();
-   }
+   ReleaseBulkBasket(basket);
 
    return N;
 }
@@ -1576,9 +1606,6 @@ Int_t TBranch::GetBulkEntries(Long64_t entry, TBuffer &user_buf)
 ///
 Int_t TBranch::GetEntriesSerialized(Long64_t entry, TBuffer &user_buf, TBuffer *count_buf)
 {
-   // TODO: Template this and TBranch::GetBulkEntries; only difference is the TLeaf function (ReadBasketFast vs
-   // ReadBasketSerialized
-
    // TODO: eventually support multiple leaves.
    if (R__unlikely(fNleaves != 1)) { return -1; }
    TLeaf *leaf = static_cast<TLeaf*>(fLeaves.UncheckedAt(0));
@@ -1587,61 +1614,10 @@ Int_t TBranch::GetEntriesSerialized(Long64_t entry, TBuffer &user_buf, TBuffer *
       return -1;
    }
 
-   // Remember which entry we are reading.
-   fReadEntry = entry;
-
-   Bool_t enabled = !TestBit(kDoNotProcess);
-   if (R__unlikely(!enabled)) { return -1; }
    TBasket *basket = nullptr;
-   Long64_t first;
-   Int_t result = GetBasketAndFirst(basket, first, &user_buf);
-   if (R__unlikely(result < 0)) { return -1; }
-   // Only support reading from full clusters.
-   if (R__unlikely(entry != first)) {
-       Error("GetEntriesSerialized", "Failed to read from full cluster; first entry is %lld; requested entry is %lld.\n", first, entry);
-       return -1;
-   }
-
-   basket->PrepareBasket(entry);
-   TBuffer* buf = basket->GetBufferRef();
-
-   // Test for very old ROOT files.
-   if (R__unlikely(!buf)) {
-      Error("GetEntriesSerialized", "Failed to get a new buffer.\n");
-      return -1;
-   }
-   // Test for displacements, which aren't supported in fast mode.
-   if (R__unlikely(basket->GetDisplacement())) {
-      Error("GetEntriesSerialized", "Basket has displacement.\n");
-      return -1;
-   }
-
-   if (&user_buf != buf) {
-      // The basket was already in memory and might (and might not) be backed by persistent
-      // storage.
-      R__ASSERT(result == fReadBasket);
-      if (fBasketSeek[fReadBasket]) {
-         // It is backed, so we can be destructive
-         user_buf.SetBuffer(buf->Buffer(), buf->BufferSize());
-         buf->ResetBit(TBufferIO::kIsOwner);
-         fCurrentBasket = nullptr;
-         fBaskets[fReadBasket] = nullptr;
-      } else {
-         // This is the only copy, we can't return it as is to the user, just make a copy.
-         if (user_buf.BufferSize() < buf->BufferSize()) {
-            user_buf.AutoExpand(buf->BufferSize());
-         }
-         memcpy(user_buf.Buffer(), buf->Buffer(), buf->BufferSize());
-      }
-   }
-
-   Int_t bufbegin = basket->GetKeylen();
-   user_buf.SetBufferOffset(bufbegin);
-
-   Int_t N = ((fNextBasketEntry < 0) ? fEntryNumber : fNextBasketEntry) - first;
-   //Info("GetEntriesSerialized", "Requesting %d events; fNextBasketEntry=%lld; first=%lld.\n", N, fNextBasketEntry, first);
-
-   user_buf.SetBufferOffset(bufbegin);
+   Int_t N = LoadBulkBasket(entry, user_buf, basket, "GetEntriesSerialized", kTRUE);
+   if (R__unlikely(N < 0)) { return -1; }
+   //Info("GetEntriesSerialized", "Requesting %d events; fNextBasketEntry=%lld; first=%lld.\n", N, fNextBasketEntry, entry);
 
    if (count_buf) {
       TLeaf *count_leaf = leaf->GetLeafCount();
@@ -1666,12 +1642,160 @@ Int_t TBranch::GetEntriesSerialized(Long64_t entry, TBuffer &user_buf, TBuffer *
       }
    }
 
-   if (fCurrentBasket == nullptr) {
-      R__ASSERT(fExtraBasket == nullptr && "fExtraBasket should have been set to nullptr by GetFreshBasket");
-      fExtraBasket = basket;
-      basket->DisownBuffer();
+   ReleaseBulkBasket(basket);
+
+   return N;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Size in bytes of the elements of type `type` that can be read with
+/// GetBulkJaggedEntries(), or 0 if the type is not supported.
+
+Int_t TBranch::GetBulkJaggedTypeSize(EDataType type)
+{
+   switch (type) {
+   case kChar_t:
+   case kUChar_t:
+   case kBool_t: return 1;
+   case kShort_t:
+   case kUShort_t: return 2;
+   case kInt_t:
+   case kUInt_t:
+   case kFloat_t: return 4;
+   case kDouble_t:
+   case kLong64_t:
+   case kULong64_t: return 8;
+   default: return 0;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Describe how the entries of this branch are laid out in its baskets, if
+/// they are variable-length collections of a primitive type that can be read
+/// with GetBulkJaggedEntries(): `type` is set to the type of the elements
+/// and `headerSize` to the number of bytes preceding the elements of each
+/// entry.
+///
+/// This implementation supports variable-length arrays of primitive types
+/// (e.g. `x[n]/F`), which have no header; TBranchElement adds support for
+/// `std::vector`s of primitive types.
+
+Bool_t TBranch::GetBulkJaggedLayout(EDataType &type, Int_t &headerSize) const
+{
+   if (fNleaves != 1)
+      return kFALSE;
+   TLeaf *leaf = static_cast<TLeaf *>(fLeaves.UncheckedAt(0));
+   if (!leaf->GetLeafCount())
+      return kFALSE;
+   const auto deserializeType = leaf->GetDeserializeType();
+   if (deserializeType != TLeaf::DeserializeType::kInPlace && deserializeType != TLeaf::DeserializeType::kZeroCopy)
+      return kFALSE;
+   TDataType *dataType = gROOT->GetType(leaf->GetTypeName());
+   if (!dataType || GetBulkJaggedTypeSize(static_cast<EDataType>(dataType->GetType())) == 0)
+      return kFALSE;
+   type = static_cast<EDataType>(dataType->GetType());
+   headerSize = 0;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Returns true if this branch supports bulk IO through
+/// GetBulkJaggedEntries(), false otherwise.
+
+Bool_t TBranch::SupportsBulkJaggedRead() const
+{
+   EDataType type;
+   Int_t headerSize;
+   return GetBulkJaggedLayout(type, headerSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read as many entries as possible of a branch holding variable-length
+/// collections of a primitive type (variable-length arrays such as
+/// `x[n]/F` or `std::vector<float>`) into the given buffer, using zero-copy
+/// mechanisms.
+///
+/// Returns -1 in case of a failure.  On success, returns the number N of
+/// entries currently in the buffer: the elements of all entries are stored
+/// contiguously and already deserialized starting at `user_buf.GetCurrent()`,
+/// and `offsets` holds N+1 values such that the elements of the i-th entry
+/// are those with indices in `[offsets[i], offsets[i+1])`:
+///
+///     auto values = reinterpret_cast<T*>(user_buf.GetCurrent());
+///     for (Int_t j = offsets[i]; j < offsets[i + 1]; ++j)
+///        use(values[j]);
+///
+/// where T is the type of the elements.  The per-entry headers of
+/// `std::vector`s are removed and all elements are byte-swapped in a single
+/// pass over the buffer.
+///
+/// As for GetBulkEntries(), `entry` must be the first entry of a basket.
+///
+/// NOTES:
+/// - This interface is meant to be used by higher-level, type-safe wrappers, not
+///   by end-users.
+
+Int_t TBranch::GetBulkJaggedEntries(Long64_t entry, TBuffer &user_buf, std::vector<Int_t> &offsets)
+{
+   EDataType type;
+   Int_t headerSize;
+   if (R__unlikely(!GetBulkJaggedLayout(type, headerSize))) return -1;
+   const Int_t typeSize = GetBulkJaggedTypeSize(type);
+
+   TBasket *basket = nullptr;
+   Int_t N = LoadBulkBasket(entry, user_buf, basket, "GetBulkJaggedEntries", kFALSE);
+   if (R__unlikely(N < 0)) return -1;
+   // The offsets may have to be computed from the basket buffer, so get them before releasing it.
+   const Int_t *entryOffsets = basket->GetEntryOffset();
+   const Int_t last = basket->GetLast();
+   ReleaseBulkBasket(basket);
+   if (R__unlikely(!entryOffsets)) {
+      Error("GetBulkJaggedEntries", "Basket has no entry offsets.\n");
+      return -1;
    }
 
+   // Remove the headers, if any, so that the elements of all entries are contiguous.
+   const Int_t bufbegin = user_buf.Length();
+   char *data = user_buf.Buffer();
+   offsets.resize(N + 1);
+   offsets[0] = 0;
+   Int_t dst = bufbegin;
+   for (Int_t i = 0; i < N; ++i) {
+      const Int_t begin = entryOffsets[i];
+      const Int_t end = (i + 1 < N) ? entryOffsets[i + 1] : last;
+      const Int_t nbytes = end - begin - headerSize;
+      if (R__unlikely(begin < dst || nbytes < 0 || nbytes % typeSize)) {
+         Error("GetBulkJaggedEntries", "Unexpected size of entry %lld.\n", entry + i);
+         return -1;
+      }
+      if (headerSize) {
+         // std::vector streamed as: byte count, version, number of elements
+         const UInt_t kByteCountMask = 0x40000000;
+         char *header = data + begin;
+         UInt_t byteCount;
+         Version_t version;
+         Int_t nElements;
+         frombuf(header, &byteCount);
+         frombuf(header, &version);
+         frombuf(header, &nElements);
+         if (R__unlikely(!(byteCount & kByteCountMask) || Int_t(byteCount & ~kByteCountMask) != end - begin - 4 ||
+                         Long64_t(nElements) * typeSize != nbytes)) {
+            Error("GetBulkJaggedEntries", "Unexpected serialization of entry %lld.\n", entry + i);
+            return -1;
+         }
+      }
+      if (dst != begin + headerSize)
+         memmove(data + dst, data + begin + headerSize, nbytes);
+      dst += nbytes;
+      offsets[i + 1] = (dst - bufbegin) / typeSize;
+   }
+
+   if (typeSize > 1 && R__unlikely(!user_buf.ByteSwapBuffer(offsets[N], type))) {
+      Error("GetBulkJaggedEntries", "Failed to byte-swap the elements.\n");
+      return -1;
+   }
+   user_buf.SetBufferOffset(bufbegin);
+
    return N;
 }
 
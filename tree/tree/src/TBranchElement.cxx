@@ -2835,6 +2835,28 @@ Int_t TBranchElement::GetExpectedType(TClass *&expectedClass,EDataType &expected
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Unsplit top-level branches holding a `std::vector` of a primitive type
+/// (other than bool) can be read with GetBulkJaggedEntries(): each entry is
+/// the byte count, the version and the number of elements, followed by the
+/// elements.
+
+Bool_t TBranchElement::GetBulkJaggedLayout(EDataType &type, Int_t &headerSize) const
+{
+   if (fID != -1 || fType != 0 || fBranches.GetEntriesFast() || fNleaves != 1)
+      return kFALSE;
+   TClass *cl = fBranchClass.GetClass();
+   TVirtualCollectionProxy *proxy = cl ? cl->GetCollectionProxy() : nullptr;
+   if (!proxy || proxy->GetCollectionType() != ROOT::kSTLvector || proxy->GetValueClass() || proxy->HasPointers())
+      return kFALSE;
+   const EDataType valueType = proxy->GetType();
+   if (valueType == kBool_t || GetBulkJaggedTypeSize(valueType) == 0)
+      return kFALSE;
+   type = valueType;
+   headerSize = 10;
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the 'full' name of the branch.  In particular prefix  the mother's name
 /// when it does not end in a trailing dot and thus is not part of the branch name
@@ -28,7 +28,9 @@ the trees in the chain.
 
 #include <iostream>
 #include <cfloat>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "TBranch.h"
 #include "TBrowser.h"
@@ -37,6 +39,7 @@ the trees in the chain.
 #include "TClass.h"
 #include "TColor.h"
 #include "TCut.h"
+#include "TEnv.h"
 #include "TError.h"
 #include "TFile.h"
 #include "TFileInfo.h"
@@ -63,8 +66,59 @@ the trees in the chain.
 #include "strlcpy.h"
 #include "snprintf.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TTaskGroup.hxx"
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 ClassImp(TChain);
 
+namespace {
+
+/// Number of entries and packet size of a tree, as read from its header.
+struct TreeHeaderInfo {
+   Long64_t fEntries = 0;
+   Int_t fPacketSize = 0;
+   Int_t fLoadResult = 0; ///< 0 on success, -3 if the file cannot be opened, -4 if the tree cannot be found
+};
+
+/// Open a file without registering it in the global lists and read the header of the tree `treename`.
+/// Thread-safe once ROOT::EnableThreadSafety() has been called.
+TreeHeaderInfo ReadTreeHeader(const char *filename, const char *treename)
+{
+   TreeHeaderInfo info;
+   TDirectory::TContext ctxt;
+   std::unique_ptr<TFile> file(TFile::Open(filename, "READ_WITHOUT_GLOBALREGISTRATION"));
+   if (!file || file->IsZombie()) {
+      info.fLoadResult = -3;
+      return info;
+   }
+   // Note: the tree is owned by the file.
+   auto tree = dynamic_cast<TTree *>(file->Get(treename));
+   if (!tree) {
+      info.fLoadResult = -4;
+      return info;
+   }
+   info.fEntries = tree->GetEntries();
+   info.fPacketSize = tree->GetPacketSize();
+   return info;
+}
+
+#ifdef R__USE_IMT
+/// Read the headers of the trees `names[i]` in the files `files[i]` using the implicit multi-threading pool.
+std::vector<TreeHeaderInfo>
+ReadTreeHeadersParallel(const std::vector<std::string> &files, const std::vector<std::string> &names)
+{
+   std::vector<TreeHeaderInfo> infos(files.size());
+   auto read = [&](unsigned int i) { infos[i] = ReadTreeHeader(files[i].c_str(), names[i].c_str()); };
+   ROOT::TThreadExecutor pool;
+   pool.Foreach(read, ROOT::TSeqU(files.size()));
+   return infos;
+}
+#endif
+
+} // anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor.
 
@@ -76,6 +130,7 @@ TChain::TChain(Mode mode)
    fFiles = new TObjArray(fTreeOffsetLen);
    fStatus = new TList();
    fTreeOffset[0]  = 0;
+   fOpenAhead = gEnv->GetValue("TChain.OpenAhead", 0) != 0;
    if (fGlobalRegistration) {
       gROOT->GetListOfSpecials()->Add(this);
    }
@@ -148,6 +203,7 @@ TChain::TChain(const char *name, const char *title, Mode mode)
    fFiles = new TObjArray(fTreeOffsetLen);
    fStatus = new TList();
    fTreeOffset[0]  = 0;
+   fOpenAhead = gEnv->GetValue("TChain.OpenAhead", 0) != 0;
    fFile = 0;
 
    // Reset PROOF-related bits
@@ -179,6 +235,7 @@ TChain::~TChain()
    }
 
    SafeDelete(fProofChain);
+   TakeOpenAheadFile(-1);
    fStatus->Delete();
    delete fStatus;
    fStatus = 0;
@@ -341,6 +398,10 @@ Int_t TChain::Add(TChain* chain)
 ///   TChain::GetEntries instead will force all the tree headers in the chain to
 ///   be read to get the number of entries in each tree.
 ///
+/// If implicit multi-threading is enabled (ROOT::EnableImplicitMT()), the tree
+/// headers of the files matching a wildcard with <tt>nentries <= 0</tt>, as well
+/// as the ones read by TChain::GetEntries, are read in parallel.
+///
 /// <h4>The %TChain data structure</h4>
 /// Each element of the chain is a TChainElement object. It has a name equal to
 /// the tree name of this chain (or the name of the specific tree in the added
@@ -401,6 +462,8 @@ Int_t TChain::Add(const char* name, Long64_t nentries /* = TTree::kMaxEntries */
       TIter next(&l);
       TObjString *obj;
       const TString hashMarkTreeName{"#" + treename};
+      // The names and tree names to pass to AddFile
+      std::vector<std::pair<TString, TString>> toAdd;
       while ((obj = (TObjString*)next())) {
          file = obj->GetName();
          if (suffix == hashMarkTreeName) {
@@ -412,12 +475,53 @@ Int_t TChain::Add(const char* name, Long64_t nentries /* = TTree::kMaxEntries */
             // file name that TChain won't be able to open afterwards. Thus,
             // we do not pass the 'suffix' as part of the file name, instead we
             // directly pass 'treename' to `AddFile`.
-            nf += AddFile(TString::Format("%s/%s", directory.Data(), file), nentries, treename);
+            toAdd.emplace_back(TString::Format("%s/%s", directory.Data(), file), treename);
          } else {
-            nf += AddFile(TString::Format("%s/%s%s", directory.Data(), file, suffix.Data()), nentries);
+            toAdd.emplace_back(TString::Format("%s/%s%s", directory.Data(), file, suffix.Data()), "");
          }
       }
       l.Delete();
+
+#ifdef R__USE_IMT
+      if (nentries <= 0 && toAdd.size() > 1 && ROOT::IsImplicitMTEnabled()) {
+         // The tree headers must be read: do it in parallel, then add the files
+         // with their number of entries as AddFile would have done.
+         std::vector<std::string> files, names;
+         for (auto &nameAndTree : toAdd) {
+            TString fbasename, ftreename, fquery, fsuffix;
+            ParseTreeFilename(nameAndTree.first, fbasename, ftreename, fquery, fsuffix);
+            files.emplace_back((fbasename + fquery).Data());
+            if (!ftreename.IsNull())
+               names.emplace_back(ftreename.Data());
+            else if (!nameAndTree.second.IsNull())
+               names.emplace_back(nameAndTree.second.Data());
+            else
+               names.emplace_back(GetName());
+         }
+         auto infos = ReadTreeHeadersParallel(files, names);
+         for (std::size_t i = 0; i < toAdd.size(); ++i) {
+            if (infos[i].fLoadResult == -3) {
+               // TFile::Open already complained
+               continue;
+            } else if (infos[i].fLoadResult == -4) {
+               Error("AddFile", "cannot find tree with name %s in file %s", names[i].c_str(), files[i].c_str());
+               continue;
+            } else if (infos[i].fEntries <= 0) {
+               Warning("AddFile", "Adding tree with no entries from file: %s", files[i].c_str());
+               ++nf;
+               continue;
+            }
+            if (AddFile(toAdd[i].first, infos[i].fEntries, toAdd[i].second)) {
+               static_cast<TChainElement *>(fFiles->Last())->SetPacketSize(infos[i].fPacketSize);
+               ++nf;
+            }
+         }
+         toAdd.clear();
+      }
+#endif
+
+      for (auto &nameAndTree : toAdd)
+         nf += AddFile(nameAndTree.first, nentries, nameAndTree.second);
    }
    if (fProofChain)
       // This updates the proxy chain when we will really use PROOF
@@ -966,7 +1070,8 @@ Long64_t TChain::GetChainEntryNumber(Long64_t entry) const
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the total number of entries in the chain.
 /// In case the number of entries in each tree is not yet known,
-/// the offset table is computed.
+/// the offset table is computed. If implicit multi-threading is enabled,
+/// the missing tree headers are read in parallel.
 
 Long64_t TChain::GetEntries() const
 {
@@ -977,6 +1082,9 @@ Long64_t TChain::GetEntries() const
                                " run TChain::SetProof(kTRUE, kTRUE) first");
       return fProofChain->GetEntries();
    }
+   if (fEntries == TTree::kMaxEntries) {
+      const_cast<TChain*>(this)->ReadTreeHeaders();
+   }
    if (fEntries == TTree::kMaxEntries) {
       const_cast<TChain*>(this)->LoadTree(TTree::kMaxEntries-1);
    }
@@ -1440,6 +1548,9 @@ Long64_t TChain::LoadTree(Long64_t entry)
       }
    }
 
+   // Used below to detect that the chain is read sequentially.
+   const Int_t previousTreeNumber = fTreeNumber;
+
    // Delete the current tree and open the new tree.
    TTreeCache* tpf = 0;
    // Delete file unless the file owns this chain!
@@ -1508,8 +1619,11 @@ Long64_t TChain::LoadTree(Long64_t entry)
    //        if we did not delete it above.
    {
       TDirectory::TContext ctxt;
-      const char *option = fGlobalRegistration ? "READ" : "READ_WITHOUT_GLOBALREGISTRATION";
-      fFile = TFile::Open(element->GetTitle(), option);
+      fFile = TakeOpenAheadFile(treenum);
+      if (!fFile) {
+         const char *option = fGlobalRegistration ? "READ" : "READ_WITHOUT_GLOBALREGISTRATION";
+         fFile = TFile::Open(element->GetTitle(), option);
+      }
       if (fFile && fGlobalRegistration)
          fFile->SetBit(kMustCleanup);
    }
@@ -1555,6 +1669,11 @@ Long64_t TChain::LoadTree(Long64_t entry)
          tpf->UpdateBranches(fTree);
          tpf->ResetCache();
          fFile->SetCacheRead(tpf, fTree);
+#ifdef R__USE_IMT
+         // The first cluster may have been read with the file, in the background.
+         if (fOpenAheadBaskets)
+            tpf->SetReadAhead(std::move(fOpenAheadBaskets));
+#endif
       } else {
          // FIXME: One of the file in the chain is missing
          // we have no place to hold the pointer to the
@@ -1568,6 +1687,13 @@ Long64_t TChain::LoadTree(Long64_t entry)
       }
    }
 
+   // When moving on to the next tree, open the one after in the background
+   // while this one is being processed, and read its first cluster for the
+   // branches that the cache has learned.
+   if (fOpenAhead && previousTreeNumber >= 0 && treenum == previousTreeNumber + 1) {
+      StartOpenAhead(treenum + 1, tpf);
+   }
+
    // Check if fTreeOffset has really been set.
    Long64_t nentries = 0;
    if (fTree) {
@@ -2220,6 +2346,132 @@ void TChain::ParseTreeFilename(const char *name, TString &filename, TString &tre
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read in parallel the headers of the trees whose number of entries is not
+/// known yet and update the offset table accordingly.
+/// This is only done if implicit multi-threading is enabled. As in LoadTree,
+/// the trees which cannot be read count as empty and their load result is set.
+
+void TChain::ReadTreeHeaders()
+{
+#ifdef R__USE_IMT
+   if (!ROOT::IsImplicitMTEnabled())
+      return;
+
+   std::vector<Int_t> treenums;
+   std::vector<std::string> files, names;
+   for (Int_t i = 0; i < fNtrees; ++i) {
+      auto element = static_cast<TChainElement *>(fFiles->At(i));
+      if (element->GetEntries() == TTree::kMaxEntries) {
+         treenums.push_back(i);
+         files.emplace_back(element->GetTitle());
+         names.emplace_back(element->GetName());
+      }
+   }
+   // Nothing to gain with respect to LoadTree
+   if (treenums.size() < 2)
+      return;
+
+   auto infos = ReadTreeHeadersParallel(files, names);
+   for (std::size_t i = 0; i < treenums.size(); ++i) {
+      auto element = static_cast<TChainElement *>(fFiles->At(treenums[i]));
+      if (infos[i].fLoadResult == -4)
+         Error("LoadTree", "Cannot find tree with name %s in file %s", element->GetName(), element->GetTitle());
+      if (infos[i].fLoadResult != 0)
+         element->SetLoadResult(infos[i].fLoadResult);
+      element->SetNumberEntries(infos[i].fEntries);
+   }
+
+   for (Int_t i = 0; i < fNtrees; ++i) {
+      const Long64_t nentries = static_cast<TChainElement *>(fFiles->At(i))->GetEntries();
+      if (fTreeOffset[i] == TTree::kMaxEntries || nentries == TTree::kMaxEntries)
+         fTreeOffset[i + 1] = TTree::kMaxEntries;
+      else
+         fTreeOffset[i + 1] = fTreeOffset[i] + nentries;
+   }
+   fEntries = fTreeOffset[fNtrees];
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Start opening the file of the tree number `treenum` (and reading the tree
+/// header) in the background, using the implicit multi-threading pool.
+/// If `cache` is done learning, the baskets of the first cluster of its
+/// branches are read as well (see TTreeCache::ReadAhead).
+/// LoadTree picks them up with TakeOpenAheadFile.
+
+void TChain::StartOpenAhead(Int_t treenum, TTreeCache *cache)
+{
+#ifdef R__USE_IMT
+   // The waiting thread does not run other tasks in the meantime (see TakeOpenAheadFile),
+   // so another thread of the pool must be available to open the file.
+   if (!ROOT::IsImplicitMTEnabled() || ROOT::GetThreadPoolSize() < 2 || treenum >= fNtrees)
+      return;
+   // Drop the file of a previous request, if it was not used.
+   TakeOpenAheadFile(-1);
+   fOpenAheadBaskets.reset();
+
+   auto element = static_cast<TChainElement *>(fFiles->At(treenum));
+   const std::string filename = element->GetTitle();
+   const std::string treename = element->GetName();
+   const bool globalRegistration = fGlobalRegistration;
+   std::vector<std::string> branchNames;
+   Long64_t cacheSize = 0;
+   if (cache && !cache->IsLearning() && !cache->IsEnablePrefetching()) {
+      branchNames = cache->GetCachedBranchNames();
+      cacheSize = cache->GetBufferSize();
+   }
+   fOpenAheadTreeNumber = treenum;
+   fOpenAheadTask.reset(new ROOT::Experimental::TTaskGroup());
+   fOpenAheadTask->Run([this, filename, treename, globalRegistration, branchNames, cacheSize]() {
+      TDirectory::TContext ctxt;
+      const char *option = globalRegistration ? "READ" : "READ_WITHOUT_GLOBALREGISTRATION";
+      TFile *file = TFile::Open(filename.c_str(), option);
+      if (file && !file->IsZombie()) {
+         if (globalRegistration)
+            file->SetBit(kMustCleanup);
+         // The tree stays in the list of objects of the file, where LoadTree finds it.
+         auto tree = dynamic_cast<TTree *>(file->Get(treename.c_str()));
+         if (tree && !branchNames.empty())
+            fOpenAheadBaskets = TTreeCache::ReadAhead(*tree, branchNames, cacheSize);
+      }
+      fOpenAheadFile = file;
+   });
+#else
+   (void)treenum;
+   (void)cache;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the file being opened in the background, if any. Return it if it
+/// is the file of the tree number `treenum` (the caller then owns it),
+/// otherwise delete it and return nullptr.
+
+TFile *TChain::TakeOpenAheadFile(Int_t treenum)
+{
+#ifdef R__USE_IMT
+   if (!fOpenAheadTask)
+      return nullptr;
+   // Do not let the waiting thread pick up unrelated tasks: the caller can itself be a
+   // task of the pool (e.g. processing an entry) which must not be interleaved with other work.
+   fOpenAheadTask->WaitIsolated();
+   fOpenAheadTask.reset();
+   TFile *file = fOpenAheadFile.exchange(nullptr);
+   const bool matches = (fOpenAheadTreeNumber == treenum);
+   fOpenAheadTreeNumber = -1;
+   if (!file || !matches) {
+      fOpenAheadBaskets.reset();
+      delete file;
+      file = nullptr;
+   }
+   return file;
+#else
+   (void)treenum;
+   return nullptr;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Print the header information of each tree in the chain.
 /// See TTree::Print for a list of options.
@@ -2301,6 +2553,11 @@ void TChain::RecursiveRemove(TObject *obj)
    if (fTree == obj) {
       fTree = 0;
    }
+#ifdef R__USE_IMT
+   if (fOpenAheadFile.load() == obj) {
+      fOpenAheadFile = nullptr;
+   }
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2331,6 +2588,7 @@ void TChain::RemoveFriend(TTree* oldFriend)
 
 void TChain::Reset(Option_t*)
 {
+   TakeOpenAheadFile(-1);
    delete fFile;
    fFile = 0;
    fNtrees         = 0;
@@ -2353,6 +2611,7 @@ void TChain::Reset(Option_t*)
 
 void TChain::ResetAfterMerge(TFileMergeInfo *info)
 {
+   TakeOpenAheadFile(-1);
    fNtrees         = 0;
    fTreeNumber     = -1;
    fTree           = 0;
@@ -2970,6 +3229,29 @@ void TChain::SetName(const char* name)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable the opening of the next file of the chain in the
+/// background while the current one is being processed.
+///
+/// This only takes effect if implicit multi-threading is enabled with at least two
+/// threads, and only when the chain is read sequentially: the next file is opened
+/// (and its tree header read) when LoadTree moves from one tree to the following
+/// one. It is disabled by default; the default can be changed with the rootrc
+/// option `TChain.OpenAhead`.
+///
+/// The thread moving to the next tree waits for the file without running other
+/// tasks of the pool. The open-ahead should therefore not be enabled on chains
+/// read from tasks of the implicit multi-threading pool, which could all end up
+/// waiting for files that no thread is left to open; the chains built internally
+/// by TTreeProcessorMT and RDataFrame never use it.
+
+void TChain::SetOpenAhead(Bool_t openahead)
+{
+   fOpenAhead = openahead;
+   if (!fOpenAhead)
+      TakeOpenAheadFile(-1);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set number of entries per packet for parallel root.
 
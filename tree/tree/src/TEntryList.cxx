@@ -55,6 +55,8 @@ End_Macro
 - __Subtract__() - if the lists are for the same TTree, removes the entries of the second
                list from the first list. If the lists are for TChains, loops over all
                sub-lists
+- __Intersect__() - keeps only the entries which are also in the second list. If the lists
+                are for TChains, loops over all sub-lists
 - __GetEntry(n)__ - returns the n-th entry number
 - __Next__()      - returns next entry number. Note, that this function is
                 much faster than GetEntry, and it's called when GetEntry() is called
@@ -155,6 +157,8 @@ See comments to those functions for more details
 #include "TSystem.h"
 #include "TObjString.h"
 
+#include <algorithm>
+
 ClassImp(TEntryList);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -698,6 +702,32 @@ Bool_t TEntryList::Enter(Long64_t localentry, const char *treename, const char *
 
 void TEntryList::EnterRange(Long64_t start, Long64_t end, TTree *tree, UInt_t step)
 {
+   if (!tree && !fLists && step == 1U && IsA() == TEntryList::Class()) {
+      //fill whole blocks at once
+      start = std::max(start, 0LL);
+      if (start >= end) return;
+      if (!fBlocks) fBlocks = new TObjArray();
+      TEntryListBlock *block = 0;
+      Long64_t lastblock = (end-1)/kBlockSize;
+      if (lastblock >= fNBlocks) {
+         if (fNBlocks>0){
+            block = (TEntryListBlock*)fBlocks->UncheckedAt(fNBlocks-1);
+            block->OptimizeStorage();
+         }
+         for (Long64_t i=fNBlocks; i<=lastblock; i++){
+            block = new TEntryListBlock();
+            fBlocks->Add(block);
+         }
+         fNBlocks = lastblock+1;
+      }
+      for (Long64_t nblock=start/kBlockSize; nblock<=lastblock; nblock++) {
+         block = (TEntryListBlock*)fBlocks->UncheckedAt(nblock);
+         Long64_t first = nblock*kBlockSize;
+         fN += block->EnterRange(std::max(start, first) - first, std::min(end, first+kBlockSize) - first);
+         if (nblock < lastblock) block->OptimizeStorage();
+      }
+      return;
+   }
    for (auto entry = start; entry < end; entry += step) {
       this->Enter(entry, tree);
    }
@@ -1335,13 +1365,21 @@ void TEntryList::Subtract(const TEntryList *elist)
          //second list is also only for 1 tree
          if (!strcmp(elist->fTreeName.Data(),fTreeName.Data()) &&
              !strcmp(elist->fFileName.Data(),fFileName.Data())){
-            //same tree
-            Long64_t n2 = elist->GetN();
-            Long64_t entry;
-            for (Int_t i=0; i<n2; i++){
-               entry = (const_cast<TEntryList*>(elist))->GetEntry(i);
-               Remove(entry);
+            //same tree, subtract block by block
+            if (!elist->fBlocks) return;
+            TEntryListBlock *block1=0;
+            TEntryListBlock *block2=0;
+            Int_t nmin = TMath::Min(fNBlocks, elist->fNBlocks);
+            Long64_t nnew, nold;
+            for (Int_t i=0; i<nmin; i++){
+               block1 = (TEntryListBlock*)fBlocks->UncheckedAt(i);
+               block2 = (TEntryListBlock*)elist->fBlocks->UncheckedAt(i);
+               nold = block1->GetNPassed();
+               nnew = block1->Subtract(block2);
+               fN = fN - nold + nnew;
             }
+            fLastIndexQueried = -1;
+            fLastIndexReturned = 0;
          } else {
             //different trees
             return;
@@ -1376,6 +1414,93 @@ void TEntryList::Subtract(const TEntryList *elist)
    return;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all the entries of this entry list, that are not contained in elist
+
+void TEntryList::Intersect(const TEntryList *elist)
+{
+   if (!elist) return;
+   if (!fLists){
+      if (!fBlocks) return;
+      const TEntryList *other = elist;
+      if (elist->fLists){
+         //second list has sublists, try to find one for the same tree as this list
+         other = 0;
+         TIter next1(elist->GetLists());
+         TEntryList *templist = 0;
+         while ((templist = (TEntryList*)next1())){
+            if (!strcmp(templist->fTreeName.Data(),fTreeName.Data()) &&
+                !strcmp(templist->fFileName.Data(),fFileName.Data())){
+               other = templist;
+               break;
+            }
+         }
+      } else if (strcmp(elist->fTreeName.Data(),fTreeName.Data()) ||
+                 strcmp(elist->fFileName.Data(),fFileName.Data())){
+         //different trees
+         other = 0;
+      }
+      //intersect block by block; the blocks which are not in the other list
+      //are intersected with an empty block
+      TEntryListBlock empty;
+      Int_t nother = (other && other->fBlocks) ? other->fNBlocks : 0;
+      TEntryListBlock *block1=0;
+      TEntryListBlock *block2=0;
+      fN = 0;
+      for (Int_t i=0; i<fNBlocks; i++){
+         block1 = (TEntryListBlock*)fBlocks->UncheckedAt(i);
+         block2 = i < nother ? (TEntryListBlock*)other->fBlocks->UncheckedAt(i) : &empty;
+         fN += block1->Intersect(block2);
+      }
+      fLastIndexQueried = -1;
+      fLastIndexReturned = 0;
+   } else {
+      //this list has sublists
+      TIter next2(fLists);
+      TEntryList *templist = 0;
+      fN = 0;
+      while ((templist = (TEntryList*)next2())){
+         templist->Intersect(elist);
+         fN += templist->GetN();
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// For each of the entry numbers (sorted in increasing order), return the
+/// number of entries of this list which are smaller, i.e. the index in the list
+/// of the first entry which is not smaller. The numbers are computed from the
+/// blocks, without iterating over the entries.
+/// Only lists without sublists are supported: for the others, an empty vector
+/// is returned.
+
+std::vector<Long64_t> TEntryList::GetNEntriesBelow(const std::vector<Long64_t> &entries) const
+{
+   std::vector<Long64_t> result;
+   if (fLists) return result;
+   result.reserve(entries.size());
+   Int_t nblocks = fBlocks ? fNBlocks : 0;
+   TEntryListBlock *block = 0;
+   //number of entries in the blocks before iblock
+   Long64_t nbelow = 0;
+   Int_t iblock = 0;
+   for (auto entry : entries){
+      Long64_t nblock = entry < 0 ? 0 : entry/kBlockSize;
+      while (iblock < nblock && iblock < nblocks){
+         block = (TEntryListBlock*)fBlocks->UncheckedAt(iblock);
+         nbelow += block->GetNPassed();
+         iblock++;
+      }
+      if (iblock == nblock && iblock < nblocks){
+         block = (TEntryListBlock*)fBlocks->UncheckedAt(iblock);
+         result.push_back(nbelow + block->GetNPassedBelow(entry - nblock*kBlockSize));
+      } else {
+         result.push_back(nbelow);
+      }
+   }
+   return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 TEntryList operator||(TEntryList &elist1, TEntryList &elist2)
@@ -702,6 +702,25 @@ void TEntryListArray::Subtract(const TEntryList *elist)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all the entries of this entry list that are not contained in elist.
+/// The subentries of the remaining entries are kept
+
+void TEntryListArray::Intersect(const TEntryList *elist)
+{
+   if (!elist) return;
+
+   TEntryList::Intersect(elist);
+   if (!fLists && fSubLists) {
+      TEntryListArray *e = 0;
+      TIter next(fSubLists);
+      while ((e = (TEntryListArray*) next())) {
+         if (!Contains(e->fEntry))
+            RemoveSubList(e);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// If a list for a tree with such name and filename exists, sets it as the current sublist
 /// If not, creates this list and sets it as the current sublist
@@ -14,16 +14,22 @@
 
 Used by TEntryList to store the entry numbers.
 
-There are 2 ways to represent entry numbers in a TEntryListBlock:
+There are 3 ways to represent entry numbers in a TEntryListBlock:
 
  1. as bits, where passing entry numbers are assigned 1, not passing - 0
  2. as a simple array of entry numbers
   - storing the numbers of entries that pass
   - storing the numbers of entries that don't pass
-
-In both cases, a UShort_t* is used. The second option is better in case
-less than 1/16 or more than 15/16 of entries pass the selection, and the representation can be
-changed by calling OptimizeStorage() function.
+ 3. as runs of consecutive passing entries, each stored as its first and last
+    entry number
+
+In all cases, a UShort_t* is used. The second option is better in case
+less than 1/16 or more than 15/16 of entries pass the selection, the third one
+when the passing entries come in long runs, e.g. for selections on ranges of
+entries or on sorted quantities. The representation can be changed by calling
+OptimizeStorage() function, which chooses the smallest one. The third
+representation only exists in memory: a block of runs is written to file as
+bits or as a list, so that the files can be read by older versions of ROOT.
 When the block is being filled, it's always stored as bits, and the OptimizeStorage()
 function is called by TEntryList when it starts filling the next block. If
 Enter() or Remove() is called after OptimizeStorage(), representation is
@@ -35,19 +41,67 @@ End_Macro
 
 ## Operations on blocks (see also function comments)
 
- - __Merge__() - adds all entries from one block to the other. If the first block
-             uses array representation, it's changed to bits representation only
-             if the total number of passing entries is still less than kBlockSize
+ - __Merge__() - adds all entries from one block to the other
+ - __Subtract__() - removes all entries of the other block from this one
+ - __Intersect__() - removes all entries which are not in the other block
+
+   The set operations combine the blocks word by word in bits representation,
+   in loops that the compiler vectorizes, and optimize the storage of the result.
  - __GetEntry(n)__ - returns n-th non-zero entry.
  - __Next__()      - return next non-zero entry. In case of representation 1), Next()
                  is faster than GetEntry()
 */
 
 #include "TEntryListBlock.h"
+#include "TBuffer.h"
 #include "TString.h"
 
+#include <algorithm>
+#include <bitset>
+
 ClassImp(TEntryListBlock);
 
+namespace {
+
+/// Number of bits set in a word of the bits representation
+inline Int_t CountBits(UShort_t word)
+{
+   return std::bitset<16>(word).count();
+}
+
+/// Number of runs of consecutive bits set in the bits representation
+Int_t CountRuns(const UShort_t *bits, Int_t nwords)
+{
+   Int_t nruns = 0;
+   UShort_t carry = 0;
+   for (Int_t i = 0; i < nwords; i++) {
+      const UShort_t word = bits[i];
+      // the bits which start a run are set, and the bit before them is not
+      nruns += CountBits(word & ~((word << 1) | carry));
+      carry = word >> 15;
+   }
+   return nruns;
+}
+
+/// Set the bits from first to last (included)
+void FillBits(UShort_t *bits, Int_t first, Int_t last)
+{
+   Int_t i = first >> 4;
+   const Int_t ilast = last >> 4;
+   const UShort_t firstMask = 0xFFFF << (first & 15);
+   const UShort_t lastMask = 0xFFFF >> (15 - (last & 15));
+   if (i == ilast) {
+      bits[i] |= firstMask & lastMask;
+      return;
+   }
+   bits[i] |= firstMask;
+   for (i++; i < ilast; i++)
+      bits[i] = 0xFFFF;
+   bits[ilast] |= lastMask;
+}
+
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default c-tor
 
@@ -149,12 +203,33 @@ Bool_t TEntryListBlock::Enter(Int_t entry)
          return 0;
       }
    }
-   //list
+   //list or runs
    //change to bits
-   UShort_t *bits = new UShort_t[kBlockSize];
-   Transform(1, bits);
-   Enter(entry);
-   return 0;
+   ToBits();
+   return Enter(entry);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Enter all entries from start to end (excluded), switching to bits representation.
+/// Returns the number of entries which were not yet in the block
+
+Int_t TEntryListBlock::EnterRange(Int_t start, Int_t end)
+{
+   start = std::max(start, 0);
+   end = std::min(end, kBlockSize*16);
+   if (start >= end) return 0;
+   ToBits();
+   const Int_t ifirst = start >> 4;
+   const Int_t ilast = (end - 1) >> 4;
+   Int_t nold = 0;
+   for (Int_t i = ifirst; i <= ilast; i++)
+      nold += CountBits(fIndices[i]);
+   FillBits(fIndices, start, end - 1);
+   Int_t nnew = 0;
+   for (Int_t i = ifirst; i <= ilast; i++)
+      nnew += CountBits(fIndices[i]);
+   fNPassed += nnew - nold;
+   return nnew - nold;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -169,7 +244,7 @@ Bool_t TEntryListBlock::Remove(Int_t entry)
       Error("Remove", "Illegal entry value!\n");
       return 0;
    }
-   if (fType==0){
+   if (fType==0 && fIndices){
       Int_t i = entry>>4;
       Int_t j = entry & 15;
       if ((fIndices[i] & (1<<j))!=0){
@@ -180,12 +255,10 @@ Bool_t TEntryListBlock::Remove(Int_t entry)
          return 0;
       }
    }
-   //list
+   //list or runs
    //change to bits
-   UShort_t *bits = new UShort_t[kBlockSize];
-   Transform(1, bits);
+   ToBits();
    return Remove(entry);
-   //return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -206,6 +279,11 @@ Int_t TEntryListBlock::Contains(Int_t entry)
       Bool_t result = (fIndices[i] & (1<<j))!=0;
       return result;
    }
+   if (fType==2){
+      //runs
+      Int_t r = FindRun(entry);
+      return r < fN && fIndices[r] <= entry;
+   }
    //list
    if (entry < fCurrent) fCurrent = 0;
    if (fPassing && fIndices){
@@ -242,121 +320,68 @@ Int_t TEntryListBlock::Contains(Int_t entry)
 
 Int_t TEntryListBlock::Merge(TEntryListBlock *block)
 {
-   Int_t i, j;
    if (block->GetNPassed() == 0) return GetNPassed();
    if (GetNPassed() == 0){
       //this block is empty
-      fN = block->fN;
-      fIndices = new UShort_t[fN];
-      for (i=0; i<fN; i++)
-         fIndices[i] = block->fIndices[i];
-      fNPassed = block->fNPassed;
-      fType = block->fType;
-      fPassing = block->fPassing;
-      fCurrent = block->fCurrent;
-      fLastIndexReturned = -1;
-      fLastIndexQueried = -1;
-      return fNPassed;
+      *this = *block;
+      return GetNPassed();
    }
-   if (fType==0){
-      //stored as bits
-      if (block->fType == 0){
-         for (i=0; i<kBlockSize*16; i++){
-            if (block->Contains(i))
-               Enter(i);
-         }
-      } else {
-         if (block->fPassing){
-            //the other block stores entries that pass
-            for (i=0; i<block->fNPassed; i++){
-               Enter(block->fIndices[i]);
-            }
-         } else {
-            //the other block stores entries that don't pass
-            if (block->fNPassed==0){
-               for (i=0; i<kBlockSize*16; i++){
-                  Enter(i);
-               }
-            }
-            for (j=0; j<block->fIndices[0]; j++)
-               Enter(j);
-            for (i=0; i<block->fNPassed-1; i++){
-               for (j=block->fIndices[i]+1; j<block->fIndices[i+1]; j++){
-                  Enter(j);
-               }
-            }
-            for (j=block->fIndices[block->fNPassed-1]+1; j<kBlockSize*16; j++)
-               Enter(j);
-         }
-      }
+   return Combine(block, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove the entries of the other block from this one
+/// Returns the resulting number of entries in the block
+
+Int_t TEntryListBlock::Subtract(TEntryListBlock *block)
+{
+   if (block->GetNPassed() == 0 || GetNPassed() == 0) return GetNPassed();
+   return Combine(block, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove the entries which are not in the other block
+/// Returns the resulting number of entries in the block
+
+Int_t TEntryListBlock::Intersect(TEntryListBlock *block)
+{
+   if (GetNPassed() == 0) return 0;
+   return Combine(block, 2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Combine the bits of this block with the ones of the other block, word by word:
+/// - op=0 - union
+/// - op=1 - difference
+/// - op=2 - intersection
+/// Returns the resulting number of entries in the block
+
+Int_t TEntryListBlock::Combine(const TEntryListBlock *block, Int_t op)
+{
+   UShort_t *buffer = nullptr;
+   const UShort_t *other = block->fIndices;
+   if (block->fType != 0 || !other) {
+      buffer = new UShort_t[kBlockSize];
+      block->GetBits(buffer);
+      other = buffer;
+   }
+   ToBits();
+   UShort_t *bits = fIndices;
+   // plain loops over the words, which the compiler vectorizes
+   if (op == 0) {
+      for (Int_t i=0; i<kBlockSize; i++)
+         bits[i] |= other[i];
+   } else if (op == 1) {
+      for (Int_t i=0; i<kBlockSize; i++)
+         bits[i] &= ~other[i];
    } else {
-      //stored as a list
-      if (GetNPassed() + block->GetNPassed() > kBlockSize){
-         //change to bits
-         UShort_t *bits = new UShort_t[kBlockSize];
-         Transform(1, bits);
-         Merge(block);
-      } else {
-         //this is only possible if fPassing=1 in both blocks
-         if (block->fType==1){
-            //second block stored as a list
-            //make a bigger list
-            Int_t en = block->fNPassed;
-            Int_t newsize = fNPassed + en;
-            UShort_t *newlist = new UShort_t[newsize];
-            UShort_t *elst = block->fIndices;
-            Int_t newpos, elpos;
-            newpos = elpos = 0;
-            for (i=0; i<fNPassed; i++) {
-               while (elpos < en && fIndices[i] > elst[elpos]) {
-                  newlist[newpos] = elst[elpos];
-                  newpos++;
-                  elpos++;
-               }
-               if (fIndices[i] == elst[elpos]) elpos++;
-               newlist[newpos] = fIndices[i];
-               newpos++;
-            }
-            while (elpos < en) {
-               newlist[newpos] = elst[elpos];
-               newpos++;
-               elpos++;
-            }
-            delete [] fIndices;
-            fIndices = newlist;
-            fNPassed = newpos;
-            fN = fNPassed;
-         } else {
-            //second block is stored as bits
-
-            Int_t en = block->fNPassed;
-            Int_t newsize = fNPassed + en;
-            UShort_t *newlist = new UShort_t[newsize];
-            Int_t newpos, current;
-            newpos = current = 0;
-            for (i=0; i<kBlockSize*16; i++){
-               if (!block->Contains(i)) continue;
-               while(current < fNPassed && fIndices[current]<i){
-                  newlist[newpos] = fIndices[current];
-                  current++;
-                  newpos++;
-               }
-               if (fIndices[current]==i) current++;
-               newlist[newpos] = i;
-               newpos++;
-            }
-            while(current<fNPassed){
-               newlist[newpos] = fIndices[current];
-               newpos++;
-               current++;
-            }
-            delete [] fIndices;
-            fIndices = newlist;
-            fNPassed = newpos;
-            fN = fNPassed;
-         }
-      }
+      for (Int_t i=0; i<kBlockSize; i++)
+         bits[i] &= other[i];
    }
+   delete [] buffer;
+   fNPassed = 0;
+   for (Int_t i=0; i<kBlockSize; i++)
+      fNPassed += CountBits(bits[i]);
    fLastIndexQueried = -1;
    fLastIndexReturned = -1;
    OptimizeStorage();
@@ -367,7 +392,7 @@ Int_t TEntryListBlock::Merge(TEntryListBlock *block)
 /// Returns the number of entries, passing the selection.
 /// In case, when the block stores entries that pass (fPassing=1) returns fNPassed
 
-Int_t TEntryListBlock::GetNPassed()
+Int_t TEntryListBlock::GetNPassed() const
 {
    if (fPassing)
       return fNPassed;
@@ -375,6 +400,37 @@ Int_t TEntryListBlock::GetNPassed()
       return kBlockSize*16-fNPassed;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Returns the number of entries passing the selection with entry number
+/// smaller than entry
+
+Int_t TEntryListBlock::GetNPassedBelow(Int_t entry) const
+{
+   entry = std::min(std::max(entry, 0), kBlockSize*16);
+   if (!fIndices)
+      return fPassing ? 0 : entry;
+   if (fType==0){
+      //bits
+      const Int_t nwords = entry >> 4;
+      Int_t npassed = 0;
+      for (Int_t i=0; i<nwords; i++)
+         npassed += CountBits(fIndices[i]);
+      if (entry & 15)
+         npassed += CountBits(fIndices[nwords] & ((1 << (entry & 15)) - 1));
+      return npassed;
+   }
+   if (fType==2){
+      //runs
+      Int_t npassed = 0;
+      for (Int_t r=0; r<fN && fIndices[r]<entry; r+=2)
+         npassed += std::min(fIndices[r+1]+1, entry) - fIndices[r];
+      return npassed;
+   }
+   //list
+   const Int_t nbelow = std::lower_bound(fIndices, fIndices + fNPassed, entry) - fIndices;
+   return fPassing ? nbelow : entry - nbelow;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return entry \#entry.
 /// See also Next()
@@ -436,6 +492,17 @@ Int_t TEntryListBlock::GetEntry(Int_t entry)
             }
          }
       }
+      if (fType==2){
+         for (i=0; i<fN; i+=2){
+            Int_t length = fIndices[i+1] - fIndices[i] + 1;
+            if (entries_found + length > entry){
+               fLastIndexQueried = entry;
+               fLastIndexReturned = fIndices[i] + entry - entries_found;
+               return fLastIndexReturned;
+            }
+            entries_found += length;
+         }
+      }
       return -1;
    }
 }
@@ -484,6 +551,12 @@ Int_t TEntryListBlock::Next()
       }
 
    }
+   if (fType==2) {
+      fLastIndexQueried++;
+      Int_t next = fLastIndexReturned+1;
+      fLastIndexReturned = std::max<Int_t>(next, fIndices[FindRun(next)]);
+      return fLastIndexReturned;
+   }
    return -1;
 }
 
@@ -514,6 +587,11 @@ void TEntryListBlock::PrintWithShift(Int_t shift) const
          if (result)
             printf("%d\n", i+shift);
       }
+   } else if (fType==2){
+      for (i=0; i<fN; i+=2){
+         for (Int_t j=fIndices[i]; j<=fIndices[i+1]; j++)
+            printf("%d\n", j+shift);
+      }
    } else {
       if (fPassing){
          for (i=0; i<fNPassed; i++){
@@ -542,11 +620,30 @@ void TEntryListBlock::PrintWithShift(Int_t shift) const
 
 ////////////////////////////////////////////////////////////////////////////////
 /// If there are < kBlockSize or >kBlockSize*15 entries, change to an array
-/// representation
+/// representation. If the entries form few enough runs that storing them takes
+/// less space than the bits or the array, change to a runs representation
 
 void TEntryListBlock::OptimizeStorage()
 {
    if (fType!=0) return;
+   Int_t nlist = kBlockSize;
+   if (fNPassed < kBlockSize)
+      nlist = fNPassed;
+   else if (fNPassed > kBlockSize*15)
+      nlist = kBlockSize*16 - fNPassed;
+   const Int_t nruns = CountRuns(fIndices, kBlockSize);
+   if (2*nruns < nlist){
+      ToRuns(nruns);
+      return;
+   }
+   OptimizeBitsOrList();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Change from bits to a list representation, if it is smaller
+
+void TEntryListBlock::OptimizeBitsOrList()
+{
    if (fNPassed > kBlockSize*15)
       fPassing = 0;
    if (fNPassed<kBlockSize || !fPassing){
@@ -556,6 +653,28 @@ void TEntryListBlock::OptimizeStorage()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Stream an object of class TEntryListBlock.
+/// A block in runs representation is written as bits or as a list, the
+/// representations known to all the versions of the class.
+
+void TEntryListBlock::Streamer(TBuffer &b)
+{
+   if (b.IsReading()) {
+      b.ReadClassBuffer(TEntryListBlock::Class(), this);
+      fCurrent = 0;
+      fLastIndexQueried = -1;
+      fLastIndexReturned = -1;
+   } else if (fType==2) {
+      TEntryListBlock block(*this);
+      block.ToBits();
+      block.OptimizeBitsOrList();
+      b.WriteClassBuffer(TEntryListBlock::Class(), &block);
+   } else {
+      b.WriteClassBuffer(TEntryListBlock::Class(), this);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Transform the existing fIndices
 /// - dir=0 - transform from bits to a list
@@ -618,3 +737,103 @@ void TEntryListBlock::Transform(Bool_t dir, UShort_t *indexnew)
    fPassing = 1;
    return;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill bits (of size kBlockSize) with the bits representation of this block
+
+void TEntryListBlock::GetBits(UShort_t *bits) const
+{
+   if (fType==0 && fIndices){
+      std::copy(fIndices, fIndices + kBlockSize, bits);
+      return;
+   }
+   if (fType==2){
+      std::fill(bits, bits + kBlockSize, 0);
+      for (Int_t i=0; i<fN; i+=2)
+         FillBits(bits, fIndices[i], fIndices[i+1]);
+      return;
+   }
+   //list, possibly of the entries that don't pass
+   std::fill(bits, bits + kBlockSize, fPassing ? 0 : 0xFFFF);
+   if (!fIndices) return;
+   for (Int_t i=0; i<fNPassed; i++)
+      bits[fIndices[i]>>4] ^= 1<<(fIndices[i] & 15);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Adopt bits (of size kBlockSize) as the bits representation of this block
+
+void TEntryListBlock::SetBits(UShort_t *bits)
+{
+   if (fIndices)
+      delete [] fIndices;
+   fIndices = bits;
+   fNPassed = 0;
+   for (Int_t i=0; i<kBlockSize; i++)
+      fNPassed += CountBits(bits[i]);
+   fType = 0;
+   fN = kBlockSize;
+   fPassing = 1;
+   fCurrent = 0;
+   fLastIndexQueried = -1;
+   fLastIndexReturned = -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Change to bits representation
+
+void TEntryListBlock::ToBits()
+{
+   if (fType==0 && fIndices) return;
+   UShort_t *bits = new UShort_t[kBlockSize];
+   GetBits(bits);
+   SetBits(bits);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Change from bits to runs representation, nruns being the number of runs
+
+void TEntryListBlock::ToRuns(Int_t nruns)
+{
+   UShort_t *runs = new UShort_t[2*nruns];
+   Int_t n = 0;
+   Bool_t inrun = kFALSE;
+   for (Int_t i=0; i<kBlockSize; i++){
+      const UShort_t word = fIndices[i];
+      //no run starts or ends in this word
+      if (word == (inrun ? 0xFFFF : 0)) continue;
+      for (Int_t j=0; j<16; j++){
+         const Bool_t set = (word & (1<<j)) != 0;
+         if (set == inrun) continue;
+         //first entry of a run, or last entry of the previous one
+         runs[n++] = set ? i*16+j : i*16+j-1;
+         inrun = set;
+      }
+   }
+   if (inrun)
+      runs[n++] = kBlockSize*16-1;
+   delete [] fIndices;
+   fIndices = runs;
+   fN = n;
+   fType = 2;
+   fPassing = 1;
+   fCurrent = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// In runs representation, return the index in fIndices of the first run
+/// ending at or after entry, or fN if there is none
+
+Int_t TEntryListBlock::FindRun(Int_t entry) const
+{
+   Int_t lo = 0;
+   Int_t hi = fN/2;
+   while (lo < hi){
+      Int_t mid = (lo + hi)/2;
+      if (fIndices[2*mid+1] < entry)
+         lo = mid+1;
+      else
+         hi = mid;
+   }
+   return 2*lo;
+}
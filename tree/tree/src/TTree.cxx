@@ -4340,6 +4340,22 @@ Long64_t TTree::Draw(const char* varexp, const TCut& selection, Option_t* option
 ///
 /// When option contains "norm" the output histogram is normalized to 1.
 ///
+/// ### Compiling the expressions
+///
+/// When option contains "jit", the expressions and the selection are
+/// translated to C++ and compiled just in time, and the entries are
+/// processed in a compiled loop instead of being evaluated by TTreeFormula.
+/// If implicit multi-threading is enabled (see ROOT::EnableImplicitMT) and
+/// the output is a histogram, the clusters of the tree are processed in
+/// parallel. Only arithmetic, comparisons, logical operations and the usual
+/// mathematical functions (sqrt, exp, log, sin, pow, ...) of scalar branches
+/// of fundamental types are supported; for any other expression, output or
+/// for trees with an entry list, the option is ignored and the expressions
+/// are interpreted as usual. Example:
+/// ~~~{.cpp}
+///    tree->Draw("sqrt(px*px+py*py)>>hpt(100,0,10)", "nhits>3", "jit");
+/// ~~~
+///
 /// ### Saving the result of Draw to a TEventList, a TEntryList or a TEntryListArray
 ///
 /// TTree::Draw can be used to fill a TEventList object (list of entry numbers)
@@ -8086,6 +8102,9 @@ void TTree::ResetBranchAddresses()
 /// - If varexp = "*" print all columns.
 ///
 /// Otherwise a columns selection can be made using "var1:var2:var3".
+///
+/// If option contains "jit", the selection is compiled (see TTree::Draw) and
+/// evaluated in a first pass, and only the selected entries are then scanned.
 /// \see TTreePlayer::Scan for more information
 
 Long64_t TTree::Scan(const char* varexp, const char* selection, Option_t* option, Long64_t nentries, Long64_t firstentry)
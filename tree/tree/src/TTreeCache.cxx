@@ -129,6 +129,17 @@ Additionally, on the first miss of an event, we must iterate through all the
 This can be potentially a CPU-expensive operation compared to, e.g., the
 latency of a SSD.  This is why the miss cache is currently disabled by default.
 
+### Deferred branches
+Branches that are only read for a small fraction of the entries (for example
+the "payload" branches read after a selective filter) can be marked as
+deferred with the DeferBranch method. Deferred branches stay in the cache but
+their baskets are not prefetched with every cluster: they are read on demand,
+through the miss cache, for the entries that are actually accessed, and the
+baskets of all deferred branches needed by such an entry are fetched together
+in a single vectored read. Deferring a branch enables the miss optimization.
+RDataFrame defers, by default, the branches that are only read downstream of
+Filters.
+
 \anchor examples
 ## Example usages of TTreeCache
 
@@ -300,6 +311,7 @@ myTreeOrChain.GetTree()->PrintCacheStats();
 #include "TBranchCacheInfo.h"
 #include "TVirtualPerfStats.h"
 #include <limits.h>
+#include <algorithm>
 
 Int_t TTreeCache::fgLearnEntries = 100;
 
@@ -668,6 +680,182 @@ Int_t TTreeCache::DropBranch(const char *bname, Bool_t subbranches /*= kFALSE*/)
    return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Mark a branch as deferred: the branch stays known to the cache but its
+/// baskets are not prefetched with every cluster. They are instead fetched on
+/// demand through the miss cache, coalesced with the baskets of the other
+/// deferred branches for the same entry. This is useful for branches that are
+/// only read for a small fraction of the entries, e.g. after a selective cut.
+/// Deferring a branch enables the miss optimization (see SetOptimizeMisses).
+/// The deferred branches are remembered by name, so that the setting is
+/// preserved when the cache is moved to the next tree of a TChain.
+/// Returns:
+///  - 0 branch deferred or already deferred
+///  - -1 on error
+
+Int_t TTreeCache::DeferBranch(TBranch *b, Bool_t subbranches /*= kFALSE*/)
+{
+   // Reject branch that are not from the cached tree.
+   if (!b || fTree->GetTree() != b->GetTree()) return -1;
+
+   if (std::find(fDeferredBranches.begin(), fDeferredBranches.end(), b) == fDeferredBranches.end()) {
+      fDeferredBranches.push_back(b);
+      if (gDebug > 0) printf("Entry: %lld, deferring branch: %s\n",b->GetTree()->GetReadEntry(),b->GetName());
+   }
+   if (std::find(fDeferredBrNames.begin(), fDeferredBrNames.end(), b->GetName()) == fDeferredBrNames.end())
+      fDeferredBrNames.emplace_back(b->GetName());
+
+   SetOptimizeMisses(kTRUE);
+
+   // process subbranches
+   Int_t res = 0;
+   if (subbranches) {
+      TObjArray *lb = b->GetListOfBranches();
+      Int_t nb = lb->GetEntriesFast();
+      for (Int_t j = 0; j < nb; j++) {
+         TBranch* branch = (TBranch*) lb->UncheckedAt(j);
+         if (!branch) continue;
+         if (DeferBranch(branch, subbranches)<0) {
+            res = -1;
+         }
+      }
+   }
+   return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Mark the branch with the given name as deferred, see DeferBranch(TBranch*,Bool_t).
+/// The branch is looked up with respect to the tree currently attached to
+/// this TTreeCache.
+/// Returns:
+///  - 0 branch deferred or already deferred
+///  - -1 on error
+
+Int_t TTreeCache::DeferBranch(const char *bname, Bool_t subbranches /*= kFALSE*/)
+{
+   TBranch *branch = fTree->GetTree()->GetBranch(bname);
+   if (!branch) {
+      Error("DeferBranch", "unknown branch -> %s", bname);
+      return -1;
+   }
+   return DeferBranch(branch, subbranches);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the baskets of this branch must not be prefetched.
+
+Bool_t TTreeCache::IsDeferred(TBranch *b) const
+{
+   return !fDeferredBranches.empty() &&
+          std::find(fDeferredBranches.begin(), fDeferredBranches.end(), b) != fDeferredBranches.end();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the names of the branches in the cache, as used to find them again
+/// in the next tree of a chain (see UpdateBranches).
+
+std::vector<std::string> TTreeCache::GetCachedBranchNames() const
+{
+   std::vector<std::string> names;
+   if (!fBrNames)
+      return names;
+   names.reserve(fBrNames->GetSize());
+   for (TObject *os : *fBrNames)
+      names.emplace_back(os->GetName());
+   return names;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the baskets of the first cluster of `tree` for the branches `branchNames`,
+/// without attaching a cache to the tree.
+///
+/// This is used by TChain to read the beginning of the next file in the
+/// background, with the branches learned on the previous files, while the
+/// current file is being processed. The result is handed over to the cache
+/// with SetReadAhead once the tree is attached to it. Only the tree and its
+/// file are accessed, so this can run in another thread than the one using the
+/// cache. Returns nullptr if there is nothing to read, if the baskets do not
+/// fit in `maxBytes` or in case of read error.
+
+std::unique_ptr<ROOT::Internal::TTreeCacheReadAhead>
+TTreeCache::ReadAhead(TTree &tree, const std::vector<std::string> &branchNames, Long64_t maxBytes)
+{
+   TFile *file = tree.GetCurrentFile();
+   if (!file || branchNames.empty() || tree.GetEntries() <= 0)
+      return nullptr;
+
+   TTree::TClusterIterator clusterIter = tree.GetClusterIterator(0);
+   clusterIter();
+   const Long64_t clusterEnd = clusterIter.GetNextEntry();
+
+   std::vector<std::pair<Long64_t, Int_t>> baskets;
+   Long64_t totalBytes = 0;
+   for (const auto &name : branchNames) {
+      TBranch *b = tree.GetBranch(name.c_str());
+      if (!b)
+         continue;
+      const Long64_t *basketEntry = b->GetBasketEntry();
+      const Int_t *basketBytes = b->GetBasketBytes();
+      // Only the baskets written to the file (the others are in the tree header).
+      for (Int_t j = 0; j < b->GetWriteBasket() && basketEntry[j] < clusterEnd; ++j) {
+         const Long64_t pos = b->GetBasketSeek(j);
+         if (pos <= 0 || basketBytes[j] <= 0)
+            continue;
+         baskets.emplace_back(pos, basketBytes[j]);
+         totalBytes += basketBytes[j];
+      }
+   }
+   if (baskets.empty() || totalBytes > maxBytes)
+      return nullptr;
+
+   std::sort(baskets.begin(), baskets.end());
+   baskets.erase(std::unique(baskets.begin(), baskets.end()), baskets.end());
+
+   auto readAhead = std::make_unique<ROOT::Internal::TTreeCacheReadAhead>();
+   Long64_t offset = 0;
+   for (const auto &basket : baskets) {
+      readAhead->fPos.push_back(basket.first);
+      readAhead->fLen.push_back(basket.second);
+      readAhead->fOffset.push_back(offset);
+      offset += basket.second;
+   }
+   readAhead->fData.resize(offset);
+   if (file->ReadBuffers(readAhead->fData.data(), readAhead->fPos.data(), readAhead->fLen.data(), baskets.size()))
+      return nullptr;
+   return readAhead;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Use the baskets read by ReadAhead for the current tree: they are served from
+/// memory until the cache fills its buffer for the first time. Ignored when
+/// prefetching is enabled.
+
+void TTreeCache::SetReadAhead(std::unique_ptr<ROOT::Internal::TTreeCacheReadAhead> readAhead)
+{
+   if (fEnablePrefetching)
+      readAhead.reset();
+   fReadAhead = std::move(readAhead);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the basket at position `pos` from the read-ahead data, if it is there.
+
+Bool_t TTreeCache::ReadBufferReadAhead(char *buf, Long64_t pos, Int_t len)
+{
+   const auto &positions = fReadAhead->fPos;
+   auto iter = std::lower_bound(positions.begin(), positions.end(), pos);
+   if (iter == positions.end() || *iter != pos)
+      return kFALSE;
+   const auto idx = iter - positions.begin();
+   if (len > fReadAhead->fLen[idx])
+      return kFALSE;
+   if (buf) {
+      memcpy(buf, &fReadAhead->fData[fReadAhead->fOffset[idx]], len);
+      fFile->SetOffset(pos + len);
+   }
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Start of methods for the miss cache.
 ////////////////////////////////////////////////////////////////////////////////
@@ -777,8 +965,8 @@ TTreeCache::IOPos TTreeCache::FindBranchBasketPos(TBranch &b, Long64_t entry)
 /// should be performed.
 ///
 /// `all` indicates that this function should search the set of _all_ branches
-/// in this TTree.  When set to false, we only search through branches that
-/// have previously incurred a miss.
+/// in this TTree (or only the deferred branches, if there are any).  When set
+/// to false, we only search through branches that have previously incurred a miss.
 ///
 /// Returns:
 /// - TBranch pointer corresponding to the basket that will be retrieved by
@@ -791,7 +979,9 @@ TBranch *TTreeCache::CalculateMissEntries(Long64_t pos, Int_t len, Bool_t all)
       return nullptr;
    }
 
-   int count = all ? (fTree->GetListOfLeaves())->GetEntriesFast() : fMissCache->fBranches.size();
+   const Bool_t deferredOnly = all && !fDeferredBranches.empty();
+   int count = deferredOnly ? fDeferredBranches.size()
+                            : (all ? (fTree->GetListOfLeaves())->GetEntriesFast() : fMissCache->fBranches.size());
    fMissCache->fEntries.reserve(count);
    fMissCache->fEntries.clear();
    Bool_t found_request = kFALSE;
@@ -803,9 +993,9 @@ TBranch *TTreeCache::CalculateMissEntries(Long64_t pos, Int_t len, Bool_t all)
 
    // printf("Will search %d branches for basket at %ld.\n", count, pos);
    for (int i = 0; i < count; i++) {
-      TBranch *b =
-         all ? static_cast<TBranch *>(static_cast<TLeaf *>((fTree->GetListOfLeaves())->UncheckedAt(i))->GetBranch())
-             : fMissCache->fBranches[i];
+      TBranch *b = deferredOnly ? fDeferredBranches[i]
+                   : all ? static_cast<TBranch *>(static_cast<TLeaf *>((fTree->GetListOfLeaves())->UncheckedAt(i))->GetBranch())
+                         : fMissCache->fBranches[i];
       IOPos iopos = FindBranchBasketPos(*b, entry);
       if (iopos.fLen == 0) { // Error indicator
          continue;
@@ -882,8 +1072,8 @@ Bool_t TTreeCache::ProcessMiss(Long64_t pos, int len)
          return kFALSE;
       }
    }
-   // TODO: this should be a set.
-   fMissCache->fBranches.push_back(b);
+   if (std::find(fMissCache->fBranches.begin(), fMissCache->fBranches.end(), b) == fMissCache->fBranches.end())
+      fMissCache->fBranches.push_back(b);
 
    // OK, sort the entries
    std::sort(fMissCache->fEntries.begin(), fMissCache->fEntries.end());
@@ -932,7 +1122,7 @@ Bool_t TTreeCache::CheckMissCache(char *buf, Long64_t pos, int len)
    MissCache::Entry mcentry{IOPos{pos, len}};
    auto iter = std::lower_bound(fMissCache->fEntries.begin(), fMissCache->fEntries.end(), mcentry);
 
-   if (iter != fMissCache->fEntries.end()) {
+   if (iter != fMissCache->fEntries.end() && iter->fIO.fPos == pos) {
       if (len > iter->fIO.fLen) {
          ++fNMissReadMiss;
          return kFALSE;
@@ -957,7 +1147,7 @@ Bool_t TTreeCache::CheckMissCache(char *buf, Long64_t pos, int len)
    // the entry we want.
    iter = std::lower_bound(fMissCache->fEntries.begin(), fMissCache->fEntries.end(), mcentry);
 
-   if (iter != fMissCache->fEntries.end()) {
+   if (iter != fMissCache->fEntries.end() && iter->fIO.fPos == pos) {
       auto offset = iter->fIndex;
       // printf("Expecting data at offset %ld in miss cache.\n", offset);
       memcpy(buf, &(fMissCache->fData[offset]), len);
@@ -1209,6 +1399,8 @@ Bool_t TTreeCache::FillBuffer()
       Bool_t allUsed = kTRUE;
       for (Int_t i = 0; i < fNbranches; ++i) {
          TBranch *b = (TBranch *)fBranches->UncheckedAt(i);
+         if (IsDeferred(b))
+            continue;
          if (!b->fCacheInfo.AllUsed()) {
             allUsed = kFALSE;
             break;
@@ -1305,6 +1497,9 @@ Bool_t TTreeCache::FillBuffer()
       }
    }
 
+   // From now on the baskets come from the cache buffer.
+   fReadAhead.reset();
+
    //clear cache buffer
    Int_t ntotCurrentBuf = 0;
    if (fEnablePrefetching){ //prefetching mode
@@ -1389,6 +1584,9 @@ Bool_t TTreeCache::FillBuffer()
                continue;
             if (b->GetDirectory()->GetFile() != fFile)
                continue;
+            // Deferred branches are read on demand through the miss cache.
+            if (IsDeferred(b))
+               continue;
             potentialVetoes.clear();
             if (pass == kStart && !cursor[i].fLoadedOnce && resetBranchInfo) {
                // First check if we have any cluster that is currently in the
@@ -1901,6 +2099,8 @@ void TTreeCache::Print(Option_t *option) const
    printf("******TreeCache statistics for tree: %s in file: %s ******\n",fTree ? fTree->GetName() : "no tree set",fFile ? fFile->GetName() : "no file set");
    if (fNbranches <= 0) return;
    printf("Number of branches in the cache ...: %d\n",fNbranches);
+   if (!fDeferredBranches.empty())
+      printf("Number of deferred branches .......: %zu\n",fDeferredBranches.size());
    printf("Cache Efficiency ..................: %f\n",GetEfficiency());
    printf("Cache Efficiency Rel...............: %f\n",GetEfficiencyRel());
    printf("Secondary Efficiency ..............: %f\n", GetMissEfficiency());
@@ -1947,6 +2147,12 @@ Int_t TTreeCache::ReadBufferNormal(char *buf, Long64_t pos, Int_t len){
       }
    };
 
+   // The first cluster of the tree may have been read ahead of time.
+   if (fReadAhead && ReadBufferReadAhead(buf, pos, len)) {
+      fNReadOk++;
+      return 1;
+   }
+
    //not found in cache. Do we need to fill the cache?
    Bool_t bufferFilled = FillBuffer();
    if (bufferFilled) {
@@ -1955,6 +2161,9 @@ Int_t TTreeCache::ReadBufferNormal(char *buf, Long64_t pos, Int_t len){
       if (res == 1)
          fNReadOk++;
       else if (res == 0) {
+         // Baskets of deferred branches are never part of the prefetched cluster.
+         if (!fDeferredBranches.empty() && CheckMissCache(buf, pos, len))
+            return 1;
          fNReadMiss++;
          auto perfStats = GetTree()->GetPerfStats();
          if (perfStats)
@@ -2236,6 +2445,16 @@ void TTreeCache::UpdateBranches(TTree *tree)
       fNbranches++;
    }
 
+   // The miss cache refers to the baskets and branches of the previous tree.
+   if (fMissCache)
+      ResetMissCache();
+   fReadAhead.reset();
+   fDeferredBranches.clear();
+   for (const auto &name : fDeferredBrNames) {
+      if (TBranch *b = fTree->GetBranch(name.c_str()))
+         fDeferredBranches.push_back(b);
+   }
+
    auto perfStats = GetTree()->GetPerfStats();
    if (perfStats)
       perfStats->UpdateBranchIndices(fBranches);
@@ -0,0 +1,129 @@
+#include "TBranch.h"
+#include "TBufferFile.h"
+#include "TFile.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+class BulkApiJaggedTest : public ::testing::Test {
+public:
+   static constexpr Long64_t fClusterSize = 1000;
+   static constexpr Long64_t fEventCount = 10000;
+   const std::string fFileName = "BulkApiJaggedTest.root";
+
+protected:
+   void SetUp() override
+   {
+      TFile hfile(fFileName.c_str(), "RECREATE");
+      TTree tree("T", "A tree with variable-length branches");
+      tree.SetBit(TTree::kOnlyFlushAtCluster);
+      tree.SetAutoFlush(fClusterSize);
+
+      int myLen = 0;
+      float f[10];
+      std::vector<float> vf;
+      std::vector<double> vd;
+      std::vector<short> vs;
+      tree.Branch("myLen", &myLen, "myLen/I");
+      tree.Branch("f", &f, "f[myLen]/F");
+      tree.Branch("vf", &vf);
+      tree.Branch("vd", &vd);
+      tree.Branch("vs", &vs);
+
+      float counter = 0;
+      for (Long64_t ev = 0; ev < fEventCount; ev++) {
+         myLen = ev % 10;
+         vf.clear();
+         vd.clear();
+         vs.clear();
+         for (int idx = 0; idx < myLen; idx++) {
+            f[idx] = counter;
+            vf.push_back(counter);
+            vd.push_back(counter + 0.5);
+            vs.push_back(static_cast<short>(ev + idx));
+            counter++;
+         }
+         tree.Fill();
+      }
+      hfile.Write();
+   }
+
+   void TearDown() override { gSystem->Unlink(fFileName.c_str()); }
+
+   /// Read `branchName` with GetBulkJaggedEntries and check its content against the values that were written.
+   template <typename T, typename ExpectedValue_t>
+   void CheckBranch(const char *branchName, ExpectedValue_t expectedValue)
+   {
+      TFile hfile(fFileName.c_str());
+      auto tree = hfile.Get<TTree>("T");
+      ASSERT_NE(tree, nullptr);
+      auto branch = tree->GetBranch(branchName);
+      ASSERT_NE(branch, nullptr);
+      ASSERT_TRUE(branch->GetBulkRead().SupportsBulkJaggedRead());
+
+      TBufferFile buf(TBuffer::kWrite, 10000);
+      std::vector<Int_t> offsets;
+      Long64_t entry = 0;
+      while (entry < fEventCount) {
+         auto count = branch->GetBulkRead().GetBulkJaggedEntries(entry, buf, offsets);
+         ASSERT_GT(count, 0);
+         ASSERT_EQ(offsets.size(), static_cast<std::size_t>(count + 1));
+         auto values = reinterpret_cast<T *>(buf.GetCurrent());
+         for (Int_t i = 0; i < count; i++) {
+            const Long64_t ev = entry + i;
+            ASSERT_EQ(offsets[i + 1] - offsets[i], ev % 10);
+            for (Int_t j = 0; j < ev % 10; j++)
+               EXPECT_EQ(values[offsets[i] + j], expectedValue(ev, j));
+         }
+         entry += count;
+      }
+      EXPECT_EQ(entry, fEventCount);
+   }
+};
+
+constexpr Long64_t BulkApiJaggedTest::fClusterSize;
+constexpr Long64_t BulkApiJaggedTest::fEventCount;
+
+/// Value written at index `idx` of entry `ev`.
+static float Counter(Long64_t ev, Int_t idx)
+{
+   // Entry ev is preceded by ev / 10 full sequences of 0+1+...+9 = 45 values and by the values of the entries
+   // ev - ev % 10 ... ev - 1 which hold 0, 1, ..., ev % 10 - 1 values.
+   const Long64_t rem = ev % 10;
+   return 45 * (ev / 10) + rem * (rem - 1) / 2 + idx;
+}
+
+TEST_F(BulkApiJaggedTest, VariableLengthArray)
+{
+   CheckBranch<float>("f", Counter);
+}
+
+TEST_F(BulkApiJaggedTest, VectorOfFloats)
+{
+   CheckBranch<float>("vf", Counter);
+}
+
+TEST_F(BulkApiJaggedTest, VectorOfDoubles)
+{
+   CheckBranch<double>("vd", [](Long64_t ev, Int_t idx) { return Counter(ev, idx) + 0.5; });
+}
+
+TEST_F(BulkApiJaggedTest, VectorOfShorts)
+{
+   CheckBranch<short>("vs", [](Long64_t ev, Int_t idx) { return static_cast<short>(ev + idx); });
+}
+
+TEST_F(BulkApiJaggedTest, Unsupported)
+{
+   TFile hfile(fFileName.c_str());
+   auto tree = hfile.Get<TTree>("T");
+   ASSERT_NE(tree, nullptr);
+   EXPECT_FALSE(tree->GetBranch("myLen")->GetBulkRead().SupportsBulkJaggedRead());
+
+   TBufferFile buf(TBuffer::kWrite, 10000);
+   std::vector<Int_t> offsets;
+   EXPECT_EQ(tree->GetBranch("myLen")->GetBulkRead().GetBulkJaggedEntries(0, buf, offsets), -1);
+}
@@ -0,0 +1,154 @@
+#include "ROOT/InternalTreeUtils.hxx"
+#include "ROOT/TestSupport.hxx"
+#include "TChain.h"
+#include "TChainElement.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeCache.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+class TChainParallelOpen : public ::testing::Test {
+protected:
+   static const std::vector<int> fEntries;
+
+   static std::string FileName(std::size_t i) { return "tchain_parallelopen_" + std::to_string(i) + ".root"; }
+
+   static void SetUpTestCase()
+   {
+      int value = 0;
+      for (std::size_t i = 0; i < fEntries.size(); ++i) {
+         TFile f(FileName(i).c_str(), "RECREATE");
+         TTree t("t", "t");
+         t.SetAutoFlush(5);
+         int x = 0;
+         t.Branch("x", &x);
+         for (int j = 0; j < fEntries[i]; ++j) {
+            x = value++;
+            t.Fill();
+         }
+         t.Write();
+      }
+   }
+
+   static void TearDownTestCase()
+   {
+      for (std::size_t i = 0; i < fEntries.size(); ++i)
+         gSystem->Unlink(FileName(i).c_str());
+   }
+
+   void SetUp() override { ROOT::EnableImplicitMT(4); }
+   void TearDown() override { ROOT::DisableImplicitMT(); }
+
+   static Long64_t TotalEntries()
+   {
+      Long64_t total = 0;
+      for (auto n : fEntries)
+         total += n;
+      return total;
+   }
+};
+
+const std::vector<int> TChainParallelOpen::fEntries{10, 0, 25, 1, 40, 7};
+
+TEST_F(TChainParallelOpen, GetEntries)
+{
+   TChain chain("t");
+   for (std::size_t i = 0; i < fEntries.size(); ++i)
+      chain.Add(FileName(i).c_str());
+   EXPECT_EQ(chain.GetEntriesFast(), TTree::kMaxEntries);
+   EXPECT_EQ(chain.GetEntries(), TotalEntries());
+
+   Long64_t offset = 0;
+   for (std::size_t i = 0; i < fEntries.size(); ++i) {
+      EXPECT_EQ(chain.GetTreeOffset()[i], offset);
+      EXPECT_EQ(static_cast<TChainElement *>(chain.GetListOfFiles()->At(i))->GetEntries(), fEntries[i]);
+      offset += fEntries[i];
+   }
+   EXPECT_EQ(chain.GetTreeOffset()[fEntries.size()], offset);
+}
+
+TEST_F(TChainParallelOpen, WildcardWithEntries)
+{
+   TChain chain("t");
+   ROOT::TestSupport::CheckDiagsRAII diags;
+   diags.requiredDiag(kWarning, "TChain::AddFile", "Adding tree with no entries from file", /*matchFullMessage=*/false);
+   // The empty file is not added.
+   EXPECT_EQ(chain.Add("tchain_parallelopen_*.root", 0), static_cast<Int_t>(fEntries.size()));
+   EXPECT_EQ(chain.GetNtrees(), static_cast<Int_t>(fEntries.size()) - 1);
+   EXPECT_EQ(chain.GetEntriesFast(), TotalEntries());
+}
+
+TEST_F(TChainParallelOpen, SequentialRead)
+{
+   for (bool openAhead : {true, false}) {
+      TChain chain("t");
+      chain.SetOpenAhead(openAhead);
+      for (std::size_t i = 0; i < fEntries.size(); ++i)
+         chain.Add(FileName(i).c_str());
+      int x = -1;
+      chain.SetBranchAddress("x", &x);
+      Long64_t entry = 0;
+      while (chain.GetEntry(entry) > 0) {
+         EXPECT_EQ(x, entry);
+         ++entry;
+      }
+      EXPECT_EQ(entry, TotalEntries());
+
+      // Random access after sequential reading
+      chain.GetEntry(3);
+      EXPECT_EQ(x, 3);
+      chain.GetEntry(TotalEntries() - 1);
+      EXPECT_EQ(x, TotalEntries() - 1);
+   }
+}
+
+TEST_F(TChainParallelOpen, OpenAheadIsOptIn)
+{
+   EXPECT_FALSE(TChain("t").GetOpenAhead());
+   // The chains read from the tasks of TTreeProcessorMT never open ahead
+   auto chain = ROOT::Internal::TreeUtils::MakeChainForMT("t");
+   EXPECT_FALSE(chain->GetOpenAhead());
+}
+
+TEST_F(TChainParallelOpen, SequentialReadWithCache)
+{
+   const auto learnEntries = TTreeCache::GetLearnEntries();
+   TTreeCache::SetLearnEntries(1);
+   TChain chain("t");
+   chain.SetOpenAhead(true);
+   for (std::size_t i = 0; i < fEntries.size(); ++i)
+      chain.Add(FileName(i).c_str());
+   chain.SetCacheSize(1000000);
+   int x = -1;
+   chain.SetBranchAddress("x", &x);
+   for (Long64_t entry = 0; entry < TotalEntries(); ++entry) {
+      ASSERT_GT(chain.GetEntry(entry), 0);
+      EXPECT_EQ(x, entry);
+   }
+   TTreeCache::SetLearnEntries(learnEntries);
+}
+
+TEST_F(TChainParallelOpen, ReadAhead)
+{
+   TFile f(FileName(2).c_str());
+   auto t = f.Get<TTree>("t");
+   ASSERT_NE(t, nullptr);
+   auto branch = t->GetBranch("x");
+
+   auto readAhead = TTreeCache::ReadAhead(*t, {"x", "nonexistent"}, 1000000);
+   ASSERT_NE(readAhead, nullptr);
+   // Only the baskets of the first cluster (entries [0, 5[) are read
+   ASSERT_EQ(readAhead->fPos.size(), 1u);
+   EXPECT_EQ(readAhead->fPos[0], branch->GetBasketSeek(0));
+   EXPECT_EQ(readAhead->fLen[0], branch->GetBasketBytes()[0]);
+   EXPECT_EQ(readAhead->fData.size(), static_cast<std::size_t>(branch->GetBasketBytes()[0]));
+
+   EXPECT_EQ(TTreeCache::ReadAhead(*t, {"x"}, 1), nullptr);
+   EXPECT_EQ(TTreeCache::ReadAhead(*t, {}, 1000000), nullptr);
+}
@@ -0,0 +1,86 @@
+#include "TFile.h"
+#include "TRandom.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeCache.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <utility>
+
+namespace {
+
+struct DeferredBranchesFile {
+   const char *fFileName = "ttreecache_deferredbranches.root";
+   DeferredBranchesFile()
+   {
+      TFile f(fFileName, "RECREATE");
+      TTree t("t", "t");
+      int x = 0;
+      double y = 0.;
+      t.Branch("x", &x);
+      auto by = t.Branch("y", &y);
+      by->SetBasketSize(4000); // many payload baskets per cluster
+      t.SetAutoFlush(10000);
+      TRandom rnd(42);
+      for (int i = 0; i < 100000; ++i) {
+         x = i;
+         y = rnd.Gaus();
+         t.Fill();
+      }
+      t.Write();
+   }
+   ~DeferredBranchesFile() { gSystem->Unlink(fFileName); }
+};
+
+/// Read "x" for all entries and "y" only for one entry every 20000.
+/// Return the sum of the y values read and the number of bytes read from the file.
+std::pair<double, Long64_t> ReadSelected(const char *fileName, bool deferPayload)
+{
+   std::unique_ptr<TFile> f(TFile::Open(fileName));
+   auto t = f->Get<TTree>("t");
+   int x = 0;
+   double y = 0.;
+   t->SetBranchAddress("x", &x);
+   t->SetBranchAddress("y", &y);
+   auto bx = t->GetBranch("x");
+   auto by = t->GetBranch("y");
+
+   t->SetCacheSize(10000000);
+   t->AddBranchToCache("*", true);
+   t->StopCacheLearningPhase();
+   auto cache = t->GetReadCache(f.get());
+   EXPECT_NE(cache, nullptr);
+   if (deferPayload) {
+      EXPECT_EQ(cache->DeferBranch("y"), 0);
+      EXPECT_TRUE(cache->GetOptimizeMisses());
+      EXPECT_EQ(cache->GetDeferredBranches().size(), 1u);
+   }
+
+   double sum = 0.;
+   const auto nEntries = t->GetEntries();
+   for (Long64_t i = 0; i < nEntries; ++i) {
+      t->LoadTree(i);
+      bx->GetEntry(i);
+      if (x % 20000 == 0) {
+         by->GetEntry(i);
+         sum += y;
+      }
+   }
+   return {sum, f->GetBytesRead()};
+}
+
+} // namespace
+
+TEST(TTreeCache, DeferBranch)
+{
+   DeferredBranchesFile file;
+
+   const auto prefetched = ReadSelected(file.fFileName, /*deferPayload=*/false);
+   const auto deferred = ReadSelected(file.fFileName, /*deferPayload=*/true);
+
+   EXPECT_DOUBLE_EQ(prefetched.first, deferred.first);
+   // only 5 of the ~200 baskets of "y" are needed
+   EXPECT_LT(deferred.second, prefetched.second / 2);
+}
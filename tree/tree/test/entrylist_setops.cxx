@@ -0,0 +1,159 @@
+#include "TEntryList.h"
+#include "TEntryListBlock.h"
+#include "TFile.h"
+#include "TSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <set>
+#include <vector>
+
+// Entries spread over 3 blocks of TEntryList::kBlockSize entries, in several patterns:
+// long runs, sparse entries, and dense random entries
+static std::set<Long64_t> MakeEntries(int pattern)
+{
+   std::set<Long64_t> entries;
+   const Long64_t n = 3 * TEntryList::kBlockSize;
+   for (Long64_t i = 0; i < n; ++i) {
+      bool pass = false;
+      switch (pattern) {
+      case 0: pass = (i / 5000) % 3 == 1; break;
+      case 1: pass = i % 997 == 0; break;
+      case 2: pass = (i * 2654435761u) % 7 < 3; break;
+      case 3: pass = i >= 60000 && i < 70000; break;
+      }
+      if (pass)
+         entries.insert(i);
+   }
+   return entries;
+}
+
+static void FillList(TEntryList &elist, const std::set<Long64_t> &entries)
+{
+   for (auto e : entries)
+      elist.Enter(e);
+   elist.OptimizeStorage();
+}
+
+static void CheckList(TEntryList &elist, const std::set<Long64_t> &entries)
+{
+   ASSERT_EQ(elist.GetN(), static_cast<Long64_t>(entries.size()));
+   Long64_t i = 0;
+   for (auto e : entries) {
+      EXPECT_EQ(elist.GetEntry(i), e) << "index " << i;
+      ++i;
+   }
+   for (Long64_t e = 0; e < 3 * TEntryList::kBlockSize; e += 101)
+      EXPECT_EQ(elist.Contains(e) != 0, entries.count(e) != 0) << "entry " << e;
+}
+
+TEST(TEntryList, EnterRangeRuns)
+{
+   TEntryList elist;
+   elist.EnterRange(10, 150000);
+   elist.EnterRange(160000, 170000);
+   std::set<Long64_t> entries;
+   for (Long64_t e = 10; e < 150000; ++e)
+      entries.insert(e);
+   for (Long64_t e = 160000; e < 170000; ++e)
+      entries.insert(e);
+   CheckList(elist, entries);
+
+   // Entering and removing single entries still works after the storage was optimized
+   elist.OptimizeStorage();
+   EXPECT_TRUE(elist.Remove(100));
+   EXPECT_TRUE(elist.Enter(155000));
+   entries.erase(100);
+   entries.insert(155000);
+   CheckList(elist, entries);
+}
+
+TEST(TEntryList, SetOperations)
+{
+   for (int p1 = 0; p1 < 4; ++p1) {
+      for (int p2 = 0; p2 < 4; ++p2) {
+         const auto entries1 = MakeEntries(p1);
+         const auto entries2 = MakeEntries(p2);
+         std::set<Long64_t> sum = entries1;
+         sum.insert(entries2.begin(), entries2.end());
+         std::set<Long64_t> difference, intersection;
+         for (auto e : entries1)
+            (entries2.count(e) ? intersection : difference).insert(e);
+
+         TEntryList elist1, elist2;
+         FillList(elist1, entries1);
+         FillList(elist2, entries2);
+
+         TEntryList added(elist1);
+         added.Add(&elist2);
+         CheckList(added, sum);
+
+         TEntryList subtracted(elist1);
+         subtracted.Subtract(&elist2);
+         CheckList(subtracted, difference);
+
+         TEntryList intersected(elist1);
+         intersected.Intersect(&elist2);
+         CheckList(intersected, intersection);
+      }
+   }
+}
+
+TEST(TEntryList, IntersectDifferentTree)
+{
+   TEntryList elist1("", "", "t1", "f.root");
+   TEntryList elist2("", "", "t2", "f.root");
+   elist1.EnterRange(0, 100);
+   elist2.EnterRange(0, 100);
+   elist1.Intersect(&elist2);
+   EXPECT_EQ(elist1.GetN(), 0);
+}
+
+TEST(TEntryList, GetNEntriesBelow)
+{
+   const auto entries = MakeEntries(0);
+   TEntryList elist;
+   FillList(elist, entries);
+
+   const std::vector<Long64_t> boundaries{0, 1, 4999, 5000, 10001, 63999, 64000, 64001, 128000, 150000, 1000000};
+   const auto nBelow = elist.GetNEntriesBelow(boundaries);
+   ASSERT_EQ(nBelow.size(), boundaries.size());
+   for (auto i = 0u; i < boundaries.size(); ++i) {
+      Long64_t expected = 0;
+      for (auto e : entries)
+         expected += e < boundaries[i];
+      EXPECT_EQ(nBelow[i], expected) << "boundary " << boundaries[i];
+   }
+}
+
+TEST(TEntryList, RunsIO)
+{
+   // A block of runs is written in one of the representations older versions of ROOT can read
+   TEntryListBlock block;
+   block.EnterRange(100, 20000);
+   block.EnterRange(30000, 40000);
+   block.OptimizeStorage();
+   ASSERT_EQ(block.GetType(), 2);
+   {
+      TFile f("entrylist_runsio.root", "RECREATE");
+      f.WriteObject(&block, "block");
+      std::vector<TEntryList> elists(4);
+      for (int p = 0; p < 4; ++p) {
+         FillList(elists[p], MakeEntries(p));
+         f.WriteObject(&elists[p], ("elist" + std::to_string(p)).c_str());
+      }
+   }
+   TFile f("entrylist_runsio.root");
+   auto readBlock = f.Get<TEntryListBlock>("block");
+   ASSERT_NE(readBlock, nullptr);
+   EXPECT_NE(readBlock->GetType(), 2);
+   EXPECT_EQ(readBlock->GetNPassed(), block.GetNPassed());
+   for (Int_t e = 0; e < TEntryListBlock::kBlockSize * 16; e += 7)
+      EXPECT_EQ(readBlock->Contains(e), block.Contains(e)) << "entry " << e;
+   for (int p = 0; p < 4; ++p) {
+      auto elist = f.Get<TEntryList>(("elist" + std::to_string(p)).c_str());
+      ASSERT_NE(elist, nullptr);
+      CheckList(*elist, MakeEntries(p));
+   }
+   gSystem->Unlink("entrylist_runsio.root");
+}
@@ -62,6 +62,7 @@ protected:
    Bool_t         fCleanElist;       ///<  True if original Tree elist must be saved
    Bool_t         fObjEval;          ///<  True if fVar1 returns an object (or pointer to).
    Long64_t       fCurrentSubEntry;  ///<  Current subentry when fSelectMultiple is true. Used to fill TEntryListArray
+   Long64_t       fNFilledValues;    ///<! Number of entries passed to ProcessFillValues since Begin
 
 protected:
    virtual void      ClearFormula();
@@ -78,6 +79,8 @@ public:
 
    void      Begin(TTree *tree) override;
    virtual Int_t     GetAction() const {return fAction;}
+   /// Number of entries computed outside of this selector (e.g. by the option "jit" of TTree::Draw) since Begin
+   Long64_t          GetNFilledValues() const {return fNFilledValues;}
    virtual Bool_t    GetCleanElist() const {return fCleanElist;}
    virtual Int_t     GetDimension() const {return fDimension;}
    virtual Long64_t  GetDrawFlag() const {return fDraw;}
@@ -107,11 +110,13 @@ public:
    /// See TSelectorDraw::GetVal
    virtual Double_t *GetV4() const   {return GetVal(3);}
    virtual Double_t *GetW() const    {return fW;}
+   virtual Bool_t    CanFillValues() const;
    Bool_t    Notify() override;
    Bool_t    Process(Long64_t /*entry*/) override { return kFALSE; }
    void      ProcessFill(Long64_t entry) override;
    virtual void      ProcessFillMultiple(Long64_t entry);
    virtual void      ProcessFillObject(Long64_t entry);
+   virtual void      ProcessFillValues(Long64_t n, const Double_t *const *vals, const Double_t *w);
    virtual void      SetEstimate(Long64_t n);
    virtual UInt_t    SplitNames(const TString &varexp, std::vector<TString> &names);
    virtual void      TakeAction();
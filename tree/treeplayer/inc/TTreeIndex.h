@@ -39,6 +39,7 @@ protected:
    TTreeFormula  *fMinorFormula;        ///<! Pointer to minor TreeFormula
    TTreeFormula  *fMajorFormulaParent;  ///<! Pointer to major TreeFormula in Parent tree (if any)
    TTreeFormula  *fMinorFormulaParent;  ///<! Pointer to minor TreeFormula in Parent tree (if any)
+   Bool_t         fDeltaEncoding;       ///<  Whether the index arrays are delta-encoded on file
 
    TTreeFormula  *GetMajorFormulaParent(const TTree *parent);
    TTreeFormula  *GetMinorFormulaParent(const TTree *parent);
@@ -65,12 +66,14 @@ public:
    Long64_t       GetN()            const override {return fN;}
    virtual TTreeFormula  *GetMajorFormula();
    virtual TTreeFormula  *GetMinorFormula();
+   Bool_t                 GetDeltaEncoding() const {return fDeltaEncoding;}
    Bool_t         IsValidFor(const TTree *parent) override;
    void           Print(Option_t *option="") const override;
+   void                   SetDeltaEncoding(Bool_t delta = kTRUE);
    void           UpdateFormulaLeaves(const TTree *parent) override;
    void           SetTree(TTree *T) override;
 
-   ClassDefOverride(TTreeIndex,2);  //A Tree Index with majorname and minorname.
+   ClassDefOverride(TTreeIndex,3);  //A Tree Index with majorname and minorname.
 };
 
 #endif
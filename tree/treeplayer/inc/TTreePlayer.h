@@ -32,6 +32,7 @@
 #include "TSelectorDraw.h"
 #include "TTree.h"
 
+class TEntryList;
 class TVirtualIndex;
 
 class TTreePlayer : public TVirtualTreePlayer {
@@ -53,10 +54,13 @@ protected:
    TList         *fInput;           ///<! input list to the selector
    TList         *fFormulaList;     ///<! Pointer to a list of coordinated list TTreeFormula (used by Scan and Query)
    TSelector     *fSelectorUpdate;  ///<! Set to the selector address when it's entry list needs to be updated by the UpdateFormulaLeaves function
+   Bool_t         fJitDraw;         ///<! True while DrawSelect processes the tree with the option "jit"
 
 protected:
    const   char  *GetNameByIndex(TString &varexp, Int_t *index,Int_t colindex);
    void           DeleteSelectorFromFile();
+   TEntryList    *JitSelectEntries(const char *selection, Long64_t nentries, Long64_t firstentry);
+   Bool_t         ProcessDrawJit(Long64_t nentries, Long64_t firstentry);
 
 public:
    TTreePlayer();
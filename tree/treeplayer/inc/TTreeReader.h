@@ -30,6 +30,7 @@
 #include <iterator>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 class TDictionary;
 class TDirectory;
@@ -218,6 +219,11 @@ public:
    /// Restart a Next() loop from entry 0 (of TEntryList index 0 of fEntryList is set).
    void Restart();
 
+   /// Set the branches whose baskets the TTreeCache should fetch on demand instead of
+   /// prefetching them with every cluster, see TTreeCache::DeferBranch().
+   /// Must be called before the first entry is loaded.
+   void SetCacheDeferredBranches(const std::vector<std::string> &branchNames) { fCacheDeferredBranches = branchNames; }
+
    ///\}
 
    EEntryStatus GetEntryStatus() const { return fEntryStatus; }
@@ -306,6 +312,7 @@ private:
    Long64_t fBeginEntry = 0LL; ///< This allows us to propagate the range to the TTreeCache
    Bool_t fProxiesSet = kFALSE; ///< True if the proxies have been set, false otherwise
    Bool_t fSetEntryBaseCallingLoadTree = kFALSE; ///< True if during the LoadTree execution triggered by SetEntryBase.
+   std::vector<std::string> fCacheDeferredBranches; ///< Branches that the TTreeCache reads on demand only
 
    friend class ROOT::Internal::TTreeReaderValueBase;
    friend class ROOT::Internal::TTreeReaderArrayBase;
@@ -78,6 +78,7 @@ TSelectorDraw::TSelectorDraw()
    fWeight         = 1;
    fCurrentSubEntry = -1;
    fTreeElistArray  = 0;
+   fNFilledValues   = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -108,6 +109,7 @@ void TSelectorDraw::Begin(TTree *tree)
    ResetAbort();
    ResetBit(kCustomHistogram);
    fSelectedRows   = 0;
+   fNFilledValues  = 0;
    fTree = tree;
    fDimension = 0;
    fAction = 0;
@@ -1276,6 +1278,42 @@ void TSelectorDraw::ProcessFillMultiple(Long64_t entry)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the values of the variables can be computed outside of
+/// this selector and passed to ProcessFillValues, i.e. if the variables and
+/// the selection have a single value per entry and the output is filled from
+/// the buffered values.
+
+Bool_t TSelectorDraw::CanFillValues() const
+{
+   return fDimension > 0 && fDimension <= fValSize && !fObjEval && !fMultiplicity && !fTreeElistArray &&
+          GetAbort() != kAbortProcess;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill n entries whose values were computed outside of this selector:
+/// vals[i][j] is the value of the i-th variable for the j-th entry and w[j]
+/// the value of the selection for that entry. The entries are buffered and
+/// the action is taken exactly as for the entries processed by ProcessFill.
+/// Only valid if CanFillValues() returns true.
+
+void TSelectorDraw::ProcessFillValues(Long64_t n, const Double_t *const *vals, const Double_t *w)
+{
+   fNFilledValues += n;
+   for (Long64_t j = 0; j < n; ++j) {
+      if (fNfill >= fTree->GetEstimate())
+         fNfill = 0;
+      fW[fNfill] = fWeight * w[j];
+      if (!fW[fNfill]) continue;
+      for (Int_t i = 0; i < fDimension; ++i)
+         fVal[i][fNfill] = vals[i][j];
+      fNfill++;
+      if (fNfill >= fTree->GetEstimate()) {
+         TakeAction();
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Called in the entry loop for all entries accepted by Select.
 /// Case where the only variable returns an object (or pointer to).
@@ -0,0 +1,311 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TTreeFormulaJit.h"
+
+#include "TBranch.h"
+#include "TInterpreter.h"
+#include "TLeaf.h"
+#include "TLeafC.h"
+#include "TTree.h"
+#include "TTreeReader.h"
+#ifdef R__USE_IMT
+#include "ROOT/TTreeProcessorMT.hxx"
+#include "TROOT.h"
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+namespace {
+
+using ROOT::Internal::TTreeFormulaJit;
+
+/// Number of entries buffered by each task before they are handed over to the consumer.
+constexpr Long64_t kBufferSize = 1024;
+
+/// Buffers filled by the compiled loop of one task.
+struct RTaskBuffers {
+   std::vector<Double_t> fVals;
+   std::vector<Double_t *> fValPtrs;
+   std::vector<Double_t> fW;
+   std::vector<Long64_t> fEntries;
+   const TTreeFormulaJit::Consumer_t &fConsume;
+   std::mutex *fMutex; ///< Serializes the calls to fConsume between tasks, if not null
+
+   RTaskBuffers(UInt_t nVars, const TTreeFormulaJit::Consumer_t &consume, std::mutex *mutex)
+      : fVals(nVars * kBufferSize), fValPtrs(std::max(nVars, 1u), nullptr), fW(kBufferSize), fEntries(kBufferSize),
+        fConsume(consume), fMutex(mutex)
+   {
+      for (UInt_t i = 0; i < nVars; ++i)
+         fValPtrs[i] = fVals.data() + i * kBufferSize;
+   }
+
+   static void Consume(void *ctx, Long64_t n)
+   {
+      auto &buffers = *static_cast<RTaskBuffers *>(ctx);
+      std::unique_lock<std::mutex> lock;
+      if (buffers.fMutex)
+         lock = std::unique_lock<std::mutex>(*buffers.fMutex);
+      buffers.fConsume(n, buffers.fValPtrs.data(), buffers.fW.data(), buffers.fEntries.data());
+   }
+
+   void Process(TTreeFormulaJit::Kernel_t kernel, TTreeReader &reader)
+   {
+      kernel(reader, fValPtrs.data(), fW.data(), fEntries.data(), kBufferSize, &Consume, this);
+   }
+};
+
+/// Return whether the leaf of a scalar branch of fundamental type can be read with a TTreeReaderValue of type `type`.
+Bool_t IsSupportedLeaf(TBranch &branch, std::string &type)
+{
+   static const std::set<std::string> supportedTypes{"Bool_t",  "Char_t",   "UChar_t",   "Short_t",
+                                                     "UShort_t", "Int_t",    "UInt_t",    "Long64_t",
+                                                     "ULong64_t", "Float_t", "Double_t"};
+   if (branch.IsA() != TBranch::Class() || branch.GetNleaves() != 1)
+      return kFALSE;
+   auto leaf = static_cast<TLeaf *>(branch.GetListOfLeaves()->UncheckedAt(0));
+   if (leaf->IsA() == TLeafC::Class() || leaf->GetLeafCount() || leaf->GetLenStatic() != 1)
+      return kFALSE;
+   type = leaf->GetTypeName();
+   return supportedTypes.count(type) > 0;
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Translate the TTreeFormula expression `expr` to a C++ expression, appended to `code`. The branches read by the
+/// expression are added to `branches` (together with their types), and referred to as `v<index>` in `code`.
+/// Return false if the expression uses constructs that are not supported.
+
+Bool_t ROOT::Internal::TTreeFormulaJit::Translate(TTree &tree, const TString &expr, std::string &code,
+                                                  std::vector<std::string> &branches, std::vector<std::string> &types)
+{
+   // Functions known to TTreeFormula, with the same meaning in C++
+   static const std::map<std::string, std::string> functions{
+      {"sqrt", "std::sqrt"}, {"exp", "std::exp"},     {"log", "std::log"},     {"log10", "std::log10"},
+      {"sin", "std::sin"},   {"cos", "std::cos"},     {"tan", "std::tan"},     {"asin", "std::asin"},
+      {"acos", "std::acos"}, {"atan", "std::atan"},   {"atan2", "std::atan2"}, {"sinh", "std::sinh"},
+      {"cosh", "std::cosh"}, {"tanh", "std::tanh"},   {"abs", "std::fabs"},    {"fabs", "std::fabs"},
+      {"pow", "std::pow"}};
+   static const char *const twoCharOperators[] = {"&&", "||", "==", "!=", "<=", ">="};
+
+   const char *s = expr.Data();
+   const Ssiz_t len = expr.Length();
+   Int_t depth = 0;
+   Bool_t empty = kTRUE;
+   code += '(';
+   for (Ssiz_t i = 0; i < len;) {
+      const char c = s[i];
+      if (isspace(c)) {
+         code += ' ';
+         ++i;
+         continue;
+      }
+      empty = kFALSE;
+
+      // Numerical constant. TTreeFormula computes everything in floating point, so make sure that
+      // e.g. 1/2 is not an integer division.
+      if (isdigit(c) || (c == '.' && i + 1 < len && isdigit(s[i + 1]))) {
+         Ssiz_t j = i;
+         Int_t ndots = 0;
+         while (j < len && (isdigit(s[j]) || s[j] == '.')) {
+            ndots += s[j] == '.';
+            ++j;
+         }
+         Bool_t hasExponent = kFALSE;
+         if (j < len && (s[j] == 'e' || s[j] == 'E')) {
+            Ssiz_t k = j + 1;
+            if (k < len && (s[k] == '+' || s[k] == '-'))
+               ++k;
+            if (k < len && isdigit(s[k])) {
+               while (k < len && isdigit(s[k]))
+                  ++k;
+               j = k;
+               hasExponent = kTRUE;
+            }
+         }
+         if (ndots > 1 || (j < len && (isalnum(s[j]) || s[j] == '_' || s[j] == '.')))
+            return kFALSE;
+         code.append(s + i, j - i);
+         if (!ndots && !hasExponent)
+            code += '.';
+         i = j;
+         continue;
+      }
+
+      // Function or branch name
+      if (isalpha(c) || c == '_') {
+         Ssiz_t j = i;
+         while (j < len && (isalnum(s[j]) || s[j] == '_'))
+            ++j;
+         const std::string name(s + i, j - i);
+         Ssiz_t k = j;
+         while (k < len && isspace(s[k]))
+            ++k;
+         if (k < len && s[k] == '(') {
+            auto function = functions.find(name);
+            if (function == functions.end())
+               return kFALSE;
+            code += function->second;
+         } else if (name == "pi") {
+            code += "TMath::Pi()";
+         } else {
+            if (tree.GetAlias(name.c_str()))
+               return kFALSE;
+            TBranch *branch = tree.GetBranch(name.c_str());
+            std::string type;
+            // Friends are not supported: the branch must belong to the (current) tree.
+            if (!branch || branch->GetTree() != tree.GetTree() || !IsSupportedLeaf(*branch, type))
+               return kFALSE;
+            auto idx = std::find(branches.begin(), branches.end(), name) - branches.begin();
+            if (idx == static_cast<decltype(idx)>(branches.size())) {
+               branches.push_back(name);
+               types.push_back(type);
+            }
+            code += "Double_t(*v" + std::to_string(idx) + ")";
+         }
+         i = j;
+         continue;
+      }
+
+      // Operators
+      if (i + 1 < len) {
+         auto twoChar = std::find_if(std::begin(twoCharOperators), std::end(twoCharOperators),
+                                     [&](const char *op) { return !strncmp(op, s + i, 2); });
+         if (twoChar != std::end(twoCharOperators)) {
+            code.append(s + i, 2);
+            i += 2;
+            continue;
+         }
+      }
+      if (!strchr("+-*/<>!,()", c) || (c == '*' && i + 1 < len && s[i + 1] == '*'))
+         return kFALSE;
+      if (c == '(')
+         ++depth;
+      if (c == ')' && --depth < 0)
+         return kFALSE;
+      code += c;
+      ++i;
+   }
+   code += ')';
+   return !empty && depth == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile a loop evaluating the expressions `vars` for the entries of `tree` passing `selection` (which can be
+/// empty). Check IsValid() to know whether the expressions are supported and could be compiled.
+
+ROOT::Internal::TTreeFormulaJit::TTreeFormulaJit(TTree &tree, const std::vector<TString> &vars,
+                                                 const TString &selection)
+{
+   if (vars.size() > static_cast<std::size_t>(kMaxVars))
+      return;
+   std::vector<std::string> branches, types, exprs(vars.size());
+   for (std::size_t i = 0; i < vars.size(); ++i) {
+      if (!Translate(tree, vars[i], exprs[i], branches, types))
+         return;
+   }
+   std::string selCode;
+   if (selection.Length() && !Translate(tree, selection, selCode, branches, types))
+      return;
+
+   std::string body = "(TTreeReader &r, Double_t **vals, Double_t *w, Long64_t *entries, Long64_t size,\n"
+                      "      void (*consume)(void *, Long64_t), void *ctx)\n{\n";
+   for (std::size_t i = 0; i < branches.size(); ++i) {
+      body += "   TTreeReaderValue<" + types[i] + "> v" + std::to_string(i) + "(r, \"" + branches[i] + "\");\n";
+   }
+   body += "   Long64_t n = 0;\n   while (r.Next()) {\n";
+   if (!selCode.empty()) {
+      // Only the branches used in the selection are read for the rejected entries.
+      body += "      const Double_t sel = " + selCode + ";\n      if (sel == 0)\n         continue;\n";
+      body += "      w[n] = sel;\n";
+   } else {
+      body += "      w[n] = 1.;\n";
+   }
+   for (std::size_t i = 0; i < exprs.size(); ++i)
+      body += "      vals[" + std::to_string(i) + "][n] = " + exprs[i] + ";\n";
+   body += "      entries[n] = r.GetCurrentEntry();\n"
+           "      if (++n == size) {\n         consume(ctx, n);\n         n = 0;\n      }\n   }\n"
+           "   if (n)\n      consume(ctx, n);\n}\n";
+
+   // The same command is often repeated, e.g. with different binnings: compile each loop only once.
+   static std::unordered_map<std::string, Kernel_t> kernels;
+   static std::mutex kernelsMutex;
+   static UInt_t nDeclared = 0;
+   std::lock_guard<std::mutex> lock(kernelsMutex);
+   auto &kernel = kernels[body];
+   if (!kernel) {
+      const std::string name = "Kernel" + std::to_string(nDeclared++);
+      const std::string code = "#include \"TTreeReader.h\"\n#include \"TTreeReaderValue.h\"\n#include \"TMath.h\"\n"
+                               "#include <cmath>\nnamespace R__TTreeFormulaJit {\nvoid " +
+                               name + body + "}\n";
+      TInterpreter::EErrorCode errorCode = TInterpreter::kNoError;
+      if (gInterpreter->Declare(code.c_str()))
+         kernel = reinterpret_cast<Kernel_t>(
+            gInterpreter->Calc(("(Long_t)&R__TTreeFormulaJit::" + name).c_str(), &errorCode));
+      if (errorCode != TInterpreter::kNoError)
+         kernel = nullptr;
+      if (!kernel) {
+         kernels.erase(body);
+         return;
+      }
+   }
+   fKernel = kernel;
+   fNVars = vars.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Run the compiled loop over `nentries` entries of `tree` starting at `firstentry`, passing the values of the
+/// selected entries to `consume`. If `allowMT` is true and implicit multi-threading is enabled, clusters are
+/// processed in parallel (in which case the entry numbers passed to `consume` are not meaningful); `consume` is
+/// never called concurrently. The tree must not have an entry list.
+/// Return false if the loop could not be run.
+
+Bool_t ROOT::Internal::TTreeFormulaJit::Run(TTree &tree, Long64_t firstentry, Long64_t nentries, Bool_t allowMT,
+                                            const Consumer_t &consume) const
+{
+   if (!fKernel)
+      return kFALSE;
+   if (nentries <= 0)
+      return kTRUE;
+
+#ifdef R__USE_IMT
+   if (allowMT && ROOT::IsImplicitMTEnabled() && tree.GetCurrentFile()) {
+      std::unique_ptr<ROOT::TTreeProcessorMT> processor;
+      try {
+         processor.reset(new ROOT::TTreeProcessorMT(tree, 0u, {firstentry, firstentry + nentries}));
+      } catch (const std::exception &) {
+         // e.g. the tree is not read from a file: process it sequentially
+      }
+      if (processor) {
+         std::mutex mutex;
+         processor->Process([&](TTreeReader &reader) {
+            RTaskBuffers buffers(fNVars, consume, &mutex);
+            buffers.Process(fKernel, reader);
+         });
+         return kTRUE;
+      }
+   }
+#else
+   (void)allowMT;
+#endif
+
+   TTreeReader reader(&tree);
+   if (reader.SetEntriesRange(firstentry, firstentry + nentries) != TTreeReader::kEntryValid)
+      return kFALSE;
+   RTaskBuffers buffers(fNVars, consume, nullptr);
+   buffers.Process(fKernel, reader);
+   return kTRUE;
+}
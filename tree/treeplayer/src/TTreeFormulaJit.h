@@ -0,0 +1,69 @@
+/*************************************************************************
+ * Copyright (C) 1995-2026, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTreeFormulaJit
+#define ROOT_TTreeFormulaJit
+
+#include "RtypesCore.h"
+#include "TString.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class TTree;
+class TTreeReader;
+
+/** \class ROOT::Internal::TTreeFormulaJit
+Translate simple TTreeFormula expressions to C++ and compile them just in time, for TTree::Draw and TTree::Scan with
+the option "jit".
+
+The supported expressions are arithmetic, comparisons and logical operations on numerical constants and on scalar
+branches of fundamental type (e.g. created with `tree->Branch("x", &x, "x/F")`), and calls to the usual mathematical
+functions (sqrt, exp, log, sin, ...). Anything else (arrays, objects, aliases, friends, special variables like
+`Entry$`, ...) is rejected, in which case the caller falls back to the interpreted TTreeFormula.
+
+The selection and the expressions are compiled into a single function that loops over the entries of a TTreeReader
+and fills buffers of values and weights (the value of the selection), which are handed over to a consumer. The loop
+runs over clusters in parallel if implicit multi-threading is enabled and the tree is read from files.
+*/
+
+namespace ROOT {
+namespace Internal {
+
+class TTreeFormulaJit {
+public:
+   static constexpr Int_t kMaxVars = 4;
+
+   /// Receive `n` entries: `vals[i][j]` is the value of the i-th expression for the j-th entry, `w[j]` the value of
+   /// the selection (1 if there is none, never 0) and `entries[j]` the entry number (only valid in sequential mode).
+   using Consumer_t = std::function<void(Long64_t n, const Double_t *const *vals, const Double_t *w,
+                                         const Long64_t *entries)>;
+   /// Signature of the compiled loops.
+   using Kernel_t = void (*)(TTreeReader &reader, Double_t **vals, Double_t *w, Long64_t *entries, Long64_t size,
+                             void (*consume)(void *ctx, Long64_t n), void *ctx);
+
+private:
+   Kernel_t fKernel = nullptr;
+   UInt_t fNVars = 0;
+
+   static Bool_t Translate(TTree &tree, const TString &expr, std::string &code, std::vector<std::string> &branches,
+                           std::vector<std::string> &types);
+
+public:
+   TTreeFormulaJit(TTree &tree, const std::vector<TString> &vars, const TString &selection);
+
+   /// Whether the expressions could be compiled.
+   Bool_t IsValid() const { return fKernel != nullptr; }
+   Bool_t Run(TTree &tree, Long64_t firstentry, Long64_t nentries, Bool_t allowMT, const Consumer_t &consume) const;
+};
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -17,9 +17,29 @@ A Tree Index with majorname and minorname.
 
 #include "TTreeFormula.h"
 #include "TTree.h"
+#include "TBranch.h"
 #include "TBuffer.h"
+#include "TBufferFile.h"
+#include "TEnv.h"
+#include "TFile.h"
+#include "TLeafB.h"
+#include "TLeafI.h"
+#include "TLeafL.h"
+#include "TLeafS.h"
 #include "TMath.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TTreeProcessorMT.hxx"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <vector>
+
 ClassImp(TTreeIndex);
 
 
@@ -29,12 +49,14 @@ struct IndexSortComparator {
         : fValMajor(major), fValMinor(minor)
   {}
 
+   // Equal values are ordered by index, so that the order does not depend on the sorting algorithm
    template<typename Index>
-   bool operator()(Index i1, Index i2) {
-      if( *(fValMajor + i1) == *(fValMajor + i2) )
-         return *(fValMinor + i1) < *(fValMinor + i2);
-      else
+   bool operator()(Index i1, Index i2) const {
+      if( *(fValMajor + i1) != *(fValMajor + i2) )
          return *(fValMajor + i1) < *(fValMajor + i2);
+      if( *(fValMinor + i1) != *(fValMinor + i2) )
+         return *(fValMinor + i1) < *(fValMinor + i2);
+      return i1 < i2;
    }
 
   // pointers to the start of index values tables keeping upper 64bit and lower 64bit
@@ -42,6 +64,172 @@ struct IndexSortComparator {
   Long64_t *fValMajor, *fValMinor;
 };
 
+namespace {
+
+using ConvertFn_t = void (*)(const char *src, Long64_t *dst, Long64_t n);
+
+template <typename T>
+void ConvertValues(const char *src, Long64_t *dst, Long64_t n)
+{
+   for (Long64_t i = 0; i < n; ++i) {
+      T value;
+      memcpy(&value, src + i * sizeof(T), sizeof(T));
+      dst[i] = value;
+   }
+}
+
+/// Return the function converting the values of `branch`, as read by TBranch::GetBulkEntries, to Long64_t if
+/// `branch` holds a single integer per entry (and can therefore be read in bulk), nullptr otherwise.
+ConvertFn_t GetBulkConverter(TBranch *branch)
+{
+   if (!branch || branch->IsA() != TBranch::Class() || branch->GetListOfLeaves()->GetEntriesFast() != 1)
+      return nullptr;
+   auto leaf = static_cast<TLeaf *>(branch->GetListOfLeaves()->UncheckedAt(0));
+   if (leaf->GetLeafCount() || leaf->GetLenStatic() != 1)
+      return nullptr;
+   const bool isUnsigned = leaf->IsUnsigned();
+   if (leaf->IsA() == TLeafB::Class())
+      return isUnsigned ? &ConvertValues<UChar_t> : &ConvertValues<Char_t>;
+   if (leaf->IsA() == TLeafS::Class())
+      return isUnsigned ? &ConvertValues<UShort_t> : &ConvertValues<Short_t>;
+   if (leaf->IsA() == TLeafI::Class())
+      return isUnsigned ? &ConvertValues<UInt_t> : &ConvertValues<Int_t>;
+   // unsigned 64 bit values might not be representable as Long64_t
+   if (leaf->IsA() == TLeafL::Class() && !isUnsigned)
+      return &ConvertValues<Long64_t>;
+   return nullptr;
+}
+
+/// Read the values of the expression `name` for the entries [first, last) of `tree` (not a chain) into `values`, if
+/// `name` is the name of an integer branch or "0". `first` must be the first entry of a cluster.
+/// Return false if the values cannot be read in bulk.
+bool ReadBulkValues(TTree &tree, const TString &name, Long64_t first, Long64_t last, Long64_t *values)
+{
+   if (name == "0") {
+      std::fill(values, values + (last - first), 0);
+      return true;
+   }
+   TBranch *branch = tree.GetBranch(name);
+   ConvertFn_t convert = GetBulkConverter(branch);
+   if (!convert)
+      return false;
+   TBufferFile buf(TBuffer::kWrite, 10000);
+   for (Long64_t entry = first; entry < last;) {
+      const Int_t n = branch->GetBulkRead().GetBulkEntries(entry, buf);
+      if (n <= 0)
+         return false;
+      convert(buf.GetCurrent(), values + (entry - first), std::min<Long64_t>(n, last - entry));
+      entry += n;
+   }
+   return true;
+}
+
+/// Read the major and minor values of the first `n` entries of `tree` with bulk I/O, which is possible if they are
+/// integer branches (or "0" for the minor) and the tree is read from files which are not being written. The clusters
+/// are read in parallel if implicit multi-threading is enabled.
+/// Return false if the values cannot be read in bulk.
+bool ReadIndexValues(TTree &tree, const TString &majorName, const TString &minorName, Long64_t n, Long64_t *major,
+                     Long64_t *minor)
+{
+   // the baskets of a tree being filled might not be written yet
+   if (!tree.GetCurrentFile() || tree.GetCurrentFile()->IsWritable())
+      return false;
+   if (!GetBulkConverter(tree.GetBranch(majorName)) ||
+       (minorName != "0" && !GetBulkConverter(tree.GetBranch(minorName))))
+      return false;
+
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled()) {
+      std::unique_ptr<ROOT::TTreeProcessorMT> processor;
+      try {
+         // with an explicit range, the entry ranges of the tasks are global entry numbers
+         processor.reset(new ROOT::TTreeProcessorMT(tree, 0u, {0ll, n}));
+      } catch (const std::exception &) {
+         // e.g. the tree is not read from a file: read it sequentially
+      }
+      if (processor) {
+         std::atomic<bool> ok{true};
+         processor->Process([&](TTreeReader &reader) {
+            const auto range = reader.GetEntriesRange();
+            TTree *chain = reader.GetTree();
+            const Long64_t local = chain->LoadTree(range.first);
+            const Long64_t last = local + range.second - range.first;
+            if (local < 0 || !ReadBulkValues(*chain->GetTree(), majorName, local, last, major + range.first) ||
+                !ReadBulkValues(*chain->GetTree(), minorName, local, last, minor + range.first))
+               ok = false;
+         });
+         return ok;
+      }
+   }
+#endif
+
+   for (Long64_t entry = 0; entry < n;) {
+      const Long64_t local = tree.LoadTree(entry);
+      if (local < 0)
+         return false;
+      TTree *t = tree.GetTree();
+      const Long64_t last = std::min(t->GetEntries(), local + n - entry);
+      if (last <= local || !ReadBulkValues(*t, majorName, local, last, major + entry) ||
+          !ReadBulkValues(*t, minorName, local, last, minor + entry))
+         return false;
+      entry += last - local;
+   }
+   return true;
+}
+
+/// Sort [first, last) according to `comp`. If implicit multi-threading is enabled, chunks are sorted in parallel
+/// and then merged pairwise in parallel.
+template <typename Comp>
+void SortIndex(Long64_t *first, Long64_t *last, const Comp &comp)
+{
+#ifdef R__USE_IMT
+   const Long64_t n = last - first;
+   const Long64_t minChunkSize = 1 << 16;
+   if (ROOT::IsImplicitMTEnabled() && n >= 2 * minChunkSize) {
+      ROOT::TThreadExecutor pool;
+      const UInt_t nChunks = std::min<Long64_t>(pool.GetPoolSize(), n / minChunkSize);
+      std::vector<Long64_t *> bounds(nChunks + 1);
+      for (UInt_t i = 0; i <= nChunks; ++i)
+         bounds[i] = first + n * i / nChunks;
+      pool.Foreach([&](UInt_t i) { std::sort(bounds[i], bounds[i + 1], comp); }, ROOT::TSeqU(nChunks));
+      for (UInt_t width = 1; width < nChunks; width *= 2) {
+         std::vector<UInt_t> merges;
+         for (UInt_t i = 0; i + width < nChunks; i += 2 * width)
+            merges.push_back(i);
+         pool.Foreach(
+            [&](UInt_t i) {
+               std::inplace_merge(bounds[i], bounds[i + width], bounds[std::min(i + 2 * width, nChunks)], comp);
+            },
+            merges);
+      }
+      return;
+   }
+#endif
+   std::sort(first, last, comp);
+}
+
+/// Replace the values by their differences to the previous ones (modulo 2^64).
+void DeltaEncode(const Long64_t *values, Long64_t *deltas, Long64_t n)
+{
+   ULong64_t previous = 0;
+   for (Long64_t i = 0; i < n; ++i) {
+      deltas[i] = static_cast<ULong64_t>(values[i]) - previous;
+      previous = values[i];
+   }
+}
+
+/// Revert DeltaEncode(), in place.
+void DeltaDecode(Long64_t *values, Long64_t n)
+{
+   ULong64_t previous = 0;
+   for (Long64_t i = 0; i < n; ++i) {
+      previous += static_cast<ULong64_t>(values[i]);
+      values[i] = previous;
+   }
+}
+
+} // namespace
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor for TTreeIndex
@@ -57,6 +245,7 @@ TTreeIndex::TTreeIndex(): TVirtualIndex()
    fMinorFormula       = 0;
    fMajorFormulaParent = 0;
    fMinorFormulaParent = 0;
+   fDeltaEncoding      = kFALSE;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -118,6 +307,14 @@ TTreeIndex::TTreeIndex(): TVirtualIndex()
 ///
 /// Note that this function can also be applied to a TChain.
 ///
+/// If majorname and minorname are names of branches holding one integer per
+/// entry (or minorname is "0"), the values are read with bulk I/O, with the
+/// clusters read in parallel if implicit multi-threading is enabled (see
+/// ROOT::EnableImplicitMT). The sort of the index is then also parallel.
+///
+/// The index can be delta-encoded when it is written, which makes it much
+/// smaller on disk once compressed, see SetDeltaEncoding().
+///
 /// The return value is the number of entries in the Index (< 0 indicates failure)
 ///
 /// It is possible to play with different TreeIndex in the same Tree.
@@ -137,6 +334,7 @@ TTreeIndex::TTreeIndex(const TTree *T, const char *majorname, const char *minorn
    fMinorFormulaParent = 0;
    fMajorName          = majorname;
    fMinorName          = minorname;
+   fDeltaEncoding      = gEnv->GetValue("TTreeIndex.DeltaEncoding", 0) != 0;
    if (!T) return;
    fN = T->GetEntries();
    if (fN <= 0) {
@@ -169,7 +367,8 @@ TTreeIndex::TTreeIndex(const TTree *T, const char *majorname, const char *minorn
    Long64_t i;
    Long64_t oldEntry = fTree->GetReadEntry();
    Int_t current = -1;
-   for (i=0;i<fN;i++) {
+   const bool bulk = ReadIndexValues(*fTree, fMajorName, fMinorName, fN, tmp_major, tmp_minor);
+   for (i=0;i<fN && !bulk;i++) {
       Long64_t centry = fTree->LoadTree(i);
       if (centry < 0) break;
       if (fTree->GetTreeNumber() != current) {
@@ -200,18 +399,23 @@ TTreeIndex::TTreeIndex(const TTree *T, const char *majorname, const char *minorn
       tmp_minor[i] = GetAndRangeCheck(false, i);
    }
    fIndex = new Long64_t[fN];
-   for(i = 0; i < fN; i++) { fIndex[i] = i; }
-   std::sort(fIndex, fIndex + fN, IndexSortComparator(tmp_major, tmp_minor) );
-   //TMath::Sort(fN,w,fIndex,0);
-   fIndexValues = new Long64_t[fN];
-   fIndexValuesMinor = new Long64_t[fN];
-   for (i=0;i<fN;i++) {
-      fIndexValues[i] = tmp_major[fIndex[i]];
-      fIndexValuesMinor[i] = tmp_minor[fIndex[i]];
+   std::iota(fIndex, fIndex + fN, 0ll);
+   IndexSortComparator comp(tmp_major, tmp_minor);
+   if (std::is_sorted(fIndex, fIndex + fN, comp)) {
+      // the values are already sorted (e.g. filled in order of run and event numbers): use them as they are
+      fIndexValues = tmp_major;
+      fIndexValuesMinor = tmp_minor;
+   } else {
+      SortIndex(fIndex, fIndex + fN, comp);
+      fIndexValues = new Long64_t[fN];
+      fIndexValuesMinor = new Long64_t[fN];
+      for (i=0;i<fN;i++) {
+         fIndexValues[i] = tmp_major[fIndex[i]];
+         fIndexValuesMinor[i] = tmp_minor[fIndex[i]];
+      }
+      delete [] tmp_major;
+      delete [] tmp_minor;
    }
-
-   delete [] tmp_major;
-   delete [] tmp_minor;
    fTree->LoadTree(oldEntry);
 }
 
@@ -290,7 +494,7 @@ void TTreeIndex::Append(const TVirtualIndex *add, Bool_t delaySort )
       Long64_t *conv = new Long64_t[fN];
 
       for(Long64_t i = 0; i < fN; i++) { conv[i] = i; }
-      std::sort(conv, conv+fN, IndexSortComparator(addValues, addValues2) );
+      SortIndex(conv, conv+fN, IndexSortComparator(addValues, addValues2) );
       //Long64_t *w = fIndexValues;
       //TMath::Sort(fN,w,conv,0);
 
@@ -573,10 +777,24 @@ void TTreeIndex::Print(Option_t * option) const
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set whether the index arrays are delta-encoded when the index is written:
+/// the difference of each value to the previous one is stored instead of the
+/// value. The sorted values, and often the entry numbers, then become small
+/// numbers which compress much better. The default is taken from the
+/// TTreeIndex.DeltaEncoding resource (0 if not set).
+
+void TTreeIndex::SetDeltaEncoding(Bool_t delta)
+{
+   fDeltaEncoding = delta;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Stream an object of class TTreeIndex.
 /// Note that this Streamer should be changed to an automatic Streamer
 /// once TStreamerInfo supports an index of type Long64_t
+/// Version 3, which adds the delta encoding flag, is only written if delta
+/// encoding is enabled; otherwise the index is written as version 2.
 
 void TTreeIndex::Streamer(TBuffer &R__b)
 {
@@ -587,6 +805,10 @@ void TTreeIndex::Streamer(TBuffer &R__b)
       fMajorName.Streamer(R__b);
       fMinorName.Streamer(R__b);
       R__b >> fN;
+      fDeltaEncoding = kFALSE;
+      if( R__v > 2 ) {
+         R__b >> fDeltaEncoding;
+      }
       fIndexValues = new Long64_t[fN];
       R__b.ReadFastArray(fIndexValues,fN);
       if( R__v > 1 ) {
@@ -597,16 +819,40 @@ void TTreeIndex::Streamer(TBuffer &R__b)
       }
       fIndex      = new Long64_t[fN];
       R__b.ReadFastArray(fIndex,fN);
+      if (fDeltaEncoding) {
+         DeltaDecode(fIndexValues, fN);
+         DeltaDecode(fIndexValuesMinor, fN);
+         DeltaDecode(fIndex, fN);
+      }
       R__b.CheckByteCount(R__s, R__c, TTreeIndex::IsA());
    } else {
       R__c = R__b.WriteVersion(TTreeIndex::IsA(), kTRUE);
+      // Without delta encoding, write version 2, which older releases can read: overwrite the class version that
+      // was just written
+      const Bool_t writeV2 = !fDeltaEncoding && dynamic_cast<TBufferFile *>(&R__b);
+      if (writeV2) {
+         R__b.SetBufferOffset(R__b.Length() - sizeof(Version_t));
+         R__b << Version_t(2);
+      }
       TVirtualIndex::Streamer(R__b);
       fMajorName.Streamer(R__b);
       fMinorName.Streamer(R__b);
       R__b << fN;
-      R__b.WriteFastArray(fIndexValues, fN);
-      R__b.WriteFastArray(fIndexValuesMinor, fN);
-      R__b.WriteFastArray(fIndex, fN);
+      if (!writeV2)
+         R__b << fDeltaEncoding;
+      if (fDeltaEncoding) {
+         std::vector<Long64_t> deltas(fN);
+         DeltaEncode(fIndexValues, deltas.data(), fN);
+         R__b.WriteFastArray(deltas.data(), fN);
+         DeltaEncode(fIndexValuesMinor, deltas.data(), fN);
+         R__b.WriteFastArray(deltas.data(), fN);
+         DeltaEncode(fIndex, deltas.data(), fN);
+         R__b.WriteFastArray(deltas.data(), fN);
+      } else {
+         R__b.WriteFastArray(fIndexValues, fN);
+         R__b.WriteFastArray(fIndexValuesMinor, fN);
+         R__b.WriteFastArray(fIndex, fN);
+      }
       R__b.SetByteCount(R__c, kTRUE);
    }
 }
@@ -54,6 +54,7 @@ extra libraries (Histogram, display, etc).
 #include "TProfile2D.h"
 #include "TTreeFormula.h"
 #include "TTreeFormulaManager.h"
+#include "TTreeFormulaJit.h"
 #include "TStyle.h"
 #include "Foption.h"
 #include "TTreeResult.h"
@@ -110,6 +111,7 @@ TTreePlayer::TTreePlayer()
    fSelectorFromFile = 0;
    fSelectorClass    = 0;
    fSelectorUpdate   = 0;
+   fJitDraw          = kFALSE;
    fInput            = new TList();
    fInput->Add(new TNamed("varexp",""));
    fInput->Add(new TNamed("selection",""));
@@ -396,10 +398,14 @@ Long64_t TTreePlayer::DrawSelect(const char *varexp0, const char *selection, Opt
 
    TString opt = option;
    opt.ToLower();
+   TString drawOption = option;
+   Bool_t optjit    = kFALSE;
    Bool_t optpara   = kFALSE;
    Bool_t optcandle = kFALSE;
    Bool_t optgl5d   = kFALSE;
    Bool_t optnorm   = kFALSE;
+   Ssiz_t jitPos = opt.Index("jit");
+   if (jitPos != kNPOS) {optjit = kTRUE; opt.Remove(jitPos,3); drawOption.Remove(jitPos,3);}
    if (opt.Contains("norm")) {optnorm = kTRUE; opt.ReplaceAll("norm",""); opt.ReplaceAll(" ","");}
    if (opt.Contains("para")) optpara = kTRUE;
    if (opt.Contains("candle")) optcandle = kTRUE;
@@ -417,7 +423,9 @@ Long64_t TTreePlayer::DrawSelect(const char *varexp0, const char *selection, Opt
    if (nentries > fTree->GetMaxEntryLoop()) nentries = fTree->GetMaxEntryLoop();
 
    // invoke the selector
-   Long64_t nrows = Process(fSelector,option,nentries,firstentry);
+   fJitDraw = optjit;
+   Long64_t nrows = Process(fSelector,drawOption,nentries,firstentry);
+   fJitDraw = kFALSE;
    fSelectedRows = nrows;
    fDimension = fSelector->GetDimension();
 
@@ -2287,7 +2295,10 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
       fSelectorUpdate = selector;
       UpdateFormulaLeaves();
 
-      for (entry=firstentry;entry<firstentry+nentries;entry++) {
+      // With the option "jit" of DrawSelect, the entries are processed by compiled expressions if possible.
+      Bool_t jitDone = fJitDraw && selector == fSelector && ProcessDrawJit(nentries, firstentry);
+
+      for (entry=firstentry;!jitDone && entry<firstentry+nentries;entry++) {
          entryNumber = fTree->GetEntryNumber(entry);
          if (entryNumber < 0) break;
          if (timer && timer->ProcessEvents()) break;
@@ -2337,6 +2348,60 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
    return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the output of fSelector using expressions compiled by
+/// ROOT::Internal::TTreeFormulaJit, for DrawSelect with the option "jit".
+/// The clusters are processed in parallel if implicit multi-threading is
+/// enabled. Returns kFALSE, without processing any entry, if the expressions
+/// or the requested output are not supported.
+
+Bool_t TTreePlayer::ProcessDrawJit(Long64_t nentries, Long64_t firstentry)
+{
+   if (!fSelector->CanFillValues() || fTree->GetEntryList() || fTree->GetEventList()) {
+      if (gDebug > 0) Info("DrawSelect", "The option \"jit\" is not supported for this output, using TTreeFormula");
+      return kFALSE;
+   }
+   std::vector<TString> vars;
+   for (Int_t i = 0; i < fSelector->GetDimension(); ++i)
+      vars.emplace_back(fSelector->GetVar(i)->GetTitle());
+   TTreeFormula *select = fSelector->GetSelect();
+   ROOT::Internal::TTreeFormulaJit jit(*fTree, vars, select ? select->GetTitle() : "");
+   if (!jit.IsValid()) {
+      if (gDebug > 0) Info("DrawSelect", "The expressions cannot be compiled with the option \"jit\", using TTreeFormula");
+      return kFALSE;
+   }
+   // Only histograms are filled from the worker threads: the other outputs (graphs, ...) may be drawn while filling.
+   const Int_t action = TMath::Abs(fSelector->GetAction());
+   const Bool_t allowMT = !fTree->GetUpdate() && (action == 1 || action == 2 || action == 4);
+   return jit.Run(*fTree, firstentry, nentries, allowMT,
+                  [this](Long64_t n, const Double_t *const *vals, const Double_t *w, const Long64_t *) {
+                     fSelector->ProcessFillValues(n, vals, w);
+                  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a new entry list with the entries in [firstentry, firstentry+nentries)
+/// passing selection, evaluated by a compiled expression, or nullptr if the
+/// selection is not supported by ROOT::Internal::TTreeFormulaJit.
+/// The caller owns the list.
+
+TEntryList *TTreePlayer::JitSelectEntries(const char *selection, Long64_t nentries, Long64_t firstentry)
+{
+   ROOT::Internal::TTreeFormulaJit jit(*fTree, {}, selection);
+   if (!jit.IsValid()) return nullptr;
+   std::vector<Long64_t> entries;
+   // Sequential, to get meaningful entry numbers.
+   Bool_t ok = jit.Run(*fTree, firstentry, nentries, kFALSE,
+                       [&entries](Long64_t n, const Double_t *const *, const Double_t *, const Long64_t *e) {
+                          entries.insert(entries.end(), e, e + n);
+                       });
+   if (!ok) return nullptr;
+   TEntryList *elist = new TEntryList("jitselection", selection);
+   for (Long64_t entry : entries)
+      elist->Enter(entry, fTree);
+   return elist;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// cleanup pointers in the player pointing to obj
 
@@ -2414,6 +2479,9 @@ void TTreePlayer::RecursiveRemove(TObject *obj)
 ///       conversion specifier is given, will be suffixed by the letter g.
 ///       before being passed to fprintf.  If no format is specified for a
 ///       column, the default is used  (aka ${colsize}.${precision}g )
+/// -  jit
+///       Evaluate the selection with compiled code in a first pass and
+///       only scan the selected entries (see the option "jit" of TTree::Draw).
 ///
 /// For example:
 /// ~~~{.cpp}
@@ -2433,6 +2501,24 @@ Long64_t TTreePlayer::Scan(const char *varexp, const char *selection,
 
    TString opt = option;
    opt.ToLower();
+
+   // With the option "jit", the selection is evaluated by a compiled expression
+   // in a first pass and the selected entries are then scanned.
+   Ssiz_t jitPos = opt.Index("jit");
+   if (jitPos != kNPOS) {
+      TString scanOption = option;
+      scanOption.Remove(jitPos,3);
+      TEntryList *selected = nullptr;
+      if (selection && strlen(selection) && !fTree->GetEntryList() && !fTree->GetEventList())
+         selected = JitSelectEntries(selection, GetEntriesToProcess(firstentry, nentries), firstentry);
+      if (!selected) return Scan(varexp, selection, scanOption, nentries, firstentry);
+      fTree->SetEntryList(selected);
+      Long64_t nsel = Scan(varexp, "", scanOption, selected->GetN(), 0);
+      fTree->SetEntryList(nullptr);
+      delete selected;
+      return nsel;
+   }
+
    UInt_t ui;
    UInt_t lenmax = 0;
    UInt_t colDefaultSize = 9;
@@ -65,51 +65,62 @@ ConvertToElistClusters(std::vector<std::vector<EntryRange>> &&clusters, TEntryLi
    const bool listHasGlobalEntryNumbers = entryList.GetLists() == nullptr;
    const auto nFiles = clusters.size();
 
-   std::unique_ptr<TChain> chain;
-   using NextFn_t = Long64_t (*)(Long64_t &, TEntryList &, TChain *);
-   // A function that advances TEntryList and returns global entry numbers or -1 if we reached the end
-   // (might or might not need a TChain depending on whether listHasGlobalEntryNumbers)
-   NextFn_t Next;
+   std::vector<std::vector<EntryRange>> elistClusters;
+
    if (listHasGlobalEntryNumbers) {
-      Next = [](Long64_t &elEntry, TEntryList &elist, TChain *) {
-         ++elEntry;
-         return elist.Next();
-      };
+      // The entry list positions of the cluster boundaries are counted from the blocks of the list, so that clusters
+      // without entries in the list are skipped without iterating over the entries
+      std::vector<Long64_t> boundaries;
+      for (const auto &fileClusters : clusters) {
+         for (const auto &c : fileClusters) {
+            boundaries.emplace_back(c.first);
+            boundaries.emplace_back(c.second);
+         }
+      }
+      const auto elistBoundaries = entryList.GetNEntriesBelow(boundaries);
+      auto boundary = elistBoundaries.begin();
+      for (const auto &fileClusters : clusters) {
+         std::vector<EntryRange> elistClustersForFile;
+         for (auto i = 0u; i < fileClusters.size(); ++i, boundary += 2) {
+            if (boundary[0] < boundary[1]) // otherwise no entrylist entries in this cluster
+               elistClustersForFile.emplace_back(EntryRange{boundary[0], boundary[1]});
+         }
+         elistClusters.emplace_back(std::move(elistClustersForFile));
+      }
    } else {
       // we need `chain` to be able to convert local entry numbers to global entry numbers in `Next`
-      chain = ROOT::Internal::TreeUtils::MakeChainForMT();
+      auto chain = ROOT::Internal::TreeUtils::MakeChainForMT();
       for (auto i = 0u; i < nFiles; ++i)
          chain->Add((fileNames[i] + "?#" + treeNames[i]).c_str(), entriesPerFile[i]);
-      Next = [](Long64_t &elEntry, TEntryList &elist, TChain *ch) {
+      // Advance the TEntryList and return global entry numbers or -1 if we reached the end
+      auto Next = [&chain](Long64_t &elEntry, TEntryList &elist) {
          ++elEntry;
          int treenum = -1;
          Long64_t localEntry = elist.GetEntryAndTree(elEntry, treenum);
          if (localEntry == -1ll)
             return localEntry;
-         return localEntry + ch->GetTreeOffset()[treenum];
+         return localEntry + chain->GetTreeOffset()[treenum];
       };
-   }
-
-   // the call to GetEntry also serves the purpose to reset TEntryList::fLastIndexQueried,
-   // so we can be sure TEntryList::Next will return the correct thing
-   Long64_t elistEntry = 0ll;
-   Long64_t entry = entryList.GetEntry(elistEntry);
 
-   std::vector<std::vector<EntryRange>> elistClusters;
-
-   for (auto fileN = 0u; fileN < nFiles; ++fileN) {
-      std::vector<EntryRange> elistClustersForFile;
-      for (const auto &c : clusters[fileN]) {
-         if (entry >= c.second || entry == -1ll) // no entrylist entries in this cluster
-            continue;
-         R__ASSERT(entry >= c.first); // current entry should never come before the cluster we are looking at
-         const Long64_t elistRangeStart = elistEntry;
-         // advance entry list until the entrylist entry goes beyond the end of the cluster
-         while (entry < c.second && entry != -1ll)
-            entry = Next(elistEntry, entryList, chain.get());
-         elistClustersForFile.emplace_back(EntryRange{elistRangeStart, elistEntry});
+      // the call to GetEntry also serves the purpose to reset TEntryList::fLastIndexQueried,
+      // so we can be sure TEntryList::Next will return the correct thing
+      Long64_t elistEntry = 0ll;
+      Long64_t entry = entryList.GetEntry(elistEntry);
+
+      for (auto fileN = 0u; fileN < nFiles; ++fileN) {
+         std::vector<EntryRange> elistClustersForFile;
+         for (const auto &c : clusters[fileN]) {
+            if (entry >= c.second || entry == -1ll) // no entrylist entries in this cluster
+               continue;
+            R__ASSERT(entry >= c.first); // current entry should never come before the cluster we are looking at
+            const Long64_t elistRangeStart = elistEntry;
+            // advance entry list until the entrylist entry goes beyond the end of the cluster
+            while (entry < c.second && entry != -1ll)
+               entry = Next(elistEntry, entryList);
+            elistClustersForFile.emplace_back(EntryRange{elistRangeStart, elistEntry});
+         }
+         elistClusters.emplace_back(std::move(elistClustersForFile));
       }
-      elistClusters.emplace_back(std::move(elistClustersForFile));
    }
 
    R__ASSERT(elistClusters.size() == clusters.size()); // same number of files
@@ -18,6 +18,8 @@
 #include "TTreeReaderValue.h"
 #include "TFriendProxy.h"
 
+#include <algorithm>
+
 
 // clang-format off
 /**
@@ -368,9 +370,12 @@ Bool_t TTreeReader::SetProxies() {
    //    upon creation of the TTreeReader{Value, Array}s
    // 3. We stop the learning phase.
    // Operations 1, 2 and 3 need to happen in this order. See: https://sft.its.cern.ch/jira/browse/ROOT-9773?focusedCommentId=87837
+   // The branches requested via SetCacheDeferredBranches are then marked as deferred, so that their
+   // baskets are only read for the entries that are actually loaded.
    if (fProxiesSet) {
       const auto curFile = fTree->GetCurrentFile();
-      if (curFile && fTree->GetTree()->GetReadCache(curFile, true)) {
+      TTreeCache *cache = curFile ? fTree->GetTree()->GetReadCache(curFile, true) : nullptr;
+      if (cache) {
          if (!(-1LL == fEndEntry && 0ULL == fBeginEntry)) {
             // We need to avoid to pass -1 as end entry to the SetCacheEntryRange method
             const auto lastEntry = (-1LL == fEndEntry) ? fTree->GetEntriesFast() : fEndEntry;
@@ -379,6 +384,12 @@ Bool_t TTreeReader::SetProxies() {
          for (auto value: fValues) {
             fTree->AddBranchToCache(value->GetProxy()->GetBranchName(), true);
          }
+         for (auto value : fValues) {
+            const char *branchName = value->GetProxy()->GetBranchName();
+            if (std::find(fCacheDeferredBranches.begin(), fCacheDeferredBranches.end(), branchName) !=
+                fCacheDeferredBranches.end())
+               cache->DeferBranch(branchName, true);
+         }
          fTree->StopCacheLearningPhase();
       }
    }
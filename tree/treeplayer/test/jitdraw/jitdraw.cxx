@@ -0,0 +1,120 @@
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TROOT.h"
+#include "TSelectorDraw.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+class TTreeJitDraw : public ::testing::Test {
+protected:
+   static constexpr const char *fFileName = "ttree_jitdraw.root";
+
+   static void SetUpTestCase()
+   {
+      TFile f(fFileName, "RECREATE");
+      TTree t("t", "t");
+      float x = 0;
+      int n = 0;
+      double y = 0;
+      t.Branch("x", &x, "x/F");
+      t.Branch("n", &n, "n/I");
+      t.Branch("y", &y, "y/D");
+      t.SetAutoFlush(1000);
+      for (int i = 0; i < 10000; ++i) {
+         x = (i % 97) * 0.5f;
+         n = i % 7;
+         y = -i * 0.01;
+         t.Fill();
+      }
+      t.Write();
+   }
+
+   static void TearDownTestCase() { gSystem->Unlink(fFileName); }
+
+   /// The number of entries filled by the compiled expressions in the last TTree::Draw, 0 if it used TTreeFormula.
+   static Long64_t GetNJitFilled(TTree &t)
+   {
+      auto selector = dynamic_cast<TSelectorDraw *>(t.GetPlayer()->GetSelector());
+      EXPECT_NE(selector, nullptr);
+      return selector ? selector->GetNFilledValues() : -1;
+   }
+
+   /// Draw into the histogram `name`, with the given `binning` (e.g. "(50,0,50)", empty for automatic binning), with
+   /// and without the option "jit" and check that the results are the same, and that the option "jit" used the
+   /// compiled expressions only if `expectJit`.
+   static void CheckSameHistogram(TTree &t, const char *varexp, const char *name, const char *binning,
+                                  const char *selection, bool expectJit = true)
+   {
+      const TString interpreted = TString::Format("%s>>%s_interpreted%s", varexp, name, binning);
+      const TString jitted = TString::Format("%s>>%s_jitted%s", varexp, name, binning);
+      const auto nInterpreted = t.Draw(interpreted, selection, "goff");
+      EXPECT_EQ(GetNJitFilled(t), 0);
+      const auto nJitted = t.Draw(jitted, selection, "goff jit");
+      if (expectJit)
+         EXPECT_GE(GetNJitFilled(t), nJitted) << varexp << " was not drawn with the compiled expressions";
+      else
+         EXPECT_EQ(GetNJitFilled(t), 0) << varexp << " was not expected to be supported by the option \"jit\"";
+      EXPECT_EQ(nInterpreted, nJitted);
+      auto hInterpreted = gDirectory->Get<TH1>(TString::Format("%s_interpreted", name).Data());
+      auto hJitted = gDirectory->Get<TH1>(TString::Format("%s_jitted", name).Data());
+      ASSERT_NE(hInterpreted, nullptr);
+      ASSERT_NE(hJitted, nullptr);
+      EXPECT_EQ(hInterpreted->GetNcells(), hJitted->GetNcells());
+      EXPECT_DOUBLE_EQ(hInterpreted->GetSumOfWeights(), hJitted->GetSumOfWeights());
+      for (Int_t bin = 0; bin < hInterpreted->GetNcells(); ++bin)
+         EXPECT_DOUBLE_EQ(hInterpreted->GetBinContent(bin), hJitted->GetBinContent(bin)) << "bin " << bin;
+   }
+
+   void Run()
+   {
+      TFile f(fFileName);
+      auto t = f.Get<TTree>("t");
+      ASSERT_NE(t, nullptr);
+      // Histograms must not be attached to the file, which is closed at the end of the test
+      TDirectory::TContext ctxt(gROOT);
+
+      CheckSameHistogram(*t, "x", "h1", "(50,0,50)", "");
+      CheckSameHistogram(*t, "sqrt(x)*2+1/2", "h2", "(50,0,20)", "n>2 && y<-10");
+      // Non-boolean selections are weights
+      CheckSameHistogram(*t, "x", "h3", "(50,0,50)", "n*0.5");
+      CheckSameHistogram(*t, "y:x", "h4", "(10,0,50,10,-100,0)", "n!=3");
+      // Automatic binning
+      CheckSameHistogram(*t, "x*2", "h5", "", "n<4");
+      // Not supported, falls back to TTreeFormula
+      CheckSameHistogram(*t, "x+Entry$", "h6", "(50,0,20000)", "", /*expectJit=*/false);
+      CheckSameHistogram(*t, "x%3", "h7", "(10,0,10)", "", /*expectJit=*/false);
+   }
+};
+
+TEST_F(TTreeJitDraw, Sequential)
+{
+   Run();
+}
+
+#ifdef R__USE_IMT
+TEST_F(TTreeJitDraw, MultiThreaded)
+{
+   ROOT::EnableImplicitMT(4);
+   Run();
+   ROOT::DisableImplicitMT();
+}
+#endif
+
+TEST_F(TTreeJitDraw, Scan)
+{
+   TFile f(fFileName);
+   auto t = f.Get<TTree>("t");
+   ASSERT_NE(t, nullptr);
+   t->SetScanField(0);
+   const auto interpreted = t->Scan("x:n", "n==3 && x>40", "", 500, 1000);
+   const auto jitted = t->Scan("x:n", "n==3 && x>40", "jit", 500, 1000);
+   EXPECT_EQ(interpreted, jitted);
+   EXPECT_GT(jitted, 0);
+   EXPECT_EQ(t->GetEntryList(), nullptr);
+}
@@ -0,0 +1,160 @@
+#include "TBufferFile.h"
+#include "TChain.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeIndex.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <vector>
+
+class TTreeIndexTest : public ::testing::Test {
+protected:
+   static constexpr int fNFiles = 2;
+   static constexpr int fNEntries = 20000;
+
+   static std::string FileName(int i) { return "ttreeindex_" + std::to_string(i) + ".root"; }
+
+   static void SetUpTestCase()
+   {
+      for (int i = 0; i < fNFiles; ++i) {
+         TFile f(FileName(i).c_str(), "RECREATE");
+         TTree t("t", "t");
+         int run = 0;
+         Long64_t event = 0;
+         short sorted = 0;
+         t.Branch("run", &run);
+         t.Branch("event", &event);
+         t.Branch("sorted", &sorted);
+         t.SetAutoFlush(1000);
+         for (int j = 0; j < fNEntries; ++j) {
+            // not in order, and with negative values
+            run = (j * 7919) % 13 - 5 + i;
+            event = (static_cast<Long64_t>(j) * 104729) % 100003 - 50000;
+            sorted = j / 100;
+            t.Fill();
+         }
+         t.Write();
+      }
+   }
+
+   static void TearDownTestCase()
+   {
+      for (int i = 0; i < fNFiles; ++i)
+         gSystem->Unlink(FileName(i).c_str());
+   }
+
+   static void ExpectSameIndex(const TTreeIndex &index1, const TTreeIndex &index2)
+   {
+      ASSERT_EQ(index1.GetN(), index2.GetN());
+      for (Long64_t i = 0; i < index1.GetN(); ++i) {
+         EXPECT_EQ(index1.GetIndexValues()[i], index2.GetIndexValues()[i]);
+         EXPECT_EQ(index1.GetIndexValuesMinor()[i], index2.GetIndexValuesMinor()[i]);
+         EXPECT_EQ(index1.GetIndex()[i], index2.GetIndex()[i]);
+      }
+   }
+
+   /// Build the index with integer branches, read in bulk, and with expressions evaluated by TTreeFormula, and check
+   /// that the results are the same.
+   static void CheckIndex(TTree &t, const char *major, const char *minor, const char *majorExpr, const char *minorExpr)
+   {
+      TTreeIndex bulk(&t, major, minor);
+      TTreeIndex formula(&t, majorExpr, minorExpr);
+      ASSERT_FALSE(bulk.IsZombie());
+      ASSERT_FALSE(formula.IsZombie());
+      ExpectSameIndex(bulk, formula);
+      for (Long64_t i = 1; i < bulk.GetN(); ++i) {
+         const auto *values = bulk.GetIndexValues();
+         const auto *minors = bulk.GetIndexValuesMinor();
+         ASSERT_TRUE(values[i - 1] < values[i] || (values[i - 1] == values[i] && minors[i - 1] <= minors[i]));
+      }
+   }
+
+   static void Run()
+   {
+      {
+         TFile f(FileName(0).c_str());
+         auto t = f.Get<TTree>("t");
+         ASSERT_NE(t, nullptr);
+         CheckIndex(*t, "run", "event", "run*1", "event+0");
+         CheckIndex(*t, "sorted", "0", "sorted+0", "0");
+      }
+      TChain c("t");
+      for (int i = 0; i < fNFiles; ++i)
+         c.Add(FileName(i).c_str());
+      CheckIndex(c, "run", "event", "run*1", "event+0");
+      CheckIndex(c, "event", "0", "event+0", "0");
+   }
+};
+
+TEST_F(TTreeIndexTest, Build)
+{
+   Run();
+}
+
+#ifdef R__USE_IMT
+TEST_F(TTreeIndexTest, BuildMT)
+{
+   ROOT::EnableImplicitMT(4);
+   Run();
+   ROOT::DisableImplicitMT();
+}
+#endif
+
+TEST_F(TTreeIndexTest, GetEntryWithIndex)
+{
+   TFile f(FileName(1).c_str());
+   auto t = f.Get<TTree>("t");
+   ASSERT_NE(t, nullptr);
+   ASSERT_GT(t->BuildIndex("run", "event"), 0);
+   int run = 0;
+   Long64_t event = 0;
+   t->SetBranchAddress("run", &run);
+   t->SetBranchAddress("event", &event);
+   for (Long64_t entry : {0ll, 1ll, 777ll, 19999ll}) {
+      t->GetEntry(entry);
+      const int expectedRun = run;
+      const Long64_t expectedEvent = event;
+      EXPECT_GT(t->GetEntryWithIndex(expectedRun, expectedEvent), 0);
+      EXPECT_EQ(run, expectedRun);
+      EXPECT_EQ(event, expectedEvent);
+   }
+   EXPECT_EQ(t->GetEntryNumberWithIndex(1000, 0), -1);
+}
+
+TEST_F(TTreeIndexTest, DeltaEncoding)
+{
+   const char *fname = "ttreeindex_delta.root";
+   std::unique_ptr<TTreeIndex> index;
+   {
+      TFile f(FileName(0).c_str());
+      auto t = f.Get<TTree>("t");
+      ASSERT_NE(t, nullptr);
+      index.reset(new TTreeIndex(t, "run", "event"));
+      // the tree is deleted with the file
+      index->SetTree(nullptr);
+   }
+   for (Bool_t delta : {kFALSE, kTRUE}) {
+      index->SetDeltaEncoding(delta);
+      // without delta encoding, the layout of version 2 is written so that older releases can read it
+      TBufferFile buf(TBuffer::kWrite);
+      index->Streamer(buf);
+      buf.SetReadMode();
+      buf.SetBufferOffset(0);
+      UInt_t start, count;
+      EXPECT_EQ(buf.ReadVersion(&start, &count), delta ? 3 : 2);
+      {
+         TFile f(fname, "RECREATE");
+         f.WriteObject(index.get(), "index");
+      }
+      TFile f(fname);
+      std::unique_ptr<TTreeIndex> read(f.Get<TTreeIndex>("index"));
+      ASSERT_NE(read, nullptr);
+      EXPECT_EQ(read->GetDeltaEncoding(), delta);
+      ExpectSameIndex(*index, *read);
+   }
+   gSystem->Unlink(fname);
+}